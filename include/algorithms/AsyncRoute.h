@@ -0,0 +1,342 @@
+#pragma once
+#include <exception>
+#include <string>
+#include <vector>
+#include "RouteService.h"
+
+/**
+ * @file AsyncRoute.h
+ * @brief Coroutine front end for RouteService
+ *
+ * Lets a coroutine-based server await routes without parking a thread per request:
+ *
+ *     RouteTask<RouteResult> handle(RouteService &service, CancellationToken token)
+ *     {
+ *         RouteResult route = co_await findRouteAsync(service, "A", "B", "time", token);
+ *         co_return route;
+ *     }
+ *
+ * Awaiting a query queues it with RouteService::submit and suspends; the worker
+ * that answers it resumes the coroutine, which then runs on that worker until it
+ * next suspends. A query that attached to an identical one in flight and stopped
+ * on its own token first resumes on the service's watcher thread instead. Work
+ * done between awaits should therefore be short.
+ *
+ * Cancellation flows through the CancellationToken handed to each query: cancelling
+ * the token a coroutine received stops every query it fanned out with it, and
+ * queries still queued are answered Cancelled without searching.
+ *
+ * Requires C++20 coroutines (build with -std=c++20, or TRANSPORT_ENABLE_COROUTINES
+ * in CMake). Under C++17 this header only defines TRANSPORT_HAS_COROUTINES as 0.
+ */
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define TRANSPORT_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifndef TRANSPORT_HAS_COROUTINES
+#define TRANSPORT_HAS_COROUTINES 0
+#endif
+
+#if TRANSPORT_HAS_COROUTINES
+#include <atomic>
+#include <coroutine>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+/**
+ * @class RouteTask
+ * @brief Lazily started coroutine producing a T (T must not be void)
+ *
+ * The body does not run until the task is awaited (or passed to whenAll/syncWait);
+ * when it finishes, the awaiting coroutine is resumed directly on the same thread.
+ * A task can be awaited once.
+ */
+template <typename T>
+class RouteTask
+{
+public:
+    struct promise_type
+    {
+        std::optional<T> value;
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation;
+
+        RouteTask get_return_object()
+        {
+            return RouteTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept
+        {
+            struct ResumeAwaiting
+            {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> finished) noexcept
+                {
+                    std::coroutine_handle<> awaiting = finished.promise().continuation;
+                    return awaiting ? awaiting : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return ResumeAwaiting{};
+        }
+
+        template <typename Value>
+        void return_value(Value &&result)
+        {
+            value.emplace(std::forward<Value>(result));
+        }
+
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    RouteTask(RouteTask &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+
+    RouteTask &operator=(RouteTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    RouteTask(const RouteTask &) = delete;
+    RouteTask &operator=(const RouteTask &) = delete;
+
+    ~RouteTask()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    // Start the body; it resumes awaiting when it finishes
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume()
+    {
+        if (handle.promise().error)
+            std::rethrow_exception(handle.promise().error);
+        return std::move(*handle.promise().value);
+    }
+
+private:
+    explicit RouteTask(std::coroutine_handle<promise_type> started) : handle(started) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * @class RouteAwaiter
+ * @brief Awaitable for one RouteService query, see findRouteAsync
+ */
+class RouteAwaiter
+{
+public:
+    RouteAwaiter(RouteService &service, std::string start, std::string end, std::string criteria,
+                 CancellationToken cancellation)
+        : service(service), start(std::move(start)), end(std::move(end)), criteria(std::move(criteria)),
+          cancellation(std::move(cancellation))
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> awaiting)
+    {
+        // The completion may resume the coroutine before submit returns, so nothing
+        // here may touch this awaiter after the call
+        service.submit(start, end, criteria, cancellation,
+                       [this, awaiting](const RouteResult &answered, std::exception_ptr failure)
+                       {
+                           result = answered;
+                           error = failure;
+                           awaiting.resume();
+                       });
+    }
+
+    RouteResult await_resume()
+    {
+        if (error)
+            std::rethrow_exception(error);
+        return std::move(result);
+    }
+
+private:
+    RouteService &service;
+    std::string start;
+    std::string end;
+    std::string criteria;
+    CancellationToken cancellation;
+    RouteResult result;
+    std::exception_ptr error;
+};
+
+/**
+ * @brief Await a route from the service's worker pool
+ * @return Awaitable yielding the same RouteResult RouteService::findRoute would
+ */
+inline RouteAwaiter findRouteAsync(RouteService &service, std::string start, std::string end,
+                                   std::string criteria = "time",
+                                   CancellationToken cancellation = CancellationToken())
+{
+    return RouteAwaiter(service, std::move(start), std::move(end), std::move(criteria), std::move(cancellation));
+}
+
+namespace route_async_detail
+{
+    // Fire-and-forget coroutine; its frame frees itself when the body ends
+    struct DetachedTask
+    {
+        struct promise_type
+        {
+            DetachedTask get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+
+    template <typename T>
+    struct WhenAllState
+    {
+        std::vector<std::optional<T>> results;
+        std::exception_ptr error; // First failure, rethrown once every task is done
+        std::mutex errorMutex;
+        std::atomic<size_t> remaining{0};
+        std::coroutine_handle<> parent;
+    };
+
+    template <typename T>
+    DetachedTask runChild(RouteTask<T> task, WhenAllState<T> *state, size_t index)
+    {
+        try
+        {
+            state->results[index].emplace(co_await task);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(state->errorMutex);
+            if (!state->error)
+                state->error = std::current_exception();
+        }
+        // The last one resumes whenAll, which may free state; nothing may follow this
+        if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            state->parent.resume();
+    }
+
+    template <typename T>
+    struct WhenAllAwaiter
+    {
+        std::vector<RouteTask<T>> &tasks;
+        WhenAllState<T> &state;
+
+        bool await_ready() const noexcept { return tasks.empty(); }
+
+        bool await_suspend(std::coroutine_handle<> parent)
+        {
+            state.parent = parent;
+            state.remaining.store(tasks.size() + 1, std::memory_order_relaxed);
+            for (size_t i = 0; i < tasks.size(); ++i)
+                runChild(std::move(tasks[i]), &state, i);
+            // The extra count keeps children that finish early from resuming the
+            // parent before it has suspended; stay running if they all did
+            return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    inline RouteTask<RouteResult> queryTask(RouteService &service, RouteService::Query query,
+                                            CancellationToken cancellation)
+    {
+        co_return co_await findRouteAsync(service, query.start, query.end, query.criteria, cancellation);
+    }
+
+    template <typename T>
+    DetachedTask runToPromise(RouteTask<T> task, std::promise<T> done)
+    {
+        try
+        {
+            done.set_value(co_await task);
+        }
+        catch (...)
+        {
+            done.set_exception(std::current_exception());
+        }
+    }
+}
+
+/**
+ * @brief Run tasks concurrently and collect their results in order
+ *
+ * Every task is started before this suspends, so their queries are all queued on
+ * the pool at once. If any task throws, the first exception is rethrown after the
+ * others have finished.
+ */
+template <typename T>
+RouteTask<std::vector<T>> whenAll(std::vector<RouteTask<T>> tasks)
+{
+    route_async_detail::WhenAllState<T> state; // Lives in this frame until every task is done
+    state.results.resize(tasks.size());
+    co_await route_async_detail::WhenAllAwaiter<T>{tasks, state};
+
+    if (state.error)
+        std::rethrow_exception(state.error);
+    std::vector<T> results;
+    results.reserve(state.results.size());
+    for (std::optional<T> &result : state.results)
+        results.push_back(std::move(*result));
+    co_return results;
+}
+
+/**
+ * @brief Await several queries at once, e.g. the legs of alternative routes
+ * @return Results in the order of queries
+ */
+inline RouteTask<std::vector<RouteResult>> findRoutesAsync(RouteService &service,
+                                                           std::vector<RouteService::Query> queries,
+                                                           CancellationToken cancellation = CancellationToken())
+{
+    std::vector<RouteTask<RouteResult>> tasks;
+    tasks.reserve(queries.size());
+    for (RouteService::Query &query : queries)
+    {
+        tasks.push_back(route_async_detail::queryTask(service, std::move(query), cancellation));
+    }
+    co_return co_await whenAll(std::move(tasks));
+}
+
+/**
+ * @brief Block the calling thread until task finishes, for code outside coroutines
+ *
+ * Must not be called from a RouteService worker or watcher thread, which would then
+ * wait on itself.
+ */
+template <typename T>
+T syncWait(RouteTask<T> task)
+{
+    std::promise<T> done;
+    std::future<T> result = done.get_future();
+    route_async_detail::runToPromise(std::move(task), std::move(done));
+    return result.get();
+}
+
+#endif // TRANSPORT_HAS_COROUTINES
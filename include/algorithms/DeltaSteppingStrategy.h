@@ -0,0 +1,87 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "RouteStrategy.h"
+#include "../core/GraphSnapshot.h"
+#include "../utils/WorkStealingScheduler.h"
+
+/**
+ * @class DeltaSteppingStrategy
+ * @brief Parallel single-source shortest paths by delta-stepping over a CSR snapshot
+ *
+ * Tentative distances are grouped into buckets of width delta. The lowest non-empty
+ * bucket is settled by repeatedly relaxing the light edges (weight <= delta) of its
+ * nodes in parallel, then the heavy edges of everything it settled are relaxed once.
+ * Relaxations from different workers meet in an atomic compare-and-swap minimum, so
+ * the final distances are exactly Dijkstra's. A small delta approaches Dijkstra's
+ * ordering; a large one approaches parallel Bellman-Ford. Weights are used as stored;
+ * Graph and GraphSnapshot::Editor both reject negative ones, so none reach a snapshot.
+ *
+ * Paths are rebuilt afterwards from tight edges (dist[u] + w == dist[v]) with a
+ * parallel breadth-first pass, which stays acyclic even with zero-weight edges.
+ *
+ * The snapshot of the last Graph searched is kept and reused until the graph's
+ * version changes, so repeated queries do not rebuild the CSR arrays.
+ */
+class DeltaSteppingStrategy : public RouteStrategy
+{
+public:
+    static constexpr long long UNREACHED = -1;
+
+    struct ShortestPaths
+    {
+        std::vector<long long> distance;  // UNREACHED for nodes the source cannot reach
+        std::vector<uint32_t> parentNode; // INVALID_NODE for the source and unreached nodes
+        std::vector<uint32_t> parentEdge; // Index into the parent node's EdgeRange
+        bool complete = false;            // False when the token stopped the search
+    };
+
+    /**
+     * @param delta Bucket width in the unit of the criterion, 0 to derive it from the graph
+     * @param scheduler Pool to relax on; null starts a private pool with one worker per core
+     */
+    explicit DeltaSteppingStrategy(long long delta = 0, transport::utils::WorkStealingScheduler *scheduler = nullptr);
+
+    RouteResult findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria,
+                          const CancellationToken &cancellation = CancellationToken(),
+                          SearchStats *stats = nullptr) override;
+
+    /**
+     * @brief Shortest distances from source to every node
+     * @param withPaths Also fill parentNode/parentEdge
+     * @param stats Filled with the work done when not null
+     */
+    ShortestPaths computeShortestPaths(const GraphSnapshot &snapshot, uint32_t source, GraphSnapshot::Criterion criterion,
+                                       bool withPaths, const CancellationToken &cancellation = CancellationToken(),
+                                       SearchStats *stats = nullptr);
+
+    /**
+     * @brief Locations reachable from origin within budget (an isochrone)
+     * @param budget Limit in the unit of the criteria, e.g. minutes for "time"
+     * @return Names of the reachable locations, origin included; empty if origin is unknown
+     */
+    std::vector<std::string> computeIsochrone(const Graph &graph, const std::string &origin, long long budget,
+                                              const std::string &criteria = "time");
+
+    void setDelta(long long delta);
+    long long getDelta() const;
+
+    // Mean positive edge weight of the criterion, a good default bucket width
+    static long long suggestDelta(const GraphSnapshot &snapshot, GraphSnapshot::Criterion criterion);
+
+private:
+    std::shared_ptr<const GraphSnapshot> snapshotFor(const Graph &graph);
+
+    template <typename Stats>
+    ShortestPaths run(const GraphSnapshot &snapshot, uint32_t source, GraphSnapshot::Criterion criterion,
+                      bool withPaths, const CancellationToken &cancellation, Stats &stats);
+
+    long long delta;
+    std::unique_ptr<transport::utils::WorkStealingScheduler> ownedScheduler;
+    transport::utils::WorkStealingScheduler *scheduler;
+
+    std::mutex snapshotMutex;
+    std::shared_ptr<const GraphSnapshot> cachedSnapshot;
+};
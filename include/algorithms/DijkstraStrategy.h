@@ -4,5 +4,7 @@
 class DijkstraStrategy : public RouteStrategy
 {
 public:
-    RouteResult findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria) override;
+    RouteResult findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria,
+                          const CancellationToken &cancellation = CancellationToken(),
+                          SearchStats *stats = nullptr) override;
 };
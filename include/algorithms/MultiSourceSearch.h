@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../core/GraphSnapshot.h"
+
+/**
+ * @class MultiSourceSearch
+ * @brief Runs up to LANES single-source searches in lockstep over one snapshot
+ *
+ * Distances are stored node-major with one 32-bit lane per source, so relaxing an
+ * edge updates all searches at once with a vector add and min. The traversal is
+ * label-correcting (a frontier-driven Bellman-Ford): a node is rescanned whenever
+ * any lane improved, which suits vector lanes better than one heap per source.
+ *
+ * The relaxation kernel is picked at runtime: AVX-512 (one 16-lane operation),
+ * AVX2 (two 8-lane operations) or a portable scalar loop. All kernels produce the
+ * same distances; only the speed differs.
+ *
+ * Distances are kept as 32-bit integers and must stay below INFINITE_DISTANCE,
+ * which holds for every criterion on city-scale networks.
+ */
+class MultiSourceSearch
+{
+public:
+    static constexpr uint32_t LANES = 16;
+    static constexpr int32_t INFINITE_DISTANCE = INT32_MAX / 2;
+    static constexpr long long UNREACHED = -1;
+
+    enum class Kernel
+    {
+        Scalar,
+        AVX2,
+        AVX512
+    };
+
+    // Widest kernel the running CPU supports
+    static Kernel detectKernel();
+    static bool isSupported(Kernel kernel);
+    static std::string kernelName(Kernel kernel);
+
+    /**
+     * @param kernel Relaxation kernel; falls back to Scalar when the CPU lacks it
+     */
+    explicit MultiSourceSearch(Kernel kernel = detectKernel());
+
+    /**
+     * @brief Search from every source at once
+     * @param sources Up to LANES node ids; lane i searches from sources[i], and
+     *        INVALID_NODE leaves a lane empty
+     */
+    void run(const GraphSnapshot &snapshot, const std::vector<uint32_t> &sources,
+             GraphSnapshot::Criterion criterion);
+
+    // Shortest distance from the source in lane to node, UNREACHED when there is no path
+    long long getDistance(uint32_t lane, uint32_t node) const;
+    bool reaches(uint32_t lane, uint32_t node) const;
+
+    Kernel getKernel() const { return kernel; }
+
+    // Returns true when any lane of target improved
+    using RelaxFunction = bool (*)(const int32_t *source, int32_t weight, int32_t *target);
+
+private:
+    Kernel kernel;
+    RelaxFunction relax;
+    std::vector<int32_t> distances; // LANES entries per node
+    std::vector<uint32_t> frontier;
+    std::vector<uint32_t> nextFrontier;
+    std::vector<uint8_t> queued;
+};
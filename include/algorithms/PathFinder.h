@@ -6,7 +6,9 @@ class PathFinder
 public:
     PathFinder(RouteStrategy *strategy);
     void setStrategy(RouteStrategy *strategy);
-    RouteResult findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria);
+    RouteResult findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria,
+                          const CancellationToken &cancellation = CancellationToken(),
+                          SearchStats *stats = nullptr);
 
 private:
     RouteStrategy *strategy;
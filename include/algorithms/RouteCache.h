@@ -0,0 +1,124 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RouteStrategy.h"
+
+/**
+ * @class RouteCache
+ * @brief Sharded, thread-safe LRU cache of route results
+ *
+ * Entries are keyed on (start, end, criteria, graph version). Graph::getVersion()
+ * changes on every edit, so a result computed before an edit can never be returned
+ * after it; purgeStale() additionally frees the memory held by other versions.
+ *
+ * The key hash selects one of several shards, each with its own mutex, LRU list and
+ * share of the memory budget, so concurrent lookups of different pairs rarely
+ * contend. Only completed searches (Found or NotFound) are worth caching; timed out
+ * and cancelled results are rejected by insert().
+ */
+class RouteCache
+{
+public:
+    struct Statistics
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t insertions = 0;
+        size_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+
+        double hitRate() const { return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses); }
+    };
+
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 8 * 1024 * 1024;
+
+    /**
+     * @param memoryBudget Approximate upper bound on cached bytes, split evenly over the shards
+     * @param shardCount Number of independently locked shards
+     */
+    explicit RouteCache(size_t memoryBudget = DEFAULT_MEMORY_BUDGET, size_t shardCount = 16);
+
+    RouteCache(const RouteCache &) = delete;
+    RouteCache &operator=(const RouteCache &) = delete;
+
+    /**
+     * @brief Look up a cached result and mark it most recently used
+     * @param result Receives the cached route on a hit
+     * @return True on a hit
+     */
+    bool lookup(const std::string &start, const std::string &end, const std::string &criteria,
+                uint64_t graphVersion, RouteResult &result);
+
+    /**
+     * @brief Store a result, evicting least recently used entries to stay within budget
+     * @return False when the result is not cacheable or larger than a shard's budget
+     */
+    bool insert(const std::string &start, const std::string &end, const std::string &criteria,
+                uint64_t graphVersion, const RouteResult &result);
+
+    // Drop every entry computed on a graph version other than currentVersion
+    size_t purgeStale(uint64_t currentVersion);
+
+    void clear();
+
+    // Shrinks take effect immediately by evicting from every shard
+    void setMemoryBudget(size_t memoryBudget);
+    size_t getMemoryBudget() const;
+
+    Statistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    struct Key
+    {
+        std::string start;
+        std::string end;
+        std::string criteria;
+        uint64_t graphVersion;
+
+        bool operator==(const Key &other) const
+        {
+            return graphVersion == other.graphVersion && start == other.start && end == other.end &&
+                   criteria == other.criteria;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const;
+    };
+
+    struct Entry
+    {
+        Key key;
+        RouteResult result;
+        size_t bytes;
+    };
+
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        std::list<Entry> lru; // Most recently used first
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        size_t bytes = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t insertions = 0;
+        size_t evictions = 0;
+    };
+
+    Shard &shardFor(const Key &key);
+    void evictLocked(Shard &shard, size_t budget);
+    static size_t estimateBytes(const Key &key, const RouteResult &result);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<size_t> memoryBudget;
+};
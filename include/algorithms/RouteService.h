@@ -0,0 +1,248 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "RouteStrategy.h"
+#include "../core/GraphSnapshot.h"
+#include "../core/VersionedGraph.h"
+#include "MultiSourceSearch.h"
+#include "ShortestPathTreeCache.h"
+#include "../utils/WorkStealingScheduler.h"
+
+class TraceLog;
+
+/**
+ * @class RouteService
+ * @brief Answers route queries concurrently on a work-stealing pool of threads
+ *
+ * Queries run against an immutable GraphSnapshot, so they never touch the mutable
+ * Graph or any shared error state. Each worker thread owns a SearchWorkspace that is
+ * sized once per snapshot and reused across queries, which keeps the per-query cost
+ * at the search itself rather than at allocating and clearing distance tables.
+ *
+ * A query is bound to the snapshot that was current when it was submitted;
+ * setSnapshot() only affects queries submitted afterwards.
+ *
+ * Identical queries (same snapshot, endpoints and criteria) submitted while one is
+ * still queued or running are coalesced: they wait for that single search and each
+ * receives a copy of its RouteResult. A waiting query whose own token stops first is
+ * detached and completed as TimedOut or Cancelled by a watcher thread, so it never
+ * waits out a leader with a longer deadline.
+ *
+ * Queued queries from an origin that is requested often are answered from that
+ * origin's cached shortest path tree (see ShortestPathTreeCache) instead of a search.
+ *
+ * With a TraceLog attached, every answered query also writes one binary trace record.
+ */
+class RouteService
+{
+public:
+    struct Query
+    {
+        std::string start;
+        std::string end;
+        std::string criteria = "time";
+    };
+
+    /**
+     * @brief Per-thread search scratch space
+     *
+     * Entries are valid only when stamp[node] == generation, so starting a new
+     * search is O(1) instead of O(nodes).
+     */
+    struct SearchWorkspace
+    {
+        std::vector<long long> distance;
+        std::vector<uint32_t> parentEdge; // Index into the parent node's EdgeRange
+        std::vector<uint32_t> parentNode;
+        std::vector<uint32_t> stamp;
+        std::vector<std::pair<long long, uint32_t>> heap;
+        uint32_t generation = 0;
+        uint32_t settled = 0; // Nodes settled by the last search run on this workspace
+
+        void prepare(uint32_t nodeCount);
+        bool isReached(uint32_t node) const { return stamp[node] == generation; }
+    };
+
+    /**
+     * @brief Start the worker pool
+     * @param snapshot Graph snapshot to answer queries from
+     * @param threadCount Number of workers, 0 for one per hardware thread
+     */
+    explicit RouteService(std::shared_ptr<const GraphSnapshot> snapshot, size_t threadCount = 0);
+
+    /**
+     * @brief Start the worker pool on a versioned graph
+     *
+     * Every query acquires the version that is current when it is submitted, so
+     * edits published through the VersionedGraph are picked up without a call to
+     * setSnapshot().
+     */
+    explicit RouteService(std::shared_ptr<const VersionedGraph> versions, size_t threadCount = 0);
+
+    // Finishes queued queries, then stops the workers
+    ~RouteService();
+
+    // Value stored in a travel matrix for destinations that cannot be reached
+    static constexpr long long UNREACHABLE = -1;
+
+    RouteService(const RouteService &) = delete;
+    RouteService &operator=(const RouteService &) = delete;
+
+    /**
+     * @brief Queue a query
+     * @param cancellation Deadline/cancel flag; a query whose token has already stopped
+     *        when a worker picks it up is answered TimedOut/Cancelled without searching,
+     *        so a backlog sheds its stale queries instead of working through them
+     */
+    std::future<RouteResult> submit(const std::string &start, const std::string &end,
+                                    const std::string &criteria = "time",
+                                    const CancellationToken &cancellation = CancellationToken());
+    // Receives the answer of a query, or the exception its search threw
+    using Completion = std::function<void(const RouteResult &result, std::exception_ptr error)>;
+
+    /**
+     * @brief Queue a query and have onComplete called with its answer
+     *
+     * onComplete runs on the worker that answered the query, never on the calling
+     * thread, and holds that worker while it runs, so it should not block. A coalesced
+     * query whose own token stops before its leader finishes is instead completed on
+     * the service's watcher thread, where a slow onComplete delays the other stopped
+     * followers. This is the hook for event loops and coroutines (see AsyncRoute.h).
+     */
+    void submit(const std::string &start, const std::string &end, const std::string &criteria,
+                const CancellationToken &cancellation, Completion onComplete);
+
+    std::vector<std::future<RouteResult>> submitBatch(const std::vector<Query> &queries,
+                                                      const CancellationToken &cancellation = CancellationToken());
+
+    /**
+     * @brief Origin-destination matrix of shortest path totals
+     *
+     * Origins are searched MultiSourceSearch::LANES at a time with the batch kernel,
+     * one group per scheduler task, so groups containing hub origins that settle most
+     * of the network do not hold up the other workers.
+     * @return matrix[o][d] in the unit of the criteria, UNREACHABLE when there is no
+     *         path or either name is unknown
+     */
+    std::vector<std::vector<long long>> computeMatrix(const std::vector<std::string> &origins,
+                                                      const std::vector<std::string> &destinations,
+                                                      const std::string &criteria = "time");
+
+    // Blocking convenience wrapper around submit()
+    RouteResult findRoute(const std::string &start, const std::string &end,
+                          const std::string &criteria = "time",
+                          const CancellationToken &cancellation = CancellationToken());
+
+    // Ignored when the service follows a VersionedGraph
+    void setSnapshot(std::shared_ptr<const GraphSnapshot> snapshot);
+    std::shared_ptr<const GraphSnapshot> getSnapshot() const;
+
+    size_t getThreadCount() const;
+    size_t getCompletedQueries() const;
+
+    // Queries answered by attaching to an identical in-flight query
+    size_t getCoalescedQueries() const;
+
+    // Pool the queries run on; batch jobs can submit their own tasks to it
+    transport::utils::WorkStealingScheduler &getScheduler();
+
+    // Tree cache used by submitted queries; tune its budget and threshold here
+    ShortestPathTreeCache &getTreeCache();
+
+    /**
+     * @brief Write a TraceLog record for every query answered from now on
+     *
+     * Records carry the query's node ids, criterion, status, the nodes its search
+     * settled (0 when answered from a cached tree) and its latency from submit() to
+     * the answer. Coalesced queries are flagged and report the search they shared.
+     * @param trace Open trace to append to, nullptr to stop tracing
+     */
+    void setTraceLog(std::shared_ptr<TraceLog> trace);
+    std::shared_ptr<TraceLog> getTraceLog() const;
+
+    // Relaxation kernel for computeMatrix; defaults to the widest one the CPU supports
+    void setBatchKernel(MultiSourceSearch::Kernel kernel);
+    MultiSourceSearch::Kernel getBatchKernel() const;
+
+    /**
+     * @brief Read max_threads from a key=value config file
+     * @return Configured worker count, or 0 (one per hardware thread) when unset
+     */
+    static size_t threadCountFromConfig(const std::string &configPath);
+
+    /**
+     * @brief Single-source Dijkstra over a snapshot using caller-owned scratch space
+     * @return Route with the same semantics as DijkstraStrategy::findRoute
+     */
+    static RouteResult search(const GraphSnapshot &snapshot, SearchWorkspace &workspace,
+                              const std::string &start, const std::string &end,
+                              const std::string &criteria,
+                              const CancellationToken &cancellation = CancellationToken());
+
+    /**
+     * @brief Settle every node reachable from source
+     *
+     * Afterwards workspace.isReached(v) and workspace.distance[v] describe the
+     * shortest path tree rooted at source.
+     */
+    static bool searchAll(const GraphSnapshot &snapshot, SearchWorkspace &workspace, uint32_t source,
+                          GraphSnapshot::Criterion criterion,
+                          const CancellationToken &cancellation = CancellationToken());
+
+    // Workspace owned by the calling thread, for tasks run on the scheduler
+    static SearchWorkspace &threadWorkspace();
+
+    // Fill result with the path to target described by parent arrays rooted at source
+    static void extractPath(const GraphSnapshot &snapshot, const uint32_t *parentNode, const uint32_t *parentEdge,
+                            uint32_t source, uint32_t target, RouteResult &result);
+
+private:
+    struct Waiter
+    {
+        Completion onComplete;
+        CancellationToken cancellation;
+        std::string criteria;
+        size_t cancelCallback; // Wakes the watcher when the token is cancelled, 0 if it cannot be
+    };
+
+    void deliver(const Completion &onComplete, const RouteResult &result, std::exception_ptr error);
+
+    // Watcher thread loop: completes followers whose token stopped before their leader finished
+    void watchFollowers();
+    void wakeWatcher();
+
+    // Wrap onComplete so that answering the query also appends its trace record
+    Completion traced(Completion onComplete, std::shared_ptr<TraceLog> trace, const GraphSnapshot &snapshot,
+                      const std::string &start, const std::string &end, const std::string &criteria,
+                      bool coalesced);
+
+    // Answer one query, through the tree cache when its origin is hot
+    RouteResult answer(const GraphSnapshot &snapshot, const std::string &start, const std::string &end,
+                       const std::string &criteria, const CancellationToken &cancellation);
+
+    std::shared_ptr<const GraphSnapshot> snapshot; // Accessed with std::atomic_load/store
+    std::shared_ptr<const VersionedGraph> versions; // Takes precedence over snapshot when set
+    std::atomic<size_t> completedQueries{0};
+    std::atomic<size_t> coalescedQueries{0};
+    std::shared_ptr<TraceLog> traceLog; // Accessed with std::atomic_load/store
+    std::mutex inflightMutex;
+    std::unordered_map<std::string, std::vector<Waiter>> inflight; // Followers of each running query
+    std::mutex watchMutex; // Never held while taking inflightMutex or a token's lock
+    std::condition_variable watchSignal;
+    bool followersChanged = false; // Guarded by watchMutex, as is stopWatching
+    bool stopWatching = false;
+    std::thread followerWatcher; // Started when the first follower with a stoppable token attaches
+    std::atomic<bool> shuttingDown{false};
+    ShortestPathTreeCache treeCache;
+    std::atomic<MultiSourceSearch::Kernel> batchKernel{MultiSourceSearch::detectKernel()};
+    std::unique_ptr<transport::utils::WorkStealingScheduler> scheduler; // Last, so it drains first
+};
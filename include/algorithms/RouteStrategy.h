@@ -1,12 +1,26 @@
 #pragma once
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <utility>
 #include "../core/Graph.h"
 #include "../core/Edge.h"
 #include "../core/Node.h"
+#include "SearchStats.h"
+
+// Why a search ended; isValid is true exactly when the status is Found
+enum class RouteStatus
+{
+    Found,
+    NotFound,  // Search finished without reaching the destination
+    TimedOut,  // Deadline passed before the search finished
+    Cancelled  // Caller cancelled the query
+};
 
 struct RouteResult
 {
@@ -17,8 +31,86 @@ struct RouteResult
     int totalTransfers;
     std::string criteria;
     bool isValid; // Added this flag
+    RouteStatus status;
+
+    RouteResult() : totalDistance(0), totalTime(0), totalCost(0), totalTransfers(0), isValid(false),
+                    status(RouteStatus::NotFound) {}
+};
+
+/**
+ * @brief Deadline and cancellation flag for one route query
+ *
+ * Copies share the cancellation flag, so the caller keeps one copy to cancel() while
+ * the search polls another. Searches call shouldStop() only every CHECK_INTERVAL
+ * settled nodes, which keeps the clock read off the hot path. A default-constructed
+ * token never stops and costs nothing to create.
+ */
+class CancellationToken
+{
+public:
+    static constexpr unsigned CHECK_INTERVAL = 256;
+
+    CancellationToken() = default;
+
+    // Token without a deadline that stops once cancel() is called on any copy
+    static CancellationToken cancellable()
+    {
+        CancellationToken token;
+        token.state = std::make_shared<State>();
+        return token;
+    }
+
+    // Cancellable token that also expires after timeout
+    static CancellationToken withTimeout(std::chrono::milliseconds timeout)
+    {
+        CancellationToken token = cancellable();
+        token.deadline = std::chrono::steady_clock::now() + timeout;
+        token.hasDeadline = true;
+        return token;
+    }
+
+    // Stops every copy and runs their cancel callbacks on the calling thread
+    void cancel();
+
+    // False for a default-constructed token, which never stops
+    bool canStop() const { return state != nullptr; }
+    bool isCancelled() const { return state && state->cancelled.load(std::memory_order_relaxed); }
+    bool isExpired() const { return hasDeadline && std::chrono::steady_clock::now() >= deadline; }
+    bool shouldStop() const { return isCancelled() || isExpired(); }
+
+    // Status to report once shouldStop() returned true
+    RouteStatus stopStatus() const { return isCancelled() ? RouteStatus::Cancelled : RouteStatus::TimedOut; }
+
+    // When the token expires, time_point::max() for a token without a deadline
+    std::chrono::steady_clock::time_point getDeadline() const
+    {
+        return hasDeadline ? deadline : std::chrono::steady_clock::time_point::max();
+    }
+
+    /**
+     * @brief Have onCancel called when cancel() is called on any copy
+     *
+     * Called right away when the token is already cancelled. Callbacks run while the
+     * token holds its lock, so they should only wake whoever waits on the token.
+     * @return Id for removeCancelCallback, 0 for a token that cannot stop
+     */
+    size_t addCancelCallback(std::function<void()> onCancel) const;
+
+    // After this returns the callback is neither running nor called again
+    void removeCancelCallback(size_t id) const;
+
+private:
+    struct State
+    {
+        std::atomic<bool> cancelled{false};
+        std::mutex mutex; // Guards callbacks and nextCallbackId
+        std::vector<std::pair<size_t, std::function<void()>>> callbacks;
+        size_t nextCallbackId = 1;
+    };
 
-    RouteResult() : totalDistance(0), totalTime(0), totalCost(0), totalTransfers(0), isValid(false) {}
+    std::shared_ptr<State> state;
+    std::chrono::steady_clock::time_point deadline;
+    bool hasDeadline = false;
 };
 
 class RouteStrategy
@@ -30,11 +122,15 @@ public:
     // Virtual destructor
     virtual ~RouteStrategy() = default;
 
-    // Main interface method for finding a route
+    // Main interface method for finding a route; implementations poll the token
+    // every CancellationToken::CHECK_INTERVAL settled nodes and, when stats is not
+    // null, fill it with the work the search did
     virtual RouteResult findRoute(const Graph &graph,
                                   const std::string &start,
                                   const std::string &end,
-                                  const std::string &criteria = "time") = 0;
+                                  const std::string &criteria = "time",
+                                  const CancellationToken &cancellation = CancellationToken(),
+                                  SearchStats *stats = nullptr) = 0;
 
 protected:
     // Helper method to reconstruct path from predecessors map
@@ -0,0 +1,149 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "../utils/Histogram.h"
+
+/**
+ * @brief Work done by one route search, filled when a caller passes a SearchStats
+ *        to RouteStrategy::findRoute
+ *
+ * For heap-based searches the queue is the binary heap; for delta-stepping it is the
+ * bucket array, so pushes are bucket insertions and the peak is the largest bucket.
+ */
+struct SearchStats
+{
+    enum Phase
+    {
+        Setup,     // Allocating and initialising distance tables
+        Search,    // Settling nodes
+        PathBuild, // Rebuilding the path and summing its metrics
+        PHASE_COUNT
+    };
+
+    uint64_t nodesSettled = 0;
+    uint64_t edgesRelaxed = 0;  // Out-edges examined from settled nodes
+    uint64_t heapPushes = 0;
+    uint64_t heapPops = 0;
+    uint64_t stalePops = 0;     // Pops skipped because a shorter distance was already found
+    uint64_t peakQueueSize = 0;
+    std::array<double, PHASE_COUNT> phaseSeconds{};
+
+    double totalSeconds() const { return phaseSeconds[Setup] + phaseSeconds[Search] + phaseSeconds[PathBuild]; }
+};
+
+/**
+ * @brief Statistics policy that records nothing
+ *
+ * Searches are templates over the policy; with this one every hook is an empty
+ * inline call and the counting disappears from the generated code.
+ */
+class NoSearchStats
+{
+public:
+    static constexpr bool ENABLED = false;
+
+    void enterPhase(SearchStats::Phase) {}
+    void settled(uint64_t = 1) {}
+    void relaxed(uint64_t = 1) {}
+    void pushed(size_t) {}
+    void popped() {}
+    void stalePopped() {}
+};
+
+/**
+ * @brief Statistics policy that fills a SearchStats
+ *
+ * Starts in the Setup phase; the time of the current phase is added when the next
+ * one is entered or the policy is destroyed.
+ */
+class CollectSearchStats
+{
+public:
+    static constexpr bool ENABLED = true;
+
+    explicit CollectSearchStats(SearchStats &stats)
+        : stats(stats), phase(SearchStats::Setup), phaseStart(std::chrono::steady_clock::now())
+    {
+        stats = SearchStats();
+    }
+
+    ~CollectSearchStats() { closePhase(); }
+
+    CollectSearchStats(const CollectSearchStats &) = delete;
+    CollectSearchStats &operator=(const CollectSearchStats &) = delete;
+
+    void enterPhase(SearchStats::Phase next)
+    {
+        closePhase();
+        phase = next;
+    }
+
+    void settled(uint64_t count = 1) { stats.nodesSettled += count; }
+    void relaxed(uint64_t count = 1) { stats.edgesRelaxed += count; }
+
+    void pushed(size_t queueSize)
+    {
+        ++stats.heapPushes;
+        if (queueSize > stats.peakQueueSize)
+            stats.peakQueueSize = queueSize;
+    }
+
+    void popped() { ++stats.heapPops; }
+    void stalePopped() { ++stats.stalePops; }
+
+private:
+    void closePhase()
+    {
+        auto now = std::chrono::steady_clock::now();
+        stats.phaseSeconds[phase] += std::chrono::duration<double>(now - phaseStart).count();
+        phaseStart = now;
+    }
+
+    SearchStats &stats;
+    SearchStats::Phase phase;
+    std::chrono::steady_clock::time_point phaseStart;
+};
+
+/**
+ * @class SearchStatsCollector
+ * @brief Thread-safe histograms of SearchStats over many queries
+ *
+ * Counters are recorded as they are; phase times are recorded in microseconds.
+ */
+class SearchStatsCollector
+{
+public:
+    enum Metric
+    {
+        NodesSettled,
+        EdgesRelaxed,
+        HeapPushes,
+        HeapPops,
+        StalePops,
+        PeakQueueSize,
+        SetupMicros,
+        SearchMicros,
+        PathBuildMicros,
+        TotalMicros,
+        METRIC_COUNT
+    };
+
+    void record(const SearchStats &stats);
+    void reset();
+
+    uint64_t getQueries() const;
+    transport::utils::Histogram getHistogram(Metric metric) const;
+
+    static std::string metricName(Metric metric);
+
+    // One line per metric with its histogram summary
+    std::string report() const;
+
+private:
+    mutable std::mutex mutex;
+    uint64_t queries = 0;
+    std::array<transport::utils::Histogram, METRIC_COUNT> histograms;
+};
@@ -0,0 +1,136 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "../core/GraphSnapshot.h"
+
+/**
+ * @class ShortestPathTreeCache
+ * @brief Keeps complete single-source shortest path trees for frequently queried origins
+ *
+ * Every query reports its origin through acquire(). Once an origin is requested
+ * hotThreshold times within one rate window, the next caller is asked to build the
+ * origin's full tree; from then on every destination from that origin is answered
+ * by walking parent pointers instead of searching.
+ *
+ * Trees are keyed on (snapshot version, origin, criterion). When a query arrives on
+ * a newer version every tree and counter of older versions is dropped, so the graph's
+ * mutation counter is the only invalidation signal needed. Trees are evicted least
+ * recently used first to stay under the memory budget. Thread-safe.
+ */
+class ShortestPathTreeCache
+{
+public:
+    struct Tree
+    {
+        uint64_t graphVersion = 0;
+        uint32_t source = GraphSnapshot::INVALID_NODE;
+        GraphSnapshot::Criterion criterion = GraphSnapshot::Criterion::Time;
+        std::vector<long long> distance; // UNREACHED for nodes the source cannot reach
+        std::vector<uint32_t> parentNode;
+        std::vector<uint32_t> parentEdge; // Index into the parent node's EdgeRange
+
+        static constexpr long long UNREACHED = -1;
+
+        bool reaches(uint32_t node) const { return distance[node] != UNREACHED; }
+        size_t getMemoryUsage() const;
+    };
+
+    struct Statistics
+    {
+        size_t hits = 0;       // Queries answered from a cached tree
+        size_t misses = 0;     // Queries that had to search
+        size_t treesBuilt = 0;
+        size_t evictions = 0;
+        size_t trees = 0;
+        size_t bytes = 0;
+    };
+
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 32 * 1024 * 1024;
+    static constexpr unsigned DEFAULT_HOT_THRESHOLD = 8;
+
+    /**
+     * @param memoryBudget Upper bound on the bytes held by cached trees
+     * @param hotThreshold Requests per window that make an origin hot
+     * @param window Length of the rate window
+     */
+    explicit ShortestPathTreeCache(size_t memoryBudget = DEFAULT_MEMORY_BUDGET,
+                                   unsigned hotThreshold = DEFAULT_HOT_THRESHOLD,
+                                   std::chrono::milliseconds window = std::chrono::milliseconds(1000));
+
+    ShortestPathTreeCache(const ShortestPathTreeCache &) = delete;
+    ShortestPathTreeCache &operator=(const ShortestPathTreeCache &) = delete;
+
+    /**
+     * @brief Count a query from source and return its tree when one is cached
+     * @param shouldBuild Set to true when this query made the origin hot; the caller
+     *        must then call publish() or abandon() for the same key
+     * @return Cached tree, or null
+     */
+    std::shared_ptr<const Tree> acquire(uint64_t graphVersion, uint32_t source,
+                                        GraphSnapshot::Criterion criterion, bool &shouldBuild);
+
+    // Store a tree built after acquire() asked for it
+    void publish(std::shared_ptr<const Tree> tree);
+
+    // Give up a build (e.g. the query deadline passed); a later query may retry
+    void abandon(uint64_t graphVersion, uint32_t source, GraphSnapshot::Criterion criterion);
+
+    void clear();
+    void setMemoryBudget(size_t memoryBudget);
+    void setHotThreshold(unsigned hotThreshold);
+    Statistics getStatistics() const;
+
+private:
+    struct Key
+    {
+        uint64_t graphVersion;
+        uint32_t source;
+        GraphSnapshot::Criterion criterion;
+
+        bool operator==(const Key &other) const
+        {
+            return graphVersion == other.graphVersion && source == other.source && criterion == other.criterion;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const
+        {
+            return std::hash<uint64_t>()(key.graphVersion * 0x9e3779b97f4a7c15ULL ^
+                                         (static_cast<uint64_t>(key.source) << 3) ^
+                                         static_cast<uint64_t>(key.criterion));
+        }
+    };
+
+    struct Slot
+    {
+        std::shared_ptr<const Tree> tree;
+        std::list<Key>::iterator lruPosition; // Valid only while tree is set
+        std::chrono::steady_clock::time_point windowStart;
+        unsigned requests = 0;
+        bool building = false;
+    };
+
+    // Bound on rate counters kept for origins without a tree
+    static constexpr size_t MAX_COUNTERS = 4096;
+
+    void dropOlderVersionsLocked(uint64_t graphVersion);
+    void evictLocked();
+
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Slot, KeyHash> slots;
+    std::list<Key> lru; // Keys of slots holding a tree, most recently used first
+    uint64_t currentVersion = 0;
+    size_t memoryBudget;
+    unsigned hotThreshold;
+    std::chrono::milliseconds window;
+    size_t bytes = 0;
+    Statistics counters;
+};
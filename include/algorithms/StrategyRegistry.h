@@ -0,0 +1,48 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "RouteStrategy.h"
+
+/**
+ * @class StrategyRegistry
+ * @brief Named factories for every RouteStrategy the system can run
+ *
+ * TransportationSystem::setAlgorithm accepts any registered name, and the differential
+ * tests run every registered strategy against "dijkstra", the reference. A new
+ * strategy therefore only needs one add() call to be selectable and to be checked
+ * on random graphs. The built-in strategies are registered on first use.
+ */
+class StrategyRegistry
+{
+public:
+    using Factory = std::function<std::unique_ptr<RouteStrategy>()>;
+
+    // Name of the reference strategy every other one must agree with
+    static constexpr const char *REFERENCE = "dijkstra";
+
+    static StrategyRegistry &instance();
+
+    /**
+     * @brief Register a strategy under a new name
+     * @return False if the name is already taken
+     */
+    bool add(const std::string &name, Factory factory);
+
+    // New instance of the named strategy, null if the name is unknown
+    std::unique_ptr<RouteStrategy> create(const std::string &name) const;
+
+    bool contains(const std::string &name) const;
+
+    // Registered names in registration order, the reference first
+    std::vector<std::string> getNames() const;
+
+private:
+    StrategyRegistry();
+
+    mutable std::mutex mutex;
+    std::vector<std::pair<std::string, Factory>> factories;
+};
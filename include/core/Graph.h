@@ -1,4 +1,6 @@
 #pragma once 
+#include <cstdint> 
+#include <functional> 
 #include <string> 
 #include <vector> 
 #include <map> 
@@ -17,6 +19,19 @@ public:
     // Basic operations 
     bool addNode(const std::string &name, double latitude, double longitude); 
     bool addEdge(const std::string &source, const std::string &destination, int distance, int time, int cost, int transfers, const std::string &transport_mode); 
+ 
+    // Bulk loading for importers: skips whatever addNode/addEdge would reject, but 
+    // prints nothing per element and bumps the version once. Returns how many were added 
+    size_t addNodes(const std::vector<Node> &newNodes); 
+    size_t addEdges(const std::vector<Edge> &newEdges); 
+    // Same for updateNode/updateEdge: coordinates and edge weights of elements that 
+    // exist are overwritten, the rest skipped. Returns how many were updated 
+    size_t updateNodes(const std::vector<Node> &changedNodes); 
+    size_t updateEdges(const std::vector<Edge> &changedEdges); 
+    // And for removeNode/removeEdge; removing nodes scans the adjacency lists once per 
+    // batch instead of once per node. Returns how many were removed 
+    size_t removeNodes(const std::vector<std::string> &names); 
+    size_t removeEdges(const std::vector<std::pair<std::string, std::string>> &endpoints); 
     bool removeNode(const std::string &name); 
     bool removeEdge(const std::string &source, const std::string &destination); 
  
@@ -34,6 +49,8 @@ public:
     int getNodeCount() const; 
     int getEdgeCount() const; 
     std::vector<std::string> getAllNodes() const; 
+    // Visit every node in name order without copying them; visit must not edit the graph 
+    void forEachNode(const std::function<void(const Node &)> &visit) const; 
  
     // Graph analysis 
     bool isConnected() const; 
@@ -49,6 +66,13 @@ public:
     // Memory management 
     void clear(); 
  
+    // Content stamp: changes on every successful mutation and is never reused by any 
+    // graph in the process, so (version, query) identifies a result. Copies share it. 
+    uint64_t getVersion() const; 
+ 
+    // Next stamp from the same sequence, for structures derived from a graph 
+    static uint64_t allocateVersion(); 
+ 
     // For compatibility with existing code 
     std::vector<std::string> getNodeNames() const; 
     std::vector<Node> getNodes() const; 
@@ -57,4 +81,7 @@ public:
 private: 
     std::map<std::string, Node> nodes; 
     std::map<std::string, std::list<Edge>> adjacency_list; 
+    uint64_t version; 
+ 
+    void touch(); 
 }; 
@@ -0,0 +1,173 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * @class GraphSnapshot
+ * @brief Immutable compressed-sparse-row copy of a Graph for concurrent searches
+ *
+ * Node names are mapped to dense ids, and the outgoing edges of each node are stored
+ * as flat arrays with one integer weight array per criterion. Nodes are grouped into
+ * blocks of BLOCK_SIZE ids; each block owns the CSR arrays of its nodes, and a node
+ * block beside it owns their names and coordinates. The name index is split by hash
+ * into shards of about one block each. All of these are held through shared pointers,
+ * so an Editor can derive a new snapshot that copies only the blocks and shards it
+ * touches and shares the rest with the original.
+ *
+ * Nothing is mutated after construction, so any number of threads can search one
+ * snapshot without locking; share it through std::shared_ptr<const GraphSnapshot>.
+ */
+class GraphSnapshot
+{
+public:
+    enum class Criterion
+    {
+        Distance,
+        Time,
+        Cost,
+        Transfers
+    };
+
+    static constexpr int CRITERION_COUNT = 4;
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+    static constexpr uint32_t BLOCK_BITS = 6;
+    static constexpr uint32_t BLOCK_SIZE = 1u << BLOCK_BITS;
+
+    // Outgoing edges of one node; pointers stay valid as long as the snapshot lives
+    struct EdgeRange
+    {
+        const uint32_t *targets;
+        const int *weights[CRITERION_COUNT];
+        const uint16_t *modes;
+        uint32_t count;
+
+        uint32_t size() const { return count; }
+        const int *getWeights(Criterion criterion) const { return weights[static_cast<int>(criterion)]; }
+        int getWeight(uint32_t index, Criterion criterion) const { return weights[static_cast<int>(criterion)][index]; }
+    };
+
+    class Editor;
+
+    explicit GraphSnapshot(const Graph &graph);
+
+    // Unrecognised criteria fall back to time, as in DijkstraStrategy
+    static Criterion parseCriterion(const std::string &criteria);
+    static std::string criterionName(Criterion criterion);
+
+    // Size of the id space; ids of removed nodes stay allocated but have no edges
+    uint32_t getNodeCount() const { return nodeCount; }
+    uint32_t getActiveNodeCount() const { return activeNodeCount; }
+    uint32_t getEdgeCount() const { return edgeCount; }
+
+    // Graph::getVersion() of the source graph; every published edit gets a fresh one
+    uint64_t getVersion() const { return version; }
+
+    // Dense id of a node name, INVALID_NODE when absent
+    uint32_t findNode(const std::string &name) const;
+    bool isActive(uint32_t node) const { return nodeBlock(node).active[node & (BLOCK_SIZE - 1)] != 0; }
+    const std::string &getName(uint32_t node) const { return nodeBlock(node).names[node & (BLOCK_SIZE - 1)]; }
+    double getLatitude(uint32_t node) const { return nodeBlock(node).latitudes[node & (BLOCK_SIZE - 1)]; }
+    double getLongitude(uint32_t node) const { return nodeBlock(node).longitudes[node & (BLOCK_SIZE - 1)]; }
+
+    EdgeRange getEdges(uint32_t node) const;
+    const std::string &getModeName(uint16_t mode) const { return (*modeNames)[mode]; }
+
+    // Approximate heap footprint, counting shared blocks in full
+    size_t getMemoryUsage() const;
+
+    // True when both snapshots hold the very same block for this node (no copy was made)
+    bool sharesBlockWith(const GraphSnapshot &other, uint32_t node) const;
+    // Same for the block holding the node's name and coordinates
+    bool sharesNodeBlockWith(const GraphSnapshot &other, uint32_t node) const;
+
+private:
+    // Names and coordinates of the nodes of one block
+    struct NodeBlock
+    {
+        std::vector<std::string> names;
+        std::vector<double> latitudes;
+        std::vector<double> longitudes;
+        std::vector<uint8_t> active;
+    };
+
+    using NameIndex = std::unordered_map<std::string, uint32_t>;
+
+    // Fewest index shards; more are used for large graphs, fixed for the editors' lifetime
+    static constexpr size_t MIN_INDEX_SHARDS = 64;
+
+    struct Block
+    {
+        std::vector<uint32_t> offsets{0}; // One entry per node in the block, plus one
+        std::vector<uint32_t> targets;
+        std::vector<int> weights[CRITERION_COUNT];
+        std::vector<uint16_t> modes;
+    };
+
+    GraphSnapshot() = default;
+
+    const NodeBlock &nodeBlock(uint32_t node) const { return *nodeBlocks[node >> BLOCK_BITS]; }
+    size_t shardOf(const std::string &name) const { return std::hash<std::string>()(name) & (indexShards.size() - 1); }
+
+    std::vector<std::shared_ptr<const NodeBlock>> nodeBlocks; // Parallel to blocks
+    std::vector<std::shared_ptr<const NameIndex>> indexShards; // Power-of-two count
+    std::vector<std::shared_ptr<const Block>> blocks;
+    std::shared_ptr<const std::vector<std::string>> modeNames;
+    uint32_t nodeCount = 0;
+    uint32_t activeNodeCount = 0;
+    uint32_t edgeCount = 0;
+    uint64_t version = 0;
+};
+
+/**
+ * @class GraphSnapshot::Editor
+ * @brief Derives a new snapshot from an existing one by copy-on-write
+ *
+ * Edge edits copy only the block of the source node. Node edits copy the node block
+ * of that node and, when the name index changes, the one index shard holding the
+ * name, so their cost does not grow with the graph. The base snapshot is never
+ * modified, so readers that still hold it are unaffected. The edit methods mirror
+ * Graph's rules: one edge per ordered node pair, both endpoints must exist, and no
+ * edge weight may be negative.
+ */
+class GraphSnapshot::Editor
+{
+public:
+    explicit Editor(const GraphSnapshot &base);
+
+    bool addNode(const std::string &name, double latitude, double longitude);
+    bool updateNode(const std::string &name, double latitude, double longitude);
+    bool removeNode(const std::string &name);
+    bool addEdge(const std::string &source, const std::string &destination, int distance,
+                 int time, int cost, int transfers, const std::string &mode);
+    bool updateEdge(const std::string &source, const std::string &destination, int distance,
+                    int time, int cost, int transfers, const std::string &mode);
+    bool removeEdge(const std::string &source, const std::string &destination);
+
+    // Number of adjacency blocks copied so far, not counting node blocks or shards
+    size_t getCopiedBlocks() const { return copiedBlocks; }
+
+    // Finish editing; the editor must not be used afterwards
+    std::shared_ptr<const GraphSnapshot> publish();
+
+private:
+    NodeBlock &mutableNodeBlock(uint32_t node);
+    NameIndex &mutableShard(const std::string &name);
+    Block &mutableBlock(uint32_t node);
+    uint16_t internMode(const std::string &mode);
+    uint32_t findEdge(uint32_t source, uint32_t target) const;
+    void setEdge(uint32_t source, uint32_t position, uint32_t target, const int values[CRITERION_COUNT], uint16_t mode);
+    void insertEdge(uint32_t source, uint32_t target, const int values[CRITERION_COUNT], uint16_t mode);
+    void eraseEdge(uint32_t source, uint32_t position);
+
+    std::shared_ptr<GraphSnapshot> draft;
+    std::shared_ptr<std::vector<std::string>> ownedModes;
+    std::vector<std::shared_ptr<Block>> ownedBlocks; // Parallel to draft->blocks, null until copied
+    std::vector<std::shared_ptr<NodeBlock>> ownedNodeBlocks; // Likewise for draft->nodeBlocks
+    std::vector<std::shared_ptr<NameIndex>> ownedShards;     // And draft->indexShards
+    size_t copiedBlocks = 0;
+};
@@ -1,13 +1,23 @@
 #ifndef TRANSPORTATION_SYSTEM_H
 #define TRANSPORTATION_SYSTEM_H
 
+#include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "Graph.h"
 #include "../algorithms/RouteStrategy.h"
+#include "../algorithms/RouteService.h"
+#include "../algorithms/RouteCache.h"
+#include "../algorithms/DeltaSteppingStrategy.h"
 #include "../preferences/UserPreferences.h"
+#include "../io/NetworkJournal.h"
+#include "../io/TraceLog.h"
+#include "../utils/Metrics.h"
+#include "../utils/MetricsServer.h"
 
 /**
  * @class TransportationSystem
@@ -55,18 +65,21 @@ public:
     void reset();
 
     // Graph management methods
-    /**
-     * @brief Get reference to the network graph
-     * @return Reference to the graph
-     */
-    Graph &getNetwork();
-
     /**
      * @brief Get const reference to the network graph
      * @return Const reference to the graph
      */
     const Graph &getNetwork() const;
 
+    /**
+     * @brief Get the network graph for direct edits
+     *
+     * Edits made through it are not journaled, so it is withheld while journaling is
+     * enabled; use the location and route methods instead, which append every edit.
+     * @return Pointer to the graph, or null while journaling is enabled
+     */
+    Graph *getMutableNetwork();
+
     /**
      * @brief Load network data from file
      * @param filename Path to the data file
@@ -148,11 +161,47 @@ public:
                      double distance, int time, double cost, int transfers,
                      const std::string &mode);
 
+    // Incremental persistence
+    /**
+     * @brief Persist every later network edit to an append-only journal
+     *
+     * The journal snapshot and logs under basePath are replayed into the current
+     * network first, so calling this after loadNetworkData() restores edits made in
+     * earlier sessions. Each edit then costs one small append instead of a full
+     * saveNetworkData() rewrite. Loading another network while the journal is open
+     * compacts it into a snapshot of the new network, so later sessions do not replay
+     * old edits on top of it.
+     * @param basePath Path prefix for the snapshot and log files
+     * @return True if successful, false otherwise
+     */
+    bool enableJournal(const std::string &basePath);
+
+    /**
+     * @brief Fold the journal logs into a new snapshot
+     * @param background Write the snapshot on a background thread
+     * @return True if compaction was started, false otherwise
+     */
+    bool compactJournal(bool background = true);
+
+    /**
+     * @brief Stop journaling, waiting for any running compaction
+     */
+    void disableJournal();
+
+    /**
+     * @brief Check whether edits are being journaled
+     * @return True if a journal is open, false otherwise
+     */
+    bool isJournalEnabled() const;
+
     // Route finding methods
     /**
      * @brief Set route finding algorithm
-     * @param algorithmName Algorithm name (dijkstra, astar)
+     * @param algorithmName "astar" (runs Dijkstra) or any StrategyRegistry name, e.g. dijkstra, delta_stepping
      * @return True if successful, false otherwise
+     *
+     * Switching to a different algorithm empties the route cache, so no query returns
+     * a result computed by the previous one.
      */
     bool setAlgorithm(const std::string &algorithmName);
 
@@ -164,6 +213,8 @@ public:
 
     /**
      * @brief Find route between two locations
+     *
+     * The search is abandoned with status TimedOut once the query timeout passes.
      * @param start Starting location name
      * @param end Destination location name
      * @param criteria Optimization criteria
@@ -172,6 +223,124 @@ public:
     RouteResult findRoute(const std::string &start, const std::string &end,
                           const std::string &criteria = "time");
 
+    /**
+     * @brief Get route cache counters (hits, misses, evictions, memory in use)
+     * @return Snapshot of the cache statistics
+     */
+    RouteCache::Statistics getRouteCacheStatistics() const;
+
+    /**
+     * @brief Set the route cache memory budget (route_cache_mb in the config file)
+     * @param bytes Approximate upper bound on cached bytes; 0 disables caching
+     */
+    void setRouteCacheBudget(size_t bytes);
+
+    /**
+     * @brief Drop all cached routes and reset the counters
+     */
+    void clearRouteCache();
+
+    /**
+     * @brief Turn per-query search statistics on or off (search_stats in the config file)
+     * @param enabled When false, findRoute runs the uninstrumented search
+     */
+    void setSearchStatsEnabled(bool enabled);
+
+    /**
+     * @brief Check whether findRoute records search statistics
+     * @return True if statistics are being collected
+     */
+    bool isSearchStatsEnabled() const;
+
+    /**
+     * @brief Get histograms of the work done by findRoute searches
+     *
+     * Only searches run while statistics were enabled are counted; cache hits are not.
+     * @return Collector holding one histogram per SearchStats counter and phase
+     */
+    const SearchStatsCollector &getSearchStatistics() const;
+
+    /**
+     * @brief Clear the search statistics histograms
+     */
+    void resetSearchStatistics();
+
+    /**
+     * @brief Set the per-query search deadline (timeout_seconds in the config file)
+     * @param timeout Time budget per query; zero or negative disables the deadline
+     */
+    void setQueryTimeout(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Get the per-query search deadline
+     * @return Time budget per query, zero when disabled
+     */
+    std::chrono::milliseconds getQueryTimeout() const;
+
+    /**
+     * @brief Queue a route query on the concurrent route service
+     *
+     * Unlike findRoute() the query runs on a worker thread against an immutable
+     * snapshot of the network and does not touch lastError, so many can be in
+     * flight at once. Must be called from the thread that edits the network.
+     * @param start Starting location name
+     * @param end Destination location name
+     * @param criteria Optimization criteria
+     * @return Future that yields the RouteResult
+     */
+    std::future<RouteResult> findRouteAsync(const std::string &start, const std::string &end,
+                                            const std::string &criteria = "time");
+
+    /**
+     * @brief Get the concurrent route service, refreshing its snapshot after edits
+     * @return Reference to the RouteService (created on first use)
+     */
+    RouteService &getRouteService();
+
+    /**
+     * @brief Trace every route query, from findRoute and the route service (trace_file in the config file)
+     * @param path Binary trace file to create, empty to stop tracing
+     * @return True if tracing was started or stopped, false if the file cannot be created
+     */
+    bool setTraceFile(const std::string &path);
+
+    /**
+     * @brief Get the active query trace
+     * @return Trace the route service writes to, nullptr when tracing is off
+     */
+    std::shared_ptr<TraceLog> getTraceLog() const;
+
+    /**
+     * @brief Get the metrics covering network loading, route queries and the route cache
+     * @return Registry to export, or to register further application metrics in
+     */
+    transport::utils::MetricsRegistry &getMetrics();
+
+    /**
+     * @brief Serve the metrics at http://127.0.0.1:<port>/metrics (metrics_port in the config file)
+     * @param port Loopback port to listen on, 0 for any free port
+     * @return True if the endpoint is listening, false otherwise
+     */
+    bool startMetricsServer(uint16_t port);
+
+    /**
+     * @brief Stop the metrics endpoint if it is running
+     */
+    void stopMetricsServer();
+
+    /**
+     * @brief Get the port the metrics endpoint listens on
+     * @return Bound port, 0 when the endpoint is not running
+     */
+    uint16_t getMetricsPort() const;
+
+    /**
+     * @brief Write the metrics in the Prometheus text format, e.g. for a textfile collector
+     * @param path File to replace with the current export
+     * @return True if successful, false otherwise
+     */
+    bool writeMetricsFile(const std::string &path);
+
     /**
      * @brief Find route using current user preferences
      * @param start Starting location name
@@ -182,6 +351,9 @@ public:
 
     /**
      * @brief Find multiple alternative routes
+     *
+     * One route per criterion (time, distance, cost, transfers), each searched by the
+     * algorithm findRoute uses; the searches run in parallel on the route service pool.
      * @param start Starting location name
      * @param end Destination location name
      * @param maxAlternatives Maximum number of alternatives
@@ -341,6 +513,88 @@ private:
     std::vector<RouteResult> routeHistory;                 ///< History of routes
     std::string lastError;                                 ///< Last error message
     bool initialized{false};                               ///< Whether the system has been initialized
+    transport::utils::MetricsRegistry metrics;             ///< Outlives the route service, whose workers update it
+    std::unique_ptr<NetworkJournal> journal;               ///< Edit log, null when journaling is off
+    std::unique_ptr<RouteService> routeService;            ///< Concurrent query pool, created on first use
+    size_t routeServiceThreads{0};                         ///< Worker count from max_threads, 0 for all cores
+    size_t treeCacheBudget{ShortestPathTreeCache::DEFAULT_MEMORY_BUDGET}; ///< spt_cache_mb, applied to the route service
+    unsigned treeHotThreshold{ShortestPathTreeCache::DEFAULT_HOT_THRESHOLD}; ///< spt_hot_threshold requests per second
+    std::chrono::milliseconds queryTimeout{30000};         ///< Search deadline per query, 0 for none
+    RouteCache routeCache;                                 ///< Results of findRoute keyed on graph version
+    uint64_t cachedGraphVersion{0};                        ///< Graph version the cache was last purged for
+    std::string currentAlgorithm{"dijkstra"};              ///< Strategy used by findRoute
+    std::unique_ptr<DeltaSteppingStrategy> deltaStepping;  ///< Parallel strategy, created on first use
+    bool searchStatsEnabled{false};                        ///< Whether findRoute records SearchStats
+    SearchStatsCollector searchStatistics;                 ///< Histograms of recorded SearchStats
+    std::shared_ptr<TraceLog> traceLog;                    ///< Query trace shared with the route service, null when off
+    std::unordered_map<std::string, uint32_t> traceNodeIds; ///< Trace node ids when the route service snapshot is stale
+    uint64_t traceNodeIdsVersion{0};                       ///< Graph version traceNodeIds was built for
+
+    /**
+     * @brief Query counters by outcome and the latency histogram of one query path
+     */
+    struct QueryMetrics
+    {
+        transport::utils::Counter *outcomes[5] = {}; ///< RouteStatus values, then queries that threw
+        transport::utils::Histogram *latency = nullptr;
+
+        void record(const RouteResult *result, std::chrono::steady_clock::time_point started) const;
+    };
+
+    QueryMetrics syncQueryMetrics;                         ///< findRoute
+    QueryMetrics asyncQueryMetrics;                        ///< findRouteAsync, recorded on the worker threads
+    transport::utils::Gauge *nodesGauge{nullptr};
+    transport::utils::Gauge *edgesGauge{nullptr};
+    transport::utils::Gauge *versionGauge{nullptr};
+    std::unique_ptr<transport::utils::MetricsServer> metricsServer; ///< Last member: stops before the state it reads goes away
+
+    /**
+     * @brief Register the built-in metrics and keep pointers to the hot ones
+     */
+    void registerMetrics();
+
+    /**
+     * @brief Publish the current graph size and version
+     */
+    void updateGraphMetrics();
+
+    /**
+     * @brief Load the network from a CSV file, timing the load
+     * @param filename CSV file to read
+     * @return True if successful, false otherwise
+     */
+    bool loadGraphFromCSV(const std::string &filename);
+
+    /**
+     * @brief Create the token for a query starting now
+     * @return Token carrying the query timeout, or one that never stops when disabled
+     */
+    CancellationToken makeQueryToken() const;
+
+    /**
+     * @brief Strategy for currentAlgorithm, as used by findRoute
+     * @param created Owns the strategy when a new instance was needed; delta-stepping is
+     *                kept across queries and left null here
+     * @return The strategy to search with, never null
+     */
+    RouteStrategy *selectStrategy(std::unique_ptr<RouteStrategy> &created);
+
+    /**
+     * @brief Append the trace record of a findRoute query, when a trace file is set
+     *
+     * Node ids are those of the route service snapshot, as in findRouteAsync records.
+     * @param nodesSettled Settled count from the query's SearchStats, 0 when no search ran
+     */
+    void traceQuery(const std::string &start, const std::string &end, const std::string &criteria,
+                    const RouteResult &result, std::chrono::steady_clock::time_point started,
+                    uint64_t nodesSettled);
+
+    /**
+     * @brief Note an applied edit: publish the graph metrics, append the edit to the
+     *        journal and compact when the log grows large
+     * @param mutation Edit that was just applied to the graph
+     */
+    void recordMutation(const NetworkJournal::Mutation &mutation);
 
     /**
      * @brief Set last error message
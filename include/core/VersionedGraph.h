@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "GraphSnapshot.h"
+
+/**
+ * @class VersionedGraph
+ * @brief Read-copy-update container of GraphSnapshot versions
+ *
+ * Readers call acquire() and search the returned version without any lock; holding
+ * the pointer pins that version. Writers are serialized among themselves, derive the
+ * next version with a GraphSnapshot::Editor (copying only the node blocks they
+ * touch) and publish it with an atomic pointer swap. Queries that started on the
+ * previous version finish on it, and it is freed when the last of them releases it.
+ *
+ * Unlike Graph::updateEdge/removeNode, edits here never change memory a reader can
+ * see, so live incident updates can be applied while queries are in flight.
+ *
+ * Only a RouteService constructed with a VersionedGraph reads through it.
+ * TransportationSystem still keeps a mutable Graph: its findRoute searches that Graph
+ * directly and its edits change it in place, so on that path edits must not run
+ * concurrently with queries. Callers that need non-blocking edits should apply them to
+ * a VersionedGraph and query through a RouteService that follows it.
+ */
+class VersionedGraph
+{
+public:
+    struct Version
+    {
+        uint64_t epoch;
+        std::shared_ptr<const GraphSnapshot> graph;
+    };
+
+    explicit VersionedGraph(const Graph &initial);
+    explicit VersionedGraph(std::shared_ptr<const GraphSnapshot> initial);
+
+    VersionedGraph(const VersionedGraph &) = delete;
+    VersionedGraph &operator=(const VersionedGraph &) = delete;
+
+    // Current version; safe to call from any thread
+    std::shared_ptr<const Version> acquire() const;
+
+    // Current snapshot, pinning its version for as long as the pointer is held
+    std::shared_ptr<const GraphSnapshot> acquireSnapshot() const;
+
+    uint64_t getEpoch() const;
+
+    /**
+     * @brief Apply a batch of edits as one new version
+     * @param edit Callback that edits the draft; return false to discard the batch
+     * @return Epoch of the published version, or 0 if nothing was published
+     */
+    uint64_t update(const std::function<bool(GraphSnapshot::Editor &)> &edit);
+
+    // Single-edit conveniences; each publishes one version when it succeeds
+    bool addNode(const std::string &name, double latitude, double longitude);
+    bool updateNode(const std::string &name, double latitude, double longitude);
+    bool removeNode(const std::string &name);
+    bool addEdge(const std::string &source, const std::string &destination, int distance,
+                 int time, int cost, int transfers, const std::string &mode);
+    bool updateEdge(const std::string &source, const std::string &destination, int distance,
+                    int time, int cost, int transfers, const std::string &mode);
+    bool removeEdge(const std::string &source, const std::string &destination);
+
+    // Versions still alive: the current one plus older ones pinned by readers
+    size_t getLiveVersionCount() const;
+
+private:
+    std::shared_ptr<const Version> current; // Accessed with std::atomic_load/store
+    mutable std::mutex writerMutex;
+    std::vector<std::weak_ptr<const Version>> retired;
+};
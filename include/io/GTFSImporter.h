@@ -0,0 +1,122 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include "../core/Graph.h"
+
+/**
+ * @class GTFSImporter
+ * @brief Imports a static GTFS feed (stops, routes, trips, stop_times) into a Graph
+ *
+ * stops.txt, routes.txt and trips.txt are small and are read fully. stop_times.txt
+ * is streamed row by row: only the stops of the trip currently being read are kept,
+ * and every consecutive stop pair is folded into a per-segment histogram of travel
+ * minutes, so the feed size does not bound memory. Each segment becomes one edge
+ * weighted with the median observed travel time.
+ *
+ * Streaming assumes stop_times.txt is grouped by trip_id. The GTFS spec does not
+ * require that, though feeds are written that way in practice. When a trip_id
+ * reappears after its rows were folded, the file is read a second time with the
+ * interleaved trips held in memory until the end, so they import whole, at the cost
+ * of the extra pass and of memory for those trips.
+ *
+ * Fares come from fare_attributes.txt/fare_rules.txt when present, otherwise from a
+ * flat per-mode default.
+ */
+class GTFSImporter
+{
+public:
+    struct ImportStatistics
+    {
+        int stopsRead = 0;
+        int routesRead = 0;
+        int tripsRead = 0;
+        long long stopTimesRead = 0;
+        int nodesAdded = 0;
+        int nodesUpdated = 0; // Stops already in the graph, given the feed's coordinates
+        int edgesAdded = 0;
+        int edgesUpdated = 0; // Stop pairs already linked, given the feed's weights
+        int rowsSkipped = 0;
+        int tripsInterleaved = 0; // Trips not grouped in stop_times.txt, read in a second pass
+    };
+
+    GTFSImporter();
+
+    /**
+     * @brief Import the feed stored in a local directory
+     * @param directory Directory containing the GTFS .txt files
+     * @param graph Graph that receives the stops and derived edges
+     * @return True if the mandatory files were read, false otherwise
+     */
+    bool importFeed(const std::string &directory, Graph &graph);
+
+    const ImportStatistics &getStatistics() const;
+    std::string getLastError() const;
+
+    // Split one CSV record, honouring RFC 4180 quoting used by GTFS producers
+    static std::vector<std::string> splitRecord(const std::string &line);
+
+    // Parse "HH:MM:SS" (hours may exceed 24), returns -1 when malformed
+    static int parseTimeSeconds(const std::string &value);
+
+    // Map a GTFS route_type to the transport mode names used in the network CSVs
+    static std::string routeTypeToMode(int routeType);
+
+private:
+    struct Stop
+    {
+        std::string nodeName;
+        double latitude = 0.0;
+        double longitude = 0.0;
+    };
+
+    struct Route
+    {
+        std::string mode;
+        int fare = 0;
+    };
+
+    struct StopVisit
+    {
+        int sequence;
+        std::string stopId;
+        int arrival;
+        int departure;
+    };
+
+    // Aggregated statistics for one directed stop-to-stop segment
+    struct Segment
+    {
+        std::map<int, int> minuteHistogram; // travel minutes -> occurrences
+        std::map<std::string, int> modeCounts;
+        int fare = 0;
+        int samples = 0;
+    };
+
+    bool readStops(const std::string &path);
+    bool readRoutes(const std::string &path);
+    bool readTrips(const std::string &path);
+    void readFares(const std::string &directory);
+    bool streamStopTimes(const std::string &path);
+    // One pass over stop_times.txt; heldTrips are folded at the end, trips that reappear
+    // after being folded are added to interleaved
+    bool readStopTimes(const std::string &path, const std::unordered_set<std::string> &heldTrips,
+                       std::unordered_set<std::string> &interleaved);
+    void flushTrip(const std::string &tripId, std::vector<StopVisit> &visits);
+    void buildGraph(Graph &graph);
+
+    static int medianOf(const std::map<int, int> &histogram, int samples);
+    static std::map<std::string, int> indexHeader(const std::string &headerLine);
+    static std::string field(const std::vector<std::string> &row,
+                             const std::map<std::string, int> &columns,
+                             const std::string &name);
+
+    std::unordered_map<std::string, Stop> stops;
+    std::unordered_map<std::string, Route> routes;
+    std::unordered_map<std::string, std::string> tripRoutes; // trip_id -> route_id
+    std::map<std::pair<std::string, std::string>, Segment> segments;
+    ImportStatistics statistics;
+    std::string lastError;
+};
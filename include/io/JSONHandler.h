@@ -1,10 +1,214 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <map>
+#include <set>
+#include <vector>
+#include <ostream>
+#include "../core/Graph.h"
+
+/**
+ * @class JSONValue
+ * @brief DOM node produced by JSONReader
+ *
+ * Objects keep their members in document order in a flat vector; preference and
+ * config objects are small, so a linear lookup is faster than a map and avoids
+ * one allocation per member.
+ */
+class JSONValue
+{
+public:
+    enum class Type
+    {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    JSONValue() : type(Type::Null), boolean(false), number(0.0) {}
+    JSONValue(bool value) : type(Type::Boolean), boolean(value), number(0.0) {}
+    JSONValue(int value) : type(Type::Number), boolean(false), number(value) {}
+    JSONValue(double value) : type(Type::Number), boolean(false), number(value) {}
+    JSONValue(const char *value) : type(Type::String), boolean(false), number(0.0), text(value) {}
+    JSONValue(const std::string &value) : type(Type::String), boolean(false), number(0.0), text(value) {}
+
+    static JSONValue array();
+    static JSONValue object();
+
+    Type getType() const { return type; }
+    bool isNull() const { return type == Type::Null; }
+    bool isBool() const { return type == Type::Boolean; }
+    bool isNumber() const { return type == Type::Number; }
+    bool isString() const { return type == Type::String; }
+    bool isArray() const { return type == Type::Array; }
+    bool isObject() const { return type == Type::Object; }
+
+    bool asBool(bool fallback = false) const;
+    double asNumber(double fallback = 0.0) const;
+    std::string asString(const std::string &fallback = "") const;
+
+    // Container access; missing members and out-of-range indexes yield a null value
+    size_t size() const;
+    const JSONValue &operator[](size_t index) const;
+    const JSONValue &get(std::string_view key) const;
+    const JSONValue *find(std::string_view key) const;
+    bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+    const std::vector<JSONValue> &items() const { return elements; }
+    const std::vector<std::pair<std::string, JSONValue>> &members() const { return fields; }
+
+    JSONValue &append(JSONValue value);
+    JSONValue &set(const std::string &key, JSONValue value);
+
+    /**
+     * @brief Serialize the value
+     * @param indent Spaces per nesting level, negative for compact output
+     */
+    std::string dump(int indent = -1) const;
+
+private:
+    friend class JSONDocumentBuilder;
+
+    Type type;
+    bool boolean;
+    double number;
+    std::string text;
+    std::vector<JSONValue> elements;
+    std::vector<std::pair<std::string, JSONValue>> fields;
+};
+
+/**
+ * @class JSONSaxHandler
+ * @brief Event interface for streaming parses; return false from any event to stop
+ *
+ * String and key views point into the input buffer (or into the reader's scratch
+ * buffer when escapes had to be decoded) and are only valid during the call.
+ */
+class JSONSaxHandler
+{
+public:
+    virtual ~JSONSaxHandler() = default;
+
+    virtual bool onNull() { return true; }
+    virtual bool onBool(bool) { return true; }
+    virtual bool onNumber(double) { return true; }
+    virtual bool onString(std::string_view) { return true; }
+    virtual bool onKey(std::string_view) { return true; }
+    virtual bool onStartObject() { return true; }
+    virtual bool onEndObject() { return true; }
+    virtual bool onStartArray() { return true; }
+    virtual bool onEndArray() { return true; }
+};
+
+/**
+ * @class JSONReader
+ * @brief Strict RFC 8259 parser with SAX and DOM entry points
+ */
+class JSONReader
+{
+public:
+    bool parse(std::string_view text, JSONSaxHandler &handler);
+    bool parse(std::string_view text, JSONValue &root);
+    bool parseFile(const std::string &filename, JSONSaxHandler &handler);
+    bool parseFile(const std::string &filename, JSONValue &root);
+
+    std::string getLastError() const;
+    size_t getErrorOffset() const;
+    void setMaxDepth(int depth);
+
+private:
+    bool parseValue(JSONSaxHandler &handler, int depth);
+    bool parseObject(JSONSaxHandler &handler, int depth);
+    bool parseArray(JSONSaxHandler &handler, int depth);
+    bool parseString(std::string_view &out);
+    bool parseNumber(double &out);
+    bool parseLiteral(const char *literal);
+    void skipWhitespace();
+    bool fail(const std::string &message);
+
+    const char *begin = nullptr;
+    const char *cursor = nullptr;
+    const char *end = nullptr;
+    std::string scratch; // Reused for strings that contain escapes
+    std::string lastError;
+    size_t errorOffset = 0;
+    int maxDepth = 512;
+};
+
+/**
+ * @class JSONWriter
+ * @brief Streaming writer that emits well-formed JSON without building a DOM
+ */
+class JSONWriter
+{
+public:
+    explicit JSONWriter(std::ostream &out, int indent = 2);
+
+    JSONWriter &beginObject();
+    JSONWriter &endObject();
+    JSONWriter &beginArray();
+    JSONWriter &endArray();
+    JSONWriter &key(std::string_view name);
+    JSONWriter &value(std::string_view text);
+    JSONWriter &value(const char *text);
+    JSONWriter &value(const std::string &text);
+    JSONWriter &value(double number);
+    JSONWriter &value(int number);
+    JSONWriter &value(long long number);
+    JSONWriter &value(bool flag);
+    JSONWriter &null();
+    JSONWriter &raw(std::string_view json); // Pre-serialized value
+
+    static void writeEscaped(std::ostream &out, std::string_view text);
+    static void writeNumber(std::ostream &out, double number);
+
+private:
+    void beforeValue();
+    void newline();
+
+    struct Level
+    {
+        bool isArray;
+        bool empty;
+    };
+
+    std::ostream &out;
+    int indent;
+    std::vector<Level> levels;
+    bool afterKey = false;
+};
 
 class JSONHandler
 {
 public:
-    static std::map<std::string, std::string> parseJSON(const std::string &filename);
-    static bool writeJSON(const std::string &filename, const std::map<std::string, std::string> &data);
+    /**
+     * @brief Read the top-level object of a file as a flat key/value map
+     *
+     * String members map to their text; numbers, literals, arrays and nested
+     * objects map to their compact JSON serialization.
+     * @param rawKeys If not null, receives the keys of the members that were not strings
+     */
+    static std::map<std::string, std::string> parseJSON(const std::string &filename,
+                                                        std::set<std::string> *rawKeys = nullptr);
+
+    /**
+     * @brief Write a flat map as a JSON object
+     *
+     * Values are written as strings, except those of rawKeys (as filled by parseJSON),
+     * which are written verbatim when they are valid JSON. Passing parseJSON's rawKeys
+     * back therefore round-trips the types of the original document.
+     */
+    static bool writeJSON(const std::string &filename, const std::map<std::string, std::string> &data,
+                          const std::set<std::string> &rawKeys = {});
+
+    // Bulk network format: {"nodes":[{name,latitude,longitude}], "edges":[{source,destination,...}]}
+    bool loadGraph(const std::string &filename, Graph &graph);
+    bool saveGraph(const std::string &filename, const Graph &graph);
+    std::string getLastError() const;
+
+private:
+    std::string lastError;
 };
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../core/Graph.h"
+
+/**
+ * @class NetworkGenerator
+ * @brief Deterministic synthetic transit networks, from a thousand to tens of millions of stops
+ *
+ * Stops sit on a jittered grid around central Jakarta, linked to their neighbours by
+ * TransJakarta buses (some legs requiring a transfer), with MRT/LRT corridors radiating
+ * from the centre and stopping every few blocks. Past a few tens of thousands of stops the
+ * grid tightens instead of growing, so coordinates stay within Greater Jakarta. Weights follow network_data.csv: metres,
+ * minutes at mode-typical speeds with a skewed delay, and fares in thousands of rupiah.
+ *
+ * Every stop and link is computed on demand from the seed and its index, so output is
+ * streamed: writing a ten-million-stop network holds only the corridor lists in memory.
+ * The same options always produce the same network.
+ */
+class NetworkGenerator
+{
+public:
+    struct Options
+    {
+        uint64_t stopCount = 1000;
+        unsigned seed = 47;
+        int corridors = 8;            // Radial MRT/LRT lines through the centre
+        int corridorStopSpacing = 4;  // Grid blocks between corridor stations
+        double blockMeters = 450.0;   // Distance between neighbouring grid stops
+        double maxExtentMeters = 60000.0; // Larger networks pack stops closer to stay this wide
+        double transferShare = 0.55;  // Bus legs that need a change of vehicle
+        double centerLatitude = -6.1754; // Monas
+        double centerLongitude = 106.8272;
+    };
+
+    struct Stop
+    {
+        uint64_t index = 0;
+        std::string id;   // Node name in the graph, e.g. "S1234"
+        std::string name; // Display name with its district, as in nodes_data.csv
+        double latitude = 0.0;
+        double longitude = 0.0;
+        int connections = 0; // Outgoing links
+    };
+
+    struct Link
+    {
+        uint64_t from = 0;
+        uint64_t to = 0;
+        int distance = 0; // Metres
+        int time = 0;     // Minutes
+        int cost = 0;     // Thousands of rupiah
+        int transfers = 0;
+        const char *mode = "";
+    };
+
+    explicit NetworkGenerator(const Options &options);
+
+    // Stop by index, 0 <= index < getStopCount()
+    Stop stop(uint64_t index) const;
+
+    // Calls visit for every stop in index order
+    void forEachStop(const std::function<void(const Stop &)> &visit) const;
+
+    // Calls visit for every directed link, grouped by origin stop
+    void forEachLink(const std::function<void(const Link &)> &visit) const;
+
+    uint64_t getStopCount() const;
+    uint64_t getLinkCount() const;
+
+    /**
+     * @brief Write the network_data.csv and nodes_data.csv schemas
+     * @return True if both files were written, false otherwise
+     */
+    bool writeCSV(const std::string &networkPath, const std::string &nodesPath);
+
+    /**
+     * @brief Write a NetworkJournal snapshot that opening a journal on basePath loads
+     * @return True if successful, false otherwise
+     */
+    bool writeSnapshot(const std::string &basePath);
+
+    // Add every stop and link to graph; meant for networks that fit in memory
+    void buildGraph(Graph &graph) const;
+
+    std::string getLastError() const;
+
+private:
+    // Random value in [0, 1) that depends only on the seed and the key
+    double unit(uint64_t key, uint64_t salt) const;
+
+    // Metres north and east of the centre, grid position plus jitter
+    void offsetFromCenter(uint64_t index, double &north, double &east) const;
+    bool exists(int64_t row, int64_t column) const;
+    uint64_t indexOf(int64_t row, int64_t column) const;
+    void linkAll(uint64_t from, const std::function<void(const Link &)> &visit) const;
+    Link makeLink(uint64_t from, uint64_t to, bool corridor) const;
+    void buildCorridors();
+
+    Options options;
+    uint64_t columns;
+    uint64_t rows;
+    double blockMeters; // options.blockMeters, tightened to fit maxExtentMeters
+    double metersPerDegreeLongitude;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> corridorNeighbours; // Station -> adjacent stations
+    uint64_t corridorLinks = 0;
+    std::string lastError;
+};
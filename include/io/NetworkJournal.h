@@ -0,0 +1,177 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "../core/Graph.h"
+
+/**
+ * @class NetworkJournal
+ * @brief Append-only, checksummed log of network edits on top of a binary snapshot
+ *
+ * Files live next to each other under a common base path:
+ *   <base>.snapshot     full network (nodes with coordinates and all edges) plus the
+ *                       log generation it already contains
+ *   <base>.log.<gen>    mutation records written after that snapshot
+ *
+ * Every record is framed as [length][CRC-32][payload], so an edit costs one small
+ * append instead of a full rewrite, and a torn record at the end of the log (crash
+ * mid-write) is detected and dropped on replay.
+ *
+ * Compaction copies the graph, starts a new log generation and writes the snapshot
+ * from the copy on a background thread. The snapshot is written to a temporary file
+ * and renamed into place, after which older log generations are deleted; a crash at
+ * any point leaves either the old snapshot plus every log, or the new snapshot plus
+ * the logs it does not yet contain.
+ */
+class NetworkJournal
+{
+public:
+    enum class Operation : uint8_t
+    {
+        AddNode = 1,
+        UpdateNode = 2,
+        RemoveNode = 3,
+        AddEdge = 4,
+        UpdateEdge = 5,
+        RemoveEdge = 6
+    };
+
+    // One network edit; nodes use source/latitude/longitude, edges use every field
+    struct Mutation
+    {
+        Operation operation = Operation::AddNode;
+        std::string source;
+        std::string destination;
+        double latitude = 0.0;
+        double longitude = 0.0;
+        int distance = 0;
+        int time = 0;
+        int cost = 0;
+        int transfers = 0;
+        std::string mode;
+    };
+
+    struct Statistics
+    {
+        uint64_t generation = 0;
+        size_t recordsReplayed = 0;
+        size_t tailsDiscarded = 0; // Logs whose torn or corrupt tail was cut off; the records
+                                   // in it cannot be counted once a frame is bad
+        size_t recordsAppended = 0;
+        size_t compactions = 0;
+        uint64_t logBytes = 0;
+    };
+
+    explicit NetworkJournal(const std::string &basePath);
+    ~NetworkJournal();
+
+    NetworkJournal(const NetworkJournal &) = delete;
+    NetworkJournal &operator=(const NetworkJournal &) = delete;
+
+    /**
+     * @brief Load the snapshot, replay the logs into graph and open the log for appending
+     * @param graph Graph to fill. A snapshot replaces its contents; without one the logs
+     *              are replayed on top of what it already holds (typically the base CSV)
+     * @return True if the journal is ready for appends, false otherwise
+     */
+    bool open(Graph &graph);
+
+    bool isOpen() const;
+
+    /**
+     * @brief Append one mutation and flush it to the operating system
+     * @return True if the record was written, false otherwise
+     */
+    bool append(const Mutation &mutation);
+
+    /**
+     * @brief Fold the current logs into a new snapshot
+     * @param graph Current network state, copied before this call returns
+     * @param background Write the snapshot on a worker thread instead of the caller
+     * @return True if compaction was started (or finished, when not in background)
+     */
+    bool compact(const Graph &graph, bool background = true);
+
+    // Block until a running background compaction has finished
+    void waitForCompaction();
+
+    // True once the active log has grown past the compaction threshold
+    bool shouldCompact() const;
+    void setCompactionThreshold(uint64_t bytes);
+
+    Statistics getStatistics() const;
+    std::string getLastError() const;
+
+    std::string getSnapshotPath() const;
+    std::string getLogPath(uint64_t generation) const;
+
+    /**
+     * @brief Apply a mutation to a graph, reporting it on the console like any edit
+     *
+     * Replay in open() does not go through here but applies records in quiet batches.
+     * @return True if the graph accepted the edit, false otherwise
+     */
+    static bool apply(const Mutation &mutation, Graph &graph);
+
+    // Standard CRC-32 (IEEE 802.3 polynomial, as used by zlib)
+    static uint32_t crc32(const void *data, size_t length, uint32_t seed = 0);
+
+    /**
+     * @class NetworkJournal::SnapshotWriter
+     * @brief Writes a snapshot record by record, for networks too large to build as a Graph
+     *
+     * Records go to a temporary file; finish() fills in the record count and renames it
+     * over the snapshot, so an interrupted write never replaces a good one. Nodes must
+     * be written before the edges that use them.
+     */
+    class SnapshotWriter
+    {
+    public:
+        SnapshotWriter(const std::string &snapshotPath, uint64_t generation);
+        ~SnapshotWriter(); // Removes the temporary file unless finish() succeeded
+
+        SnapshotWriter(const SnapshotWriter &) = delete;
+        SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+        bool open();
+        bool write(const Mutation &mutation);
+        bool finish();
+
+        uint64_t getRecordCount() const;
+        std::string getLastError() const;
+
+    private:
+        std::string path;
+        std::string tempPath;
+        uint64_t generation;
+        std::ofstream out;
+        std::string payload; // Reused between records
+        uint64_t records = 0;
+        bool finished = false;
+        std::string lastError;
+    };
+
+private:
+    static void encode(const Mutation &mutation, std::string &payload);
+    static bool decode(const std::string &payload, Mutation &mutation);
+    static void writeRecord(std::ostream &out, const std::string &payload);
+
+    // Reads records until end of file or the first bad frame, returns the good byte count
+    uint64_t replayLog(const std::string &path, Graph &graph);
+    bool loadSnapshot(Graph &graph, uint64_t &generation);
+    bool writeSnapshot(const Graph &graph, uint64_t generation);
+    bool openLog(uint64_t generation);
+    void removeLogsBefore(uint64_t generation);
+    void setLastError(const std::string &error);
+
+    std::string basePath;
+    std::ofstream log;
+    std::thread compactionThread;
+    mutable std::mutex mutex;
+    Statistics stats;
+    uint64_t compactionThreshold = 4 * 1024 * 1024;
+    std::string lastError;
+    bool opened = false;
+};
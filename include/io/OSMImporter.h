@@ -0,0 +1,114 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include <functional>
+#include "../core/Graph.h"
+
+/**
+ * @class OSMImporter
+ * @brief Imports walking and feeder-road legs from an OpenStreetMap extract
+ *
+ * Reads either OSM XML (.osm) or the PBF container (.osm.pbf) as a stream and never
+ * holds the whole extract in memory. The import runs three passes over the file:
+ *   1. ways  - keep ways whose highway tag matches the profile, count node references
+ *   2. nodes - remember coordinates only for nodes referenced by kept ways
+ *   3. ways  - split kept ways at junctions into contracted street segments
+ * Chains of degree-2 junctions left after splitting are contracted once more, then
+ * the remaining junctions are added as "osm:<id>" nodes and every transit node with
+ * coordinates is snapped to its nearest junction with a walking connector.
+ *
+ * Compressed PBF blobs need zlib (TRANSPORT_HAVE_ZLIB, defined by the CMake and Makefile
+ * builds when they find it); without it they fail to import with an error saying so.
+ * XML needs nothing extra.
+ */
+class OSMImporter
+{
+public:
+    struct ImportOptions
+    {
+        bool includeFootways = true;     ///< footway, path, pedestrian, steps, living_street...
+        bool includeFeederRoads = true;  ///< residential up to primary, used by ojek/angkot feeders
+        double snapRadiusMeters = 300.0; ///< Maximum station-to-junction connector length
+        double walkingSpeed = 80.0;      ///< Meters per minute
+        double feederSpeed = 250.0;      ///< Meters per minute
+        int feederCostPerKm = 2500;      ///< IDR per started kilometre on feeder roads
+    };
+
+    struct ImportStatistics
+    {
+        long long nodesScanned = 0;
+        long long waysScanned = 0;
+        long long waysKept = 0;
+        long long referencedNodes = 0;
+        int junctionsAdded = 0;
+        int segmentsAdded = 0;
+        int stationsSnapped = 0;
+    };
+
+    OSMImporter();
+    explicit OSMImporter(const ImportOptions &options);
+
+    /**
+     * @brief Import the street network of an extract and attach it to existing stations
+     * @param filename Path to a .osm or .osm.pbf file
+     * @param graph Graph that already contains the transit stations
+     * @return True if the file could be read, false otherwise
+     */
+    bool importFile(const std::string &filename, Graph &graph);
+
+    const ImportStatistics &getStatistics() const;
+    std::string getLastError() const;
+
+    /**
+     * @brief Classify a way by its highway tag
+     * @return "walk", "feeder" or an empty string when the way is not imported
+     */
+    std::string classifyHighway(const std::string &highway) const;
+
+    // Element callbacks shared by the XML and PBF readers
+    using TagList = std::vector<std::pair<std::string, std::string>>;
+    using NodeCallback = std::function<void(int64_t id, double latitude, double longitude)>;
+    using WayCallback = std::function<void(int64_t id, const std::vector<int64_t> &refs, const TagList &tags)>;
+
+    static bool streamXML(const std::string &filename, const NodeCallback &onNode,
+                          const WayCallback &onWay, std::string &error);
+    static bool streamPBF(const std::string &filename, const NodeCallback &onNode,
+                          const WayCallback &onWay, std::string &error);
+
+private:
+    // Street segment between two junctions after contraction
+    struct Segment
+    {
+        int64_t from;
+        int64_t to;
+        double length;
+        bool feeder;
+        bool oneway;
+    };
+
+    struct Coordinate
+    {
+        double latitude;
+        double longitude;
+    };
+
+    bool streamFile(const std::string &filename, const NodeCallback &onNode, const WayCallback &onWay);
+    std::string wayProfile(const TagList &tags, bool &oneway) const;
+    void contractDegreeTwoChains();
+    void addToGraph(Graph &graph);
+    void snapStations(Graph &graph);
+
+    static double haversine(const Coordinate &a, const Coordinate &b);
+    static std::string junctionName(int64_t id);
+
+    ImportOptions options;
+    ImportStatistics statistics;
+    std::string lastError;
+
+    std::unordered_map<int64_t, uint32_t> referenceCounts;
+    std::unordered_map<int64_t, Coordinate> coordinates;
+    std::vector<Segment> segments;
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class TraceLog
+ * @brief Compact binary trace of answered route queries for offline analysis
+ *
+ * A trace file is a 16 byte header followed by fixed-size little-endian records, so
+ * it can be scanned or memory-mapped without parsing text; tools/trace_analyzer.cpp
+ * reads it back. Layout of one record (RECORD_SIZE bytes):
+ *
+ *   offset  size  field
+ *        0     8  timestampNanos   completion time, nanoseconds since the Unix epoch
+ *        8     8  queryId
+ *       16     4  threadId         small id of the thread that answered
+ *       20     4  startNode        GraphSnapshot id, INVALID_NODE when unknown
+ *       24     4  endNode
+ *       28     4  nodesSettled
+ *       32     4  latencyMicros    submit to answer, including time spent queued
+ *       36     1  criterion        GraphSnapshot::Criterion
+ *       37     1  status           RouteStatus
+ *       38     1  flags            FLAG_* bits
+ *       39     1  reserved
+ *
+ * record() encodes into a buffer owned by the calling thread and only takes the file
+ * lock once per BUFFER_RECORDS records, so tracing adds no shared lock to the query
+ * path. Records still in thread buffers are written by flush() and the destructor.
+ */
+class TraceLog
+{
+public:
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr size_t RECORD_SIZE = 40;
+    static constexpr size_t BUFFER_RECORDS = 256;
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+    static constexpr uint8_t FLAG_COALESCED = 1; // Shared the search of an identical in-flight query
+    static constexpr uint8_t FLAG_FAILED = 2;    // The search threw instead of answering
+
+    struct Record
+    {
+        uint64_t timestampNanos = 0;
+        uint64_t queryId = 0;
+        uint32_t threadId = 0;
+        uint32_t startNode = INVALID_NODE;
+        uint32_t endNode = INVALID_NODE;
+        uint32_t nodesSettled = 0;
+        uint32_t latencyMicros = 0;
+        uint8_t criterion = 0;
+        uint8_t status = 0;
+        uint8_t flags = 0;
+    };
+
+    explicit TraceLog(const std::string &path);
+    ~TraceLog();
+
+    TraceLog(const TraceLog &) = delete;
+    TraceLog &operator=(const TraceLog &) = delete;
+
+    /**
+     * @brief Create the file (replacing an existing one) and write the header
+     * @return True if the trace is ready for records, false otherwise
+     */
+    bool open();
+
+    bool isOpen() const;
+
+    /**
+     * @brief Append one record; safe to call from any number of threads
+     *
+     * Ignored when the trace is not open.
+     */
+    void record(const Record &record);
+
+    // Write the records buffered by every thread and flush the file
+    void flush();
+
+    // Records accepted by record() so far
+    uint64_t getRecordCount() const;
+
+    // Fresh queryId for a record; every writer to this trace draws from the same sequence
+    uint64_t nextQueryId();
+
+    std::string getPath() const;
+    std::string getLastError() const;
+
+    /**
+     * @brief Read every complete record of a trace file
+     * @param error Set to the reason when the file cannot be read
+     * @return True if the header was valid; a torn final record is ignored
+     */
+    static bool readFile(const std::string &path, std::vector<Record> &records, std::string &error);
+
+    static void encode(const Record &record, std::string &out);
+    static Record decode(const unsigned char *bytes);
+
+    // Small dense id of the calling thread, stable for its lifetime
+    static uint32_t currentThreadId();
+
+    // Wall clock time in nanoseconds since the Unix epoch
+    static uint64_t nowNanos();
+
+private:
+    struct ThreadBuffer
+    {
+        std::mutex mutex; // Uncontended except while flush() drains the buffer
+        std::string bytes;
+    };
+
+    ThreadBuffer &localBuffer();
+    void writeBytes(const std::string &bytes);
+
+    std::string path;
+    std::ofstream file;
+    mutable std::mutex fileMutex;
+    std::string lastError;
+    std::atomic<bool> opened{false};
+    std::atomic<uint64_t> recordCount{0};
+    std::atomic<uint64_t> queryIds{1};
+
+    const uint64_t instanceId; // Distinguishes traces in the per-thread buffer cache
+    std::mutex buffersMutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadBuffer>> buffers;
+};
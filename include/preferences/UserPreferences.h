@@ -6,6 +6,8 @@
 #include <vector>
 #include <memory>
 
+class JSONValue;
+
 /**
  * @struct PreferenceCriteria
  * @brief Represents user preference criteria for route selection
@@ -275,6 +277,20 @@ public:
      * @return True if successful, false otherwise
      */
     bool loadFromFile(const std::string &filename);
+
+    /**
+     * @brief Apply preferences from a parsed JSON object
+     * @param root Object in the saveToFile layout or the preferences template layout
+     * @return True if the weights were valid and applied
+     */
+    bool applyJSON(const JSONValue &root);
+
+    /**
+     * @brief Load many per-user profiles from one file
+     * @param filename JSON object keyed by user id, or array of profiles with user_profile.user_id
+     * @return Map of user id to preferences; invalid profiles are skipped
+     */
+    static std::map<std::string, UserPreferences> loadProfiles(const std::string &filename);
 };
 
 /**
@@ -1,6 +1,8 @@
 #pragma once
 #include "../core/Graph.h"
 #include "../algorithms/DijkstraStrategy.h"
+#include "../algorithms/MultiSourceSearch.h"
+#include "../utils/WorkStealingScheduler.h"
 #include "../preferences/DecisionTree.h"
 #include "../preferences/UserPreferences.h"
 #include "../preferences/PreferenceManager.h"
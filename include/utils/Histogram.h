@@ -0,0 +1,78 @@
+#ifndef TRANSPORT_HISTOGRAM_H
+#define TRANSPORT_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace transport
+{
+    namespace utils
+    {
+
+        /**
+         * @brief Log-linear histogram of non-negative integers (HdrHistogram style)
+         *
+         * Values below SUB_BUCKETS get a bucket each; above that every power of two is split
+         * into SUB_BUCKETS equal sub-buckets, so any recorded value is known to within
+         * 1/SUB_BUCKETS (about 3%) while the whole uint64_t range fits in BUCKETS counters.
+         *
+         * record() is a few shifts and relaxed atomic increments, so metrics update a shared
+         * histogram from any thread without a lock. Copies, merge() and reset() read or
+         * write the counters one by one; callers that need them consistent with concurrent
+         * records serialize them, as SearchStatsCollector does.
+         */
+        class Histogram
+        {
+        public:
+            static constexpr unsigned SUB_BUCKET_BITS = 5;
+            static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+            static constexpr size_t BUCKETS = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+            Histogram() = default;
+            Histogram(const Histogram &other);
+            Histogram &operator=(const Histogram &other);
+
+            void record(uint64_t value);
+            void merge(const Histogram &other);
+            void reset();
+
+            uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+            uint64_t getSum() const { return sum.load(std::memory_order_relaxed); }
+            uint64_t getMin() const { return getCount() ? min.load(std::memory_order_relaxed) : 0; }
+            uint64_t getMax() const { return max.load(std::memory_order_relaxed); }
+            double getMean() const;
+            uint64_t getBucketCount(size_t bucket) const { return buckets[bucket].load(std::memory_order_relaxed); }
+
+            // Number of recorded values whose bucket lies entirely at or below limit
+            uint64_t getCountAtOrBelow(uint64_t limit) const;
+
+            /**
+             * @brief Approximate value below which the given fraction of samples fall
+             * @param fraction In [0, 1], e.g. 0.99 for the 99th percentile
+             * @return Upper bound of the bucket holding that rank, clamped to [getMin(), getMax()]
+             */
+            uint64_t getPercentile(double fraction) const;
+
+            static size_t bucketIndex(uint64_t value);
+
+            // Smallest and largest value stored in a bucket
+            static uint64_t bucketLowerBound(size_t bucket);
+            static uint64_t bucketUpperBound(size_t bucket);
+
+            // One line: count, mean, p50, p90, p99 and max
+            std::string summary() const;
+
+        private:
+            std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> sum{0};
+            std::atomic<uint64_t> min{UINT64_MAX};
+            std::atomic<uint64_t> max{0};
+        };
+
+    } // namespace utils
+} // namespace transport
+
+#endif // TRANSPORT_HISTOGRAM_H
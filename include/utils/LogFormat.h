@@ -0,0 +1,108 @@
+#ifndef TRANSPORT_LOG_FORMAT_H
+#define TRANSPORT_LOG_FORMAT_H
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace transport
+{
+    namespace utils
+    {
+
+        /**
+         * @brief Append one formatting argument to a log line
+         * Strings, characters, booleans and integers are appended directly; anything
+         * else goes through its operator<<.
+         */
+        template <typename T>
+        void appendLogArgument(std::string &out, const T &value)
+        {
+            using Decayed = std::decay_t<T>;
+            if constexpr (std::is_same_v<Decayed, bool>)
+            {
+                out += value ? "true" : "false";
+            }
+            else if constexpr (std::is_same_v<Decayed, char>)
+            {
+                out += value;
+            }
+            else if constexpr (std::is_integral_v<Decayed>)
+            {
+                out += std::to_string(value);
+            }
+            else if constexpr (std::is_same_v<T, const char *> || std::is_same_v<T, char *>)
+            {
+                out += value ? value : "(null)";
+            }
+            else if constexpr (std::is_convertible_v<const T &, std::string_view>)
+            {
+                out += std::string_view(value);
+            }
+            else
+            {
+                std::ostringstream stream;
+                stream << value;
+                out += stream.str();
+            }
+        }
+
+        /**
+         * @brief Copy the rest of a format string once all arguments are used
+         * "{{" and "}}" become literal braces; placeholders without an argument stay as "{}".
+         */
+        inline void formatLogInto(std::string &out, std::string_view format)
+        {
+            for (size_t i = 0; i < format.size(); ++i)
+            {
+                out += format[i];
+                if ((format[i] == '{' || format[i] == '}') && i + 1 < format.size() && format[i + 1] == format[i])
+                    ++i;
+            }
+        }
+
+        /**
+         * @brief Substitute the first "{}" in format with first, then continue with the rest
+         * Arguments beyond the last placeholder are ignored.
+         */
+        template <typename First, typename... Rest>
+        void formatLogInto(std::string &out, std::string_view format, const First &first, const Rest &...rest)
+        {
+            for (size_t i = 0; i < format.size(); ++i)
+            {
+                char c = format[i];
+                bool paired = i + 1 < format.size();
+                if (c == '{' && paired && format[i + 1] == '}')
+                {
+                    appendLogArgument(out, first);
+                    formatLogInto(out, format.substr(i + 2), rest...);
+                    return;
+                }
+                out += c;
+                if ((c == '{' || c == '}') && paired && format[i + 1] == c)
+                    ++i;
+            }
+        }
+
+        /**
+         * @brief Build a log message from a std::format-style template
+         * Only "{}" placeholders are supported: formatLog("{} -> {} in {} min", a, b, 12).
+         * Used by the LOG_*_FMT macros, which call it only when the level is enabled.
+         * @param format Message template
+         * @param args Values substituted for the placeholders in order
+         * @return Formatted message
+         */
+        template <typename... Args>
+        std::string formatLog(std::string_view format, const Args &...args)
+        {
+            std::string out;
+            out.reserve(format.size() + 16 * sizeof...(Args));
+            formatLogInto(out, format, args...);
+            return out;
+        }
+
+    } // namespace utils
+} // namespace transport
+
+#endif // TRANSPORT_LOG_FORMAT_H
@@ -11,6 +11,15 @@
 #include <sstream>
 #include <vector>
 #include <thread>
+#include <atomic>
+#include <condition_variable>
+#include "LogFormat.h"
+#include "MpscRingBuffer.h"
+
+// Log statements below this level (0=DEBUG ... 4=CRITICAL) are compiled out entirely
+#ifndef TRANSPORT_LOG_MIN_LEVEL
+#define TRANSPORT_LOG_MIN_LEVEL 0
+#endif
 
 namespace transport
 {
@@ -30,6 +39,16 @@ namespace transport
             CRITICAL = 4 // Critical errors that may cause program termination
         };
 
+        /**
+         * @brief Check whether statements at a level survive TRANSPORT_LOG_MIN_LEVEL
+         * @param level Log level to check
+         * @return true if the level is compiled in
+         */
+        constexpr bool isLogLevelCompiledIn(LogLevel level)
+        {
+            return static_cast<int>(level) >= TRANSPORT_LOG_MIN_LEVEL;
+        }
+
         /**
          * @brief Enum for different log output destinations
          */
@@ -40,6 +59,15 @@ namespace transport
             BOTH          // Output to both console and file
         };
 
+        /**
+         * @brief What log() does when the asynchronous queue is full
+         */
+        enum class OverflowPolicy
+        {
+            DROP, // Discard the entry and count it; the caller never waits
+            BLOCK // Wait until the writer thread frees a slot
+        };
+
         /**
          * @brief Structure for log entry metadata
          * Contains information about each log entry for advanced filtering
@@ -54,6 +82,8 @@ namespace transport
             int lineNumber;
             std::string functionName;
 
+            LogEntry() : level(LogLevel::INFO), lineNumber(0) {}
+
             LogEntry(LogLevel lvl, const std::string &msg, const std::string &file = "",
                      int line = 0, const std::string &func = "")
                 : level(lvl), message(msg), filename(file), lineNumber(line), functionName(func)
@@ -72,6 +102,8 @@ namespace transport
          *
          * Features:
          * - Thread-safe logging for parallel development
+         * - Asynchronous backend: callers format the line and push it into a bounded
+         *   lock-free ring buffer; a dedicated writer thread writes it out in batches
          * - Multiple log levels with filtering
          * - Console and file output support
          * - Automatic log rotation
@@ -89,6 +121,10 @@ namespace transport
          * LOG_WARNING("Warning message");
          * LOG_ERROR("Error message");
          * LOG_CRITICAL("Critical message");
+         * LOG_DEBUG_FMT("Expanded {} of {} nodes", settled, total);
+         *
+         * Macro arguments are evaluated only when the level is enabled, and levels
+         * below TRANSPORT_LOG_MIN_LEVEL are removed at compile time.
          */
         class Logger
         {
@@ -135,8 +171,8 @@ namespace transport
              * @param functionName Source function name (usually __FUNCTION__)
              */
             void log(LogLevel level, const std::string &message,
-                     const std::string &filename = "", int lineNumber = 0,
-                     const std::string &functionName = "");
+                     const std::string &filename, int lineNumber,
+                     const std::string &functionName);
 
             /**
              * @brief Simplified logging function without metadata
@@ -176,9 +212,54 @@ namespace transport
              */
             void setThreadIdEnabled(bool enable);
 
+            /**
+             * @brief Switch between the asynchronous writer thread and writing on the caller
+             * Disabling drains the queue first; synchronous mode serializes callers on one lock.
+             * @param enable true for asynchronous logging (the default)
+             */
+            void setAsyncEnabled(bool enable);
+
+            /**
+             * @brief Check whether entries are written by the writer thread
+             * @return true if asynchronous logging is enabled
+             */
+            bool isAsyncEnabled() const;
+
+            /**
+             * @brief Resize the asynchronous queue
+             * Safe while other threads log: they write synchronously until the new queue
+             * is in place, and pending entries are written out before the old one is freed.
+             * @param capacity Number of queued entries (rounded up to a power of two)
+             */
+            void setQueueCapacity(size_t capacity);
+
+            /**
+             * @brief Get the number of entries the asynchronous queue can hold
+             * @return Queue capacity
+             */
+            size_t getQueueCapacity() const;
+
+            /**
+             * @brief Choose what happens when the asynchronous queue is full
+             * @param policy DROP to discard and count the entry, BLOCK to wait for space
+             */
+            void setOverflowPolicy(OverflowPolicy policy);
+
+            /**
+             * @brief Get the current overflow policy
+             * @return Current overflow policy
+             */
+            OverflowPolicy getOverflowPolicy() const;
+
+            /**
+             * @brief Get the number of entries discarded because the queue was full
+             * @return Dropped entry count since construction
+             */
+            size_t getDroppedCount() const;
+
             /**
              * @brief Flush all pending log messages to file
-             * Ensures all buffered messages are written to disk
+             * Blocks until every entry queued before the call has been written
              */
             void flush();
 
@@ -241,17 +322,48 @@ namespace transport
             std::string formatMessage(const LogEntry &entry) const;
 
             /**
-             * @brief Write message to console
-             * @param formattedMessage Formatted message to write
-             * @param level Log level for color coding
+             * @brief A log entry together with its preformatted line
+             */
+            struct QueuedEntry
+            {
+                LogEntry entry;
+                std::string formatted;
+            };
+
+            /**
+             * @brief Write a batch of entries with one console and one file write
+             * Caller must hold logMutex_.
+             * @param batch Entries in the order they were queued
              */
-            void writeToConsole(const std::string &formattedMessage, LogLevel level);
+            void writeBatch(std::vector<QueuedEntry> &batch);
 
             /**
-             * @brief Write message to file
-             * @param formattedMessage Formatted message to write
+             * @brief Write one entry on the calling thread (synchronous mode)
+             * Entries still queued from asynchronous mode are written first.
+             * @param item Entry to write
              */
-            void writeToFile(const std::string &formattedMessage);
+            void writeSynchronously(QueuedEntry &item);
+
+            /**
+             * @brief Write out entries left in the queue while no writer thread runs
+             * Caller must hold logMutex_.
+             */
+            void drainPending();
+
+            /**
+             * @brief Writer thread body: drain the queue in batches until stopped
+             */
+            void writerLoop();
+
+            /**
+             * @brief Start the writer thread if asynchronous logging is enabled
+             */
+            void startWriter();
+
+            /**
+             * @brief Drain the queue and join the writer thread
+             */
+            void stopWriter();
 
             /**
              * @brief Rotate log file if it exceeds maximum size
@@ -272,44 +384,70 @@ namespace transport
             std::string getResetCode() const;
 
             // Member variables
-            mutable std::mutex logMutex_;            // Thread safety
-            LogLevel currentLogLevel_;               // Current minimum log level
+            mutable std::mutex logMutex_;            // Guards outputs, file state and history
+            std::atomic<LogLevel> currentLogLevel_;  // Current minimum log level
             LogDestination destination_;             // Output destination
             std::string logFileName_;                // Log file path
             std::unique_ptr<std::ofstream> logFile_; // File stream for logging
+            size_t currentFileSize_;                 // Bytes in the current log file
             size_t maxFileSize_;                     // Maximum file size before rotation
             int maxBackupFiles_;                     // Number of backup files to keep
             bool consoleOutputEnabled_;              // Console output flag
             bool fileOutputEnabled_;                 // File output flag
-            bool timestampEnabled_;                  // Timestamp flag
-            bool threadIdEnabled_;                   // Thread ID flag
+            std::atomic<bool> timestampEnabled_;     // Timestamp flag (read by producers)
+            std::atomic<bool> threadIdEnabled_;      // Thread ID flag (read by producers)
 
             // Statistics and history
-            mutable std::vector<LogEntry> logHistory_; // Recent log entries
-            size_t maxHistorySize_;                    // Maximum history entries to keep
-            mutable size_t totalLogCount_;             // Total number of log messages
-            mutable size_t logCountByLevel_[5];        // Count by log level
+            mutable std::vector<LogEntry> logHistory_;  // Recent log entries
+            size_t maxHistorySize_;                     // Maximum history entries to keep
+            std::atomic<size_t> totalLogCount_;         // Total number of log messages
+            std::atomic<size_t> logCountByLevel_[5];    // Count by log level
+            std::atomic<size_t> droppedCount_;          // Entries discarded on a full queue
+
+            // Asynchronous backend
+            std::unique_ptr<MpscRingBuffer<QueuedEntry>> queue_; // Preformatted entries
+            std::atomic<OverflowPolicy> overflowPolicy_;         // Full-queue behaviour
+            std::atomic<bool> asyncEnabled_;                     // Writer thread in use
+            std::atomic<int> activeProducers_;                   // Callers between the async check and their push
+            std::thread writerThread_;                           // Drains queue_
+            std::mutex writerMutex_;                             // Guards the wake-up state below
+            std::condition_variable writerWake_;                 // Signals new entries or stop
+            std::condition_variable drained_;                    // Signals progress to flush()/BLOCK
+            std::atomic<bool> writerSleeping_;                   // Writer waits on writerWake_
+            bool stopWriter_;                                    // Writer should exit once drained
+            std::atomic<size_t> enqueuedCount_;                  // Entries pushed to queue_
+            std::atomic<size_t> writtenCount_;                   // Entries written by the writer
+            std::mutex lifecycleMutex_;                          // Serializes start/stop/resize
 
             // Performance optimization
-            std::string cachedThreadId_; // Cached thread ID for current thread
-            bool colorSupported_;        // Whether console supports colors
+            bool colorSupported_; // Whether console supports colors
         };
 
-// Convenience macros for logging with file and line information
-#define LOG_DEBUG(message) \
-    transport::utils::Logger::getInstance().log(transport::utils::LogLevel::DEBUG, message, __FILE__, __LINE__, __FUNCTION__)
-
-#define LOG_INFO(message) \
-    transport::utils::Logger::getInstance().log(transport::utils::LogLevel::INFO, message, __FILE__, __LINE__, __FUNCTION__)
+// Level check first: the message expression is evaluated only if the entry will be logged
+#define TRANSPORT_LOG_AT(level, message)                                                                \
+    do                                                                                                  \
+    {                                                                                                   \
+        if constexpr (transport::utils::isLogLevelCompiledIn(transport::utils::LogLevel::level))        \
+        {                                                                                               \
+            if (transport::utils::Logger::getInstance().shouldLog(transport::utils::LogLevel::level))   \
+                transport::utils::Logger::getInstance().log(transport::utils::LogLevel::level,          \
+                                                            message, __FILE__, __LINE__, __FUNCTION__); \
+        }                                                                                               \
+    } while (0)
 
-#define LOG_WARNING(message) \
-    transport::utils::Logger::getInstance().log(transport::utils::LogLevel::WARNING, message, __FILE__, __LINE__, __FUNCTION__)
-
-#define LOG_ERROR(message) \
-    transport::utils::Logger::getInstance().log(transport::utils::LogLevel::ERROR, message, __FILE__, __LINE__, __FUNCTION__)
-
-#define LOG_CRITICAL(message) \
-    transport::utils::Logger::getInstance().log(transport::utils::LogLevel::CRITICAL, message, __FILE__, __LINE__, __FUNCTION__)
+// Convenience macros for logging with file and line information
+#define LOG_DEBUG(message) TRANSPORT_LOG_AT(DEBUG, message)
+#define LOG_INFO(message) TRANSPORT_LOG_AT(INFO, message)
+#define LOG_WARNING(message) TRANSPORT_LOG_AT(WARNING, message)
+#define LOG_ERROR(message) TRANSPORT_LOG_AT(ERROR, message)
+#define LOG_CRITICAL(message) TRANSPORT_LOG_AT(CRITICAL, message)
+
+// Deferred formatting: LOG_INFO_FMT("Route {} -> {} took {} ms", start, end, ms)
+#define LOG_DEBUG_FMT(...) TRANSPORT_LOG_AT(DEBUG, transport::utils::formatLog(__VA_ARGS__))
+#define LOG_INFO_FMT(...) TRANSPORT_LOG_AT(INFO, transport::utils::formatLog(__VA_ARGS__))
+#define LOG_WARNING_FMT(...) TRANSPORT_LOG_AT(WARNING, transport::utils::formatLog(__VA_ARGS__))
+#define LOG_ERROR_FMT(...) TRANSPORT_LOG_AT(ERROR, transport::utils::formatLog(__VA_ARGS__))
+#define LOG_CRITICAL_FMT(...) TRANSPORT_LOG_AT(CRITICAL, transport::utils::formatLog(__VA_ARGS__))
 
 // Conditional logging macros (only log if condition is true)
 #define LOG_DEBUG_IF(condition, message) \
@@ -335,16 +473,16 @@ namespace transport
 // Performance logging macros for algorithm benchmarking
 #define LOG_PERFORMANCE_START(operation)                                     \
     auto start_time_##operation = std::chrono::high_resolution_clock::now(); \
-    LOG_DEBUG("Starting operation: " + std::string(#operation))
+    LOG_DEBUG_FMT("Starting operation: {}", #operation)
 
 #define LOG_PERFORMANCE_END(operation)                                                                                                \
     auto end_time_##operation = std::chrono::high_resolution_clock::now();                                                            \
     auto duration_##operation = std::chrono::duration_cast<std::chrono::milliseconds>(end_time_##operation - start_time_##operation); \
-    LOG_INFO("Operation " + std::string(#operation) + " completed in " + std::to_string(duration_##operation.count()) + " ms")
+    LOG_INFO_FMT("Operation {} completed in {} ms", #operation, duration_##operation.count())
 
 // Stream-style logging for complex messages
-#define LOG_STREAM(level)                                         \
-    if (transport::utils::Logger::getInstance().shouldLog(level)) \
+#define LOG_STREAM(level)                                                                                     \
+    if (transport::utils::isLogLevelCompiledIn(level) && transport::utils::Logger::getInstance().shouldLog(level)) \
     transport::utils::LogStreamHelper(level)
 
         /**
@@ -0,0 +1,144 @@
+#ifndef TRANSPORT_METRICS_H
+#define TRANSPORT_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Histogram.h"
+
+namespace transport
+{
+    namespace utils
+    {
+
+        /**
+         * @brief Monotonically increasing count, safe to bump from any thread
+         */
+        class Counter
+        {
+        public:
+            void increment(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+            uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+        private:
+            std::atomic<uint64_t> value{0};
+        };
+
+        /**
+         * @brief Value that can go up and down, safe to update from any thread
+         */
+        class Gauge
+        {
+        public:
+            void set(double newValue);
+            void add(double delta);
+            double get() const;
+
+        private:
+            std::atomic<uint64_t> bits{0}; // Bit pattern of a double; 0 is 0.0
+        };
+
+        /**
+         * @brief Named metrics exported in the Prometheus text exposition format
+         *
+         * counter(), gauge() and histogram() register a metric on first use and return the
+         * same object for the same name and labels afterwards; the reference stays valid
+         * for the registry's lifetime, so hot paths look a metric up once and then update
+         * it without locking. Registration and export take the registry mutex.
+         *
+         * Function metrics are read when exporting, for values that already live elsewhere
+         * (cache statistics, queue lengths); the callback must be safe to call from the
+         * exporting thread.
+         *
+         * Usage:
+         * MetricsRegistry metrics;
+         * Counter &queries = metrics.counter("transport_route_queries_total", "Route queries answered");
+         * queries.increment();
+         * metrics.writePrometheusFile("/var/lib/node_exporter/transport.prom");
+         */
+        class MetricsRegistry
+        {
+        public:
+            using Labels = std::vector<std::pair<std::string, std::string>>;
+
+            // Bucket bounds for latencies in seconds, 100 microseconds to 10 seconds
+            static const std::vector<double> &defaultLatencyBounds();
+
+            Counter &counter(const std::string &name, const std::string &help, const Labels &labels = {});
+            Gauge &gauge(const std::string &name, const std::string &help, const Labels &labels = {});
+
+            /**
+             * @brief Register a histogram
+             * @param unitScale Factor from recorded integers to the exported unit, e.g. 1e-6 when
+             *        recording microseconds for a metric in seconds
+             * @param bounds Exported cumulative bucket bounds, in the exported unit
+             */
+            Histogram &histogram(const std::string &name, const std::string &help, const Labels &labels = {},
+                                 double unitScale = 1e-6,
+                                 const std::vector<double> &bounds = defaultLatencyBounds());
+
+            // Counter or gauge whose value is read from read() at export time
+            void counterFunction(const std::string &name, const std::string &help, std::function<double()> read,
+                                 const Labels &labels = {});
+            void gaugeFunction(const std::string &name, const std::string &help, std::function<double()> read,
+                               const Labels &labels = {});
+
+            /**
+             * @brief Render every metric in the Prometheus text format (version 0.0.4)
+             * @return Exposition text, families sorted by name
+             */
+            std::string exportPrometheus() const;
+
+            /**
+             * @brief Write the exposition to a file for a textfile collector
+             * The file is replaced atomically, so a scraper never reads a partial export.
+             * @return True if the file was written, false otherwise
+             */
+            bool writePrometheusFile(const std::string &path) const;
+
+        private:
+            enum class Type
+            {
+                Counter,
+                Gauge,
+                Histogram
+            };
+
+            struct Series
+            {
+                std::string labels; // Rendered as a="x",b="y"
+                std::unique_ptr<Counter> counter;
+                std::unique_ptr<Gauge> gauge;
+                std::unique_ptr<Histogram> histogram;
+                std::function<double()> read;
+                double unitScale = 1.0;
+                std::vector<double> bounds;
+            };
+
+            struct Family
+            {
+                Type type = Type::Counter;
+                std::string help;
+                std::vector<std::unique_ptr<Series>> series;
+            };
+
+            // Find or create the series; throws std::invalid_argument on a type clash
+            Series &series(const std::string &name, const std::string &help, Type type, const Labels &labels,
+                           bool &created);
+
+            static std::string renderLabels(const Labels &labels);
+
+            mutable std::mutex mutex;
+            std::map<std::string, Family> families;
+        };
+
+    } // namespace utils
+} // namespace transport
+
+#endif // TRANSPORT_METRICS_H
@@ -0,0 +1,68 @@
+#ifndef TRANSPORT_METRICS_SERVER_H
+#define TRANSPORT_METRICS_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace transport
+{
+    namespace utils
+    {
+
+        class MetricsRegistry;
+
+        /**
+         * @brief Minimal HTTP endpoint serving a MetricsRegistry for Prometheus scrapes
+         *
+         * Listens on 127.0.0.1 only and answers GET /metrics with the text exposition; any
+         * other request gets 404. Requests are handled one at a time on a single background
+         * thread, which is plenty for a scraper polling every few seconds. POSIX sockets
+         * only: on other platforms start() fails and the registry can still be exported
+         * with MetricsRegistry::writePrometheusFile().
+         */
+        class MetricsServer
+        {
+        public:
+            explicit MetricsServer(const MetricsRegistry &registry);
+            ~MetricsServer();
+
+            MetricsServer(const MetricsServer &) = delete;
+            MetricsServer &operator=(const MetricsServer &) = delete;
+
+            /**
+             * @brief Bind to the port and start serving
+             * @param port TCP port on the loopback interface, 0 for any free port
+             * @return True if the server is listening, false otherwise (see getLastError())
+             */
+            bool start(uint16_t port);
+
+            // Stop serving and close the socket; waits for the request in progress
+            void stop();
+
+            bool isRunning() const;
+
+            // Port actually bound, useful after start(0); 0 when not running
+            uint16_t getPort() const;
+
+            std::string getLastError() const;
+
+        private:
+            void serve();
+            void handleClient(int client);
+
+            const MetricsRegistry &registry;
+            int listenSocket = -1;
+            std::atomic<bool> running{false};
+            std::atomic<uint16_t> boundPort{0};
+            std::thread thread;
+            mutable std::mutex mutex; // Guards start/stop and lastError
+            std::string lastError;
+        };
+
+    } // namespace utils
+} // namespace transport
+
+#endif // TRANSPORT_METRICS_SERVER_H
@@ -0,0 +1,117 @@
+#ifndef TRANSPORT_MPSC_RING_BUFFER_H
+#define TRANSPORT_MPSC_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace transport
+{
+    namespace utils
+    {
+
+        /**
+         * @brief Bounded lock-free queue for many producers and one consumer
+         *
+         * Each slot carries a sequence number that tells producers whether it is free
+         * and the consumer whether it has been published (D. Vyukov's bounded queue).
+         * Producers claim a slot with one compare-and-swap on the enqueue position and
+         * never wait on each other; a full queue is reported instead of blocking, so
+         * the caller chooses whether to drop or retry.
+         *
+         * T must be default constructible and move assignable. Only one thread may
+         * call tryPop() and hasPending().
+         */
+        template <typename T>
+        class MpscRingBuffer
+        {
+        public:
+            /**
+             * @param capacity Number of slots, rounded up to a power of two (at least 2)
+             */
+            explicit MpscRingBuffer(size_t capacity)
+            {
+                size_t slots = 2;
+                while (slots < capacity)
+                    slots <<= 1;
+                mask = slots - 1;
+                cells.reset(new Cell[slots]);
+                for (size_t i = 0; i < slots; ++i)
+                    cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            MpscRingBuffer(const MpscRingBuffer &) = delete;
+            MpscRingBuffer &operator=(const MpscRingBuffer &) = delete;
+
+            // Queue value; returns false, leaving value untouched, when the queue is full
+            bool tryPush(T &&value)
+            {
+                size_t position = enqueuePosition.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    Cell &cell = cells[position & mask];
+                    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                    intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                    if (difference == 0)
+                    {
+                        if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            cell.value = std::move(value);
+                            cell.sequence.store(position + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (difference < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        position = enqueuePosition.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            // Take the oldest published value; false when there is none yet
+            bool tryPop(T &value)
+            {
+                size_t position = dequeuePosition.load(std::memory_order_relaxed);
+                Cell &cell = cells[position & mask];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence != position + 1)
+                    return false;
+
+                value = std::move(cell.value);
+                cell.sequence.store(position + mask + 1, std::memory_order_release);
+                dequeuePosition.store(position + 1, std::memory_order_relaxed);
+                return true;
+            }
+
+            // True when tryPop() would succeed
+            bool hasPending() const
+            {
+                size_t position = dequeuePosition.load(std::memory_order_relaxed);
+                return cells[position & mask].sequence.load(std::memory_order_acquire) == position + 1;
+            }
+
+            size_t capacity() const { return mask + 1; }
+
+        private:
+            struct Cell
+            {
+                std::atomic<size_t> sequence{0};
+                T value{};
+            };
+
+            std::unique_ptr<Cell[]> cells;
+            size_t mask = 0;
+            alignas(64) std::atomic<size_t> enqueuePosition{0};
+            alignas(64) std::atomic<size_t> dequeuePosition{0};
+        };
+
+    } // namespace utils
+} // namespace transport
+
+#endif // TRANSPORT_MPSC_RING_BUFFER_H
@@ -0,0 +1,125 @@
+#ifndef TRANSPORT_WORK_STEALING_SCHEDULER_H
+#define TRANSPORT_WORK_STEALING_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace transport
+{
+    namespace utils
+    {
+
+        /**
+         * @brief Thread pool with one task deque per worker and work stealing
+         *
+         * A worker pushes and pops tasks at the back of its own deque (LIFO, cache
+         * friendly for nested work) and, when that is empty, steals from the front of
+         * another worker's deque (FIFO, so thieves take the oldest and usually largest
+         * pieces). Tasks submitted from outside the pool are spread round-robin.
+         *
+         * This keeps every core busy when task costs are very uneven, e.g. one routing
+         * search per origin where hub origins settle far more nodes than leaf stops.
+         */
+        class WorkStealingScheduler
+        {
+        public:
+            using Task = std::function<void()>;
+
+            struct WorkerStats
+            {
+                size_t tasksExecuted = 0;
+                size_t tasksStolen = 0;
+                double busySeconds = 0.0; // Running tasks, excluding nested tasks and parallelFor waits
+                double utilization = 0.0; // Busy time over wall time since the last reset
+            };
+
+            /**
+             * @brief Start the workers
+             * @param threadCount Number of workers, 0 for one per hardware thread
+             */
+            explicit WorkStealingScheduler(size_t threadCount = 0);
+
+            // Runs every queued task, then stops the workers
+            ~WorkStealingScheduler();
+
+            WorkStealingScheduler(const WorkStealingScheduler &) = delete;
+            WorkStealingScheduler &operator=(const WorkStealingScheduler &) = delete;
+
+            void submit(Task task);
+
+            // Submit a callable and receive its result through a future
+            template <typename Function>
+            auto async(Function function) -> std::future<decltype(function())>
+            {
+                using Result = decltype(function());
+                auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+                std::future<Result> result = task->get_future();
+                submit([task]()
+                       { (*task)(); });
+                return result;
+            }
+
+            /**
+             * @brief Run body(i) for every i in [begin, end) and wait for all of them
+             *
+             * The range is split into chunks of grainSize indexes. When called from a
+             * worker, the caller keeps executing tasks while it waits, so nested
+             * parallel loops cannot deadlock the pool; when there is nothing to run it
+             * sleeps with a growing backoff instead of spinning.
+             */
+            void parallelFor(size_t begin, size_t end, const std::function<void(size_t)> &body,
+                             size_t grainSize = 1);
+
+            // Block until every task submitted so far has finished
+            void waitIdle();
+
+            size_t getThreadCount() const;
+            std::vector<WorkerStats> getWorkerStats() const;
+            void resetStats();
+
+            // Index of the calling worker in this scheduler, -1 for other threads
+            int currentWorkerIndex() const;
+
+        private:
+            struct Worker
+            {
+                std::mutex mutex;
+                std::deque<Task> tasks;
+                std::atomic<size_t> executed{0};
+                std::atomic<size_t> stolen{0};
+                std::atomic<uint64_t> busyNanoseconds{0};
+            };
+
+            void workerLoop(size_t index);
+            bool tryRunOne(size_t self);
+            bool popLocal(size_t self, Task &task);
+            bool steal(size_t self, Task &task);
+            void run(size_t self, Task &task);
+
+            std::vector<std::unique_ptr<Worker>> workers;
+            std::vector<std::thread> threads;
+
+            std::mutex sleepMutex;
+            std::condition_variable wakeUp;
+            std::condition_variable idle;
+            std::atomic<size_t> queued{0};      // Tasks sitting in deques
+            std::atomic<size_t> outstanding{0}; // Tasks submitted but not finished
+            std::atomic<size_t> nextQueue{0};
+            bool stopping = false;
+
+            std::atomic<int64_t> statsStartNanoseconds{0};
+        };
+
+    } // namespace utils
+} // namespace transport
+
+#endif // TRANSPORT_WORK_STEALING_SCHEDULER_H
@@ -0,0 +1,291 @@
+#include "../../include/algorithms/DeltaSteppingStrategy.h"
+#include "../../include/algorithms/RouteService.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+namespace
+{
+    constexpr long long INFINITE = std::numeric_limits<long long>::max();
+
+    // Nodes relaxed per scheduler task; small frontiers run as a single task
+    constexpr size_t GRAIN = 256;
+
+    // Lower the stored distance to candidate; true if this call made it smaller
+    bool atomicMin(std::atomic<long long> &slot, long long candidate)
+    {
+        long long current = slot.load(std::memory_order_relaxed);
+        while (candidate < current)
+        {
+            if (slot.compare_exchange_weak(current, candidate, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+}
+
+DeltaSteppingStrategy::DeltaSteppingStrategy(long long bucketWidth, transport::utils::WorkStealingScheduler *pool)
+    : delta(std::max(0LL, bucketWidth)), scheduler(pool)
+{
+    if (!scheduler)
+    {
+        ownedScheduler = std::make_unique<transport::utils::WorkStealingScheduler>();
+        scheduler = ownedScheduler.get();
+    }
+}
+
+void DeltaSteppingStrategy::setDelta(long long bucketWidth)
+{
+    delta = std::max(0LL, bucketWidth);
+}
+
+long long DeltaSteppingStrategy::getDelta() const
+{
+    return delta;
+}
+
+long long DeltaSteppingStrategy::suggestDelta(const GraphSnapshot &graph, GraphSnapshot::Criterion criterion)
+{
+    long long total = 0, count = 0;
+    for (uint32_t u = 0; u < graph.getNodeCount(); ++u)
+    {
+        GraphSnapshot::EdgeRange edges = graph.getEdges(u);
+        const int *weights = edges.getWeights(criterion);
+        for (uint32_t e = 0; e < edges.count; ++e)
+        {
+            if (weights[e] > 0)
+            {
+                total += weights[e];
+                ++count;
+            }
+        }
+    }
+    return count == 0 ? 1 : std::max(1LL, total / count);
+}
+
+std::shared_ptr<const GraphSnapshot> DeltaSteppingStrategy::snapshotFor(const Graph &graph)
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (!cachedSnapshot || cachedSnapshot->getVersion() != graph.getVersion())
+        cachedSnapshot = std::make_shared<const GraphSnapshot>(graph);
+    return cachedSnapshot;
+}
+
+DeltaSteppingStrategy::ShortestPaths DeltaSteppingStrategy::computeShortestPaths(const GraphSnapshot &graph, uint32_t source,
+                                                                                 GraphSnapshot::Criterion criterion,
+                                                                                 bool withPaths,
+                                                                                 const CancellationToken &cancellation,
+                                                                                 SearchStats *stats)
+{
+    if (stats)
+    {
+        CollectSearchStats collector(*stats);
+        return run(graph, source, criterion, withPaths, cancellation, collector);
+    }
+    NoSearchStats none;
+    return run(graph, source, criterion, withPaths, cancellation, none);
+}
+
+// Stats is NoSearchStats or CollectSearchStats; it is only touched by the calling
+// thread, so parallel chunks count into locals that are merged afterwards
+template <typename Stats>
+DeltaSteppingStrategy::ShortestPaths DeltaSteppingStrategy::run(const GraphSnapshot &graph, uint32_t source,
+                                                                GraphSnapshot::Criterion criterion, bool withPaths,
+                                                                const CancellationToken &cancellation, Stats &stats)
+{
+    const uint32_t nodeCount = graph.getNodeCount();
+    const long long width = delta > 0 ? delta : suggestDelta(graph, criterion);
+
+    ShortestPaths paths;
+    if (source >= nodeCount)
+        return paths;
+
+    std::unique_ptr<std::atomic<long long>[]> dist(new std::atomic<long long>[nodeCount]);
+    for (uint32_t v = 0; v < nodeCount; ++v)
+        dist[v].store(INFINITE, std::memory_order_relaxed);
+    dist[source].store(0, std::memory_order_relaxed);
+
+    std::vector<std::vector<uint32_t>> buckets(1, std::vector<uint32_t>{source});
+    std::vector<uint32_t> roundStamp(nodeCount, 0), bucketStamp(nodeCount, 0);
+    uint32_t round = 0;
+    stats.pushed(1);
+
+    // Relax the light or heavy out-edges of frontier in parallel and file every node
+    // whose distance dropped into the bucket of its new distance
+    auto relax = [&](const std::vector<uint32_t> &frontier, bool light)
+    {
+        size_t chunks = (frontier.size() + GRAIN - 1) / GRAIN;
+        std::vector<std::vector<uint32_t>> improved(chunks);
+        std::vector<uint64_t> examined(Stats::ENABLED ? chunks : 0);
+        scheduler->parallelFor(0, chunks, [&](size_t chunk)
+                               {
+            size_t last = std::min(frontier.size(), (chunk + 1) * GRAIN);
+            for (size_t i = chunk * GRAIN; i < last; ++i)
+            {
+                uint32_t u = frontier[i];
+                long long du = dist[u].load(std::memory_order_relaxed);
+                GraphSnapshot::EdgeRange edges = graph.getEdges(u);
+                const int *weights = edges.getWeights(criterion);
+                for (uint32_t e = 0; e < edges.count; ++e)
+                {
+                    long long w = weights[e];
+                    if ((w <= width) != light)
+                        continue;
+                    if (Stats::ENABLED)
+                        ++examined[chunk];
+                    if (atomicMin(dist[edges.targets[e]], du + w))
+                        improved[chunk].push_back(edges.targets[e]);
+                }
+            } });
+
+        for (size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            if (Stats::ENABLED)
+                stats.relaxed(examined[chunk]);
+            for (uint32_t v : improved[chunk])
+            {
+                size_t bucket = static_cast<size_t>(dist[v].load(std::memory_order_relaxed) / width);
+                if (bucket >= buckets.size())
+                    buckets.resize(bucket + 1);
+                buckets[bucket].push_back(v);
+                stats.pushed(buckets[bucket].size());
+            }
+        }
+    };
+
+    stats.enterPhase(SearchStats::Search);
+    for (size_t current = 0; current < buckets.size(); ++current)
+    {
+        if (buckets[current].empty())
+            continue;
+        if (cancellation.shouldStop())
+            return paths;
+
+        std::vector<uint32_t> settled;
+        while (!buckets[current].empty())
+        {
+            // Keep each node once, and only if it still belongs to this bucket
+            std::vector<uint32_t> frontier;
+            ++round;
+            for (uint32_t v : buckets[current])
+            {
+                stats.popped();
+                if (roundStamp[v] != round &&
+                    static_cast<size_t>(dist[v].load(std::memory_order_relaxed) / width) == current)
+                {
+                    roundStamp[v] = round;
+                    frontier.push_back(v);
+                    if (bucketStamp[v] != current + 1)
+                    {
+                        bucketStamp[v] = static_cast<uint32_t>(current + 1);
+                        settled.push_back(v);
+                        stats.settled();
+                    }
+                }
+                else
+                {
+                    stats.stalePopped();
+                }
+            }
+            buckets[current].clear();
+            relax(frontier, true);
+        }
+        relax(settled, false);
+    }
+
+    stats.enterPhase(SearchStats::PathBuild);
+    paths.distance.resize(nodeCount);
+    for (uint32_t v = 0; v < nodeCount; ++v)
+    {
+        long long d = dist[v].load(std::memory_order_relaxed);
+        paths.distance[v] = d == INFINITE ? UNREACHED : d;
+    }
+    paths.complete = true;
+    if (!withPaths)
+        return paths;
+
+    // Breadth-first over tight edges; the first parent to claim a node keeps it
+    std::unique_ptr<std::atomic<uint32_t>[]> claimed(new std::atomic<uint32_t>[nodeCount]);
+    for (uint32_t v = 0; v < nodeCount; ++v)
+        claimed[v].store(GraphSnapshot::INVALID_NODE, std::memory_order_relaxed);
+    claimed[source].store(source, std::memory_order_relaxed);
+    paths.parentNode.assign(nodeCount, GraphSnapshot::INVALID_NODE);
+    paths.parentEdge.assign(nodeCount, GraphSnapshot::INVALID_NODE);
+
+    std::vector<uint32_t> level{source};
+    while (!level.empty())
+    {
+        size_t chunks = (level.size() + GRAIN - 1) / GRAIN;
+        std::vector<std::vector<uint32_t>> discovered(chunks);
+        scheduler->parallelFor(0, chunks, [&](size_t chunk)
+                               {
+            size_t last = std::min(level.size(), (chunk + 1) * GRAIN);
+            for (size_t i = chunk * GRAIN; i < last; ++i)
+            {
+                uint32_t u = level[i];
+                GraphSnapshot::EdgeRange edges = graph.getEdges(u);
+                const int *weights = edges.getWeights(criterion);
+                for (uint32_t e = 0; e < edges.count; ++e)
+                {
+                    uint32_t v = edges.targets[e];
+                    uint32_t unclaimed = GraphSnapshot::INVALID_NODE;
+                    if (paths.distance[u] + weights[e] == paths.distance[v] &&
+                        claimed[v].compare_exchange_strong(unclaimed, u, std::memory_order_relaxed))
+                    {
+                        paths.parentNode[v] = u;
+                        paths.parentEdge[v] = e;
+                        discovered[chunk].push_back(v);
+                    }
+                }
+            } });
+
+        level.clear();
+        for (const auto &nodes : discovered)
+            level.insert(level.end(), nodes.begin(), nodes.end());
+    }
+    return paths;
+}
+
+RouteResult DeltaSteppingStrategy::findRoute(const Graph &graph, const std::string &start, const std::string &end,
+                                             const std::string &criteria, const CancellationToken &cancellation,
+                                             SearchStats *stats)
+{
+    RouteResult result;
+    result.criteria = criteria;
+
+    std::shared_ptr<const GraphSnapshot> snapshot = snapshotFor(graph);
+    uint32_t source = snapshot->findNode(start);
+    uint32_t target = snapshot->findNode(end);
+    if (source == GraphSnapshot::INVALID_NODE || target == GraphSnapshot::INVALID_NODE)
+        return result;
+
+    ShortestPaths paths = computeShortestPaths(*snapshot, source, GraphSnapshot::parseCriterion(criteria), true,
+                                               cancellation, stats);
+    if (!paths.complete)
+    {
+        result.status = cancellation.stopStatus();
+        return result;
+    }
+
+    if (paths.distance[target] != UNREACHED)
+        RouteService::extractPath(*snapshot, paths.parentNode.data(), paths.parentEdge.data(), source, target, result);
+    return result;
+}
+
+std::vector<std::string> DeltaSteppingStrategy::computeIsochrone(const Graph &graph, const std::string &origin,
+                                                                 long long budget, const std::string &criteria)
+{
+    std::vector<std::string> reachable;
+    std::shared_ptr<const GraphSnapshot> snapshot = snapshotFor(graph);
+    uint32_t source = snapshot->findNode(origin);
+    if (source == GraphSnapshot::INVALID_NODE)
+        return reachable;
+
+    ShortestPaths paths = computeShortestPaths(*snapshot, source, GraphSnapshot::parseCriterion(criteria), false);
+    for (uint32_t v = 0; v < snapshot->getNodeCount(); ++v)
+    {
+        if (snapshot->isActive(v) && paths.distance[v] != UNREACHED && paths.distance[v] <= budget)
+            reachable.push_back(snapshot->getName(v));
+    }
+    return reachable;
+}
@@ -5,122 +5,159 @@
 #include <unordered_map>
 #include <algorithm>
 
-RouteResult DijkstraStrategy::findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria)
+namespace
 {
-    RouteResult result;
-    result.criteria = criteria;
-
-    // Get node names for building lookup tables
-    std::vector<std::string> nodeNames = graph.getNodeNames();
-
-    // Create lookup maps
-    std::unordered_map<std::string, double> dist;
-    std::unordered_map<std::string, std::string> prev;
-
-    // Initialize with infinity distances
-    for (const auto &name : nodeNames)
+    // Stats is NoSearchStats or CollectSearchStats; see SearchStats.h
+    template <typename Stats>
+    RouteResult runDijkstra(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria,
+                            const CancellationToken &cancellation, Stats &stats)
     {
-        dist[name] = std::numeric_limits<double>::infinity();
-        prev[name] = "";
-    }
+        RouteResult result;
+        result.criteria = criteria;
 
-    // Distance to start is zero
-    dist[start] = 0;
+        // Get node names for building lookup tables
+        std::vector<std::string> nodeNames = graph.getNodeNames();
 
-    // Priority queue for Dijkstra
-    using NodePriority = std::pair<double, std::string>;
-    std::priority_queue<NodePriority, std::vector<NodePriority>, std::greater<NodePriority>> pq;
-    pq.push({0, start});
+        // Create lookup maps
+        std::unordered_map<std::string, double> dist;
+        std::unordered_map<std::string, std::string> prev;
 
-    while (!pq.empty())
-    {
-        auto [d, u] = pq.top();
-        pq.pop();
+        // Initialize with infinity distances
+        for (const auto &name : nodeNames)
+        {
+            dist[name] = std::numeric_limits<double>::infinity();
+            prev[name] = "";
+        }
 
-        // Found destination
-        if (u == end)
-            break;
+        // Distance to start is zero
+        dist[start] = 0;
 
-        // Skip outdated entries
-        if (d > dist[u])
-            continue;
+        // Priority queue for Dijkstra
+        using NodePriority = std::pair<double, std::string>;
+        std::priority_queue<NodePriority, std::vector<NodePriority>, std::greater<NodePriority>> pq;
+        pq.push({0, start});
+        stats.pushed(pq.size());
+        unsigned settled = 0;
+        stats.enterPhase(SearchStats::Search);
 
-        // Process all edges from current node
-        std::vector<Edge> edges = graph.getEdgesFrom(u);
-        for (const auto &edge : edges)
+        while (!pq.empty())
         {
-            const std::string &v = edge.getDestination();
+            auto [d, u] = pq.top();
+            pq.pop();
+            stats.popped();
 
-            // Choose weight based on criteria
-            double weight = 0;
-            if (criteria == "distance")
-            {
-                weight = edge.getDistance();
-            }
-            else if (criteria == "time")
-            {
-                weight = edge.getTime();
-            }
-            else if (criteria == "cost")
-            {
-                weight = edge.getCost();
-            }
-            else if (criteria == "transfers")
+            // Found destination
+            if (u == end)
+                break;
+
+            // Skip outdated entries
+            if (d > dist[u])
             {
-                weight = edge.getTransfers();
+                stats.stalePopped();
+                continue;
             }
-            else
+            stats.settled();
+
+            // Give up on queries past their deadline instead of exploring the whole graph
+            if (++settled % CancellationToken::CHECK_INTERVAL == 0 && cancellation.shouldStop())
             {
-                // Default to time if criteria is not recognized
-                weight = edge.getTime();
+                result.status = cancellation.stopStatus();
+                return result;
             }
 
-            double alt = dist[u] + weight;
-            if (alt < dist[v])
+            // Process all edges from current node
+            std::vector<Edge> edges = graph.getEdgesFrom(u);
+            for (const auto &edge : edges)
             {
-                dist[v] = alt;
-                prev[v] = u;
-                pq.push({alt, v});
+                const std::string &v = edge.getDestination();
+                stats.relaxed();
+
+                // Choose weight based on criteria
+                double weight = 0;
+                if (criteria == "distance")
+                {
+                    weight = edge.getDistance();
+                }
+                else if (criteria == "time")
+                {
+                    weight = edge.getTime();
+                }
+                else if (criteria == "cost")
+                {
+                    weight = edge.getCost();
+                }
+                else if (criteria == "transfers")
+                {
+                    weight = edge.getTransfers();
+                }
+                else
+                {
+                    // Default to time if criteria is not recognized
+                    weight = edge.getTime();
+                }
+
+                double alt = dist[u] + weight;
+                if (alt < dist[v])
+                {
+                    dist[v] = alt;
+                    prev[v] = u;
+                    pq.push({alt, v});
+                    stats.pushed(pq.size());
+                }
             }
         }
-    }
-
-    // Reconstruct path
-    std::vector<std::string> path;
-    for (std::string at = end; !at.empty(); at = prev[at])
-    {
-        path.push_back(at);
-    }
 
-    // Check if we reached the start node
-    if (path.empty() || path.back() != start)
-    {
-        result.isValid = false;
-        return result;
-    }
+        // Reconstruct path
+        stats.enterPhase(SearchStats::PathBuild);
+        std::vector<std::string> path;
+        for (std::string at = end; !at.empty(); at = prev[at])
+        {
+            path.push_back(at);
+        }
 
-    // Reverse to get path from start to end
-    std::reverse(path.begin(), path.end());
+        // Check if we reached the start node
+        if (path.empty() || path.back() != start)
+        {
+            result.isValid = false;
+            return result;
+        }
 
-    // Calculate metrics for the path
-    result.path = path;
-    result.isValid = true;
+        // Reverse to get path from start to end
+        std::reverse(path.begin(), path.end());
 
-    // Sum up the metrics for the edges in the path
-    for (size_t i = 0; i < path.size() - 1; ++i)
-    {
-        const std::string &from = path[i];
-        const std::string &to = path[i + 1];
+        // Calculate metrics for the path
+        result.path = path;
+        result.isValid = true;
+        result.status = RouteStatus::Found;
 
-        if (graph.hasEdge(from, to))
+        // Sum up the metrics for the edges in the path
+        for (size_t i = 0; i < path.size() - 1; ++i)
         {
-            Edge edge = graph.getEdge(from, to);
-            result.totalDistance += edge.getDistance();
-            result.totalTime += edge.getTime();
-            result.totalCost += edge.getCost();
-            result.totalTransfers += edge.getTransfers();
+            const std::string &from = path[i];
+            const std::string &to = path[i + 1];
+
+            if (graph.hasEdge(from, to))
+            {
+                Edge edge = graph.getEdge(from, to);
+                result.totalDistance += edge.getDistance();
+                result.totalTime += edge.getTime();
+                result.totalCost += edge.getCost();
+                result.totalTransfers += edge.getTransfers();
+            }
         }
+
+        return result;
     }
+}
 
-    return result;
+RouteResult DijkstraStrategy::findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria,
+                                        const CancellationToken &cancellation, SearchStats *stats)
+{
+    if (stats)
+    {
+        CollectSearchStats collector(*stats);
+        return runDijkstra(graph, start, end, criteria, cancellation, collector);
+    }
+    NoSearchStats none;
+    return runDijkstra(graph, start, end, criteria, cancellation, none);
 }
@@ -0,0 +1,166 @@
+#include "../../include/algorithms/MultiSourceSearch.h"
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TRANSPORT_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define TRANSPORT_X86_SIMD 0
+#endif
+
+namespace
+{
+    bool relaxScalar(const int32_t *source, int32_t weight, int32_t *target)
+    {
+        bool improved = false;
+        for (uint32_t lane = 0; lane < MultiSourceSearch::LANES; ++lane)
+        {
+            int32_t candidate = source[lane] + weight;
+            if (candidate < target[lane])
+            {
+                target[lane] = candidate;
+                improved = true;
+            }
+        }
+        return improved;
+    }
+
+#if TRANSPORT_X86_SIMD
+    // Compiled for the wider ISA only here; callers reach them after a CPU check
+    __attribute__((target("avx2"))) bool relaxAvx2(const int32_t *source, int32_t weight, int32_t *target)
+    {
+        const __m256i broadcast = _mm256_set1_epi32(weight);
+        int changed = 0;
+        for (uint32_t half = 0; half < MultiSourceSearch::LANES; half += 8)
+        {
+            __m256i candidate = _mm256_add_epi32(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + half)), broadcast);
+            __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(target + half));
+            __m256i better = _mm256_min_epi32(candidate, current);
+            changed |= _mm256_movemask_epi8(_mm256_cmpgt_epi32(current, better));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(target + half), better);
+        }
+        return changed != 0;
+    }
+
+    __attribute__((target("avx512f"))) bool relaxAvx512(const int32_t *source, int32_t weight, int32_t *target)
+    {
+        __m512i candidate = _mm512_add_epi32(_mm512_loadu_si512(source), _mm512_set1_epi32(weight));
+        __mmask16 improved = _mm512_cmplt_epi32_mask(candidate, _mm512_loadu_si512(target));
+        if (!improved)
+            return false;
+        _mm512_mask_storeu_epi32(target, improved, candidate);
+        return true;
+    }
+#endif
+}
+
+MultiSourceSearch::Kernel MultiSourceSearch::detectKernel()
+{
+    if (isSupported(Kernel::AVX512))
+        return Kernel::AVX512;
+    if (isSupported(Kernel::AVX2))
+        return Kernel::AVX2;
+    return Kernel::Scalar;
+}
+
+bool MultiSourceSearch::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+#if TRANSPORT_X86_SIMD
+    case Kernel::AVX512:
+        return __builtin_cpu_supports("avx512f");
+    case Kernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    case Kernel::Scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+std::string MultiSourceSearch::kernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::AVX512:
+        return "avx512";
+    case Kernel::AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+MultiSourceSearch::MultiSourceSearch(Kernel requested)
+    : kernel(isSupported(requested) ? requested : Kernel::Scalar), relax(relaxScalar)
+{
+#if TRANSPORT_X86_SIMD
+    if (kernel == Kernel::AVX512)
+        relax = relaxAvx512;
+    else if (kernel == Kernel::AVX2)
+        relax = relaxAvx2;
+#endif
+}
+
+void MultiSourceSearch::run(const GraphSnapshot &graph, const std::vector<uint32_t> &sources,
+                            GraphSnapshot::Criterion criterion)
+{
+    const uint32_t nodeCount = graph.getNodeCount();
+    distances.assign(static_cast<size_t>(nodeCount) * LANES, INFINITE_DISTANCE);
+    queued.assign(nodeCount, 0);
+    frontier.clear();
+
+    for (uint32_t lane = 0; lane < LANES && lane < sources.size(); ++lane)
+    {
+        uint32_t source = sources[lane];
+        if (source == GraphSnapshot::INVALID_NODE || source >= nodeCount)
+            continue;
+        distances[static_cast<size_t>(source) * LANES + lane] = 0;
+        if (!queued[source])
+        {
+            queued[source] = 1;
+            frontier.push_back(source);
+        }
+    }
+
+    // Each round relaxes the out-edges of every node that improved in any lane during
+    // the previous one; with non-negative weights this settles after at most n rounds
+    for (uint32_t round = 0; !frontier.empty() && round < nodeCount; ++round)
+    {
+        nextFrontier.clear();
+        for (uint32_t u : frontier)
+            queued[u] = 0;
+
+        for (uint32_t u : frontier)
+        {
+            const int32_t *fromDistances = &distances[static_cast<size_t>(u) * LANES];
+            GraphSnapshot::EdgeRange edges = graph.getEdges(u);
+            const int *weights = edges.getWeights(criterion);
+            for (uint32_t e = 0; e < edges.count; ++e)
+            {
+                uint32_t v = edges.targets[e];
+                int32_t weight = std::min(std::max(weights[e], 0), INFINITE_DISTANCE);
+                if (relax(fromDistances, weight, &distances[static_cast<size_t>(v) * LANES]) && !queued[v])
+                {
+                    queued[v] = 1;
+                    nextFrontier.push_back(v);
+                }
+            }
+        }
+        frontier.swap(nextFrontier);
+    }
+}
+
+long long MultiSourceSearch::getDistance(uint32_t lane, uint32_t node) const
+{
+    int32_t distance = distances[static_cast<size_t>(node) * LANES + lane];
+    return distance >= INFINITE_DISTANCE ? UNREACHED : distance;
+}
+
+bool MultiSourceSearch::reaches(uint32_t lane, uint32_t node) const
+{
+    return distances[static_cast<size_t>(node) * LANES + lane] < INFINITE_DISTANCE;
+}
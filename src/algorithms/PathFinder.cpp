@@ -7,10 +7,11 @@ void PathFinder::setStrategy(RouteStrategy *strategy)
     this->strategy = strategy;
 }
 
-RouteResult PathFinder::findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria)
+RouteResult PathFinder::findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria,
+                                  const CancellationToken &cancellation, SearchStats *stats)
 {
     if (strategy)
-        return strategy->findRoute(graph, start, end, criteria);
+        return strategy->findRoute(graph, start, end, criteria, cancellation, stats);
 
     // Return invalid route result if no strategy is set
     RouteResult emptyResult;
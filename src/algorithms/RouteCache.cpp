@@ -0,0 +1,183 @@
+#include "../../include/algorithms/RouteCache.h"
+#include <algorithm>
+#include <functional>
+
+size_t RouteCache::KeyHash::operator()(const Key &key) const
+{
+    std::hash<std::string> hashString;
+    size_t hash = hashString(key.start);
+    // boost::hash_combine mixing
+    hash ^= hashString(key.end) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    hash ^= hashString(key.criteria) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<uint64_t>()(key.graphVersion) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+RouteCache::RouteCache(size_t budget, size_t shardCount)
+    : memoryBudget(budget)
+{
+    shardCount = std::max<size_t>(1, shardCount);
+    for (size_t i = 0; i < shardCount; ++i)
+        shards.push_back(std::make_unique<Shard>());
+}
+
+RouteCache::Shard &RouteCache::shardFor(const Key &key)
+{
+    // Fold the high bits in so the shard choice does not mirror the bucket choice inside it
+    size_t hash = KeyHash()(key);
+    return *shards[(hash ^ (hash >> 17)) % shards.size()];
+}
+
+size_t RouteCache::estimateBytes(const Key &key, const RouteResult &result)
+{
+    // Entry plus the list node and map node around it; strings count their heap capacity
+    size_t bytes = sizeof(Entry) + 2 * sizeof(void *) + sizeof(Key) + 4 * sizeof(void *);
+    bytes += 2 * (key.start.capacity() + key.end.capacity() + key.criteria.capacity());
+    bytes += result.criteria.capacity();
+    bytes += result.path.capacity() * sizeof(std::string);
+    for (const std::string &stop : result.path)
+        bytes += stop.capacity();
+    return bytes;
+}
+
+void RouteCache::evictLocked(Shard &shard, size_t budget)
+{
+    while (shard.bytes > budget && !shard.lru.empty())
+    {
+        Entry &victim = shard.lru.back();
+        shard.bytes -= victim.bytes;
+        shard.index.erase(victim.key);
+        shard.lru.pop_back();
+        ++shard.evictions;
+    }
+}
+
+bool RouteCache::lookup(const std::string &start, const std::string &end, const std::string &criteria,
+                        uint64_t graphVersion, RouteResult &result)
+{
+    Key key{start, end, criteria, graphVersion};
+    Shard &shard = shardFor(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end())
+    {
+        ++shard.misses;
+        return false;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+    result = found->second->result;
+    ++shard.hits;
+    return true;
+}
+
+bool RouteCache::insert(const std::string &start, const std::string &end, const std::string &criteria,
+                        uint64_t graphVersion, const RouteResult &result)
+{
+    if (result.status != RouteStatus::Found && result.status != RouteStatus::NotFound)
+        return false;
+
+    Key key{start, end, criteria, graphVersion};
+    size_t bytes = estimateBytes(key, result);
+    size_t shardBudget = memoryBudget.load(std::memory_order_relaxed) / shards.size();
+    if (bytes > shardBudget)
+        return false;
+
+    Shard &shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto found = shard.index.find(key);
+    if (found != shard.index.end())
+    {
+        // Another thread computed the same route first; keep one copy
+        shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+        return true;
+    }
+
+    shard.lru.push_front(Entry{key, result, bytes});
+    shard.index.emplace(std::move(key), shard.lru.begin());
+    shard.bytes += bytes;
+    ++shard.insertions;
+    evictLocked(shard, shardBudget);
+    return true;
+}
+
+size_t RouteCache::purgeStale(uint64_t currentVersion)
+{
+    size_t purged = 0;
+    for (auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto it = shard->lru.begin(); it != shard->lru.end();)
+        {
+            if (it->key.graphVersion != currentVersion)
+            {
+                shard->bytes -= it->bytes;
+                shard->index.erase(it->key);
+                it = shard->lru.erase(it);
+                ++purged;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+    return purged;
+}
+
+void RouteCache::clear()
+{
+    for (auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->index.clear();
+        shard->lru.clear();
+        shard->bytes = 0;
+    }
+}
+
+void RouteCache::setMemoryBudget(size_t budget)
+{
+    memoryBudget.store(budget, std::memory_order_relaxed);
+    size_t shardBudget = budget / shards.size();
+    for (auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        evictLocked(*shard, shardBudget);
+    }
+}
+
+size_t RouteCache::getMemoryBudget() const
+{
+    return memoryBudget.load(std::memory_order_relaxed);
+}
+
+RouteCache::Statistics RouteCache::getStatistics() const
+{
+    Statistics total;
+    for (const auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total.hits += shard->hits;
+        total.misses += shard->misses;
+        total.insertions += shard->insertions;
+        total.evictions += shard->evictions;
+        total.entries += shard->lru.size();
+        total.bytes += shard->bytes;
+    }
+    return total;
+}
+
+void RouteCache::resetStatistics()
+{
+    for (auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->hits = 0;
+        shard->misses = 0;
+        shard->insertions = 0;
+        shard->evictions = 0;
+    }
+}
@@ -0,0 +1,574 @@
+#include "../../include/algorithms/RouteService.h"
+#include "../../include/io/ConfigManager.h"
+#include "../../include/io/TraceLog.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+void RouteService::SearchWorkspace::prepare(uint32_t nodeCount)
+{
+    if (stamp.size() != nodeCount)
+    {
+        distance.assign(nodeCount, 0);
+        parentEdge.assign(nodeCount, GraphSnapshot::INVALID_NODE);
+        parentNode.assign(nodeCount, GraphSnapshot::INVALID_NODE);
+        stamp.assign(nodeCount, 0);
+        generation = 0;
+    }
+
+    if (++generation == 0)
+    {
+        // Stamps wrapped around; old entries could alias the new generation
+        std::fill(stamp.begin(), stamp.end(), 0);
+        generation = 1;
+    }
+    heap.clear();
+    settled = 0;
+}
+
+namespace
+{
+    // Dijkstra from source; stops once target is settled, or runs to exhaustion for INVALID_NODE.
+    // Returns false when the token stopped the search first.
+    bool runDijkstra(const GraphSnapshot &graph, RouteService::SearchWorkspace &workspace,
+                     uint32_t source, uint32_t target, GraphSnapshot::Criterion criterion,
+                     const CancellationToken &cancellation = CancellationToken())
+    {
+        workspace.prepare(graph.getNodeCount());
+
+        using Entry = std::pair<long long, uint32_t>;
+        std::greater<Entry> later;
+        auto &heap = workspace.heap;
+
+        workspace.stamp[source] = workspace.generation;
+        workspace.distance[source] = 0;
+        workspace.parentEdge[source] = GraphSnapshot::INVALID_NODE;
+        heap.push_back({0, source});
+        unsigned settled = 0;
+
+        while (!heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            auto [d, u] = heap.back();
+            heap.pop_back();
+
+            if (u == target)
+                break;
+            if (d > workspace.distance[u])
+                continue;
+            if (++settled % CancellationToken::CHECK_INTERVAL == 0 && cancellation.shouldStop())
+            {
+                workspace.settled = settled;
+                return false;
+            }
+
+            GraphSnapshot::EdgeRange edges = graph.getEdges(u);
+            const int *weights = edges.getWeights(criterion);
+            for (uint32_t e = 0; e < edges.count; ++e)
+            {
+                uint32_t v = edges.targets[e];
+                long long alt = d + weights[e];
+                if (!workspace.isReached(v) || alt < workspace.distance[v])
+                {
+                    workspace.stamp[v] = workspace.generation;
+                    workspace.distance[v] = alt;
+                    workspace.parentEdge[v] = e;
+                    workspace.parentNode[v] = u;
+                    heap.push_back({alt, v});
+                    std::push_heap(heap.begin(), heap.end(), later);
+                }
+            }
+        }
+        workspace.settled = settled;
+        return true;
+    }
+}
+
+RouteService::RouteService(std::shared_ptr<const GraphSnapshot> initialSnapshot, size_t threadCount)
+    : snapshot(std::move(initialSnapshot)),
+      scheduler(std::make_unique<transport::utils::WorkStealingScheduler>(threadCount))
+{
+}
+
+RouteService::RouteService(std::shared_ptr<const VersionedGraph> versionedGraph, size_t threadCount)
+    : versions(std::move(versionedGraph)),
+      scheduler(std::make_unique<transport::utils::WorkStealingScheduler>(threadCount))
+{
+}
+
+RouteService::~RouteService()
+{
+    // Leaders that give up from now on retry their followers themselves
+    shuttingDown = true;
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        stopWatching = true;
+    }
+    watchSignal.notify_all();
+    if (followerWatcher.joinable())
+        followerWatcher.join();
+    // Queued queries still reference this service, so finish them while the pool exists
+    scheduler->waitIdle();
+    scheduler.reset();
+}
+
+RouteService::SearchWorkspace &RouteService::threadWorkspace()
+{
+    thread_local SearchWorkspace workspace;
+    return workspace;
+}
+
+std::future<RouteResult> RouteService::submit(const std::string &start, const std::string &end,
+                                              const std::string &criteria, const CancellationToken &cancellation)
+{
+    auto promise = std::make_shared<std::promise<RouteResult>>();
+    std::future<RouteResult> result = promise->get_future();
+    submit(start, end, criteria, cancellation, [promise](const RouteResult &answered, std::exception_ptr error)
+           {
+        if (error)
+            promise->set_exception(error);
+        else
+            promise->set_value(answered); });
+    return result;
+}
+
+void RouteService::submit(const std::string &start, const std::string &end, const std::string &criteria,
+                          const CancellationToken &cancellation, Completion onComplete)
+{
+    std::shared_ptr<const GraphSnapshot> bound = getSnapshot();
+    std::shared_ptr<TraceLog> trace = std::atomic_load(&traceLog);
+
+    // Identical queries on the same snapshot attach to the one already in flight
+    std::string key = std::to_string(bound->getVersion()) + '\0' + start + '\0' + end + '\0' + criteria;
+    {
+        std::lock_guard<std::mutex> lock(inflightMutex);
+        auto found = inflight.find(key);
+        if (found != inflight.end())
+        {
+            if (trace)
+                onComplete = traced(std::move(onComplete), std::move(trace), *bound, start, end, criteria, true);
+            Waiter follower{std::move(onComplete), cancellation, criteria, 0};
+            if (cancellation.canStop())
+            {
+                if (!followerWatcher.joinable())
+                    followerWatcher = std::thread(&RouteService::watchFollowers, this);
+                follower.cancelCallback = cancellation.addCancelCallback([this]
+                                                                         { wakeWatcher(); });
+                wakeWatcher();
+            }
+            found->second.push_back(std::move(follower));
+            coalescedQueries.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        inflight.emplace(key, std::vector<Waiter>());
+    }
+    if (trace)
+        onComplete = traced(std::move(onComplete), std::move(trace), *bound, start, end, criteria, false);
+
+    scheduler->submit([this, onComplete, bound, key, start, end, criteria, cancellation]()
+                      {
+        RouteResult answered;
+        std::exception_ptr error;
+        threadWorkspace().settled = 0; // Stays 0 when the answer comes from a cached tree
+        try
+        {
+            answered = answer(*bound, start, end, criteria, cancellation);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        std::vector<Waiter> followers;
+        {
+            std::lock_guard<std::mutex> lock(inflightMutex);
+            auto found = inflight.find(key);
+            followers = std::move(found->second);
+            inflight.erase(found);
+        }
+
+        deliver(onComplete, answered, error);
+        bool leaderGaveUp = answered.status == RouteStatus::TimedOut || answered.status == RouteStatus::Cancelled;
+        auto retry = [this, bound, start, end, criteria](const Waiter &follower)
+        {
+            RouteResult retried;
+            std::exception_ptr retryError;
+            threadWorkspace().settled = 0;
+            try
+            {
+                retried = answer(*bound, start, end, criteria, follower.cancellation);
+            }
+            catch (...)
+            {
+                retryError = std::current_exception();
+            }
+            deliver(follower.onComplete, retried, retryError);
+        };
+        for (Waiter &follower : followers)
+        {
+            follower.cancellation.removeCancelCallback(follower.cancelCallback);
+            if (!error && leaderGaveUp && !follower.cancellation.shouldStop())
+            {
+                // The leader's deadline ran out but this caller still has time of its own.
+                // Once the service is being destroyed the pool may not take new work.
+                if (shuttingDown)
+                    retry(follower);
+                else
+                    scheduler->submit([retry, follower]()
+                                      { retry(follower); });
+            }
+            else
+            {
+                deliver(follower.onComplete, answered, error);
+            }
+        } });
+}
+
+void RouteService::wakeWatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        followersChanged = true;
+    }
+    watchSignal.notify_one();
+}
+
+void RouteService::watchFollowers()
+{
+    using Clock = std::chrono::steady_clock;
+    while (true)
+    {
+        std::vector<Waiter> stopped;
+        Clock::time_point nextDeadline = Clock::time_point::max();
+        {
+            std::lock_guard<std::mutex> lock(inflightMutex);
+            for (auto &entry : inflight)
+            {
+                std::vector<Waiter> &followers = entry.second;
+                for (auto follower = followers.begin(); follower != followers.end();)
+                {
+                    if (follower->cancellation.shouldStop())
+                    {
+                        // Detached under the lock, so the leader can no longer deliver to it
+                        stopped.push_back(std::move(*follower));
+                        follower = followers.erase(follower);
+                        continue;
+                    }
+                    nextDeadline = std::min(nextDeadline, follower->cancellation.getDeadline());
+                    ++follower;
+                }
+            }
+        }
+
+        threadWorkspace().settled = 0; // No search ran for them
+        for (const Waiter &follower : stopped)
+        {
+            follower.cancellation.removeCancelCallback(follower.cancelCallback);
+            RouteResult result;
+            result.status = follower.cancellation.stopStatus();
+            result.criteria = follower.criteria;
+            deliver(follower.onComplete, result, nullptr);
+        }
+
+        // Sleep until the earliest deadline, or until a follower attaches or is cancelled
+        std::unique_lock<std::mutex> lock(watchMutex);
+        auto woken = [this]
+        { return stopWatching || followersChanged; };
+        if (nextDeadline == Clock::time_point::max())
+            watchSignal.wait(lock, woken);
+        else
+            watchSignal.wait_until(lock, nextDeadline, woken);
+        if (stopWatching)
+            return;
+        followersChanged = false;
+    }
+}
+
+void RouteService::deliver(const Completion &onComplete, const RouteResult &result, std::exception_ptr error)
+{
+    // Counted first: a completion may resume a coroutine that runs for a long time
+    completedQueries.fetch_add(1, std::memory_order_relaxed);
+    onComplete(result, error);
+}
+
+RouteService::Completion RouteService::traced(Completion onComplete, std::shared_ptr<TraceLog> trace,
+                                              const GraphSnapshot &graph, const std::string &start,
+                                              const std::string &end, const std::string &criteria, bool coalesced)
+{
+    TraceLog::Record record;
+    record.queryId = trace->nextQueryId();
+    record.startNode = graph.findNode(start);
+    record.endNode = graph.findNode(end);
+    record.criterion = static_cast<uint8_t>(GraphSnapshot::parseCriterion(criteria));
+    record.flags = coalesced ? TraceLog::FLAG_COALESCED : 0;
+    auto submitted = std::chrono::steady_clock::now();
+
+    return [onComplete = std::move(onComplete), trace = std::move(trace), record, submitted](
+               const RouteResult &result, std::exception_ptr error)
+    {
+        // Runs on the worker right after the search, so its workspace still holds the count
+        TraceLog::Record done = record;
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - submitted);
+        done.timestampNanos = TraceLog::nowNanos();
+        done.threadId = TraceLog::currentThreadId();
+        done.latencyMicros = static_cast<uint32_t>(std::min<long long>(latency.count(), UINT32_MAX));
+        done.nodesSettled = threadWorkspace().settled;
+        done.status = static_cast<uint8_t>(result.status);
+        if (error)
+            done.flags |= TraceLog::FLAG_FAILED;
+        trace->record(done);
+        onComplete(result, error);
+    };
+}
+
+std::vector<std::future<RouteResult>> RouteService::submitBatch(const std::vector<Query> &queries,
+                                                                const CancellationToken &cancellation)
+{
+    std::vector<std::future<RouteResult>> results;
+    results.reserve(queries.size());
+    for (const Query &query : queries)
+        results.push_back(submit(query.start, query.end, query.criteria, cancellation));
+    return results;
+}
+
+std::vector<std::vector<long long>> RouteService::computeMatrix(const std::vector<std::string> &origins,
+                                                               const std::vector<std::string> &destinations,
+                                                               const std::string &criteria)
+{
+    std::shared_ptr<const GraphSnapshot> bound = getSnapshot();
+    const GraphSnapshot::Criterion criterion = GraphSnapshot::parseCriterion(criteria);
+    const MultiSourceSearch::Kernel kernel = getBatchKernel();
+
+    std::vector<uint32_t> sources;
+    sources.reserve(origins.size());
+    for (const std::string &name : origins)
+        sources.push_back(bound->findNode(name));
+
+    std::vector<uint32_t> targets;
+    targets.reserve(destinations.size());
+    for (const std::string &name : destinations)
+        targets.push_back(bound->findNode(name));
+
+    std::vector<std::vector<long long>> matrix(origins.size(),
+                                               std::vector<long long>(destinations.size(), UNREACHABLE));
+    const size_t lanes = MultiSourceSearch::LANES;
+    const size_t groups = (origins.size() + lanes - 1) / lanes;
+    scheduler->parallelFor(0, groups, [&](size_t group)
+                           {
+        size_t first = group * lanes;
+        size_t last = std::min(origins.size(), first + lanes);
+        std::vector<uint32_t> laneSources(sources.begin() + first, sources.begin() + last);
+
+        thread_local std::unique_ptr<MultiSourceSearch> search;
+        if (!search || search->getKernel() != kernel)
+            search = std::make_unique<MultiSourceSearch>(kernel);
+        search->run(*bound, laneSources, criterion);
+
+        for (size_t o = first; o < last; ++o)
+        {
+            if (sources[o] == GraphSnapshot::INVALID_NODE)
+                continue;
+            uint32_t lane = static_cast<uint32_t>(o - first);
+            for (size_t d = 0; d < targets.size(); ++d)
+            {
+                if (targets[d] != GraphSnapshot::INVALID_NODE)
+                    matrix[o][d] = search->getDistance(lane, targets[d]);
+            }
+        }
+        completedQueries.fetch_add(last - first, std::memory_order_relaxed); });
+    return matrix;
+}
+
+RouteResult RouteService::findRoute(const std::string &start, const std::string &end,
+                                    const std::string &criteria, const CancellationToken &cancellation)
+{
+    return submit(start, end, criteria, cancellation).get();
+}
+
+void RouteService::setSnapshot(std::shared_ptr<const GraphSnapshot> newSnapshot)
+{
+    std::atomic_store(&snapshot, std::move(newSnapshot));
+}
+
+std::shared_ptr<const GraphSnapshot> RouteService::getSnapshot() const
+{
+    if (versions)
+        return versions->acquireSnapshot();
+    return std::atomic_load(&snapshot);
+}
+
+void RouteService::setTraceLog(std::shared_ptr<TraceLog> trace)
+{
+    std::atomic_store(&traceLog, std::move(trace));
+}
+
+std::shared_ptr<TraceLog> RouteService::getTraceLog() const
+{
+    return std::atomic_load(&traceLog);
+}
+
+size_t RouteService::getThreadCount() const
+{
+    return scheduler->getThreadCount();
+}
+
+size_t RouteService::getCompletedQueries() const
+{
+    return completedQueries.load(std::memory_order_relaxed);
+}
+
+size_t RouteService::getCoalescedQueries() const
+{
+    return coalescedQueries.load(std::memory_order_relaxed);
+}
+
+transport::utils::WorkStealingScheduler &RouteService::getScheduler()
+{
+    return *scheduler;
+}
+
+ShortestPathTreeCache &RouteService::getTreeCache()
+{
+    return treeCache;
+}
+
+void RouteService::setBatchKernel(MultiSourceSearch::Kernel kernel)
+{
+    batchKernel = MultiSourceSearch::isSupported(kernel) ? kernel : MultiSourceSearch::Kernel::Scalar;
+}
+
+MultiSourceSearch::Kernel RouteService::getBatchKernel() const
+{
+    return batchKernel.load();
+}
+
+size_t RouteService::threadCountFromConfig(const std::string &configPath)
+{
+    ConfigManager config;
+    if (!config.loadConfig(configPath))
+        return 0;
+
+    try
+    {
+        int threads = std::stoi(config.getValue("max_threads"));
+        return threads > 0 ? static_cast<size_t>(threads) : 0;
+    }
+    catch (const std::exception &)
+    {
+        return 0;
+    }
+}
+
+RouteResult RouteService::search(const GraphSnapshot &graph, SearchWorkspace &workspace,
+                                 const std::string &start, const std::string &end,
+                                 const std::string &criteria, const CancellationToken &cancellation)
+{
+    RouteResult result;
+    result.criteria = criteria;
+
+    uint32_t source = graph.findNode(start);
+    uint32_t target = graph.findNode(end);
+    if (source == GraphSnapshot::INVALID_NODE || target == GraphSnapshot::INVALID_NODE)
+        return result;
+
+    if (!runDijkstra(graph, workspace, source, target, GraphSnapshot::parseCriterion(criteria), cancellation))
+    {
+        result.status = cancellation.stopStatus();
+        return result;
+    }
+
+    if (workspace.isReached(target))
+        extractPath(graph, workspace.parentNode.data(), workspace.parentEdge.data(), source, target, result);
+    return result;
+}
+
+bool RouteService::searchAll(const GraphSnapshot &graph, SearchWorkspace &workspace, uint32_t source,
+                             GraphSnapshot::Criterion criterion, const CancellationToken &cancellation)
+{
+    return runDijkstra(graph, workspace, source, GraphSnapshot::INVALID_NODE, criterion, cancellation);
+}
+
+RouteResult RouteService::answer(const GraphSnapshot &graph, const std::string &start, const std::string &end,
+                                 const std::string &criteria, const CancellationToken &cancellation)
+{
+    if (cancellation.shouldStop())
+    {
+        // Expired while queued; shed it without searching
+        RouteResult shed;
+        shed.criteria = criteria;
+        shed.status = cancellation.stopStatus();
+        return shed;
+    }
+
+    uint32_t source = graph.findNode(start);
+    uint32_t target = graph.findNode(end);
+    if (source == GraphSnapshot::INVALID_NODE || target == GraphSnapshot::INVALID_NODE)
+        return search(graph, threadWorkspace(), start, end, criteria, cancellation);
+
+    const GraphSnapshot::Criterion criterion = GraphSnapshot::parseCriterion(criteria);
+    bool shouldBuild = false;
+    std::shared_ptr<const ShortestPathTreeCache::Tree> tree =
+        treeCache.acquire(graph.getVersion(), source, criterion, shouldBuild);
+
+    if (!tree && shouldBuild)
+    {
+        SearchWorkspace &workspace = threadWorkspace();
+        if (!searchAll(graph, workspace, source, criterion, cancellation))
+        {
+            treeCache.abandon(graph.getVersion(), source, criterion);
+            RouteResult stopped;
+            stopped.criteria = criteria;
+            stopped.status = cancellation.stopStatus();
+            return stopped;
+        }
+
+        auto built = std::make_shared<ShortestPathTreeCache::Tree>();
+        built->graphVersion = graph.getVersion();
+        built->source = source;
+        built->criterion = criterion;
+        built->distance.assign(graph.getNodeCount(), ShortestPathTreeCache::Tree::UNREACHED);
+        built->parentNode.assign(graph.getNodeCount(), GraphSnapshot::INVALID_NODE);
+        built->parentEdge.assign(graph.getNodeCount(), GraphSnapshot::INVALID_NODE);
+        for (uint32_t v = 0; v < graph.getNodeCount(); ++v)
+        {
+            if (workspace.isReached(v))
+            {
+                built->distance[v] = workspace.distance[v];
+                built->parentNode[v] = workspace.parentNode[v];
+                built->parentEdge[v] = workspace.parentEdge[v];
+            }
+        }
+        tree = built;
+        treeCache.publish(built);
+    }
+
+    if (!tree)
+        return search(graph, threadWorkspace(), start, end, criteria, cancellation);
+
+    RouteResult result;
+    result.criteria = criteria;
+    if (tree->reaches(target))
+        extractPath(graph, tree->parentNode.data(), tree->parentEdge.data(), source, target, result);
+    return result;
+}
+
+void RouteService::extractPath(const GraphSnapshot &graph, const uint32_t *parentNode, const uint32_t *parentEdge,
+                               uint32_t source, uint32_t target, RouteResult &result)
+{
+    // Walk the parent edges back, summing every metric of the edges actually taken
+    for (uint32_t at = target; at != source; at = parentNode[at])
+    {
+        uint32_t e = parentEdge[at];
+        GraphSnapshot::EdgeRange edges = graph.getEdges(parentNode[at]);
+        result.path.push_back(graph.getName(at));
+        result.totalDistance += edges.getWeight(e, GraphSnapshot::Criterion::Distance);
+        result.totalTime += edges.getWeight(e, GraphSnapshot::Criterion::Time);
+        result.totalCost += edges.getWeight(e, GraphSnapshot::Criterion::Cost);
+        result.totalTransfers += edges.getWeight(e, GraphSnapshot::Criterion::Transfers);
+    }
+    result.path.push_back(graph.getName(source));
+    std::reverse(result.path.begin(), result.path.end());
+    result.isValid = true;
+    result.status = RouteStatus::Found;
+}
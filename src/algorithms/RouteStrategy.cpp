@@ -1,6 +1,41 @@
 #include "../../include/algorithms/RouteStrategy.h"
 #include <algorithm>
 
+void CancellationToken::cancel()
+{
+    if (!state)
+        return;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->cancelled.exchange(true, std::memory_order_relaxed))
+        return;
+    for (auto &callback : state->callbacks)
+        callback.second();
+}
+
+size_t CancellationToken::addCancelCallback(std::function<void()> onCancel) const
+{
+    if (!state)
+        return 0;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    size_t id = state->nextCallbackId++;
+    state->callbacks.emplace_back(id, std::move(onCancel));
+    if (state->cancelled.load(std::memory_order_relaxed))
+        state->callbacks.back().second();
+    return id;
+}
+
+void CancellationToken::removeCancelCallback(size_t id) const
+{
+    if (!state || id == 0)
+        return;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto found = std::find_if(state->callbacks.begin(), state->callbacks.end(),
+                              [id](const std::pair<size_t, std::function<void()>> &callback)
+                              { return callback.first == id; });
+    if (found != state->callbacks.end())
+        state->callbacks.erase(found);
+}
+
 std::vector<std::string> RouteStrategy::reconstructPath(const std::unordered_map<std::string, std::string> &predecessors,
                                                         const std::string &start,
                                                         const std::string &end) const
@@ -0,0 +1,85 @@
+#include "../../include/algorithms/SearchStats.h"
+#include <sstream>
+
+namespace
+{
+    uint64_t toMicros(double seconds)
+    {
+        return static_cast<uint64_t>(seconds * 1e6 + 0.5);
+    }
+}
+
+void SearchStatsCollector::record(const SearchStats &stats)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ++queries;
+    histograms[NodesSettled].record(stats.nodesSettled);
+    histograms[EdgesRelaxed].record(stats.edgesRelaxed);
+    histograms[HeapPushes].record(stats.heapPushes);
+    histograms[HeapPops].record(stats.heapPops);
+    histograms[StalePops].record(stats.stalePops);
+    histograms[PeakQueueSize].record(stats.peakQueueSize);
+    histograms[SetupMicros].record(toMicros(stats.phaseSeconds[SearchStats::Setup]));
+    histograms[SearchMicros].record(toMicros(stats.phaseSeconds[SearchStats::Search]));
+    histograms[PathBuildMicros].record(toMicros(stats.phaseSeconds[SearchStats::PathBuild]));
+    histograms[TotalMicros].record(toMicros(stats.totalSeconds()));
+}
+
+void SearchStatsCollector::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    queries = 0;
+    for (transport::utils::Histogram &histogram : histograms)
+        histogram.reset();
+}
+
+uint64_t SearchStatsCollector::getQueries() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queries;
+}
+
+transport::utils::Histogram SearchStatsCollector::getHistogram(Metric metric) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return histograms[metric];
+}
+
+std::string SearchStatsCollector::metricName(Metric metric)
+{
+    switch (metric)
+    {
+    case NodesSettled:
+        return "nodes_settled";
+    case EdgesRelaxed:
+        return "edges_relaxed";
+    case HeapPushes:
+        return "heap_pushes";
+    case HeapPops:
+        return "heap_pops";
+    case StalePops:
+        return "stale_pops";
+    case PeakQueueSize:
+        return "peak_queue_size";
+    case SetupMicros:
+        return "setup_us";
+    case SearchMicros:
+        return "search_us";
+    case PathBuildMicros:
+        return "path_build_us";
+    case TotalMicros:
+        return "total_us";
+    default:
+        return "unknown";
+    }
+}
+
+std::string SearchStatsCollector::report() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    out << "Search statistics over " << queries << " queries:\n";
+    for (int metric = 0; metric < METRIC_COUNT; ++metric)
+        out << "  " << metricName(static_cast<Metric>(metric)) << ": " << histograms[metric].summary() << "\n";
+    return out.str();
+}
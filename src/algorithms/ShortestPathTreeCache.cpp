@@ -0,0 +1,169 @@
+#include "../../include/algorithms/ShortestPathTreeCache.h"
+#include <algorithm>
+
+size_t ShortestPathTreeCache::Tree::getMemoryUsage() const
+{
+    return sizeof(Tree) + distance.capacity() * sizeof(long long) +
+           (parentNode.capacity() + parentEdge.capacity()) * sizeof(uint32_t);
+}
+
+ShortestPathTreeCache::ShortestPathTreeCache(size_t budget, unsigned threshold, std::chrono::milliseconds rateWindow)
+    : memoryBudget(budget), hotThreshold(std::max(1u, threshold)), window(rateWindow)
+{
+}
+
+std::shared_ptr<const ShortestPathTreeCache::Tree> ShortestPathTreeCache::acquire(uint64_t graphVersion, uint32_t source,
+                                                                                  GraphSnapshot::Criterion criterion,
+                                                                                  bool &shouldBuild)
+{
+    shouldBuild = false;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (graphVersion > currentVersion)
+        dropOlderVersionsLocked(graphVersion);
+    if (graphVersion < currentVersion || memoryBudget == 0)
+    {
+        // Query bound to a superseded snapshot; its trees are gone and not worth rebuilding
+        ++counters.misses;
+        return nullptr;
+    }
+
+    Key key{graphVersion, source, criterion};
+    auto found = slots.find(key);
+    if (found == slots.end())
+    {
+        if (slots.size() - lru.size() >= MAX_COUNTERS)
+        {
+            // Too many cold origins; forget their counts rather than grow without bound
+            for (auto it = slots.begin(); it != slots.end();)
+                it = (it->second.tree || it->second.building) ? std::next(it) : slots.erase(it);
+        }
+        found = slots.emplace(key, Slot()).first;
+        found->second.windowStart = std::chrono::steady_clock::now();
+    }
+
+    Slot &slot = found->second;
+    if (slot.tree)
+    {
+        lru.splice(lru.begin(), lru, slot.lruPosition);
+        ++counters.hits;
+        return slot.tree;
+    }
+
+    ++counters.misses;
+    if (slot.building)
+        return nullptr;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - slot.windowStart > window)
+    {
+        slot.windowStart = now;
+        slot.requests = 0;
+    }
+    if (++slot.requests >= hotThreshold)
+    {
+        slot.building = true;
+        shouldBuild = true;
+    }
+    return nullptr;
+}
+
+void ShortestPathTreeCache::publish(std::shared_ptr<const Tree> tree)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Key key{tree->graphVersion, tree->source, tree->criterion};
+    auto found = slots.find(key);
+    if (found == slots.end() || found->second.tree)
+        return; // Version was superseded while the tree was being built
+
+    size_t treeBytes = tree->getMemoryUsage();
+    if (treeBytes > memoryBudget)
+    {
+        found->second.building = false;
+        found->second.requests = 0;
+        return;
+    }
+
+    Slot &slot = found->second;
+    slot.building = false;
+    slot.tree = std::move(tree);
+    lru.push_front(key);
+    slot.lruPosition = lru.begin();
+    bytes += treeBytes;
+    ++counters.treesBuilt;
+    evictLocked();
+}
+
+void ShortestPathTreeCache::abandon(uint64_t graphVersion, uint32_t source, GraphSnapshot::Criterion criterion)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = slots.find(Key{graphVersion, source, criterion});
+    if (found != slots.end())
+    {
+        found->second.building = false;
+        found->second.requests = 0;
+    }
+}
+
+void ShortestPathTreeCache::dropOlderVersionsLocked(uint64_t graphVersion)
+{
+    for (auto it = slots.begin(); it != slots.end();)
+    {
+        if (it->first.graphVersion < graphVersion)
+        {
+            if (it->second.tree)
+            {
+                bytes -= it->second.tree->getMemoryUsage();
+                lru.erase(it->second.lruPosition);
+            }
+            it = slots.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    currentVersion = graphVersion;
+}
+
+void ShortestPathTreeCache::evictLocked()
+{
+    while (bytes > memoryBudget && !lru.empty())
+    {
+        auto found = slots.find(lru.back());
+        bytes -= found->second.tree->getMemoryUsage();
+        slots.erase(found);
+        lru.pop_back();
+        ++counters.evictions;
+    }
+}
+
+void ShortestPathTreeCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    slots.clear();
+    lru.clear();
+    bytes = 0;
+}
+
+void ShortestPathTreeCache::setMemoryBudget(size_t budget)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    memoryBudget = budget;
+    evictLocked();
+}
+
+void ShortestPathTreeCache::setHotThreshold(unsigned threshold)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    hotThreshold = std::max(1u, threshold);
+}
+
+ShortestPathTreeCache::Statistics ShortestPathTreeCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Statistics statistics = counters;
+    statistics.trees = lru.size();
+    statistics.bytes = bytes;
+    return statistics;
+}
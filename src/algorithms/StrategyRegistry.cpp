@@ -0,0 +1,66 @@
+#include "../../include/algorithms/StrategyRegistry.h"
+#include "../../include/algorithms/DeltaSteppingStrategy.h"
+#include "../../include/algorithms/DijkstraStrategy.h"
+
+StrategyRegistry &StrategyRegistry::instance()
+{
+    static StrategyRegistry registry;
+    return registry;
+}
+
+// Built-ins are registered here rather than by static objects in their own files,
+// which the linker may drop when the library is static
+StrategyRegistry::StrategyRegistry()
+{
+    factories.emplace_back(REFERENCE, []()
+                           { return std::make_unique<DijkstraStrategy>(); });
+    factories.emplace_back("delta_stepping", []()
+                           { return std::make_unique<DeltaSteppingStrategy>(); });
+}
+
+bool StrategyRegistry::add(const std::string &name, Factory factory)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &entry : factories)
+    {
+        if (entry.first == name)
+            return false;
+    }
+    factories.emplace_back(name, std::move(factory));
+    return true;
+}
+
+std::unique_ptr<RouteStrategy> StrategyRegistry::create(const std::string &name) const
+{
+    Factory factory;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &entry : factories)
+        {
+            if (entry.first == name)
+                factory = entry.second;
+        }
+    }
+    // Outside the lock, so a factory may itself use the registry
+    return factory ? factory() : nullptr;
+}
+
+bool StrategyRegistry::contains(const std::string &name) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &entry : factories)
+    {
+        if (entry.first == name)
+            return true;
+    }
+    return false;
+}
+
+std::vector<std::string> StrategyRegistry::getNames() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> names;
+    for (const auto &entry : factories)
+        names.push_back(entry.first);
+    return names;
+}
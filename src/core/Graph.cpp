@@ -8,16 +8,23 @@
 #include <limits>
 #include <unordered_map>
 #include <unordered_set>
+#include <atomic>
+
+namespace
+{
+    // Shared by all graphs so that a version number is never reused
+    std::atomic<uint64_t> nextGraphVersion{1};
+}
 
 // Constructor default
-Graph::Graph()
+Graph::Graph() : version(allocateVersion())
 {
     std::cout << "Graph initialized with adjacency list representation." << std::endl;
 }
 
 // Copy constructor
 Graph::Graph(const Graph &other)
-    : adjacency_list(other.adjacency_list), nodes(other.nodes) {}
+    : nodes(other.nodes), adjacency_list(other.adjacency_list), version(other.version) {}
 
 // Assignment operator
 Graph &Graph::operator=(const Graph &other)
@@ -26,6 +33,7 @@ Graph &Graph::operator=(const Graph &other)
     {
         adjacency_list = other.adjacency_list;
         nodes = other.nodes;
+        version = other.version;
     }
     return *this;
 }
@@ -51,6 +59,7 @@ bool Graph::addNode(const std::string &name, double latitude, double longitude)
         Node newNode(name, latitude, longitude);
         nodes[name] = newNode;
         adjacency_list[name] = std::list<Edge>();
+        touch();
 
         std::cout << "Node '" << name << "' added successfully." << std::endl;
         return true;
@@ -85,6 +94,7 @@ bool Graph::addEdge(const std::string &source, const std::string &destination,
     {
         Edge newEdge(source, destination, distance, time, cost, transfers, transport_mode);
         adjacency_list[source].push_back(newEdge);
+        touch();
 
         std::cout << "Edge added: " << source << " -> " << destination << std::endl;
         return true;
@@ -96,6 +106,121 @@ bool Graph::addEdge(const std::string &source, const std::string &destination,
     }
 }
 
+size_t Graph::addNodes(const std::vector<Node> &newNodes)
+{
+    size_t added = 0;
+    for (const Node &node : newNodes)
+    {
+        if (!nodes.emplace(node.getName(), node).second)
+            continue;
+        adjacency_list.emplace(node.getName(), std::list<Edge>());
+        added++;
+    }
+    if (added > 0)
+        touch();
+    return added;
+}
+
+size_t Graph::addEdges(const std::vector<Edge> &newEdges)
+{
+    size_t added = 0;
+    for (const Edge &edge : newEdges)
+    {
+        const std::string source = edge.getSource();
+        const std::string destination = edge.getDestination();
+        if (!hasNode(source) || !hasNode(destination) || hasEdge(source, destination))
+            continue;
+        adjacency_list[source].push_back(edge);
+        added++;
+    }
+    if (added > 0)
+        touch();
+    return added;
+}
+
+size_t Graph::updateNodes(const std::vector<Node> &changedNodes)
+{
+    size_t updated = 0;
+    for (const Node &node : changedNodes)
+    {
+        auto found = nodes.find(node.getName());
+        if (found == nodes.end())
+            continue;
+        found->second.setLatitude(node.getLatitude());
+        found->second.setLongitude(node.getLongitude());
+        updated++;
+    }
+    if (updated > 0)
+        touch();
+    return updated;
+}
+
+size_t Graph::updateEdges(const std::vector<Edge> &changedEdges)
+{
+    size_t updated = 0;
+    for (const Edge &edge : changedEdges)
+    {
+        auto list = adjacency_list.find(edge.getSource());
+        if (list == adjacency_list.end())
+            continue;
+        const std::string destination = edge.getDestination();
+        auto it = std::find_if(list->second.begin(), list->second.end(),
+                               [&destination](const Edge &existing)
+                               { return existing.getDestination() == destination; });
+        if (it == list->second.end())
+            continue;
+        *it = edge;
+        updated++;
+    }
+    if (updated > 0)
+        touch();
+    return updated;
+}
+
+size_t Graph::removeNodes(const std::vector<std::string> &names)
+{
+    std::unordered_set<std::string> removed;
+    for (const std::string &name : names)
+    {
+        if (nodes.erase(name) == 0)
+            continue;
+        adjacency_list.erase(name);
+        removed.insert(name);
+    }
+    if (removed.empty())
+        return 0;
+
+    for (auto &pair : adjacency_list)
+    {
+        pair.second.remove_if([&removed](const Edge &edge)
+                              { return removed.count(edge.getDestination()) > 0; });
+    }
+    touch();
+    return removed.size();
+}
+
+size_t Graph::removeEdges(const std::vector<std::pair<std::string, std::string>> &endpoints)
+{
+    size_t removed = 0;
+    for (const auto &endpoint : endpoints)
+    {
+        auto list = adjacency_list.find(endpoint.first);
+        if (list == adjacency_list.end())
+            continue;
+        const std::string &destination = endpoint.second;
+        auto it = std::find_if(list->second.begin(), list->second.end(),
+                               [&destination](const Edge &edge)
+                               { return edge.getDestination() == destination; });
+        if (it == list->second.end())
+            continue;
+        list->second.erase(it);
+        removed++;
+    }
+    if (removed > 0)
+        touch();
+    return removed;
+}
+
 // Menghapus node dari graf
 bool Graph::removeNode(const std::string &name)
 {
@@ -116,6 +241,7 @@ bool Graph::removeNode(const std::string &name)
     // Hapus node dan adjacency list-nya
     adjacency_list.erase(name);
     nodes.erase(name);
+    touch();
 
     std::cout << "Node '" << name << "' removed successfully." << std::endl;
     return true;
@@ -140,6 +266,7 @@ bool Graph::removeEdge(const std::string &source, const std::string &destination
     if (it != edges.end())
     {
         edges.erase(it);
+        touch();
         std::cout << "Edge removed: " << source << " -> " << destination << std::endl;
         return true;
     }
@@ -163,6 +290,7 @@ bool Graph::updateNode(const std::string &name, double latitude, double longitud
     {
         nodes[name].setLatitude(latitude);
         nodes[name].setLongitude(longitude);
+        touch();
 
         std::cout << "Node '" << name << "' updated successfully." << std::endl;
         return true;
@@ -200,6 +328,7 @@ bool Graph::updateEdge(const std::string &source, const std::string &destination
         it->setCost(cost);
         it->setTransfers(transfers);
         it->setTransportMode(transport_mode);
+        touch();
 
         std::cout << "Edge updated: " << source << " -> " << destination << std::endl;
         return true;
@@ -332,6 +461,14 @@ std::vector<std::string> Graph::getNodeNames() const
     return names;
 }
 
+void Graph::forEachNode(const std::function<void(const Node &)> &visit) const
+{
+    for (const auto &node_pair : nodes)
+    {
+        visit(node_pair.second);
+    }
+}
+
 // Get nodes as vector - for compatibility
 std::vector<Node> Graph::getNodes() const
 {
@@ -487,6 +624,7 @@ bool Graph::loadFromCSV(const std::string &filename)
     // Clear existing data
     adjacency_list.clear();
     nodes.clear();
+    touch();
 
     std::string line;
     bool first_line = true;
@@ -643,5 +781,21 @@ void Graph::clear()
 {
     adjacency_list.clear();
     nodes.clear();
+    touch();
     std::cout << "Graph cleared successfully." << std::endl;
 }
+
+uint64_t Graph::getVersion() const
+{
+    return version;
+}
+
+uint64_t Graph::allocateVersion()
+{
+    return nextGraphVersion.fetch_add(1);
+}
+
+void Graph::touch()
+{
+    version = allocateVersion();
+}
@@ -0,0 +1,389 @@
+#include "include/core/GraphSnapshot.h"
+#include <algorithm>
+
+GraphSnapshot::GraphSnapshot(const Graph &graph) : version(graph.getVersion())
+{
+    auto modeTable = std::make_shared<std::vector<std::string>>();
+    std::unordered_map<std::string, uint16_t> modeIds;
+
+    std::vector<Node> graphNodes = graph.getNodes();
+    nodeCount = activeNodeCount = static_cast<uint32_t>(graphNodes.size());
+
+    // About one block of names per shard, so an index edit copies as little as a block edit
+    size_t shardCount = MIN_INDEX_SHARDS;
+    while (shardCount * BLOCK_SIZE < graphNodes.size())
+        shardCount *= 2;
+    std::vector<std::shared_ptr<NameIndex>> shards(shardCount);
+    for (auto &shard : shards)
+        shard = std::make_shared<NameIndex>();
+    indexShards.assign(shards.begin(), shards.end());
+
+    std::unordered_map<std::string, uint32_t> ids; // Whole index, only while building
+    ids.reserve(graphNodes.size());
+    std::shared_ptr<NodeBlock> currentNodes;
+    for (const Node &node : graphNodes)
+    {
+        uint32_t id = static_cast<uint32_t>(ids.size());
+        if ((id & (BLOCK_SIZE - 1)) == 0)
+        {
+            currentNodes = std::make_shared<NodeBlock>();
+            nodeBlocks.push_back(currentNodes);
+        }
+        ids.emplace(node.getName(), id);
+        shards[shardOf(node.getName())]->emplace(node.getName(), id);
+        currentNodes->names.push_back(node.getName());
+        currentNodes->latitudes.push_back(node.getLatitude());
+        currentNodes->longitudes.push_back(node.getLongitude());
+        currentNodes->active.push_back(1);
+    }
+
+    std::shared_ptr<Block> current;
+    for (uint32_t id = 0; id < nodeCount; ++id)
+    {
+        if ((id & (BLOCK_SIZE - 1)) == 0)
+        {
+            current = std::make_shared<Block>();
+            blocks.push_back(current);
+        }
+
+        for (const Edge &edge : graph.getEdgesFrom(getName(id)))
+        {
+            auto target = ids.find(edge.getDestination());
+            if (target == ids.end())
+                continue;
+
+            auto mode = modeIds.emplace(edge.getTransportMode(), static_cast<uint16_t>(modeTable->size()));
+            if (mode.second)
+                modeTable->push_back(edge.getTransportMode());
+
+            current->targets.push_back(target->second);
+            current->weights[static_cast<int>(Criterion::Distance)].push_back(edge.getDistance());
+            current->weights[static_cast<int>(Criterion::Time)].push_back(edge.getTime());
+            current->weights[static_cast<int>(Criterion::Cost)].push_back(edge.getCost());
+            current->weights[static_cast<int>(Criterion::Transfers)].push_back(edge.getTransfers());
+            current->modes.push_back(mode.first->second);
+            ++edgeCount;
+        }
+        current->offsets.push_back(static_cast<uint32_t>(current->targets.size()));
+    }
+
+    modeNames = modeTable;
+}
+
+GraphSnapshot::Criterion GraphSnapshot::parseCriterion(const std::string &criteria)
+{
+    if (criteria == "distance")
+        return Criterion::Distance;
+    if (criteria == "cost")
+        return Criterion::Cost;
+    if (criteria == "transfers")
+        return Criterion::Transfers;
+    return Criterion::Time;
+}
+
+std::string GraphSnapshot::criterionName(Criterion criterion)
+{
+    switch (criterion)
+    {
+    case Criterion::Distance:
+        return "distance";
+    case Criterion::Cost:
+        return "cost";
+    case Criterion::Transfers:
+        return "transfers";
+    case Criterion::Time:
+        break;
+    }
+    return "time";
+}
+
+uint32_t GraphSnapshot::findNode(const std::string &name) const
+{
+    const NameIndex &shard = *indexShards[shardOf(name)];
+    auto it = shard.find(name);
+    return it != shard.end() ? it->second : INVALID_NODE;
+}
+
+GraphSnapshot::EdgeRange GraphSnapshot::getEdges(uint32_t node) const
+{
+    const Block &block = *blocks[node >> BLOCK_BITS];
+    uint32_t local = node & (BLOCK_SIZE - 1);
+    uint32_t begin = block.offsets[local];
+
+    EdgeRange range;
+    range.targets = block.targets.data() + begin;
+    for (int c = 0; c < CRITERION_COUNT; ++c)
+        range.weights[c] = block.weights[c].data() + begin;
+    range.modes = block.modes.data() + begin;
+    range.count = block.offsets[local + 1] - begin;
+    return range;
+}
+
+size_t GraphSnapshot::getMemoryUsage() const
+{
+    size_t bytes = sizeof(*this) + blocks.capacity() * sizeof(blocks[0]) +
+                   nodeBlocks.capacity() * sizeof(nodeBlocks[0]) + indexShards.capacity() * sizeof(indexShards[0]);
+    for (const auto &nodeBlock : nodeBlocks)
+    {
+        bytes += sizeof(NodeBlock);
+        for (const std::string &name : nodeBlock->names)
+            bytes += 2 * (name.capacity() + sizeof(std::string)) + sizeof(uint32_t) + 2 * sizeof(void *);
+        bytes += (nodeBlock->latitudes.capacity() + nodeBlock->longitudes.capacity()) * sizeof(double) +
+                 nodeBlock->active.capacity();
+    }
+    for (const auto &shard : indexShards)
+        bytes += sizeof(NameIndex) + shard->bucket_count() * sizeof(void *);
+    for (const auto &block : blocks)
+    {
+        bytes += sizeof(Block) + (block->offsets.capacity() + block->targets.capacity()) * sizeof(uint32_t);
+        for (const auto &criterionWeights : block->weights)
+            bytes += criterionWeights.capacity() * sizeof(int);
+        bytes += block->modes.capacity() * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+bool GraphSnapshot::sharesBlockWith(const GraphSnapshot &other, uint32_t node) const
+{
+    uint32_t block = node >> BLOCK_BITS;
+    return block < blocks.size() && block < other.blocks.size() && blocks[block] == other.blocks[block];
+}
+
+bool GraphSnapshot::sharesNodeBlockWith(const GraphSnapshot &other, uint32_t node) const
+{
+    uint32_t block = node >> BLOCK_BITS;
+    return block < nodeBlocks.size() && block < other.nodeBlocks.size() &&
+           nodeBlocks[block] == other.nodeBlocks[block];
+}
+
+// ============================================================================
+// Editor
+// ============================================================================
+
+GraphSnapshot::Editor::Editor(const GraphSnapshot &base)
+    : draft(std::shared_ptr<GraphSnapshot>(new GraphSnapshot(base))),
+      ownedBlocks(base.blocks.size()),
+      ownedNodeBlocks(base.nodeBlocks.size()),
+      ownedShards(base.indexShards.size())
+{
+}
+
+GraphSnapshot::NodeBlock &GraphSnapshot::Editor::mutableNodeBlock(uint32_t node)
+{
+    uint32_t index = node >> BLOCK_BITS;
+    if (!ownedNodeBlocks[index])
+    {
+        ownedNodeBlocks[index] = std::make_shared<NodeBlock>(*draft->nodeBlocks[index]);
+        draft->nodeBlocks[index] = ownedNodeBlocks[index];
+    }
+    return *ownedNodeBlocks[index];
+}
+
+GraphSnapshot::NameIndex &GraphSnapshot::Editor::mutableShard(const std::string &name)
+{
+    size_t index = draft->shardOf(name);
+    if (!ownedShards[index])
+    {
+        ownedShards[index] = std::make_shared<NameIndex>(*draft->indexShards[index]);
+        draft->indexShards[index] = ownedShards[index];
+    }
+    return *ownedShards[index];
+}
+
+GraphSnapshot::Block &GraphSnapshot::Editor::mutableBlock(uint32_t node)
+{
+    uint32_t index = node >> BLOCK_BITS;
+    if (!ownedBlocks[index])
+    {
+        ownedBlocks[index] = std::make_shared<Block>(*draft->blocks[index]);
+        draft->blocks[index] = ownedBlocks[index];
+        ++copiedBlocks;
+    }
+    return *ownedBlocks[index];
+}
+
+uint16_t GraphSnapshot::Editor::internMode(const std::string &mode)
+{
+    const auto &names = *draft->modeNames;
+    auto it = std::find(names.begin(), names.end(), mode);
+    if (it != names.end())
+        return static_cast<uint16_t>(it - names.begin());
+
+    if (!ownedModes)
+    {
+        ownedModes = std::make_shared<std::vector<std::string>>(names);
+        draft->modeNames = ownedModes;
+    }
+    ownedModes->push_back(mode);
+    return static_cast<uint16_t>(ownedModes->size() - 1);
+}
+
+uint32_t GraphSnapshot::Editor::findEdge(uint32_t source, uint32_t target) const
+{
+    EdgeRange range = draft->getEdges(source);
+    for (uint32_t i = 0; i < range.count; ++i)
+    {
+        if (range.targets[i] == target)
+            return i;
+    }
+    return INVALID_NODE;
+}
+
+void GraphSnapshot::Editor::setEdge(uint32_t source, uint32_t position, uint32_t target,
+                                    const int values[CRITERION_COUNT], uint16_t mode)
+{
+    Block &block = mutableBlock(source);
+    uint32_t at = block.offsets[source & (BLOCK_SIZE - 1)] + position;
+    block.targets[at] = target;
+    for (int c = 0; c < CRITERION_COUNT; ++c)
+        block.weights[c][at] = values[c];
+    block.modes[at] = mode;
+}
+
+void GraphSnapshot::Editor::insertEdge(uint32_t source, uint32_t target,
+                                       const int values[CRITERION_COUNT], uint16_t mode)
+{
+    Block &block = mutableBlock(source);
+    uint32_t local = source & (BLOCK_SIZE - 1);
+    uint32_t at = block.offsets[local + 1];
+    block.targets.insert(block.targets.begin() + at, target);
+    for (int c = 0; c < CRITERION_COUNT; ++c)
+        block.weights[c].insert(block.weights[c].begin() + at, values[c]);
+    block.modes.insert(block.modes.begin() + at, mode);
+    for (size_t k = local + 1; k < block.offsets.size(); ++k)
+        ++block.offsets[k];
+    ++draft->edgeCount;
+}
+
+void GraphSnapshot::Editor::eraseEdge(uint32_t source, uint32_t position)
+{
+    Block &block = mutableBlock(source);
+    uint32_t local = source & (BLOCK_SIZE - 1);
+    uint32_t at = block.offsets[local] + position;
+    block.targets.erase(block.targets.begin() + at);
+    for (int c = 0; c < CRITERION_COUNT; ++c)
+        block.weights[c].erase(block.weights[c].begin() + at);
+    block.modes.erase(block.modes.begin() + at);
+    for (size_t k = local + 1; k < block.offsets.size(); ++k)
+        --block.offsets[k];
+    --draft->edgeCount;
+}
+
+bool GraphSnapshot::Editor::addNode(const std::string &name, double latitude, double longitude)
+{
+    if (draft->findNode(name) != INVALID_NODE)
+        return false;
+
+    uint32_t id = draft->nodeCount;
+    if ((id & (BLOCK_SIZE - 1)) == 0)
+    {
+        auto block = std::make_shared<Block>();
+        draft->blocks.push_back(block);
+        ownedBlocks.push_back(block);
+        auto nodeBlock = std::make_shared<NodeBlock>();
+        draft->nodeBlocks.push_back(nodeBlock);
+        ownedNodeBlocks.push_back(nodeBlock);
+    }
+
+    NodeBlock &nodeBlock = mutableNodeBlock(id);
+    nodeBlock.names.push_back(name);
+    nodeBlock.latitudes.push_back(latitude);
+    nodeBlock.longitudes.push_back(longitude);
+    nodeBlock.active.push_back(1);
+    mutableShard(name).emplace(name, id);
+    ++draft->nodeCount;
+    ++draft->activeNodeCount;
+
+    Block &block = mutableBlock(id);
+    block.offsets.push_back(block.offsets.back());
+    return true;
+}
+
+bool GraphSnapshot::Editor::updateNode(const std::string &name, double latitude, double longitude)
+{
+    uint32_t id = draft->findNode(name);
+    if (id == INVALID_NODE)
+        return false;
+
+    NodeBlock &nodeBlock = mutableNodeBlock(id);
+    nodeBlock.latitudes[id & (BLOCK_SIZE - 1)] = latitude;
+    nodeBlock.longitudes[id & (BLOCK_SIZE - 1)] = longitude;
+    return true;
+}
+
+bool GraphSnapshot::Editor::removeNode(const std::string &name)
+{
+    uint32_t id = draft->findNode(name);
+    if (id == INVALID_NODE)
+        return false;
+
+    // Drop inbound edges; blocks without any are left shared
+    for (uint32_t source = 0; source < draft->getNodeCount(); ++source)
+    {
+        uint32_t position = findEdge(source, id);
+        if (position != INVALID_NODE)
+            eraseEdge(source, position);
+    }
+    while (draft->getEdges(id).count > 0)
+        eraseEdge(id, 0);
+
+    mutableShard(name).erase(name);
+    mutableNodeBlock(id).active[id & (BLOCK_SIZE - 1)] = 0;
+    --draft->activeNodeCount;
+    return true;
+}
+
+bool GraphSnapshot::Editor::addEdge(const std::string &source, const std::string &destination,
+                                    int distance, int time, int cost, int transfers, const std::string &mode)
+{
+    uint32_t from = draft->findNode(source);
+    uint32_t to = draft->findNode(destination);
+    if (from == INVALID_NODE || to == INVALID_NODE || findEdge(from, to) != INVALID_NODE)
+        return false;
+    if (distance < 0 || time < 0 || cost < 0 || transfers < 0)
+        return false;
+
+    const int values[CRITERION_COUNT] = {distance, time, cost, transfers};
+    insertEdge(from, to, values, internMode(mode));
+    return true;
+}
+
+bool GraphSnapshot::Editor::updateEdge(const std::string &source, const std::string &destination,
+                                       int distance, int time, int cost, int transfers, const std::string &mode)
+{
+    uint32_t from = draft->findNode(source);
+    uint32_t to = draft->findNode(destination);
+    if (from == INVALID_NODE || to == INVALID_NODE)
+        return false;
+    uint32_t position = findEdge(from, to);
+    if (position == INVALID_NODE || distance < 0 || time < 0 || cost < 0 || transfers < 0)
+        return false;
+
+    const int values[CRITERION_COUNT] = {distance, time, cost, transfers};
+    setEdge(from, position, to, values, internMode(mode));
+    return true;
+}
+
+bool GraphSnapshot::Editor::removeEdge(const std::string &source, const std::string &destination)
+{
+    uint32_t from = draft->findNode(source);
+    uint32_t to = draft->findNode(destination);
+    if (from == INVALID_NODE || to == INVALID_NODE)
+        return false;
+    uint32_t position = findEdge(from, to);
+    if (position == INVALID_NODE)
+        return false;
+
+    eraseEdge(from, position);
+    return true;
+}
+
+std::shared_ptr<const GraphSnapshot> GraphSnapshot::Editor::publish()
+{
+    ownedModes.reset();
+    ownedBlocks.clear();
+    ownedNodeBlocks.clear();
+    ownedShards.clear();
+    draft->version = Graph::allocateVersion();
+    return std::move(draft);
+}
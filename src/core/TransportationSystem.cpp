@@ -1,20 +1,30 @@
 #include "include/core/TransportationSystem.h"
 #include "include/io/ConfigManager.h"
 #include "include/io/CSVHandler.h"
-#include "include/algorithms/DijkstraStrategy.h"
-// #include "include/algorithms/AStarStrategy.h"
 #include "include/algorithms/PathFinder.h"
+#include "include/algorithms/StrategyRegistry.h"
+#include "include/algorithms/RouteService.h"
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
+namespace
+{
+    const char *const QUERY_OUTCOMES[] = {"found", "not_found", "timed_out", "cancelled", "error"};
+}
+
 TransportationSystem::TransportationSystem()
 {
+    registerMetrics();
     initialize();
 }
 
 TransportationSystem::~TransportationSystem()
 {
-    // Clean up resources
+    stopMetricsServer();
+
+    // Let a background compaction finish before the journal goes away
+    disableJournal();
 }
 
 bool TransportationSystem::initialize()
@@ -28,7 +38,7 @@ bool TransportationSystem::initialize(const std::string &dataFile)
     std::cout << "Initializing Transportation System with data file: " << dataFile << std::endl;
 
     // Load the transportation network
-    if (!graph.loadFromCSV(dataFile))
+    if (!loadGraphFromCSV(dataFile))
     {
         std::cerr << "Failed to load transportation network data from: " << dataFile << std::endl;
         return false;
@@ -45,7 +55,9 @@ bool TransportationSystem::isInitialized() const
 
 void TransportationSystem::reset()
 {
+    disableJournal();
     graph = Graph(); // Reset the graph
+    updateGraphMetrics();
     locationTypes.clear();
     edgeTransportModes.clear();
     lastError.clear();
@@ -63,6 +75,86 @@ bool TransportationSystem::loadConfig(const std::string &configPath)
         return false;
     }
 
+    // Worker count for the concurrent query service; takes effect when it is next created
+    routeServiceThreads = RouteService::threadCountFromConfig(configPath);
+    deltaStepping.reset(); // Runs on the service's scheduler
+    routeService.reset();
+
+    // Shortest path tree cache of the route service
+    try
+    {
+        std::string treeBudgetValue = configManager.getValue("spt_cache_mb");
+        if (!treeBudgetValue.empty())
+            treeCacheBudget = static_cast<size_t>(std::max(0, std::stoi(treeBudgetValue))) * 1024 * 1024;
+        std::string thresholdValue = configManager.getValue("spt_hot_threshold");
+        if (!thresholdValue.empty())
+            treeHotThreshold = static_cast<unsigned>(std::max(1, std::stoi(thresholdValue)));
+    }
+    catch (const std::exception &)
+    {
+        std::cerr << "Ignoring invalid shortest path tree cache settings" << std::endl;
+    }
+
+    // Route cache memory budget
+    std::string cacheValue = configManager.getValue("route_cache_mb");
+    if (!cacheValue.empty())
+    {
+        try
+        {
+            setRouteCacheBudget(static_cast<size_t>(std::max(0, std::stoi(cacheValue))) * 1024 * 1024);
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "Ignoring invalid route_cache_mb: " << cacheValue << std::endl;
+        }
+    }
+
+    // Per-query search statistics
+    std::string statsValue = configManager.getValue("search_stats");
+    if (!statsValue.empty())
+    {
+        setSearchStatsEnabled(statsValue == "true" || statsValue == "1" || statsValue == "yes");
+    }
+
+    // Binary trace of route service queries
+    std::string traceValue = configManager.getValue("trace_file");
+    if (!traceValue.empty() && !setTraceFile(traceValue))
+    {
+        std::cerr << "Ignoring trace_file: " << lastError << std::endl;
+    }
+
+    // Prometheus endpoint on the loopback interface
+    std::string metricsPortValue = configManager.getValue("metrics_port");
+    if (!metricsPortValue.empty())
+    {
+        try
+        {
+            int port = std::stoi(metricsPortValue);
+            if (port < 0 || port > 65535)
+                throw std::out_of_range(metricsPortValue);
+            if (!startMetricsServer(static_cast<uint16_t>(port)))
+                std::cerr << "Ignoring metrics_port: " << lastError << std::endl;
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "Ignoring invalid metrics_port: " << metricsPortValue << std::endl;
+        }
+    }
+
+    // Search deadline per query
+    std::string timeoutValue = configManager.getValue("timeout_seconds");
+    if (!timeoutValue.empty())
+    {
+        try
+        {
+            queryTimeout = std::chrono::seconds(std::stoi(timeoutValue));
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "Ignoring invalid timeout_seconds: " << timeoutValue << std::endl;
+        }
+    }
+
     // Get data file path from config
     std::string dataFilePath = configManager.getValue("data_dir");
     if (dataFilePath.empty())
@@ -75,7 +167,7 @@ bool TransportationSystem::loadConfig(const std::string &configPath)
     }
 
     // Load the transportation network
-    if (!graph.loadFromCSV(dataFilePath))
+    if (!loadGraphFromCSV(dataFilePath))
     {
         std::cerr << "Failed to load transportation network data." << std::endl;
         return false;
@@ -85,19 +177,50 @@ bool TransportationSystem::loadConfig(const std::string &configPath)
     return true;
 }
 
-Graph &TransportationSystem::getNetwork()
+const Graph &TransportationSystem::getNetwork() const
 {
     return graph;
 }
 
-const Graph &TransportationSystem::getNetwork() const
+Graph *TransportationSystem::getMutableNetwork()
 {
-    return graph;
+    if (journal)
+    {
+        lastError = "The network cannot be edited directly while journaling is enabled";
+        return nullptr;
+    }
+
+    // Edits made through this pointer bump the graph version, which getRouteService() checks
+    return &graph;
 }
 
 bool TransportationSystem::loadNetworkData(const std::string &filename)
 {
-    return graph.loadFromCSV(filename);
+    return loadGraphFromCSV(filename);
+}
+
+bool TransportationSystem::loadGraphFromCSV(const std::string &filename)
+{
+    uint64_t versionBefore = graph.getVersion();
+    auto started = std::chrono::steady_clock::now();
+    bool loaded = graph.loadFromCSV(filename);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+
+    // The journal's snapshot and logs describe the network that was just replaced;
+    // fold the new one into a fresh snapshot, or stop journaling if that fails
+    if (journal && graph.getVersion() != versionBefore && !compactJournal(false))
+    {
+        std::cerr << lastError << std::endl;
+        disableJournal();
+    }
+
+    metrics.histogram("transport_network_load_duration_seconds", "Time to load the network", {{"source", "csv"}})
+        .record(static_cast<uint64_t>(elapsed.count()));
+    if (!loaded)
+        metrics.counter("transport_network_load_failures_total", "Network loads that failed", {{"source", "csv"}})
+            .increment();
+    updateGraphMetrics();
+    return loaded;
 }
 
 bool TransportationSystem::saveNetworkData(const std::string &filename) const
@@ -126,6 +249,13 @@ bool TransportationSystem::addLocation(const std::string &name, double latitude,
     // Store the location type (optional feature)
     locationTypes[name] = type;
 
+    NetworkJournal::Mutation mutation;
+    mutation.operation = NetworkJournal::Operation::AddNode;
+    mutation.source = name;
+    mutation.latitude = latitude;
+    mutation.longitude = longitude;
+    recordMutation(mutation);
+
     return true;
 }
 
@@ -141,11 +271,42 @@ bool TransportationSystem::removeLocation(const std::string &name)
     if (success)
     {
         locationTypes.erase(name);
+
+        NetworkJournal::Mutation mutation;
+        mutation.operation = NetworkJournal::Operation::RemoveNode;
+        mutation.source = name;
+        recordMutation(mutation);
     }
 
     return success;
 }
 
+bool TransportationSystem::updateLocation(const std::string &name, double newLatitude,
+                                          double newLongitude, const std::string &newType)
+{
+    if (!graph.hasNode(name))
+    {
+        lastError = "Location '" + name + "' does not exist";
+        return false;
+    }
+
+    if (!graph.updateNode(name, newLatitude, newLongitude))
+    {
+        lastError = "Failed to update location '" + name + "'";
+        return false;
+    }
+
+    locationTypes[name] = newType;
+
+    NetworkJournal::Mutation mutation;
+    mutation.operation = NetworkJournal::Operation::UpdateNode;
+    mutation.source = name;
+    mutation.latitude = newLatitude;
+    mutation.longitude = newLongitude;
+    recordMutation(mutation);
+    return true;
+}
+
 // Add a new route between two locations
 bool TransportationSystem::addRoute(const std::string &source, const std::string &destination,
                                     double distance, int time, double cost,
@@ -176,15 +337,153 @@ bool TransportationSystem::addRoute(const std::string &source, const std::string
     // Store the transport mode (optional feature)
     edgeTransportModes[source + "-" + destination] = mode;
 
+    NetworkJournal::Mutation mutation;
+    mutation.operation = NetworkJournal::Operation::AddEdge;
+    mutation.source = source;
+    mutation.destination = destination;
+    mutation.distance = static_cast<int>(distance);
+    mutation.time = time;
+    mutation.cost = static_cast<int>(cost);
+    mutation.transfers = transfers;
+    mutation.mode = mode;
+    recordMutation(mutation);
+
+    return true;
+}
+
+bool TransportationSystem::removeRoute(const std::string &source, const std::string &destination)
+{
+    if (!graph.removeEdge(source, destination))
+    {
+        lastError = "No route from '" + source + "' to '" + destination + "'";
+        return false;
+    }
+
+    edgeTransportModes.erase(source + "-" + destination);
+
+    NetworkJournal::Mutation mutation;
+    mutation.operation = NetworkJournal::Operation::RemoveEdge;
+    mutation.source = source;
+    mutation.destination = destination;
+    recordMutation(mutation);
+    return true;
+}
+
+bool TransportationSystem::updateRoute(const std::string &source, const std::string &destination,
+                                       double distance, int time, double cost, int transfers,
+                                       const std::string &mode)
+{
+    if (!graph.hasEdge(source, destination))
+    {
+        lastError = "No route from '" + source + "' to '" + destination + "'";
+        return false;
+    }
+
+    if (!graph.updateEdge(source, destination, static_cast<int>(distance), time,
+                          static_cast<int>(cost), transfers, mode))
+    {
+        lastError = "Failed to update route from '" + source + "' to '" + destination + "'";
+        return false;
+    }
+
+    edgeTransportModes[source + "-" + destination] = mode;
+
+    NetworkJournal::Mutation mutation;
+    mutation.operation = NetworkJournal::Operation::UpdateEdge;
+    mutation.source = source;
+    mutation.destination = destination;
+    mutation.distance = static_cast<int>(distance);
+    mutation.time = time;
+    mutation.cost = static_cast<int>(cost);
+    mutation.transfers = transfers;
+    mutation.mode = mode;
+    recordMutation(mutation);
+    return true;
+}
+
+bool TransportationSystem::enableJournal(const std::string &basePath)
+{
+    disableJournal();
+
+    auto opened = std::make_unique<NetworkJournal>(basePath);
+    auto started = std::chrono::steady_clock::now();
+    bool loaded = opened->open(graph);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    updateGraphMetrics();
+    if (!loaded)
+    {
+        metrics.counter("transport_network_load_failures_total", "Network loads that failed", {{"source", "journal"}})
+            .increment();
+        lastError = "Failed to open journal: " + opened->getLastError();
+        return false;
+    }
+    metrics.histogram("transport_network_load_duration_seconds", "Time to load the network", {{"source", "journal"}})
+        .record(static_cast<uint64_t>(elapsed.count()));
+
+    journal = std::move(opened);
+    return true;
+}
+
+bool TransportationSystem::compactJournal(bool background)
+{
+    if (!journal)
+    {
+        lastError = "Journaling is not enabled";
+        return false;
+    }
+
+    if (!journal->compact(graph, background))
+    {
+        lastError = "Journal compaction failed: " + journal->getLastError();
+        return false;
+    }
     return true;
 }
 
+void TransportationSystem::disableJournal()
+{
+    if (journal)
+    {
+        journal->waitForCompaction();
+        journal.reset();
+    }
+}
+
+bool TransportationSystem::isJournalEnabled() const
+{
+    return journal != nullptr;
+}
+
+void TransportationSystem::recordMutation(const NetworkJournal::Mutation &mutation)
+{
+    updateGraphMetrics();
+    if (!journal)
+        return;
+
+    // The graph already holds the edit, so a failed append is reported but not undone
+    if (!journal->append(mutation))
+    {
+        lastError = "Journal append failed: " + journal->getLastError();
+        std::cerr << lastError << std::endl;
+        return;
+    }
+
+    if (journal->shouldCompact())
+    {
+        compactJournal(true);
+    }
+}
+
 bool TransportationSystem::setAlgorithm(const std::string &algorithmName)
 {
-    if (algorithmName == "dijkstra" || algorithmName == "astar")
+    if (algorithmName == "astar" || StrategyRegistry::instance().contains(algorithmName))
     {
-        // We can store this in the lastError as a hack for now, or just return true
-        // Since the header doesn't declare currentAlgorithm member
+        // Cached results are keyed without the algorithm, so they belong to the previous one
+        if (algorithmName != currentAlgorithm)
+        {
+            routeCache.clear();
+        }
+        currentAlgorithm = algorithmName;
         return true;
     }
 
@@ -194,7 +493,7 @@ bool TransportationSystem::setAlgorithm(const std::string &algorithmName)
 
 std::string TransportationSystem::getCurrentAlgorithm() const
 {
-    return "dijkstra"; // Default algorithm
+    return currentAlgorithm;
 }
 
 // Validate the transportation system
@@ -226,6 +525,8 @@ std::string TransportationSystem::getLastError() const
 // Find route implementation
 RouteResult TransportationSystem::findRoute(const std::string &start, const std::string &end, const std::string &criteria)
 {
+    auto started = std::chrono::steady_clock::now();
+
     // Verify nodes exist
     if (!graph.hasNode(start) || !graph.hasNode(end))
     {
@@ -242,39 +543,345 @@ RouteResult TransportationSystem::findRoute(const std::string &start, const std:
             lastError = "End location '" + end + "' does not exist";
         }
 
+        syncQueryMetrics.record(&invalidResult, started);
+        traceQuery(start, end, criteria, invalidResult, started, 0);
         return invalidResult;
     }
 
-    // Determine which algorithm to use (based on criteria or current algorithm setting)
-    std::unique_ptr<RouteStrategy> strategy;
-
-    std::string algorithmToUse = getCurrentAlgorithm();
-
-    if (algorithmToUse == "astar")
+    // Popular pairs are answered from the cache; the key includes the graph version,
+    // so any edit since the result was computed makes it miss
+    uint64_t version = graph.getVersion();
+    if (version != cachedGraphVersion)
     {
-        strategy = std::make_unique<AStarStrategy>();
+        routeCache.purgeStale(version);
+        cachedGraphVersion = version;
+        updateGraphMetrics(); // Also catches edits made through getMutableNetwork()
     }
-    else
+
+    RouteResult cached;
+    if (routeCache.getMemoryBudget() > 0 && routeCache.lookup(start, end, criteria, version, cached))
     {
-        // Default to Dijkstra
-        strategy = std::make_unique<DijkstraStrategy>();
+        if (!cached.isValid)
+        {
+            lastError = "No route found between '" + start + "' and '" + end + "' with criteria '" + criteria + "'";
+        }
+        syncQueryMetrics.record(&cached, started);
+        traceQuery(start, end, criteria, cached, started, 0);
+        return cached;
     }
 
     // Create PathFinder with selected strategy
-    PathFinder pathFinder(strategy.get());
+    std::unique_ptr<RouteStrategy> created;
+    PathFinder pathFinder(selectStrategy(created));
 
-    // Find and return the route
-    RouteResult result = pathFinder.findRoute(graph, start, end, criteria);
+    // Find and return the route, instrumented only when statistics or a trace are wanted
+    RouteResult result;
+    SearchStats stats;
+    if (searchStatsEnabled || traceLog)
+    {
+        result = pathFinder.findRoute(graph, start, end, criteria, makeQueryToken(), &stats);
+        if (searchStatsEnabled)
+        {
+            searchStatistics.record(stats);
+        }
+    }
+    else
+    {
+        result = pathFinder.findRoute(graph, start, end, criteria, makeQueryToken());
+    }
+    if (routeCache.getMemoryBudget() > 0)
+    {
+        routeCache.insert(start, end, criteria, version, result);
+    }
 
     // Update last error if route not found
-    if (!result.isValid)
+    if (result.status == RouteStatus::TimedOut)
+    {
+        lastError = "Route search between '" + start + "' and '" + end + "' timed out after " +
+                    std::to_string(queryTimeout.count()) + " ms";
+    }
+    else if (!result.isValid)
     {
         lastError = "No route found between '" + start + "' and '" + end + "' with criteria '" + criteria + "'";
     }
 
+    syncQueryMetrics.record(&result, started);
+    traceQuery(start, end, criteria, result, started, stats.nodesSettled);
     return result;
 }
 
+void TransportationSystem::traceQuery(const std::string &start, const std::string &end, const std::string &criteria,
+                                      const RouteResult &result, std::chrono::steady_clock::time_point started,
+                                      uint64_t nodesSettled)
+{
+    if (!traceLog)
+    {
+        return;
+    }
+
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+
+    // Node ids as the route service numbers them. Its snapshot is used only when it is
+    // already current: building one here would make tracing change what it measures.
+    // Otherwise the ids come from a name index over getNodeNames() order, which is how
+    // GraphSnapshot numbers nodes, rebuilt once per graph version
+    std::shared_ptr<const GraphSnapshot> snapshot;
+    if (routeService && routeService->getSnapshot()->getVersion() == graph.getVersion())
+    {
+        snapshot = routeService->getSnapshot();
+    }
+    else if (traceNodeIdsVersion != graph.getVersion())
+    {
+        traceNodeIds.clear();
+        uint32_t id = 0;
+        for (const std::string &name : graph.getNodeNames())
+        {
+            traceNodeIds.emplace(name, id++);
+        }
+        traceNodeIdsVersion = graph.getVersion();
+    }
+    auto nodeId = [this, &snapshot](const std::string &name)
+    {
+        if (snapshot)
+            return snapshot->findNode(name);
+        auto found = traceNodeIds.find(name);
+        return found == traceNodeIds.end() ? GraphSnapshot::INVALID_NODE : found->second;
+    };
+
+    TraceLog::Record record;
+    record.queryId = traceLog->nextQueryId();
+    record.timestampNanos = TraceLog::nowNanos();
+    record.threadId = TraceLog::currentThreadId();
+    record.startNode = nodeId(start);
+    record.endNode = nodeId(end);
+    record.nodesSettled = static_cast<uint32_t>(std::min<uint64_t>(nodesSettled, UINT32_MAX));
+    record.latencyMicros = static_cast<uint32_t>(std::min<long long>(latency.count(), UINT32_MAX));
+    record.criterion = static_cast<uint8_t>(GraphSnapshot::parseCriterion(criteria));
+    record.status = static_cast<uint8_t>(result.status);
+    traceLog->record(record);
+}
+
+RouteService &TransportationSystem::getRouteService()
+{
+    if (!routeService)
+    {
+        routeService = std::make_unique<RouteService>(std::make_shared<const GraphSnapshot>(graph),
+                                                      routeServiceThreads);
+        routeService->getTreeCache().setMemoryBudget(treeCacheBudget);
+        routeService->getTreeCache().setHotThreshold(treeHotThreshold);
+        routeService->setTraceLog(traceLog);
+    }
+    else if (routeService->getSnapshot()->getVersion() != graph.getVersion())
+    {
+        // Every edit bumps the version, including edits through a kept getMutableNetwork() pointer
+        routeService->setSnapshot(std::make_shared<const GraphSnapshot>(graph));
+        updateGraphMetrics();
+    }
+    return *routeService;
+}
+
+std::future<RouteResult> TransportationSystem::findRouteAsync(const std::string &start, const std::string &end,
+                                                              const std::string &criteria)
+{
+    auto promise = std::make_shared<std::promise<RouteResult>>();
+    std::future<RouteResult> answer = promise->get_future();
+    QueryMetrics queryMetrics = asyncQueryMetrics; // Copied: the counters live in the registry, which outlives the service
+    auto started = std::chrono::steady_clock::now();
+    getRouteService().submit(start, end, criteria, makeQueryToken(),
+                             [promise, queryMetrics, started](const RouteResult &result, std::exception_ptr error)
+                             {
+        queryMetrics.record(error ? nullptr : &result, started);
+        if (error)
+            promise->set_exception(error);
+        else
+            promise->set_value(result); });
+    return answer;
+}
+
+RouteCache::Statistics TransportationSystem::getRouteCacheStatistics() const
+{
+    return routeCache.getStatistics();
+}
+
+void TransportationSystem::setRouteCacheBudget(size_t bytes)
+{
+    routeCache.setMemoryBudget(bytes);
+}
+
+void TransportationSystem::clearRouteCache()
+{
+    routeCache.clear();
+    routeCache.resetStatistics();
+}
+
+void TransportationSystem::setSearchStatsEnabled(bool enabled)
+{
+    searchStatsEnabled = enabled;
+}
+
+bool TransportationSystem::isSearchStatsEnabled() const
+{
+    return searchStatsEnabled;
+}
+
+const SearchStatsCollector &TransportationSystem::getSearchStatistics() const
+{
+    return searchStatistics;
+}
+
+void TransportationSystem::resetSearchStatistics()
+{
+    searchStatistics.reset();
+}
+
+bool TransportationSystem::setTraceFile(const std::string &path)
+{
+    std::shared_ptr<TraceLog> trace;
+    if (!path.empty())
+    {
+        trace = std::make_shared<TraceLog>(path);
+        if (!trace->open())
+        {
+            lastError = trace->getLastError();
+            return false;
+        }
+    }
+
+    // The service may still hold the old trace until its in-flight queries finish
+    traceLog = trace;
+    if (routeService)
+        routeService->setTraceLog(trace);
+    return true;
+}
+
+std::shared_ptr<TraceLog> TransportationSystem::getTraceLog() const
+{
+    return traceLog;
+}
+
+transport::utils::MetricsRegistry &TransportationSystem::getMetrics()
+{
+    return metrics;
+}
+
+bool TransportationSystem::startMetricsServer(uint16_t port)
+{
+    stopMetricsServer();
+    auto server = std::make_unique<transport::utils::MetricsServer>(metrics);
+    if (!server->start(port))
+    {
+        lastError = server->getLastError();
+        return false;
+    }
+    metricsServer = std::move(server);
+    return true;
+}
+
+void TransportationSystem::stopMetricsServer()
+{
+    if (metricsServer)
+    {
+        metricsServer->stop();
+        metricsServer.reset();
+    }
+}
+
+uint16_t TransportationSystem::getMetricsPort() const
+{
+    return metricsServer ? metricsServer->getPort() : 0;
+}
+
+bool TransportationSystem::writeMetricsFile(const std::string &path)
+{
+    if (!metrics.writePrometheusFile(path))
+    {
+        lastError = "Failed to write metrics to " + path;
+        return false;
+    }
+    return true;
+}
+
+void TransportationSystem::registerMetrics()
+{
+    using Labels = transport::utils::MetricsRegistry::Labels;
+
+    // Query rate and latency, per query path and outcome
+    const char *const modes[] = {"sync", "async"};
+    QueryMetrics *paths[] = {&syncQueryMetrics, &asyncQueryMetrics};
+    for (int m = 0; m < 2; ++m)
+    {
+        for (int outcome = 0; outcome < 5; ++outcome)
+            paths[m]->outcomes[outcome] = &metrics.counter("transport_route_queries_total", "Route queries answered",
+                                                           Labels{{"mode", modes[m]}, {"status", QUERY_OUTCOMES[outcome]}});
+        paths[m]->latency = &metrics.histogram("transport_route_query_duration_seconds",
+                                               "Route query latency, including time queued for async queries",
+                                               Labels{{"mode", modes[m]}});
+    }
+
+    // Route cache, read from its own statistics when exported
+    metrics.counterFunction("transport_route_cache_hits_total", "Route cache lookups answered from the cache",
+                            [this]()
+                            { return static_cast<double>(routeCache.getStatistics().hits); });
+    metrics.counterFunction("transport_route_cache_misses_total", "Route cache lookups that missed",
+                            [this]()
+                            { return static_cast<double>(routeCache.getStatistics().misses); });
+    metrics.counterFunction("transport_route_cache_evictions_total", "Route cache entries evicted for space",
+                            [this]()
+                            { return static_cast<double>(routeCache.getStatistics().evictions); });
+    metrics.gaugeFunction("transport_route_cache_entries", "Routes currently cached",
+                          [this]()
+                          { return static_cast<double>(routeCache.getStatistics().entries); });
+    metrics.gaugeFunction("transport_route_cache_bytes", "Approximate memory held by cached routes",
+                          [this]()
+                          { return static_cast<double>(routeCache.getStatistics().bytes); });
+    metrics.gaugeFunction("transport_route_cache_hit_ratio", "Fraction of route cache lookups that hit",
+                          [this]()
+                          { return routeCache.getStatistics().hitRate(); });
+
+    // Network size and loading; the gauges are set by the thread that edits the graph
+    nodesGauge = &metrics.gauge("transport_network_nodes", "Locations in the network");
+    edgesGauge = &metrics.gauge("transport_network_edges", "Routes in the network");
+    versionGauge = &metrics.gauge("transport_network_version",
+                                 "Version id of the current network; only ever increases, not an edit count");
+    for (const char *source : {"csv", "journal"})
+    {
+        metrics.histogram("transport_network_load_duration_seconds", "Time to load the network", Labels{{"source", source}});
+        metrics.counter("transport_network_load_failures_total", "Network loads that failed", Labels{{"source", source}});
+    }
+}
+
+void TransportationSystem::updateGraphMetrics()
+{
+    nodesGauge->set(static_cast<double>(graph.getNodeCount()));
+    edgesGauge->set(static_cast<double>(graph.getEdgeCount()));
+    versionGauge->set(static_cast<double>(graph.getVersion()));
+}
+
+void TransportationSystem::QueryMetrics::record(const RouteResult *result,
+                                                std::chrono::steady_clock::time_point started) const
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    outcomes[result ? static_cast<int>(result->status) : 4]->increment();
+    latency->record(static_cast<uint64_t>(elapsed.count()));
+}
+
+void TransportationSystem::setQueryTimeout(std::chrono::milliseconds timeout)
+{
+    queryTimeout = timeout.count() > 0 ? timeout : std::chrono::milliseconds(0);
+}
+
+std::chrono::milliseconds TransportationSystem::getQueryTimeout() const
+{
+    return queryTimeout;
+}
+
+CancellationToken TransportationSystem::makeQueryToken() const
+{
+    if (queryTimeout.count() <= 0)
+        return CancellationToken();
+    return CancellationToken::withTimeout(queryTimeout);
+}
+
 // Find route with user preferences
 RouteResult TransportationSystem::findRouteWithPreferences(const std::string &start, const std::string &end)
 {
@@ -291,27 +898,72 @@ RouteResult TransportationSystem::findRouteWithPreferences(const std::string &st
     return findRoute(start, end, preferredCriteria);
 }
 
+RouteStrategy *TransportationSystem::selectStrategy(std::unique_ptr<RouteStrategy> &created)
+{
+    // "astar" is accepted by setAlgorithm but runs Dijkstra
+    if (currentAlgorithm == "delta_stepping")
+    {
+        // Kept across queries so its snapshot is reused while the graph is unchanged
+        if (!deltaStepping)
+        {
+            deltaStepping = std::make_unique<DeltaSteppingStrategy>(0, &getRouteService().getScheduler());
+        }
+        return deltaStepping.get();
+    }
+
+    created = StrategyRegistry::instance().create(currentAlgorithm);
+    if (!created)
+    {
+        created = StrategyRegistry::instance().create(StrategyRegistry::REFERENCE);
+    }
+    return created.get();
+}
+
 std::vector<RouteResult> TransportationSystem::findAlternativeRoutes(const std::string &start,
                                                                      const std::string &end,
                                                                      int maxAlternatives)
 {
     std::vector<RouteResult> alternatives;
 
-    // Find routes with different criteria
-    std::vector<std::string> criteriaOptions = {"time", "distance", "cost", "transfers"};
+    if (!graph.hasNode(start) || !graph.hasNode(end))
+    {
+        lastError = !graph.hasNode(start) ? "Start location '" + start + "' does not exist"
+                                          : "End location '" + end + "' does not exist";
+        return alternatives;
+    }
 
-    for (const auto &criteria : criteriaOptions)
+    // Find routes with different criteria, each with the strategy findRoute would use.
+    // Strategies are chosen up front: selectStrategy may create the shared delta-stepping
+    // instance, whose searches are safe to run concurrently
+    const char *const criteriaList[] = {"time", "distance", "cost", "transfers"};
+    const size_t criteriaCount = sizeof(criteriaList) / sizeof(criteriaList[0]);
+    std::vector<std::unique_ptr<RouteStrategy>> created(criteriaCount);
+    std::vector<RouteStrategy *> strategies(criteriaCount);
+    for (size_t i = 0; i < criteriaCount; ++i)
     {
-        if (alternatives.size() >= maxAlternatives)
-            break;
+        strategies[i] = selectStrategy(created[i]);
+    }
+
+    // The searches fan out over the route service pool
+    std::vector<RouteResult> results(criteriaCount);
+    CancellationToken token = makeQueryToken();
+    getRouteService().getScheduler().parallelFor(0, criteriaCount, [&](size_t i)
+                                                 { results[i] = strategies[i]->findRoute(graph, start, end,
+                                                                                         criteriaList[i], token); });
 
-        RouteResult result = findRoute(start, end, criteria);
-        if (result.isValid)
+    for (const RouteResult &result : results)
+    {
+        if (result.isValid && static_cast<int>(alternatives.size()) < maxAlternatives)
         {
             alternatives.push_back(result);
         }
     }
 
+    if (alternatives.empty())
+    {
+        lastError = "No route found between '" + start + "' and '" + end + "'";
+    }
+
     return alternatives;
 }
 
@@ -0,0 +1,100 @@
+#include "include/core/VersionedGraph.h"
+#include <algorithm>
+
+VersionedGraph::VersionedGraph(const Graph &initial)
+    : VersionedGraph(std::make_shared<const GraphSnapshot>(initial))
+{
+}
+
+VersionedGraph::VersionedGraph(std::shared_ptr<const GraphSnapshot> initial)
+    : current(std::make_shared<const Version>(Version{1, std::move(initial)}))
+{
+}
+
+std::shared_ptr<const VersionedGraph::Version> VersionedGraph::acquire() const
+{
+    return std::atomic_load(&current);
+}
+
+std::shared_ptr<const GraphSnapshot> VersionedGraph::acquireSnapshot() const
+{
+    std::shared_ptr<const Version> version = acquire();
+    // Aliasing constructor: the returned pointer keeps the whole version alive
+    return std::shared_ptr<const GraphSnapshot>(version, version->graph.get());
+}
+
+uint64_t VersionedGraph::getEpoch() const
+{
+    return acquire()->epoch;
+}
+
+uint64_t VersionedGraph::update(const std::function<bool(GraphSnapshot::Editor &)> &edit)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+    std::shared_ptr<const Version> previous = std::atomic_load(&current);
+
+    GraphSnapshot::Editor editor(*previous->graph);
+    if (!edit(editor))
+        return 0;
+
+    auto next = std::make_shared<const Version>(Version{previous->epoch + 1, editor.publish()});
+    std::atomic_store(&current, std::shared_ptr<const Version>(next));
+
+    // Remember the old version only to report how many are still pinned
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [](const std::weak_ptr<const Version> &version)
+                                 { return version.expired(); }),
+                  retired.end());
+    retired.push_back(previous);
+    return next->epoch;
+}
+
+bool VersionedGraph::addNode(const std::string &name, double latitude, double longitude)
+{
+    return update([&](GraphSnapshot::Editor &editor)
+                  { return editor.addNode(name, latitude, longitude); }) != 0;
+}
+
+bool VersionedGraph::updateNode(const std::string &name, double latitude, double longitude)
+{
+    return update([&](GraphSnapshot::Editor &editor)
+                  { return editor.updateNode(name, latitude, longitude); }) != 0;
+}
+
+bool VersionedGraph::removeNode(const std::string &name)
+{
+    return update([&](GraphSnapshot::Editor &editor)
+                  { return editor.removeNode(name); }) != 0;
+}
+
+bool VersionedGraph::addEdge(const std::string &source, const std::string &destination, int distance,
+                             int time, int cost, int transfers, const std::string &mode)
+{
+    return update([&](GraphSnapshot::Editor &editor)
+                  { return editor.addEdge(source, destination, distance, time, cost, transfers, mode); }) != 0;
+}
+
+bool VersionedGraph::updateEdge(const std::string &source, const std::string &destination, int distance,
+                                int time, int cost, int transfers, const std::string &mode)
+{
+    return update([&](GraphSnapshot::Editor &editor)
+                  { return editor.updateEdge(source, destination, distance, time, cost, transfers, mode); }) != 0;
+}
+
+bool VersionedGraph::removeEdge(const std::string &source, const std::string &destination)
+{
+    return update([&](GraphSnapshot::Editor &editor)
+                  { return editor.removeEdge(source, destination); }) != 0;
+}
+
+size_t VersionedGraph::getLiveVersionCount() const
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+    size_t live = 1;
+    for (const auto &version : retired)
+    {
+        if (!version.expired())
+            ++live;
+    }
+    return live;
+}
@@ -0,0 +1,639 @@
+#include "../../include/io/GTFSImporter.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+namespace
+{
+    // Flat fares (IDR) used when the feed carries no fare_attributes.txt
+    int defaultFareForMode(const std::string &mode)
+    {
+        if (mode == "mrt")
+            return 14000;
+        if (mode == "lrt")
+            return 5000;
+        if (mode == "train")
+            return 3000;
+        if (mode == "bus")
+            return 3500;
+        return 0;
+    }
+
+    std::string joinPath(const std::string &directory, const std::string &file)
+    {
+        if (directory.empty())
+            return file;
+        char last = directory.back();
+        if (last == '/' || last == '\\')
+            return directory + file;
+        return directory + "/" + file;
+    }
+
+    // Strip the UTF-8 BOM and trailing CR that many GTFS exports carry
+    void normaliseLine(std::string &line, bool firstLine)
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (firstLine && line.size() >= 3 &&
+            static_cast<unsigned char>(line[0]) == 0xEF &&
+            static_cast<unsigned char>(line[1]) == 0xBB &&
+            static_cast<unsigned char>(line[2]) == 0xBF)
+        {
+            line.erase(0, 3);
+        }
+    }
+}
+
+GTFSImporter::GTFSImporter() {}
+
+bool GTFSImporter::importFeed(const std::string &directory, Graph &graph)
+{
+    stops.clear();
+    routes.clear();
+    tripRoutes.clear();
+    segments.clear();
+    statistics = ImportStatistics();
+    lastError.clear();
+
+    if (!readStops(joinPath(directory, "stops.txt")) ||
+        !readRoutes(joinPath(directory, "routes.txt")) ||
+        !readTrips(joinPath(directory, "trips.txt")))
+    {
+        return false;
+    }
+
+    readFares(directory);
+
+    if (!streamStopTimes(joinPath(directory, "stop_times.txt")))
+    {
+        return false;
+    }
+
+    buildGraph(graph);
+
+    std::cout << "GTFS feed imported from " << directory << ": "
+              << statistics.nodesAdded << " new and " << statistics.nodesUpdated << " existing stops, "
+              << statistics.edgesAdded << " new and " << statistics.edgesUpdated << " existing segments." << std::endl;
+    return true;
+}
+
+const GTFSImporter::ImportStatistics &GTFSImporter::getStatistics() const
+{
+    return statistics;
+}
+
+std::string GTFSImporter::getLastError() const
+{
+    return lastError;
+}
+
+std::vector<std::string> GTFSImporter::splitRecord(const std::string &line)
+{
+    std::vector<std::string> fields;
+    std::string current;
+    bool inQuotes = false;
+
+    for (size_t i = 0; i < line.size(); ++i)
+    {
+        char c = line[i];
+        if (inQuotes)
+        {
+            if (c == '"')
+            {
+                if (i + 1 < line.size() && line[i + 1] == '"')
+                {
+                    current += '"';
+                    ++i;
+                }
+                else
+                {
+                    inQuotes = false;
+                }
+            }
+            else
+            {
+                current += c;
+            }
+        }
+        else if (c == '"')
+        {
+            inQuotes = true;
+        }
+        else if (c == ',')
+        {
+            fields.push_back(current);
+            current.clear();
+        }
+        else
+        {
+            current += c;
+        }
+    }
+    fields.push_back(current);
+
+    // GTFS allows optional whitespace around values
+    for (auto &value : fields)
+    {
+        size_t first = value.find_first_not_of(" \t");
+        size_t last = value.find_last_not_of(" \t");
+        value = (first == std::string::npos) ? "" : value.substr(first, last - first + 1);
+    }
+    return fields;
+}
+
+int GTFSImporter::parseTimeSeconds(const std::string &value)
+{
+    int hours = 0, minutes = 0, seconds = 0;
+    char sep1 = 0, sep2 = 0;
+    std::istringstream ss(value);
+    if (!(ss >> hours >> sep1 >> minutes >> sep2 >> seconds) || sep1 != ':' || sep2 != ':')
+    {
+        return -1;
+    }
+    if (hours < 0 || minutes < 0 || minutes > 59 || seconds < 0 || seconds > 59)
+    {
+        return -1;
+    }
+    return hours * 3600 + minutes * 60 + seconds;
+}
+
+std::string GTFSImporter::routeTypeToMode(int routeType)
+{
+    // Basic route types plus the extended (Google) ranges
+    switch (routeType)
+    {
+    case 0:
+        return "lrt";
+    case 1:
+        return "mrt";
+    case 2:
+        return "train";
+    case 3:
+        return "bus";
+    case 4:
+        return "ferry";
+    default:
+        break;
+    }
+    if (routeType >= 100 && routeType < 200)
+        return "train";
+    if (routeType >= 200 && routeType < 300)
+        return "bus";
+    if (routeType >= 400 && routeType < 500)
+        return "mrt";
+    if (routeType >= 700 && routeType < 800)
+        return "bus";
+    if (routeType >= 900 && routeType < 1000)
+        return "lrt";
+    if (routeType >= 1000 && routeType < 1100)
+        return "ferry";
+    return "unknown";
+}
+
+std::map<std::string, int> GTFSImporter::indexHeader(const std::string &headerLine)
+{
+    std::map<std::string, int> columns;
+    std::vector<std::string> names = splitRecord(headerLine);
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        columns[names[i]] = static_cast<int>(i);
+    }
+    return columns;
+}
+
+std::string GTFSImporter::field(const std::vector<std::string> &row,
+                                const std::map<std::string, int> &columns,
+                                const std::string &name)
+{
+    auto it = columns.find(name);
+    if (it == columns.end() || it->second >= static_cast<int>(row.size()))
+        return "";
+    return row[it->second];
+}
+
+bool GTFSImporter::readStops(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        lastError = "Cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line))
+    {
+        lastError = "Empty file " + path;
+        return false;
+    }
+    normaliseLine(line, true);
+    auto columns = indexHeader(line);
+
+    // A stop name may be shared by several platforms; only the first keeps the plain name
+    std::set<std::string> usedNames;
+
+    while (std::getline(file, line))
+    {
+        normaliseLine(line, false);
+        if (line.empty())
+            continue;
+
+        auto row = splitRecord(line);
+        std::string id = field(row, columns, "stop_id");
+        std::string name = field(row, columns, "stop_name");
+        std::string lat = field(row, columns, "stop_lat");
+        std::string lon = field(row, columns, "stop_lon");
+        std::string locationType = field(row, columns, "location_type");
+
+        // Entrances, generic nodes and boarding areas are not routable stops
+        if (id.empty() || lat.empty() || lon.empty() ||
+            (!locationType.empty() && locationType != "0" && locationType != "1"))
+        {
+            statistics.rowsSkipped++;
+            continue;
+        }
+
+        try
+        {
+            Stop stop;
+            stop.latitude = std::stod(lat);
+            stop.longitude = std::stod(lon);
+            // Written as a range check so that "nan" is rejected too
+            if (!(stop.latitude >= -90.0 && stop.latitude <= 90.0) ||
+                !(stop.longitude >= -180.0 && stop.longitude <= 180.0))
+            {
+                statistics.rowsSkipped++;
+                continue;
+            }
+            stop.nodeName = name.empty() ? id : name;
+            if (!usedNames.insert(stop.nodeName).second)
+            {
+                stop.nodeName += " (" + id + ")";
+                usedNames.insert(stop.nodeName);
+            }
+            stops[id] = stop;
+            statistics.stopsRead++;
+        }
+        catch (const std::exception &)
+        {
+            statistics.rowsSkipped++;
+        }
+    }
+    return true;
+}
+
+bool GTFSImporter::readRoutes(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        lastError = "Cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line))
+    {
+        lastError = "Empty file " + path;
+        return false;
+    }
+    normaliseLine(line, true);
+    auto columns = indexHeader(line);
+
+    while (std::getline(file, line))
+    {
+        normaliseLine(line, false);
+        if (line.empty())
+            continue;
+
+        auto row = splitRecord(line);
+        std::string id = field(row, columns, "route_id");
+        if (id.empty())
+        {
+            statistics.rowsSkipped++;
+            continue;
+        }
+
+        Route route;
+        try
+        {
+            route.mode = routeTypeToMode(std::stoi(field(row, columns, "route_type")));
+        }
+        catch (const std::exception &)
+        {
+            route.mode = "unknown";
+        }
+        route.fare = defaultFareForMode(route.mode);
+        routes[id] = route;
+        statistics.routesRead++;
+    }
+    return true;
+}
+
+bool GTFSImporter::readTrips(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        lastError = "Cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line))
+    {
+        lastError = "Empty file " + path;
+        return false;
+    }
+    normaliseLine(line, true);
+    auto columns = indexHeader(line);
+
+    while (std::getline(file, line))
+    {
+        normaliseLine(line, false);
+        if (line.empty())
+            continue;
+
+        auto row = splitRecord(line);
+        std::string tripId = field(row, columns, "trip_id");
+        std::string routeId = field(row, columns, "route_id");
+        if (tripId.empty() || routes.find(routeId) == routes.end())
+        {
+            statistics.rowsSkipped++;
+            continue;
+        }
+        tripRoutes[tripId] = routeId;
+        statistics.tripsRead++;
+    }
+    return true;
+}
+
+void GTFSImporter::readFares(const std::string &directory)
+{
+    std::ifstream attributes(joinPath(directory, "fare_attributes.txt"));
+    std::ifstream rules(joinPath(directory, "fare_rules.txt"));
+    if (!attributes.is_open() || !rules.is_open())
+        return; // Optional files, keep per-mode defaults
+
+    std::unordered_map<std::string, int> prices;
+    std::string line;
+    if (std::getline(attributes, line))
+    {
+        normaliseLine(line, true);
+        auto columns = indexHeader(line);
+        while (std::getline(attributes, line))
+        {
+            normaliseLine(line, false);
+            auto row = splitRecord(line);
+            try
+            {
+                prices[field(row, columns, "fare_id")] =
+                    static_cast<int>(std::stod(field(row, columns, "price")));
+            }
+            catch (const std::exception &)
+            {
+                statistics.rowsSkipped++;
+            }
+        }
+    }
+
+    if (std::getline(rules, line))
+    {
+        normaliseLine(line, true);
+        auto columns = indexHeader(line);
+        while (std::getline(rules, line))
+        {
+            normaliseLine(line, false);
+            auto row = splitRecord(line);
+            auto price = prices.find(field(row, columns, "fare_id"));
+            auto route = routes.find(field(row, columns, "route_id"));
+            if (price != prices.end() && route != routes.end())
+            {
+                route->second.fare = price->second;
+            }
+        }
+    }
+}
+
+bool GTFSImporter::streamStopTimes(const std::string &path)
+{
+    int skippedBefore = statistics.rowsSkipped;
+    std::unordered_set<std::string> interleaved;
+    if (!readStopTimes(path, {}, interleaved))
+        return false;
+    if (interleaved.empty())
+        return true;
+
+    // The first pass folded the interleaved trips piecewise; redo it with them held whole
+    std::cerr << "Warning: " << path << " is not grouped by trip_id (" << interleaved.size()
+              << " trips interleaved), reading it again" << std::endl;
+    segments.clear();
+    statistics.stopTimesRead = 0;
+    statistics.rowsSkipped = skippedBefore;
+    statistics.tripsInterleaved = static_cast<int>(interleaved.size());
+    std::unordered_set<std::string> unused;
+    return readStopTimes(path, interleaved, unused);
+}
+
+bool GTFSImporter::readStopTimes(const std::string &path, const std::unordered_set<std::string> &heldTrips,
+                                 std::unordered_set<std::string> &interleaved)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        lastError = "Cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line))
+    {
+        lastError = "Empty file " + path;
+        return false;
+    }
+    normaliseLine(line, true);
+    auto columns = indexHeader(line);
+    const int tripCol = columns.count("trip_id") ? columns["trip_id"] : -1;
+    const int stopCol = columns.count("stop_id") ? columns["stop_id"] : -1;
+    const int seqCol = columns.count("stop_sequence") ? columns["stop_sequence"] : -1;
+    const int arrCol = columns.count("arrival_time") ? columns["arrival_time"] : -1;
+    const int depCol = columns.count("departure_time") ? columns["departure_time"] : -1;
+    if (tripCol < 0 || stopCol < 0 || seqCol < 0)
+    {
+        lastError = "stop_times.txt is missing trip_id, stop_id or stop_sequence";
+        return false;
+    }
+
+    // Only the current trip is buffered, plus every held trip in full
+    std::string currentTrip;
+    std::vector<StopVisit> visits;
+    std::unordered_set<std::string> flushedTrips;
+    std::unordered_map<std::string, std::vector<StopVisit>> held;
+
+    while (std::getline(file, line))
+    {
+        normaliseLine(line, false);
+        if (line.empty())
+            continue;
+
+        auto row = splitRecord(line);
+        int maxCol = std::max({tripCol, stopCol, seqCol, arrCol, depCol});
+        if (static_cast<int>(row.size()) <= maxCol)
+        {
+            statistics.rowsSkipped++;
+            continue;
+        }
+
+        StopVisit visit;
+        try
+        {
+            visit.sequence = std::stoi(row[seqCol]);
+        }
+        catch (const std::exception &)
+        {
+            statistics.rowsSkipped++;
+            continue;
+        }
+
+        visit.stopId = row[stopCol];
+        visit.arrival = arrCol >= 0 ? parseTimeSeconds(row[arrCol]) : -1;
+        visit.departure = depCol >= 0 ? parseTimeSeconds(row[depCol]) : -1;
+        if (visit.departure < 0)
+            visit.departure = visit.arrival;
+        if (visit.arrival < 0)
+            visit.arrival = visit.departure;
+
+        statistics.stopTimesRead++;
+        const std::string &tripId = row[tripCol];
+        if (heldTrips.count(tripId))
+        {
+            held[tripId].push_back(visit);
+            continue;
+        }
+        if (tripId != currentTrip)
+        {
+            flushTrip(currentTrip, visits);
+            flushedTrips.insert(currentTrip);
+            currentTrip = tripId;
+            if (flushedTrips.count(currentTrip))
+                interleaved.insert(currentTrip);
+        }
+        visits.push_back(visit);
+    }
+    flushTrip(currentTrip, visits);
+    for (auto &trip : held)
+        flushTrip(trip.first, trip.second);
+    return true;
+}
+
+void GTFSImporter::flushTrip(const std::string &tripId, std::vector<StopVisit> &visits)
+{
+    if (visits.empty())
+        return;
+
+    auto trip = tripRoutes.find(tripId);
+    if (trip == tripRoutes.end())
+    {
+        visits.clear();
+        return;
+    }
+    const Route &route = routes[trip->second];
+
+    std::sort(visits.begin(), visits.end(),
+              [](const StopVisit &a, const StopVisit &b)
+              { return a.sequence < b.sequence; });
+
+    // Untimed intermediate stops are bridged until the next timed stop
+    size_t from = 0;
+    while (from < visits.size() &&
+           (visits[from].departure < 0 || stops.find(visits[from].stopId) == stops.end()))
+    {
+        ++from;
+    }
+
+    for (size_t to = from + 1; to < visits.size(); ++to)
+    {
+        const StopVisit &next = visits[to];
+        if (next.arrival < 0 || stops.find(next.stopId) == stops.end())
+            continue;
+
+        const StopVisit &prev = visits[from];
+        if (prev.stopId != next.stopId && next.arrival >= prev.departure)
+        {
+            int minutes = (next.arrival - prev.departure + 30) / 60;
+            Segment &segment = segments[{prev.stopId, next.stopId}];
+            segment.minuteHistogram[minutes]++;
+            segment.modeCounts[route.mode]++;
+            segment.fare = std::max(segment.fare, route.fare);
+            segment.samples++;
+        }
+        from = to;
+    }
+
+    visits.clear();
+}
+
+int GTFSImporter::medianOf(const std::map<int, int> &histogram, int samples)
+{
+    int target = (samples + 1) / 2;
+    int seen = 0;
+    for (const auto &bucket : histogram)
+    {
+        seen += bucket.second;
+        if (seen >= target)
+            return bucket.first;
+    }
+    return histogram.empty() ? 0 : histogram.rbegin()->first;
+}
+
+void GTFSImporter::buildGraph(Graph &graph)
+{
+    // Only stops that are served by at least one segment become nodes
+    std::set<std::string> servedStops;
+    for (const auto &entry : segments)
+    {
+        servedStops.insert(entry.first.first);
+        servedStops.insert(entry.first.second);
+    }
+
+    // Inserted in bulk: addNode/addEdge print a line per element, far too many for a city feed
+    std::vector<Node> newNodes, changedNodes;
+    for (const auto &stopId : servedStops)
+    {
+        const Stop &stop = stops[stopId]; // Coordinates were range-checked by readStops
+        (graph.hasNode(stop.nodeName) ? changedNodes : newNodes)
+            .emplace_back(stop.nodeName, stop.latitude, stop.longitude);
+    }
+    statistics.nodesAdded += static_cast<int>(graph.addNodes(newNodes));
+    statistics.nodesUpdated += static_cast<int>(graph.updateNodes(changedNodes));
+
+    std::vector<Edge> newEdges, changedEdges;
+    for (const auto &entry : segments)
+    {
+        const Stop &from = stops[entry.first.first];
+        const Stop &to = stops[entry.first.second];
+        const Segment &segment = entry.second;
+
+        std::string mode = "unknown";
+        int bestCount = 0;
+        for (const auto &modeCount : segment.modeCounts)
+        {
+            if (modeCount.second > bestCount)
+            {
+                mode = modeCount.first;
+                bestCount = modeCount.second;
+            }
+        }
+
+        Node fromNode(from.nodeName, from.latitude, from.longitude);
+        Node toNode(to.nodeName, to.latitude, to.longitude);
+        int distance = static_cast<int>(fromNode.distanceTo(toNode));
+        int time = std::max(1, medianOf(segment.minuteHistogram, segment.samples));
+        (graph.hasEdge(from.nodeName, to.nodeName) ? changedEdges : newEdges)
+            .emplace_back(from.nodeName, to.nodeName, distance, time, segment.fare, 0, mode);
+    }
+    statistics.edgesAdded += static_cast<int>(graph.addEdges(newEdges));
+    statistics.edgesUpdated += static_cast<int>(graph.updateEdges(changedEdges));
+}
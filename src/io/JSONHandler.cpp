@@ -1,34 +1,1167 @@
 #include "../../include/io/JSONHandler.h"
 #include <fstream>
 #include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_set>
 
-// Dummy JSON parser for key-value pairs (not a full JSON parser)
-std::map<std::string, std::string> JSONHandler::parseJSON(const std::string &filename)
+namespace
 {
-    std::map<std::string, std::string> data;
-    std::ifstream file(filename);
-    std::string line;
-    while (std::getline(file, line))
+    const JSONValue &nullValue()
+    {
+        static const JSONValue value;
+        return value;
+    }
+
+    bool readWholeFile(const std::string &filename, std::string &content)
+    {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open())
+            return false;
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        content.resize(size > 0 ? static_cast<size_t>(size) : 0);
+        if (size > 0)
+            file.read(&content[0], size);
+        return true;
+    }
+
+    void appendUtf8(std::string &out, unsigned codepoint)
+    {
+        if (codepoint < 0x80)
+        {
+            out += static_cast<char>(codepoint);
+        }
+        else if (codepoint < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (codepoint >> 6));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (codepoint >> 12));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (codepoint >> 18));
+            out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// JSONValue
+// ---------------------------------------------------------------------------
+
+JSONValue JSONValue::array()
+{
+    JSONValue value;
+    value.type = Type::Array;
+    return value;
+}
+
+JSONValue JSONValue::object()
+{
+    JSONValue value;
+    value.type = Type::Object;
+    return value;
+}
+
+bool JSONValue::asBool(bool fallback) const
+{
+    return type == Type::Boolean ? boolean : fallback;
+}
+
+double JSONValue::asNumber(double fallback) const
+{
+    return type == Type::Number ? number : fallback;
+}
+
+std::string JSONValue::asString(const std::string &fallback) const
+{
+    return type == Type::String ? text : fallback;
+}
+
+size_t JSONValue::size() const
+{
+    if (type == Type::Array)
+        return elements.size();
+    if (type == Type::Object)
+        return fields.size();
+    return 0;
+}
+
+const JSONValue &JSONValue::operator[](size_t index) const
+{
+    return (type == Type::Array && index < elements.size()) ? elements[index] : nullValue();
+}
+
+const JSONValue *JSONValue::find(std::string_view key) const
+{
+    if (type != Type::Object)
+        return nullptr;
+    for (const auto &member : fields)
+    {
+        if (member.first == key)
+            return &member.second;
+    }
+    return nullptr;
+}
+
+const JSONValue &JSONValue::get(std::string_view key) const
+{
+    const JSONValue *value = find(key);
+    return value ? *value : nullValue();
+}
+
+JSONValue &JSONValue::append(JSONValue value)
+{
+    if (type != Type::Array)
+        *this = array();
+    elements.push_back(std::move(value));
+    return elements.back();
+}
+
+JSONValue &JSONValue::set(const std::string &key, JSONValue value)
+{
+    if (type != Type::Object)
+        *this = object();
+    for (auto &member : fields)
+    {
+        if (member.first == key)
+        {
+            member.second = std::move(value);
+            return member.second;
+        }
+    }
+    fields.emplace_back(key, std::move(value));
+    return fields.back().second;
+}
+
+namespace
+{
+    void dumpValue(JSONWriter &writer, const JSONValue &value)
+    {
+        switch (value.getType())
+        {
+        case JSONValue::Type::Null:
+            writer.null();
+            break;
+        case JSONValue::Type::Boolean:
+            writer.value(value.asBool());
+            break;
+        case JSONValue::Type::Number:
+            writer.value(value.asNumber());
+            break;
+        case JSONValue::Type::String:
+            writer.value(value.asString());
+            break;
+        case JSONValue::Type::Array:
+            writer.beginArray();
+            for (const auto &item : value.items())
+                dumpValue(writer, item);
+            writer.endArray();
+            break;
+        case JSONValue::Type::Object:
+            writer.beginObject();
+            for (const auto &member : value.members())
+            {
+                writer.key(member.first);
+                dumpValue(writer, member.second);
+            }
+            writer.endObject();
+            break;
+        }
+    }
+}
+
+std::string JSONValue::dump(int indent) const
+{
+    std::ostringstream out;
+    JSONWriter writer(out, indent);
+    dumpValue(writer, *this);
+    return out.str();
+}
+
+// ---------------------------------------------------------------------------
+// DOM construction on top of the SAX interface
+// ---------------------------------------------------------------------------
+
+class JSONDocumentBuilder : public JSONSaxHandler
+{
+public:
+    explicit JSONDocumentBuilder(JSONValue &root) : root(root) {}
+
+    bool onNull() override
+    {
+        add(JSONValue());
+        return true;
+    }
+    bool onBool(bool value) override
+    {
+        add(JSONValue(value));
+        return true;
+    }
+    bool onNumber(double value) override
+    {
+        add(JSONValue(value));
+        return true;
+    }
+    bool onString(std::string_view value) override
+    {
+        add(JSONValue(std::string(value)));
+        return true;
+    }
+    bool onKey(std::string_view key) override
+    {
+        pendingKey.assign(key.data(), key.size());
+        return true;
+    }
+    bool onStartObject() override
+    {
+        stack.push_back(&add(JSONValue::object()));
+        return true;
+    }
+    bool onEndObject() override
+    {
+        stack.pop_back();
+        return true;
+    }
+    bool onStartArray() override
+    {
+        stack.push_back(&add(JSONValue::array()));
+        return true;
+    }
+    bool onEndArray() override
+    {
+        stack.pop_back();
+        return true;
+    }
+
+private:
+    // Children are appended to the innermost open container; pointers stay valid
+    // because a container only grows while it is the innermost one
+    JSONValue &add(JSONValue value)
+    {
+        if (stack.empty())
+        {
+            root = std::move(value);
+            return root;
+        }
+        JSONValue &parent = *stack.back();
+        if (parent.type == JSONValue::Type::Array)
+        {
+            parent.elements.push_back(std::move(value));
+            return parent.elements.back();
+        }
+        parent.fields.emplace_back(std::move(pendingKey), std::move(value));
+        pendingKey.clear();
+        return parent.fields.back().second;
+    }
+
+    JSONValue &root;
+    std::vector<JSONValue *> stack;
+    std::string pendingKey;
+};
+
+// ---------------------------------------------------------------------------
+// JSONReader
+// ---------------------------------------------------------------------------
+
+bool JSONReader::parse(std::string_view text, JSONSaxHandler &handler)
+{
+    begin = text.data();
+    cursor = begin;
+    end = begin + text.size();
+    lastError.clear();
+    errorOffset = 0;
+
+    skipWhitespace();
+    if (!parseValue(handler, 0))
+        return false;
+    skipWhitespace();
+    if (cursor != end)
+        return fail("Unexpected trailing characters");
+    return true;
+}
+
+bool JSONReader::parse(std::string_view text, JSONValue &root)
+{
+    root = JSONValue();
+    JSONDocumentBuilder builder(root);
+    return parse(text, builder);
+}
+
+bool JSONReader::parseFile(const std::string &filename, JSONSaxHandler &handler)
+{
+    std::string content;
+    if (!readWholeFile(filename, content))
+    {
+        lastError = "Cannot open " + filename;
+        return false;
+    }
+    return parse(content, handler);
+}
+
+bool JSONReader::parseFile(const std::string &filename, JSONValue &root)
+{
+    std::string content;
+    if (!readWholeFile(filename, content))
+    {
+        lastError = "Cannot open " + filename;
+        return false;
+    }
+    return parse(content, root);
+}
+
+std::string JSONReader::getLastError() const
+{
+    return lastError;
+}
+
+size_t JSONReader::getErrorOffset() const
+{
+    return errorOffset;
+}
+
+void JSONReader::setMaxDepth(int depth)
+{
+    maxDepth = depth;
+}
+
+bool JSONReader::fail(const std::string &message)
+{
+    if (lastError.empty())
+    {
+        errorOffset = static_cast<size_t>(cursor - begin);
+        lastError = message + " at offset " + std::to_string(errorOffset);
+    }
+    return false;
+}
+
+void JSONReader::skipWhitespace()
+{
+    while (cursor < end && (*cursor == ' ' || *cursor == '\n' || *cursor == '\r' || *cursor == '\t'))
+        ++cursor;
+}
+
+bool JSONReader::parseValue(JSONSaxHandler &handler, int depth)
+{
+    if (cursor >= end)
+        return fail("Unexpected end of input");
+
+    switch (*cursor)
+    {
+    case '{':
+        return parseObject(handler, depth + 1);
+    case '[':
+        return parseArray(handler, depth + 1);
+    case '"':
+    {
+        std::string_view text;
+        if (!parseString(text))
+            return false;
+        return handler.onString(text) || fail("Parse aborted by handler");
+    }
+    case 't':
+        return (parseLiteral("true") && handler.onBool(true)) || fail("Invalid literal");
+    case 'f':
+        return (parseLiteral("false") && handler.onBool(false)) || fail("Invalid literal");
+    case 'n':
+        return (parseLiteral("null") && handler.onNull()) || fail("Invalid literal");
+    default:
+    {
+        double number = 0.0;
+        if (!parseNumber(number))
+            return false;
+        return handler.onNumber(number) || fail("Parse aborted by handler");
+    }
+    }
+}
+
+bool JSONReader::parseObject(JSONSaxHandler &handler, int depth)
+{
+    if (depth > maxDepth)
+        return fail("Nesting too deep");
+    ++cursor; // '{'
+    if (!handler.onStartObject())
+        return fail("Parse aborted by handler");
+
+    skipWhitespace();
+    if (cursor < end && *cursor == '}')
+    {
+        ++cursor;
+        return handler.onEndObject() || fail("Parse aborted by handler");
+    }
+
+    while (true)
+    {
+        skipWhitespace();
+        if (cursor >= end || *cursor != '"')
+            return fail("Expected member name");
+        std::string_view key;
+        if (!parseString(key))
+            return false;
+        if (!handler.onKey(key))
+            return fail("Parse aborted by handler");
+
+        skipWhitespace();
+        if (cursor >= end || *cursor != ':')
+            return fail("Expected ':'");
+        ++cursor;
+        skipWhitespace();
+        if (!parseValue(handler, depth))
+            return false;
+
+        skipWhitespace();
+        if (cursor < end && *cursor == ',')
+        {
+            ++cursor;
+            continue;
+        }
+        if (cursor < end && *cursor == '}')
+        {
+            ++cursor;
+            return handler.onEndObject() || fail("Parse aborted by handler");
+        }
+        return fail("Expected ',' or '}'");
+    }
+}
+
+bool JSONReader::parseArray(JSONSaxHandler &handler, int depth)
+{
+    if (depth > maxDepth)
+        return fail("Nesting too deep");
+    ++cursor; // '['
+    if (!handler.onStartArray())
+        return fail("Parse aborted by handler");
+
+    skipWhitespace();
+    if (cursor < end && *cursor == ']')
+    {
+        ++cursor;
+        return handler.onEndArray() || fail("Parse aborted by handler");
+    }
+
+    while (true)
+    {
+        skipWhitespace();
+        if (!parseValue(handler, depth))
+            return false;
+        skipWhitespace();
+        if (cursor < end && *cursor == ',')
+        {
+            ++cursor;
+            continue;
+        }
+        if (cursor < end && *cursor == ']')
+        {
+            ++cursor;
+            return handler.onEndArray() || fail("Parse aborted by handler");
+        }
+        return fail("Expected ',' or ']'");
+    }
+}
+
+bool JSONReader::parseString(std::string_view &out)
+{
+    ++cursor; // opening quote
+    const char *start = cursor;
+
+    // Fast path: no escapes, hand out a view into the input
+    while (cursor < end && *cursor != '"' && *cursor != '\\')
+    {
+        if (static_cast<unsigned char>(*cursor) < 0x20)
+            return fail("Control character in string");
+        ++cursor;
+    }
+    if (cursor >= end)
+        return fail("Unterminated string");
+    if (*cursor == '"')
+    {
+        out = std::string_view(start, static_cast<size_t>(cursor - start));
+        ++cursor;
+        return true;
+    }
+
+    // Slow path: decode into the scratch buffer
+    scratch.assign(start, cursor);
+    while (cursor < end && *cursor != '"')
     {
-        auto pos = line.find(':');
-        if (pos != std::string::npos)
+        char c = *cursor++;
+        if (static_cast<unsigned char>(c) < 0x20)
+            return fail("Control character in string");
+        if (c != '\\')
+        {
+            scratch += c;
+            continue;
+        }
+        if (cursor >= end)
+            return fail("Unterminated escape");
+        char escape = *cursor++;
+        switch (escape)
+        {
+        case '"':
+            scratch += '"';
+            break;
+        case '\\':
+            scratch += '\\';
+            break;
+        case '/':
+            scratch += '/';
+            break;
+        case 'b':
+            scratch += '\b';
+            break;
+        case 'f':
+            scratch += '\f';
+            break;
+        case 'n':
+            scratch += '\n';
+            break;
+        case 'r':
+            scratch += '\r';
+            break;
+        case 't':
+            scratch += '\t';
+            break;
+        case 'u':
         {
-            std::string key = line.substr(0, pos);
-            std::string value = line.substr(pos + 1);
-            data[key] = value;
+            auto readHex = [this](unsigned &value)
+            {
+                if (end - cursor < 4)
+                    return false;
+                value = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    char h = *cursor++;
+                    value <<= 4;
+                    if (h >= '0' && h <= '9')
+                        value |= static_cast<unsigned>(h - '0');
+                    else if (h >= 'a' && h <= 'f')
+                        value |= static_cast<unsigned>(h - 'a' + 10);
+                    else if (h >= 'A' && h <= 'F')
+                        value |= static_cast<unsigned>(h - 'A' + 10);
+                    else
+                        return false;
+                }
+                return true;
+            };
+            unsigned codepoint = 0;
+            if (!readHex(codepoint))
+                return fail("Invalid unicode escape");
+            if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+            {
+                unsigned low = 0;
+                if (end - cursor < 6 || cursor[0] != '\\' || cursor[1] != 'u')
+                    return fail("Unpaired surrogate");
+                cursor += 2;
+                if (!readHex(low) || low < 0xDC00 || low > 0xDFFF)
+                    return fail("Invalid surrogate pair");
+                codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+            appendUtf8(scratch, codepoint);
+            break;
+        }
+        default:
+            return fail("Invalid escape sequence");
         }
     }
+    if (cursor >= end)
+        return fail("Unterminated string");
+    ++cursor;
+    out = scratch;
+    return true;
+}
+
+bool JSONReader::parseNumber(double &out)
+{
+    const char *start = cursor;
+    bool negative = false;
+    if (cursor < end && *cursor == '-')
+    {
+        negative = true;
+        ++cursor;
+    }
+    if (cursor >= end || *cursor < '0' || *cursor > '9')
+        return fail("Invalid value");
+
+    // Integer fast path covers weights, counts, ids and most coordinates' prefixes
+    unsigned long long integer = 0;
+    int digits = 0;
+    if (*cursor == '0')
+    {
+        ++cursor;
+        digits = 1;
+    }
+    else
+    {
+        while (cursor < end && *cursor >= '0' && *cursor <= '9')
+        {
+            integer = integer * 10 + static_cast<unsigned>(*cursor - '0');
+            ++cursor;
+            ++digits;
+        }
+    }
+
+    bool isInteger = true;
+    if (cursor < end && *cursor == '.')
+    {
+        isInteger = false;
+        ++cursor;
+        if (cursor >= end || *cursor < '0' || *cursor > '9')
+            return fail("Invalid number");
+        while (cursor < end && *cursor >= '0' && *cursor <= '9')
+            ++cursor;
+    }
+    if (cursor < end && (*cursor == 'e' || *cursor == 'E'))
+    {
+        isInteger = false;
+        ++cursor;
+        if (cursor < end && (*cursor == '+' || *cursor == '-'))
+            ++cursor;
+        if (cursor >= end || *cursor < '0' || *cursor > '9')
+            return fail("Invalid number");
+        while (cursor < end && *cursor >= '0' && *cursor <= '9')
+            ++cursor;
+    }
+
+    if (isInteger && digits <= 15)
+    {
+        out = negative ? -static_cast<double>(integer) : static_cast<double>(integer);
+        return true;
+    }
+
+    // strtod needs a terminated buffer; JSON numbers are short enough for the stack
+    char buffer[64];
+    size_t length = static_cast<size_t>(cursor - start);
+    if (length >= sizeof(buffer))
+    {
+        std::string copy(start, length);
+        out = std::strtod(copy.c_str(), nullptr);
+        return true;
+    }
+    std::memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    out = std::strtod(buffer, nullptr);
+    return true;
+}
+
+bool JSONReader::parseLiteral(const char *literal)
+{
+    size_t length = std::strlen(literal);
+    if (static_cast<size_t>(end - cursor) < length || std::strncmp(cursor, literal, length) != 0)
+        return false;
+    cursor += length;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// JSONWriter
+// ---------------------------------------------------------------------------
+
+JSONWriter::JSONWriter(std::ostream &out, int indent) : out(out), indent(indent) {}
+
+void JSONWriter::newline()
+{
+    if (indent < 0)
+        return;
+    out << '\n';
+    for (size_t i = 0; i < levels.size() * static_cast<size_t>(indent); ++i)
+        out << ' ';
+}
+
+void JSONWriter::beforeValue()
+{
+    if (afterKey)
+    {
+        afterKey = false;
+        return;
+    }
+    if (!levels.empty())
+    {
+        if (!levels.back().empty)
+            out << ',';
+        levels.back().empty = false;
+        newline();
+    }
+}
+
+JSONWriter &JSONWriter::beginObject()
+{
+    beforeValue();
+    out << '{';
+    levels.push_back({false, true});
+    return *this;
+}
+
+JSONWriter &JSONWriter::endObject()
+{
+    bool empty = levels.back().empty;
+    levels.pop_back();
+    if (!empty)
+        newline();
+    out << '}';
+    if (levels.empty() && indent >= 0)
+        out << '\n';
+    return *this;
+}
+
+JSONWriter &JSONWriter::beginArray()
+{
+    beforeValue();
+    out << '[';
+    levels.push_back({true, true});
+    return *this;
+}
+
+JSONWriter &JSONWriter::endArray()
+{
+    bool empty = levels.back().empty;
+    levels.pop_back();
+    if (!empty)
+        newline();
+    out << ']';
+    if (levels.empty() && indent >= 0)
+        out << '\n';
+    return *this;
+}
+
+JSONWriter &JSONWriter::key(std::string_view name)
+{
+    beforeValue();
+    writeEscaped(out, name);
+    out << (indent >= 0 ? ": " : ":");
+    afterKey = true;
+    return *this;
+}
+
+JSONWriter &JSONWriter::value(std::string_view text)
+{
+    beforeValue();
+    writeEscaped(out, text);
+    return *this;
+}
+
+JSONWriter &JSONWriter::value(const char *text)
+{
+    return value(std::string_view(text));
+}
+
+JSONWriter &JSONWriter::value(const std::string &text)
+{
+    return value(std::string_view(text));
+}
+
+JSONWriter &JSONWriter::value(double number)
+{
+    beforeValue();
+    writeNumber(out, number);
+    return *this;
+}
+
+JSONWriter &JSONWriter::value(int number)
+{
+    beforeValue();
+    out << number;
+    return *this;
+}
+
+JSONWriter &JSONWriter::value(long long number)
+{
+    beforeValue();
+    out << number;
+    return *this;
+}
+
+JSONWriter &JSONWriter::value(bool flag)
+{
+    beforeValue();
+    out << (flag ? "true" : "false");
+    return *this;
+}
+
+JSONWriter &JSONWriter::null()
+{
+    beforeValue();
+    out << "null";
+    return *this;
+}
+
+JSONWriter &JSONWriter::raw(std::string_view json)
+{
+    beforeValue();
+    out << json;
+    return *this;
+}
+
+void JSONWriter::writeEscaped(std::ostream &out, std::string_view text)
+{
+    out << '"';
+    size_t runStart = 0;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c != '"' && c != '\\' && c >= 0x20)
+            continue;
+
+        out.write(text.data() + runStart, static_cast<std::streamsize>(i - runStart));
+        runStart = i + 1;
+        switch (c)
+        {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\r':
+            out << "\\r";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        case '\b':
+            out << "\\b";
+            break;
+        case '\f':
+            out << "\\f";
+            break;
+        default:
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        }
+        }
+    }
+    out.write(text.data() + runStart, static_cast<std::streamsize>(text.size() - runStart));
+    out << '"';
+}
+
+void JSONWriter::writeNumber(std::ostream &out, double number)
+{
+    if (!std::isfinite(number))
+    {
+        out << "null"; // JSON has no NaN or infinity
+        return;
+    }
+    if (number == std::floor(number) && std::fabs(number) < 1e15)
+    {
+        out << static_cast<long long>(number);
+        return;
+    }
+
+    // Shortest of %.15g / %.17g that round-trips
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", number);
+    if (std::strtod(buffer, nullptr) != number)
+        std::snprintf(buffer, sizeof(buffer), "%.17g", number);
+    out << buffer;
+}
+
+// ---------------------------------------------------------------------------
+// JSONHandler
+// ---------------------------------------------------------------------------
+
+std::map<std::string, std::string> JSONHandler::parseJSON(const std::string &filename,
+                                                         std::set<std::string> *rawKeys)
+{
+    std::map<std::string, std::string> data;
+    JSONValue root;
+    JSONReader reader;
+    if (!reader.parseFile(filename, root) || !root.isObject())
+        return data;
+
+    for (const auto &member : root.members())
+    {
+        data[member.first] = member.second.isString() ? member.second.asString() : member.second.dump();
+        if (rawKeys && !member.second.isString())
+            rawKeys->insert(member.first);
+    }
     return data;
 }
 
-bool JSONHandler::writeJSON(const std::string &filename, const std::map<std::string, std::string> &data)
+bool JSONHandler::writeJSON(const std::string &filename, const std::map<std::string, std::string> &data,
+                            const std::set<std::string> &rawKeys)
 {
     std::ofstream file(filename);
     if (!file.is_open())
         return false;
+
+    JSONWriter writer(file);
+    JSONReader reader;
+    JSONSaxHandler validator; // Accepts every event, only checks syntax
+    writer.beginObject();
     for (const auto &kv : data)
     {
-        file << kv.first << ":" << kv.second << "\n";
+        writer.key(kv.first);
+        // Only values that were not strings in the source go out verbatim, so "123" stays a string
+        bool isJSON = rawKeys.count(kv.first) && reader.parse(kv.second, validator);
+        if (isJSON)
+            writer.raw(kv.second);
+        else
+            writer.value(kv.second);
+    }
+    writer.endObject();
+    return file.good();
+}
+
+namespace
+{
+    // Streams {"nodes":[...], "edges":[...]} straight into a Graph without a DOM. Records
+    // are applied in batches through the bulk Graph calls, which print nothing per element
+    class NetworkLoader : public JSONSaxHandler
+    {
+    public:
+        explicit NetworkLoader(Graph &graph) : graph(graph) {}
+
+        bool onStartObject() override
+        {
+            ++depth;
+            if (depth == 3)
+                resetRecord();
+            return true;
+        }
+        bool onEndObject() override
+        {
+            if (depth == 3)
+                commitRecord();
+            --depth;
+            return true;
+        }
+        bool onStartArray() override
+        {
+            ++depth;
+            return true;
+        }
+        bool onEndArray() override
+        {
+            --depth;
+            if (depth == 1)
+            {
+                flush();
+                section = Section::None;
+            }
+            return true;
+        }
+        bool onKey(std::string_view key) override
+        {
+            if (depth == 1)
+                section = key == "nodes" ? Section::Nodes : key == "edges" ? Section::Edges : Section::None;
+            else if (depth == 3)
+                currentKey.assign(key.data(), key.size());
+            return true;
+        }
+        bool onString(std::string_view value) override
+        {
+            if (depth != 3)
+                return true;
+            if (currentKey == "name" || currentKey == "id")
+                name.assign(value.data(), value.size());
+            else if (currentKey == "source" || currentKey == "from")
+                source.assign(value.data(), value.size());
+            else if (currentKey == "destination" || currentKey == "to")
+                destination.assign(value.data(), value.size());
+            else if (currentKey == "mode" || currentKey == "transport_mode")
+                mode.assign(value.data(), value.size());
+            return true;
+        }
+        bool onNumber(double value) override
+        {
+            if (depth != 3)
+                return true;
+            if (currentKey == "latitude" || currentKey == "lat")
+                latitude = value;
+            else if (currentKey == "longitude" || currentKey == "lon")
+                longitude = value;
+            else if (currentKey == "distance" || currentKey == "distance_m")
+                distance = static_cast<int>(value);
+            else if (currentKey == "time" || currentKey == "time_min")
+                time = static_cast<int>(value);
+            else if (currentKey == "cost" || currentKey == "cost_idr")
+                cost = static_cast<int>(value);
+            else if (currentKey == "transfers" || currentKey == "transit")
+                transfers = static_cast<int>(value);
+            return true;
+        }
+
+        // Apply the buffered records; nodes first, since the edges may need them
+        void flush()
+        {
+            nodesLoaded += static_cast<int>(graph.addNodes(newNodes));
+            graph.updateNodes(changedNodes);
+            edgesLoaded += static_cast<int>(graph.addEdges(newEdges));
+            newNodes.clear();
+            changedNodes.clear();
+            newEdges.clear();
+            pendingNames.clear();
+        }
+
+        int nodesLoaded = 0;
+        int edgesLoaded = 0;
+
+    private:
+        static const size_t BATCH_SIZE = 4096;
+
+        enum class Section
+        {
+            None,
+            Nodes,
+            Edges
+        };
+
+        void resetRecord()
+        {
+            name.clear();
+            source.clear();
+            destination.clear();
+            mode = "unknown";
+            latitude = longitude = 0.0;
+            distance = time = cost = transfers = 0;
+        }
+
+        bool isKnown(const std::string &node) const
+        {
+            return graph.hasNode(node) || pendingNames.count(node) > 0;
+        }
+
+        // A later record for the same node wins, as it did with addNode/updateNode
+        void stageNode(const std::string &node, double lat, double lon)
+        {
+            try
+            {
+                if (isKnown(node))
+                    changedNodes.emplace_back(node, lat, lon);
+                else
+                {
+                    newNodes.emplace_back(node, lat, lon);
+                    pendingNames.insert(node);
+                }
+            }
+            catch (const std::invalid_argument &)
+            {
+                // Out-of-range coordinates; addNode rejected these as well
+            }
+        }
+
+        void commitRecord()
+        {
+            if (section == Section::Nodes && !name.empty())
+            {
+                stageNode(name, latitude, longitude);
+            }
+            else if (section == Section::Edges && !source.empty() && !destination.empty())
+            {
+                if (!isKnown(source))
+                    stageNode(source, 0.0, 0.0);
+                if (!isKnown(destination))
+                    stageNode(destination, 0.0, 0.0);
+                try
+                {
+                    newEdges.emplace_back(source, destination, distance, time, cost, transfers, mode);
+                }
+                catch (const std::invalid_argument &)
+                {
+                    // Negative weights; addEdge rejected these as well
+                }
+            }
+            if (newNodes.size() + changedNodes.size() + newEdges.size() >= BATCH_SIZE)
+                flush();
+        }
+
+        Graph &graph;
+        Section section = Section::None;
+        int depth = 0;
+        std::string currentKey;
+        std::string name, source, destination, mode;
+        double latitude = 0.0, longitude = 0.0;
+        int distance = 0, time = 0, cost = 0, transfers = 0;
+        std::vector<Node> newNodes, changedNodes;
+        std::vector<Edge> newEdges;
+        std::unordered_set<std::string> pendingNames; // Staged in newNodes, not yet in graph
+    };
+}
+
+bool JSONHandler::loadGraph(const std::string &filename, Graph &graph)
+{
+    NetworkLoader loader(graph);
+    JSONReader reader;
+    bool parsed = reader.parseFile(filename, loader);
+    loader.flush(); // Records before a syntax error are kept, as before batching
+    if (!parsed)
+    {
+        lastError = reader.getLastError();
+        return false;
     }
     return true;
 }
+
+bool JSONHandler::saveGraph(const std::string &filename, const Graph &graph)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        lastError = "Cannot open " + filename + " for writing";
+        return false;
+    }
+
+    JSONWriter writer(file);
+    writer.beginObject();
+
+    writer.key("nodes").beginArray();
+    for (const auto &node : graph.getNodes())
+    {
+        writer.beginObject()
+            .key("name")
+            .value(node.getName())
+            .key("latitude")
+            .value(node.getLatitude())
+            .key("longitude")
+            .value(node.getLongitude())
+            .endObject();
+    }
+    writer.endArray();
+
+    writer.key("edges").beginArray();
+    for (const auto &edge : graph.getEdges())
+    {
+        writer.beginObject()
+            .key("source")
+            .value(edge.getSource())
+            .key("destination")
+            .value(edge.getDestination())
+            .key("distance")
+            .value(edge.getDistance())
+            .key("time")
+            .value(edge.getTime())
+            .key("cost")
+            .value(edge.getCost())
+            .key("transfers")
+            .value(edge.getTransfers())
+            .key("mode")
+            .value(edge.getTransportMode())
+            .endObject();
+    }
+    writer.endArray();
+
+    writer.endObject();
+    return file.good();
+}
+
+std::string JSONHandler::getLastError() const
+{
+    return lastError;
+}
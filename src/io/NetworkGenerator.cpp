@@ -0,0 +1,343 @@
+#include "../../include/io/NetworkGenerator.h"
+#include "../../include/io/NetworkJournal.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+    const double METERS_PER_DEGREE_LATITUDE = 111320.0;
+    const double PI = 3.14159265358979323846;
+
+    // Typical speeds in metres per minute, including stops along the way
+    const double BUS_SPEED = 300.0;  // 18 km/h in Jakarta traffic
+    const double RAIL_SPEED = 600.0; // 36 km/h between stations
+    const int TRANSFER_MINUTES = 4;
+
+    // Salts keep the random streams of different properties independent
+    enum Salt : uint64_t
+    {
+        JITTER_NORTH = 1,
+        JITTER_EAST,
+        DETOUR,
+        DELAY,
+        TRANSFER,
+        CORRIDOR_ANGLE
+    };
+
+    uint64_t splitMix64(uint64_t value)
+    {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    std::string stopId(uint64_t index)
+    {
+        return "S" + std::to_string(index);
+    }
+}
+
+NetworkGenerator::NetworkGenerator(const Options &generatorOptions)
+    : options(generatorOptions)
+{
+    options.stopCount = std::max<uint64_t>(options.stopCount, 1);
+    options.corridorStopSpacing = std::max(options.corridorStopSpacing, 1);
+    columns = static_cast<uint64_t>(std::ceil(std::sqrt(static_cast<double>(options.stopCount))));
+    rows = (options.stopCount + columns - 1) / columns;
+    blockMeters = options.blockMeters;
+    if (columns > 1)
+        blockMeters = std::min(blockMeters, options.maxExtentMeters / static_cast<double>(columns - 1));
+    metersPerDegreeLongitude = METERS_PER_DEGREE_LATITUDE * std::cos(options.centerLatitude * PI / 180.0);
+    buildCorridors();
+}
+
+NetworkGenerator::Stop NetworkGenerator::stop(uint64_t index) const
+{
+    int64_t row = static_cast<int64_t>(index / columns);
+    int64_t column = static_cast<int64_t>(index % columns);
+    double north, east;
+    offsetFromCenter(index, north, east);
+
+    // Districts as seen from Monas: the centre is Pusat, the rest by dominant direction
+    const char *district;
+    if (std::fabs(north) < 3000.0 && std::fabs(east) < 3000.0)
+        district = "Jakarta Pusat";
+    else if (std::fabs(north) >= std::fabs(east))
+        district = north > 0 ? "Jakarta Utara" : "Jakarta Selatan";
+    else
+        district = east > 0 ? "Jakarta Timur" : "Jakarta Barat";
+
+    auto corridor = corridorNeighbours.find(index);
+    int gridNeighbours = (exists(row - 1, column) ? 1 : 0) + (exists(row + 1, column) ? 1 : 0) +
+                         (exists(row, column - 1) ? 1 : 0) + (exists(row, column + 1) ? 1 : 0);
+
+    Stop result;
+    result.index = index;
+    result.id = stopId(index);
+    result.name = std::string(corridor == corridorNeighbours.end() ? "Halte " : "Stasiun ") +
+                  std::to_string(index) + " (" + district + ")";
+    result.latitude = options.centerLatitude + north / METERS_PER_DEGREE_LATITUDE;
+    result.longitude = options.centerLongitude + east / metersPerDegreeLongitude;
+    result.connections = gridNeighbours +
+                         (corridor == corridorNeighbours.end() ? 0 : static_cast<int>(corridor->second.size()));
+    return result;
+}
+
+void NetworkGenerator::forEachStop(const std::function<void(const Stop &)> &visit) const
+{
+    for (uint64_t index = 0; index < options.stopCount; ++index)
+        visit(stop(index));
+}
+
+void NetworkGenerator::forEachLink(const std::function<void(const Link &)> &visit) const
+{
+    for (uint64_t index = 0; index < options.stopCount; ++index)
+        linkAll(index, visit);
+}
+
+uint64_t NetworkGenerator::getStopCount() const
+{
+    return options.stopCount;
+}
+
+uint64_t NetworkGenerator::getLinkCount() const
+{
+    uint64_t fullRows = options.stopCount / columns;
+    uint64_t remainder = options.stopCount % columns;
+    uint64_t horizontal = fullRows * (columns - 1) + (remainder > 0 ? remainder - 1 : 0);
+    uint64_t vertical = options.stopCount > columns ? options.stopCount - columns : 0;
+    return 2 * (horizontal + vertical) + corridorLinks;
+}
+
+bool NetworkGenerator::writeCSV(const std::string &networkPath, const std::string &nodesPath)
+{
+    std::ofstream nodes(nodesPath);
+    std::ofstream network(networkPath);
+    if (!nodes.is_open() || !network.is_open())
+    {
+        lastError = "Cannot open " + (nodes.is_open() ? networkPath : nodesPath) + " for writing";
+        return false;
+    }
+    nodes << std::fixed << std::setprecision(6);
+    network << std::fixed << std::setprecision(6);
+
+    nodes << "id,name,latitude,longitude,connections\n";
+    forEachStop([&nodes](const Stop &stop)
+                { nodes << stop.id << ',' << stop.name << ',' << stop.latitude << ',' << stop.longitude << ','
+                        << stop.connections << '\n'; });
+
+    network << "from,to,distance,time,cost,transfers,mode,from_lat,from_lon,to_lat,to_lon,from_name,to_name\n";
+    for (uint64_t index = 0; index < options.stopCount; ++index)
+    {
+        Stop from = stop(index);
+        linkAll(index, [&](const Link &link)
+                {
+            Stop to = stop(link.to);
+            network << from.id << ',' << to.id << ',' << link.distance << ',' << link.time << ',' << link.cost << ','
+                    << link.transfers << ',' << link.mode << ',' << from.latitude << ',' << from.longitude << ','
+                    << to.latitude << ',' << to.longitude << ',' << from.name << ',' << to.name << '\n'; });
+    }
+
+    nodes.flush();
+    network.flush();
+    if (!nodes || !network)
+    {
+        lastError = "Failed while writing " + (nodes ? networkPath : nodesPath);
+        return false;
+    }
+    return true;
+}
+
+bool NetworkGenerator::writeSnapshot(const std::string &basePath)
+{
+    NetworkJournal::SnapshotWriter writer(NetworkJournal(basePath).getSnapshotPath(), 0);
+    if (!writer.open())
+    {
+        lastError = writer.getLastError();
+        return false;
+    }
+
+    NetworkJournal::Mutation mutation;
+    mutation.operation = NetworkJournal::Operation::AddNode;
+    forEachStop([&](const Stop &stop)
+                {
+        mutation.source = stop.id;
+        mutation.latitude = stop.latitude;
+        mutation.longitude = stop.longitude;
+        writer.write(mutation); });
+
+    mutation = NetworkJournal::Mutation();
+    mutation.operation = NetworkJournal::Operation::AddEdge;
+    forEachLink([&](const Link &link)
+                {
+        mutation.source = stopId(link.from);
+        mutation.destination = stopId(link.to);
+        mutation.distance = link.distance;
+        mutation.time = link.time;
+        mutation.cost = link.cost;
+        mutation.transfers = link.transfers;
+        mutation.mode = link.mode;
+        writer.write(mutation); });
+
+    if (!writer.finish())
+    {
+        lastError = writer.getLastError();
+        return false;
+    }
+    return true;
+}
+
+void NetworkGenerator::buildGraph(Graph &graph) const
+{
+    std::vector<Node> nodes;
+    nodes.reserve(getStopCount());
+    forEachStop([&nodes](const Stop &stop)
+                { nodes.emplace_back(stop.id, stop.latitude, stop.longitude); });
+    graph.addNodes(nodes);
+    nodes.clear();
+    nodes.shrink_to_fit();
+
+    std::vector<Edge> edges;
+    edges.reserve(getLinkCount());
+    forEachLink([&edges](const Link &link)
+                { edges.emplace_back(stopId(link.from), stopId(link.to), link.distance, link.time, link.cost,
+                                     link.transfers, link.mode); });
+    graph.addEdges(edges);
+}
+
+std::string NetworkGenerator::getLastError() const
+{
+    return lastError;
+}
+
+double NetworkGenerator::unit(uint64_t key, uint64_t salt) const
+{
+    uint64_t mixed = splitMix64(splitMix64(key ^ (static_cast<uint64_t>(options.seed) << 32)) + salt);
+    return static_cast<double>(mixed >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void NetworkGenerator::offsetFromCenter(uint64_t index, double &north, double &east) const
+{
+    double row = static_cast<double>(index / columns);
+    double column = static_cast<double>(index % columns);
+    north = (static_cast<double>(rows - 1) / 2.0 - row) * blockMeters +
+            (unit(index, JITTER_NORTH) - 0.5) * 0.3 * blockMeters;
+    east = (column - static_cast<double>(columns - 1) / 2.0) * blockMeters +
+           (unit(index, JITTER_EAST) - 0.5) * 0.3 * blockMeters;
+}
+
+bool NetworkGenerator::exists(int64_t row, int64_t column) const
+{
+    return row >= 0 && column >= 0 && static_cast<uint64_t>(column) < columns &&
+           static_cast<uint64_t>(row) < rows && indexOf(row, column) < options.stopCount;
+}
+
+uint64_t NetworkGenerator::indexOf(int64_t row, int64_t column) const
+{
+    return static_cast<uint64_t>(row) * columns + static_cast<uint64_t>(column);
+}
+
+void NetworkGenerator::linkAll(uint64_t from, const std::function<void(const Link &)> &visit) const
+{
+    int64_t row = static_cast<int64_t>(from / columns);
+    int64_t column = static_cast<int64_t>(from % columns);
+    const int64_t offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    for (const auto &offset : offsets)
+    {
+        if (exists(row + offset[0], column + offset[1]))
+            visit(makeLink(from, indexOf(row + offset[0], column + offset[1]), false));
+    }
+
+    auto corridor = corridorNeighbours.find(from);
+    if (corridor != corridorNeighbours.end())
+    {
+        for (uint64_t to : corridor->second)
+            visit(makeLink(from, to, true));
+    }
+}
+
+NetworkGenerator::Link NetworkGenerator::makeLink(uint64_t from, uint64_t to, bool corridor) const
+{
+    // Keyed on the unordered pair, so both directions of a link get the same weights
+    uint64_t key = splitMix64(std::min(from, to)) ^ std::max(from, to);
+    double fromNorth, fromEast, toNorth, toEast;
+    offsetFromCenter(from, fromNorth, fromEast);
+    offsetFromCenter(to, toNorth, toEast);
+    double straight = std::hypot(fromNorth - toNorth, fromEast - toEast);
+
+    // Exponential delay: most legs run close to schedule, a few are much slower
+    double delay = -std::log(1.0 - unit(key, DELAY)) * 0.35;
+
+    Link link;
+    link.from = from;
+    link.to = to;
+    if (corridor)
+    {
+        link.distance = static_cast<int>(std::lround(straight * 1.05));
+        link.time = static_cast<int>(std::ceil(link.distance / RAIL_SPEED * (1.0 + delay / 3.0))) + 1;
+        link.cost = std::min(14, 3 + link.distance / 1000);
+        link.transfers = 0;
+        link.mode = "MRT/LRT";
+    }
+    else
+    {
+        link.distance = static_cast<int>(std::lround(straight * (1.1 + 0.3 * unit(key, DETOUR))));
+        link.time = static_cast<int>(std::ceil(link.distance / BUS_SPEED * (1.0 + delay)));
+        link.cost = 3;
+        link.transfers = unit(key, TRANSFER) < options.transferShare ? 1 : 0;
+        link.mode = link.transfers ? "TransJakarta+Transfer" : "TransJakarta";
+        if (link.transfers)
+            link.time += TRANSFER_MINUTES;
+    }
+    link.distance = std::max(link.distance, 1);
+    link.time = std::max(link.time, 1);
+    return link;
+}
+
+void NetworkGenerator::buildCorridors()
+{
+    double centerRow = static_cast<double>(rows - 1) / 2.0;
+    double centerColumn = static_cast<double>(columns - 1) / 2.0;
+    int64_t hubRow = static_cast<int64_t>(std::lround(centerRow));
+    int64_t hubColumn = static_cast<int64_t>(std::lround(centerColumn));
+    if (options.corridors <= 0 || !exists(hubRow, hubColumn))
+        return;
+
+    auto connect = [this](uint64_t a, uint64_t b)
+    {
+        // Neighbouring grid stops already have a bus link; the graph holds one edge per pair
+        int64_t rowGap = std::llabs(static_cast<int64_t>(a / columns) - static_cast<int64_t>(b / columns));
+        int64_t columnGap = std::llabs(static_cast<int64_t>(a % columns) - static_cast<int64_t>(b % columns));
+        if (rowGap + columnGap <= 1)
+            return;
+        auto fromA = corridorNeighbours.find(a);
+        if (fromA != corridorNeighbours.end() &&
+            std::find(fromA->second.begin(), fromA->second.end(), b) != fromA->second.end())
+            return;
+        corridorNeighbours[a].push_back(b);
+        corridorNeighbours[b].push_back(a);
+        corridorLinks += 2;
+    };
+
+    double rotation = unit(0, CORRIDOR_ANGLE) * 2.0 * PI / options.corridors;
+    for (int corridor = 0; corridor < options.corridors; ++corridor)
+    {
+        double angle = rotation + 2.0 * PI * corridor / options.corridors;
+        uint64_t previous = indexOf(hubRow, hubColumn);
+        for (int step = 1;; ++step)
+        {
+            double reach = static_cast<double>(step) * options.corridorStopSpacing;
+            int64_t row = static_cast<int64_t>(std::lround(centerRow - reach * std::sin(angle)));
+            int64_t column = static_cast<int64_t>(std::lround(centerColumn + reach * std::cos(angle)));
+            if (!exists(row, column))
+                break;
+            uint64_t station = indexOf(row, column);
+            connect(previous, station);
+            previous = station;
+        }
+    }
+}
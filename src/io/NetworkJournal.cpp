@@ -0,0 +1,695 @@
+#include "../../include/io/NetworkJournal.h"
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const char SNAPSHOT_MAGIC[8] = {'T', 'N', 'S', 'N', 'A', 'P', '1', '\0'};
+    const uint32_t MAX_RECORD_BYTES = 1 << 20;
+
+    std::array<uint32_t, 256> buildCrcTable()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit)
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            table[i] = value;
+        }
+        return table;
+    }
+
+    // Fixed little-endian encoding so journals move between machines
+    void putU32(std::string &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    void putU64(std::string &out, uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    void putDouble(std::string &out, double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        putU64(out, bits);
+    }
+
+    void putString(std::string &out, const std::string &value)
+    {
+        putU32(out, static_cast<uint32_t>(value.size()));
+        out += value;
+    }
+
+    uint32_t readU32(const unsigned char *bytes)
+    {
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    uint64_t readU64(const unsigned char *bytes)
+    {
+        return static_cast<uint64_t>(readU32(bytes)) | (static_cast<uint64_t>(readU32(bytes + 4)) << 32);
+    }
+
+    class PayloadReader
+    {
+    public:
+        explicit PayloadReader(const std::string &payload)
+            : cursor(reinterpret_cast<const unsigned char *>(payload.data())), end(cursor + payload.size()) {}
+
+        bool u8(uint8_t &value)
+        {
+            if (end - cursor < 1)
+                return false;
+            value = *cursor++;
+            return true;
+        }
+
+        bool u32(uint32_t &value)
+        {
+            if (end - cursor < 4)
+                return false;
+            value = readU32(cursor);
+            cursor += 4;
+            return true;
+        }
+
+        bool i32(int &value)
+        {
+            uint32_t raw;
+            if (!u32(raw))
+                return false;
+            value = static_cast<int>(static_cast<int32_t>(raw));
+            return true;
+        }
+
+        bool f64(double &value)
+        {
+            if (end - cursor < 8)
+                return false;
+            uint64_t bits = readU64(cursor);
+            std::memcpy(&value, &bits, sizeof value);
+            cursor += 8;
+            return true;
+        }
+
+        bool text(std::string &value)
+        {
+            uint32_t length;
+            if (!u32(length) || static_cast<uint32_t>(end - cursor) < length)
+                return false;
+            value.assign(reinterpret_cast<const char *>(cursor), length);
+            cursor += length;
+            return true;
+        }
+
+        bool atEnd() const { return cursor == end; }
+
+    private:
+        const unsigned char *cursor;
+        const unsigned char *end;
+    };
+
+    enum class FrameStatus
+    {
+        Ok,
+        EndOfFile,
+        Corrupt
+    };
+
+    FrameStatus readFrame(std::istream &in, std::string &payload)
+    {
+        unsigned char header[8];
+        in.read(reinterpret_cast<char *>(header), sizeof header);
+        if (in.gcount() == 0)
+            return FrameStatus::EndOfFile;
+        if (in.gcount() != sizeof header)
+            return FrameStatus::Corrupt;
+
+        uint32_t length = readU32(header);
+        uint32_t checksum = readU32(header + 4);
+        if (length == 0 || length > MAX_RECORD_BYTES)
+            return FrameStatus::Corrupt;
+
+        payload.resize(length);
+        in.read(&payload[0], length);
+        if (static_cast<uint32_t>(in.gcount()) != length)
+            return FrameStatus::Corrupt;
+        if (NetworkJournal::crc32(payload.data(), payload.size()) != checksum)
+            return FrameStatus::Corrupt;
+        return FrameStatus::Ok;
+    }
+
+    /**
+     * Replays records through the bulk Graph calls, which print nothing per element.
+     * Consecutive records with the same operation form one batch, so the edits land in
+     * log order exactly as apply() would have made them.
+     */
+    class ReplayBatch
+    {
+    public:
+        explicit ReplayBatch(Graph &graph) : graph(graph) {}
+
+        void add(const NetworkJournal::Mutation &mutation)
+        {
+            if (!pending.empty() && (pending.front().operation != mutation.operation || pending.size() >= BATCH_SIZE))
+                flush();
+            pending.push_back(mutation);
+        }
+
+        void flush()
+        {
+            using Operation = NetworkJournal::Operation;
+            if (pending.empty())
+                return;
+
+            Operation operation = pending.front().operation;
+            if (operation == Operation::AddNode || operation == Operation::UpdateNode)
+            {
+                std::vector<Node> nodes;
+                nodes.reserve(pending.size());
+                for (const NetworkJournal::Mutation &mutation : pending)
+                {
+                    try
+                    {
+                        nodes.emplace_back(mutation.source, mutation.latitude, mutation.longitude);
+                    }
+                    catch (const std::invalid_argument &)
+                    {
+                        // Rejected by addNode/updateNode as well
+                    }
+                }
+                if (operation == Operation::AddNode)
+                    graph.addNodes(nodes);
+                else
+                    graph.updateNodes(nodes);
+            }
+            else if (operation == Operation::AddEdge || operation == Operation::UpdateEdge)
+            {
+                std::vector<Edge> edges;
+                edges.reserve(pending.size());
+                for (const NetworkJournal::Mutation &mutation : pending)
+                {
+                    try
+                    {
+                        edges.emplace_back(mutation.source, mutation.destination, mutation.distance,
+                                           mutation.time, mutation.cost, mutation.transfers, mutation.mode);
+                    }
+                    catch (const std::invalid_argument &)
+                    {
+                        // Rejected by addEdge/updateEdge as well
+                    }
+                }
+                if (operation == Operation::AddEdge)
+                    graph.addEdges(edges);
+                else
+                    graph.updateEdges(edges);
+            }
+            else if (operation == Operation::RemoveNode)
+            {
+                std::vector<std::string> names;
+                names.reserve(pending.size());
+                for (const NetworkJournal::Mutation &mutation : pending)
+                    names.push_back(mutation.source);
+                graph.removeNodes(names);
+            }
+            else
+            {
+                std::vector<std::pair<std::string, std::string>> endpoints;
+                endpoints.reserve(pending.size());
+                for (const NetworkJournal::Mutation &mutation : pending)
+                    endpoints.emplace_back(mutation.source, mutation.destination);
+                graph.removeEdges(endpoints);
+            }
+            pending.clear();
+        }
+
+    private:
+        static const size_t BATCH_SIZE = 4096;
+
+        Graph &graph;
+        std::vector<NetworkJournal::Mutation> pending;
+    };
+}
+
+NetworkJournal::NetworkJournal(const std::string &basePath) : basePath(basePath) {}
+
+NetworkJournal::~NetworkJournal()
+{
+    waitForCompaction();
+}
+
+uint32_t NetworkJournal::crc32(const void *data, size_t length, uint32_t seed)
+{
+    static const std::array<uint32_t, 256> table = buildCrcTable();
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint32_t crc = ~seed;
+    for (size_t i = 0; i < length; ++i)
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+std::string NetworkJournal::getSnapshotPath() const
+{
+    return basePath + ".snapshot";
+}
+
+std::string NetworkJournal::getLogPath(uint64_t generation) const
+{
+    return basePath + ".log." + std::to_string(generation);
+}
+
+void NetworkJournal::encode(const Mutation &mutation, std::string &payload)
+{
+    payload.clear();
+    payload.push_back(static_cast<char>(mutation.operation));
+    putString(payload, mutation.source);
+    putString(payload, mutation.destination);
+    putDouble(payload, mutation.latitude);
+    putDouble(payload, mutation.longitude);
+    putU32(payload, static_cast<uint32_t>(mutation.distance));
+    putU32(payload, static_cast<uint32_t>(mutation.time));
+    putU32(payload, static_cast<uint32_t>(mutation.cost));
+    putU32(payload, static_cast<uint32_t>(mutation.transfers));
+    putString(payload, mutation.mode);
+}
+
+bool NetworkJournal::decode(const std::string &payload, Mutation &mutation)
+{
+    PayloadReader reader(payload);
+    uint8_t operation;
+    if (!reader.u8(operation) || operation < static_cast<uint8_t>(Operation::AddNode) ||
+        operation > static_cast<uint8_t>(Operation::RemoveEdge))
+        return false;
+    mutation.operation = static_cast<Operation>(operation);
+    return reader.text(mutation.source) && reader.text(mutation.destination) &&
+           reader.f64(mutation.latitude) && reader.f64(mutation.longitude) &&
+           reader.i32(mutation.distance) && reader.i32(mutation.time) &&
+           reader.i32(mutation.cost) && reader.i32(mutation.transfers) &&
+           reader.text(mutation.mode) && reader.atEnd();
+}
+
+void NetworkJournal::writeRecord(std::ostream &out, const std::string &payload)
+{
+    std::string header;
+    putU32(header, static_cast<uint32_t>(payload.size()));
+    putU32(header, crc32(payload.data(), payload.size()));
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+}
+
+bool NetworkJournal::apply(const Mutation &mutation, Graph &graph)
+{
+    switch (mutation.operation)
+    {
+    case Operation::AddNode:
+        return graph.addNode(mutation.source, mutation.latitude, mutation.longitude);
+    case Operation::UpdateNode:
+        return graph.updateNode(mutation.source, mutation.latitude, mutation.longitude);
+    case Operation::RemoveNode:
+        return graph.removeNode(mutation.source);
+    case Operation::AddEdge:
+        return graph.addEdge(mutation.source, mutation.destination, mutation.distance,
+                             mutation.time, mutation.cost, mutation.transfers, mutation.mode);
+    case Operation::UpdateEdge:
+        return graph.updateEdge(mutation.source, mutation.destination, mutation.distance,
+                                mutation.time, mutation.cost, mutation.transfers, mutation.mode);
+    case Operation::RemoveEdge:
+        return graph.removeEdge(mutation.source, mutation.destination);
+    }
+    return false;
+}
+
+bool NetworkJournal::open(Graph &graph)
+{
+    waitForCompaction();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (log.is_open())
+        log.close();
+    opened = false;
+
+    uint64_t generation = 0;
+    if (!loadSnapshot(graph, generation))
+        return false;
+
+    // Replay every consecutive generation the snapshot does not contain yet
+    uint64_t active = generation;
+    for (uint64_t current = generation; std::filesystem::exists(getLogPath(current)); ++current)
+    {
+        std::string path = getLogPath(current);
+        uint64_t goodBytes = replayLog(path, graph);
+        std::error_code error;
+        if (goodBytes < std::filesystem::file_size(path, error) && !error)
+        {
+            // Drop the torn tail so new records are not appended after garbage
+            std::cerr << "Warning: discarding corrupt tail of " << path << " after byte " << goodBytes << "\n";
+            std::filesystem::resize_file(path, goodBytes, error);
+            stats.tailsDiscarded++;
+        }
+        active = current;
+    }
+
+    removeLogsBefore(generation);
+    if (!openLog(active))
+        return false;
+
+    opened = true;
+    std::cout << "Network journal opened at generation " << active << " (" << stats.recordsReplayed
+              << " edits replayed)." << std::endl;
+    return true;
+}
+
+bool NetworkJournal::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return opened;
+}
+
+uint64_t NetworkJournal::replayLog(const std::string &path, Graph &graph)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+        return 0;
+
+    uint64_t goodBytes = 0;
+    std::string payload;
+    Mutation mutation;
+    ReplayBatch batch(graph);
+    while (true)
+    {
+        FrameStatus status = readFrame(in, payload);
+        if (status != FrameStatus::Ok || !decode(payload, mutation))
+            break;
+        batch.add(mutation);
+        stats.recordsReplayed++;
+        goodBytes += 8 + payload.size();
+    }
+    batch.flush();
+    return goodBytes;
+}
+
+bool NetworkJournal::loadSnapshot(Graph &graph, uint64_t &generation)
+{
+    generation = 0;
+    std::ifstream in(getSnapshotPath(), std::ios::binary);
+    if (!in.is_open())
+        return true; // No snapshot yet: the logs alone describe the network
+
+    unsigned char header[24];
+    in.read(reinterpret_cast<char *>(header), sizeof header);
+    if (in.gcount() != sizeof header || std::memcmp(header, SNAPSHOT_MAGIC, sizeof SNAPSHOT_MAGIC) != 0)
+    {
+        lastError = "Invalid snapshot header in " + getSnapshotPath();
+        return false;
+    }
+    generation = readU64(header + 8);
+    uint64_t recordCount = readU64(header + 16);
+
+    graph.clear();
+    std::string payload;
+    Mutation mutation;
+    ReplayBatch batch(graph);
+    for (uint64_t i = 0; i < recordCount; ++i)
+    {
+        if (readFrame(in, payload) != FrameStatus::Ok || !decode(payload, mutation))
+        {
+            lastError = "Corrupt snapshot record " + std::to_string(i) + " in " + getSnapshotPath();
+            return false;
+        }
+        batch.add(mutation);
+    }
+    batch.flush();
+    return true;
+}
+
+bool NetworkJournal::writeSnapshot(const Graph &graph, uint64_t generation)
+{
+    SnapshotWriter writer(getSnapshotPath(), generation);
+    if (!writer.open())
+    {
+        setLastError(writer.getLastError());
+        return false;
+    }
+
+    Mutation mutation;
+    mutation.operation = Operation::AddNode;
+    for (const Node &node : graph.getNodes())
+    {
+        mutation.source = node.getName();
+        mutation.latitude = node.getLatitude();
+        mutation.longitude = node.getLongitude();
+        writer.write(mutation);
+    }
+
+    mutation = Mutation();
+    mutation.operation = Operation::AddEdge;
+    for (const Edge &edge : graph.getEdges())
+    {
+        mutation.source = edge.getSource();
+        mutation.destination = edge.getDestination();
+        mutation.distance = edge.getDistance();
+        mutation.time = edge.getTime();
+        mutation.cost = edge.getCost();
+        mutation.transfers = edge.getTransfers();
+        mutation.mode = edge.getTransportMode();
+        writer.write(mutation);
+    }
+
+    if (!writer.finish())
+    {
+        setLastError(writer.getLastError());
+        return false;
+    }
+    return true;
+}
+
+NetworkJournal::SnapshotWriter::SnapshotWriter(const std::string &snapshotPath, uint64_t snapshotGeneration)
+    : path(snapshotPath), tempPath(snapshotPath + ".tmp"), generation(snapshotGeneration)
+{
+}
+
+NetworkJournal::SnapshotWriter::~SnapshotWriter()
+{
+    if (out.is_open())
+        out.close();
+    if (!finished)
+    {
+        std::error_code error;
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+bool NetworkJournal::SnapshotWriter::open()
+{
+    out.open(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        lastError = "Cannot open " + tempPath + " for writing";
+        return false;
+    }
+
+    // The record count is filled in by finish()
+    std::string header(SNAPSHOT_MAGIC, sizeof SNAPSHOT_MAGIC);
+    putU64(header, generation);
+    putU64(header, 0);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    return true;
+}
+
+bool NetworkJournal::SnapshotWriter::write(const Mutation &mutation)
+{
+    if (!out.is_open())
+        return false;
+    encode(mutation, payload);
+    writeRecord(out, payload);
+    records++;
+    return static_cast<bool>(out);
+}
+
+bool NetworkJournal::SnapshotWriter::finish()
+{
+    if (!out.is_open())
+    {
+        lastError = "Snapshot " + tempPath + " is not open";
+        return false;
+    }
+
+    std::string count;
+    putU64(count, records);
+    out.seekp(sizeof SNAPSHOT_MAGIC + 8);
+    out.write(count.data(), static_cast<std::streamsize>(count.size()));
+    out.flush();
+    bool written = static_cast<bool>(out);
+    out.close();
+    if (!written)
+    {
+        lastError = "Failed while writing " + tempPath;
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        lastError = "Cannot replace " + path + ": " + error.message();
+        return false;
+    }
+    finished = true;
+    return true;
+}
+
+uint64_t NetworkJournal::SnapshotWriter::getRecordCount() const
+{
+    return records;
+}
+
+std::string NetworkJournal::SnapshotWriter::getLastError() const
+{
+    return lastError;
+}
+
+bool NetworkJournal::openLog(uint64_t generation)
+{
+    std::string path = getLogPath(generation);
+    log.open(path, std::ios::binary | std::ios::app);
+    if (!log.is_open())
+    {
+        lastError = "Cannot open " + path + " for appending";
+        return false;
+    }
+
+    std::error_code error;
+    uint64_t size = std::filesystem::file_size(path, error);
+    stats.generation = generation;
+    stats.logBytes = error ? 0 : size;
+    return true;
+}
+
+void NetworkJournal::removeLogsBefore(uint64_t generation)
+{
+    std::error_code error;
+    for (uint64_t current = generation; current > 0; --current)
+    {
+        if (!std::filesystem::remove(getLogPath(current - 1), error))
+            break;
+    }
+}
+
+bool NetworkJournal::append(const Mutation &mutation)
+{
+    std::string payload;
+    encode(mutation, payload);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!opened)
+    {
+        lastError = "Journal is not open";
+        return false;
+    }
+
+    writeRecord(log, payload);
+    log.flush();
+    if (!log)
+    {
+        lastError = "Failed to append to " + getLogPath(stats.generation);
+        log.clear();
+        return false;
+    }
+
+    stats.recordsAppended++;
+    stats.logBytes += 8 + payload.size();
+    return true;
+}
+
+bool NetworkJournal::compact(const Graph &graph, bool background)
+{
+    waitForCompaction();
+
+    std::shared_ptr<Graph> copy;
+    uint64_t newGeneration;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!opened)
+        {
+            lastError = "Journal is not open";
+            return false;
+        }
+
+        // Later edits go to the next generation while the snapshot is written
+        copy = std::make_shared<Graph>(graph);
+        newGeneration = stats.generation + 1;
+        log.close();
+        if (!openLog(newGeneration))
+        {
+            opened = false;
+            return false;
+        }
+    }
+
+    auto task = [this, copy, newGeneration]()
+    {
+        if (!writeSnapshot(*copy, newGeneration))
+        {
+            std::cerr << "Journal compaction failed: " << getLastError() << "\n";
+            return false;
+        }
+        removeLogsBefore(newGeneration);
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.compactions++;
+        return true;
+    };
+
+    if (!background)
+        return task();
+
+    compactionThread = std::thread(task);
+    return true;
+}
+
+void NetworkJournal::waitForCompaction()
+{
+    if (compactionThread.joinable())
+        compactionThread.join();
+}
+
+bool NetworkJournal::shouldCompact() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return opened && stats.logBytes >= compactionThreshold;
+}
+
+void NetworkJournal::setCompactionThreshold(uint64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    compactionThreshold = bytes;
+}
+
+NetworkJournal::Statistics NetworkJournal::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+std::string NetworkJournal::getLastError() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastError;
+}
+
+void NetworkJournal::setLastError(const std::string &error)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    lastError = error;
+}
@@ -0,0 +1,990 @@
+#include "../../include/io/OSMImporter.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+#ifdef TRANSPORT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace
+{
+    const double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+    // OSM PBF format limits: 64 KiB per BlobHeader, 32 MiB per Blob both as stored and decompressed
+    const uint32_t MAX_HEADER_SIZE = 64 * 1024;
+    const uint64_t MAX_BLOB_SIZE = 32 * 1024 * 1024;
+
+    // ---------------------------------------------------------------------
+    // XML helpers
+    // ---------------------------------------------------------------------
+
+    std::string decodeEntities(const std::string &value)
+    {
+        if (value.find('&') == std::string::npos)
+            return value;
+
+        std::string decoded;
+        decoded.reserve(value.size());
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            if (value[i] != '&')
+            {
+                decoded += value[i];
+                continue;
+            }
+            size_t end = value.find(';', i);
+            if (end == std::string::npos)
+            {
+                decoded += value[i];
+                continue;
+            }
+            std::string entity = value.substr(i + 1, end - i - 1);
+            if (entity == "amp")
+                decoded += '&';
+            else if (entity == "lt")
+                decoded += '<';
+            else if (entity == "gt")
+                decoded += '>';
+            else if (entity == "quot")
+                decoded += '"';
+            else if (entity == "apos")
+                decoded += '\'';
+            else
+                decoded += "&" + entity + ";";
+            i = end;
+        }
+        return decoded;
+    }
+
+    bool attribute(const std::string &tag, const char *name, std::string &value)
+    {
+        const size_t nameLength = std::strlen(name);
+        size_t pos = 0;
+        while ((pos = tag.find(name, pos)) != std::string::npos)
+        {
+            // Must be a whole attribute name followed by ="..." or ='...'
+            bool boundary = pos > 0 && (tag[pos - 1] == ' ' || tag[pos - 1] == '\t' ||
+                                        tag[pos - 1] == '\n' || tag[pos - 1] == '\r');
+            size_t eq = pos + nameLength;
+            if (boundary && eq + 1 < tag.size() && tag[eq] == '=' &&
+                (tag[eq + 1] == '"' || tag[eq + 1] == '\''))
+            {
+                char quote = tag[eq + 1];
+                size_t end = tag.find(quote, eq + 2);
+                if (end == std::string::npos)
+                    return false;
+                value = decodeEntities(tag.substr(eq + 2, end - eq - 2));
+                return true;
+            }
+            pos += nameLength;
+        }
+        return false;
+    }
+
+    // Read up to the next tag end and return the tag without its angle brackets. A '>'
+    // inside a quoted attribute value or a comment does not end the tag
+    bool readTag(std::streambuf &input, std::string &tag)
+    {
+        tag.clear();
+        int c;
+        while ((c = input.sbumpc()) != EOF && c != '<')
+        {
+        }
+
+        char quote = 0;
+        while ((c = input.sbumpc()) != EOF)
+        {
+            if (quote != 0)
+            {
+                if (c == quote)
+                    quote = 0;
+            }
+            else if (tag.size() >= 3 && tag.compare(0, 3, "!--") == 0)
+            {
+                if (c == '>' && tag.size() >= 5 && tag.compare(tag.size() - 2, 2, "--") == 0)
+                    return true;
+            }
+            else if (c == '"' || c == '\'')
+            {
+                quote = static_cast<char>(c);
+            }
+            else if (c == '>')
+            {
+                return true;
+            }
+            tag += static_cast<char>(c);
+        }
+        return false;
+    }
+
+    bool startsWith(const std::string &text, const char *prefix)
+    {
+        return text.compare(0, std::strlen(prefix), prefix) == 0;
+    }
+
+    // ---------------------------------------------------------------------
+    // Minimal protobuf decoding for the PBF container
+    // ---------------------------------------------------------------------
+
+    struct ProtoReader
+    {
+        const uint8_t *cursor;
+        const uint8_t *end;
+        bool ok = true;
+
+        ProtoReader(const uint8_t *data, size_t size) : cursor(data), end(data + size) {}
+
+        bool atEnd() const { return cursor >= end || !ok; }
+
+        uint64_t varint()
+        {
+            uint64_t result = 0;
+            int shift = 0;
+            while (cursor < end && shift < 64)
+            {
+                uint8_t byte = *cursor++;
+                result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                    return result;
+                shift += 7;
+            }
+            ok = false;
+            return 0;
+        }
+
+        int64_t svarint()
+        {
+            uint64_t raw = varint();
+            return static_cast<int64_t>((raw >> 1) ^ (~(raw & 1) + 1));
+        }
+
+        bool next(uint32_t &field, uint32_t &wireType)
+        {
+            if (atEnd())
+                return false;
+            uint64_t key = varint();
+            field = static_cast<uint32_t>(key >> 3);
+            wireType = static_cast<uint32_t>(key & 7);
+            return ok;
+        }
+
+        ProtoReader bytes()
+        {
+            uint64_t length = varint();
+            if (!ok || length > static_cast<uint64_t>(end - cursor))
+            {
+                ok = false;
+                return ProtoReader(end, 0);
+            }
+            ProtoReader sub(cursor, static_cast<size_t>(length));
+            cursor += length;
+            return sub;
+        }
+
+        void skip(uint32_t wireType)
+        {
+            switch (wireType)
+            {
+            case 0:
+                varint();
+                break;
+            case 1:
+                cursor += 8;
+                break;
+            case 2:
+                bytes();
+                break;
+            case 5:
+                cursor += 4;
+                break;
+            default:
+                ok = false;
+            }
+            if (cursor > end)
+                ok = false;
+        }
+    };
+
+    struct BlockContext
+    {
+        std::vector<std::string> strings;
+        int64_t granularity = 100;
+        int64_t latOffset = 0;
+        int64_t lonOffset = 0;
+
+        double latitude(int64_t raw) const { return 1e-9 * (latOffset + granularity * raw); }
+        double longitude(int64_t raw) const { return 1e-9 * (lonOffset + granularity * raw); }
+        const std::string &string(uint64_t index) const
+        {
+            static const std::string empty;
+            return index < strings.size() ? strings[index] : empty;
+        }
+    };
+
+    void decodeDenseNodes(ProtoReader reader, const BlockContext &context,
+                          const OSMImporter::NodeCallback &onNode, long long &count)
+    {
+        std::vector<int64_t> ids, lats, lons;
+        uint32_t field, wireType;
+        while (reader.next(field, wireType))
+        {
+            std::vector<int64_t> *target = field == 1 ? &ids : field == 8 ? &lats : field == 9 ? &lons : nullptr;
+            if (target && wireType == 2)
+            {
+                ProtoReader packed = reader.bytes();
+                while (!packed.atEnd())
+                    target->push_back(packed.svarint());
+            }
+            else
+            {
+                reader.skip(wireType);
+            }
+        }
+
+        size_t n = std::min({ids.size(), lats.size(), lons.size()});
+        int64_t id = 0, lat = 0, lon = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            id += ids[i];
+            lat += lats[i];
+            lon += lons[i];
+            onNode(id, context.latitude(lat), context.longitude(lon));
+        }
+        count += static_cast<long long>(n);
+    }
+
+    void decodeNode(ProtoReader reader, const BlockContext &context,
+                    const OSMImporter::NodeCallback &onNode)
+    {
+        int64_t id = 0, lat = 0, lon = 0;
+        uint32_t field, wireType;
+        while (reader.next(field, wireType))
+        {
+            if (field == 1 && wireType == 0)
+                id = reader.svarint();
+            else if (field == 8 && wireType == 0)
+                lat = reader.svarint();
+            else if (field == 9 && wireType == 0)
+                lon = reader.svarint();
+            else
+                reader.skip(wireType);
+        }
+        onNode(id, context.latitude(lat), context.longitude(lon));
+    }
+
+    void decodeWay(ProtoReader reader, const BlockContext &context,
+                   const OSMImporter::WayCallback &onWay)
+    {
+        int64_t id = 0;
+        std::vector<uint64_t> keys, vals;
+        std::vector<int64_t> refs;
+        uint32_t field, wireType;
+        while (reader.next(field, wireType))
+        {
+            if (field == 1 && wireType == 0)
+            {
+                id = static_cast<int64_t>(reader.varint());
+            }
+            else if ((field == 2 || field == 3) && wireType == 2)
+            {
+                ProtoReader packed = reader.bytes();
+                auto &target = field == 2 ? keys : vals;
+                while (!packed.atEnd())
+                    target.push_back(packed.varint());
+            }
+            else if (field == 8 && wireType == 2)
+            {
+                ProtoReader packed = reader.bytes();
+                int64_t ref = 0;
+                while (!packed.atEnd())
+                {
+                    ref += packed.svarint();
+                    refs.push_back(ref);
+                }
+            }
+            else
+            {
+                reader.skip(wireType);
+            }
+        }
+
+        OSMImporter::TagList tags;
+        for (size_t i = 0; i < keys.size() && i < vals.size(); ++i)
+        {
+            tags.emplace_back(context.string(keys[i]), context.string(vals[i]));
+        }
+        onWay(id, refs, tags);
+    }
+
+    void decodePrimitiveBlock(const std::string &data, const OSMImporter::NodeCallback &onNode,
+                              const OSMImporter::WayCallback &onWay, long long &nodeCount)
+    {
+        const uint8_t *raw = reinterpret_cast<const uint8_t *>(data.data());
+        BlockContext context;
+        uint32_t field, wireType;
+
+        // First pass: string table and coordinate scaling
+        ProtoReader header(raw, data.size());
+        while (header.next(field, wireType))
+        {
+            if (field == 1 && wireType == 2)
+            {
+                ProtoReader table = header.bytes();
+                while (table.next(field, wireType))
+                {
+                    if (field == 1 && wireType == 2)
+                    {
+                        ProtoReader s = table.bytes();
+                        context.strings.emplace_back(reinterpret_cast<const char *>(s.cursor), s.end - s.cursor);
+                    }
+                    else
+                    {
+                        table.skip(wireType);
+                    }
+                }
+            }
+            else if (field == 17 && wireType == 0)
+                context.granularity = static_cast<int64_t>(header.varint());
+            else if (field == 19 && wireType == 0)
+                context.latOffset = static_cast<int64_t>(header.varint());
+            else if (field == 20 && wireType == 0)
+                context.lonOffset = static_cast<int64_t>(header.varint());
+            else
+                header.skip(wireType);
+        }
+
+        // Second pass: primitive groups
+        ProtoReader block(raw, data.size());
+        while (block.next(field, wireType))
+        {
+            if (field != 2 || wireType != 2)
+            {
+                block.skip(wireType);
+                continue;
+            }
+            ProtoReader group = block.bytes();
+            while (group.next(field, wireType))
+            {
+                if (field == 1 && wireType == 2 && onNode)
+                {
+                    decodeNode(group.bytes(), context, onNode);
+                    nodeCount++;
+                }
+                else if (field == 2 && wireType == 2 && onNode)
+                    decodeDenseNodes(group.bytes(), context, onNode, nodeCount);
+                else if (field == 3 && wireType == 2 && onWay)
+                    decodeWay(group.bytes(), context, onWay);
+                else
+                    group.skip(wireType);
+            }
+        }
+    }
+
+    bool readBlob(const std::string &blob, std::string &data, std::string &error)
+    {
+        ProtoReader reader(reinterpret_cast<const uint8_t *>(blob.data()), blob.size());
+        uint32_t field, wireType;
+        uint64_t rawSize = 0;
+        ProtoReader raw(nullptr, 0), compressed(nullptr, 0);
+        bool hasRaw = false, hasZlib = false;
+
+        while (reader.next(field, wireType))
+        {
+            if (field == 1 && wireType == 2)
+            {
+                raw = reader.bytes();
+                hasRaw = true;
+            }
+            else if (field == 2 && wireType == 0)
+                rawSize = reader.varint();
+            else if (field == 3 && wireType == 2)
+            {
+                compressed = reader.bytes();
+                hasZlib = true;
+            }
+            else
+                reader.skip(wireType);
+        }
+
+        if (hasRaw)
+        {
+            data.assign(reinterpret_cast<const char *>(raw.cursor), raw.end - raw.cursor);
+            return true;
+        }
+        if (hasZlib)
+        {
+            // raw_size comes from the file; trusting it would let one blob demand gigabytes
+            if (rawSize > MAX_BLOB_SIZE)
+            {
+                error = "Invalid Blob raw_size in PBF file";
+                return false;
+            }
+#ifdef TRANSPORT_HAVE_ZLIB
+            data.resize(static_cast<size_t>(rawSize));
+            uLongf destLength = static_cast<uLongf>(rawSize);
+            if (uncompress(reinterpret_cast<Bytef *>(&data[0]), &destLength,
+                           compressed.cursor, static_cast<uLong>(compressed.end - compressed.cursor)) != Z_OK)
+            {
+                error = "Corrupt zlib blob in PBF file";
+                return false;
+            }
+            data.resize(destLength);
+            return true;
+#else
+            error = "PBF file uses zlib compression but this build has no zlib support "
+                    "(install zlib and rebuild)";
+            return false;
+#endif
+        }
+        error = "Unsupported PBF blob compression";
+        return false;
+    }
+}
+
+OSMImporter::OSMImporter() {}
+
+OSMImporter::OSMImporter(const ImportOptions &options) : options(options) {}
+
+const OSMImporter::ImportStatistics &OSMImporter::getStatistics() const
+{
+    return statistics;
+}
+
+std::string OSMImporter::getLastError() const
+{
+    return lastError;
+}
+
+std::string OSMImporter::classifyHighway(const std::string &highway) const
+{
+    static const char *footways[] = {"footway", "path", "pedestrian", "steps", "corridor",
+                                      "living_street", "track", "platform"};
+    static const char *roads[] = {"primary", "primary_link", "secondary", "secondary_link",
+                                  "tertiary", "tertiary_link", "unclassified", "residential", "service"};
+    static const char *minorRoads[] = {"tertiary", "unclassified", "residential", "service"};
+
+    for (const char *value : footways)
+    {
+        if (highway == value)
+            return options.includeFootways ? "walk" : "";
+    }
+    if (options.includeFeederRoads)
+    {
+        for (const char *value : roads)
+        {
+            if (highway == value)
+                return "feeder";
+        }
+    }
+    else if (options.includeFootways)
+    {
+        // Without feeder legs, quiet streets still carry pedestrians
+        for (const char *value : minorRoads)
+        {
+            if (highway == value)
+                return "walk";
+        }
+    }
+    return "";
+}
+
+std::string OSMImporter::wayProfile(const TagList &tags, bool &oneway) const
+{
+    std::string profile;
+    oneway = false;
+    for (const auto &tag : tags)
+    {
+        if (tag.first == "highway")
+            profile = classifyHighway(tag.second);
+        else if (tag.first == "oneway")
+            oneway = (tag.second == "yes" || tag.second == "1" || tag.second == "true");
+        else if (tag.first == "access" && (tag.second == "private" || tag.second == "no"))
+            return "";
+        else if (tag.first == "area" && tag.second == "yes")
+            return "";
+    }
+    if (profile != "feeder")
+        oneway = false; // Pedestrians ignore one-way restrictions
+    return profile;
+}
+
+bool OSMImporter::streamXML(const std::string &filename, const NodeCallback &onNode,
+                            const WayCallback &onWay, std::string &error)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        error = "Cannot open " + filename;
+        return false;
+    }
+
+    std::string tag;
+    bool inWay = false;
+    int64_t wayId = 0;
+    std::vector<int64_t> refs;
+    TagList tags;
+
+    // The file is consumed one tag at a time
+    while (readTag(*file.rdbuf(), tag))
+    {
+        bool selfClosing = !tag.empty() && tag.back() == '/';
+
+        try
+        {
+            if (startsWith(tag, "node ") || startsWith(tag, "node\t"))
+            {
+                std::string id, lat, lon;
+                if (onNode && attribute(tag, "id", id) && attribute(tag, "lat", lat) && attribute(tag, "lon", lon))
+                {
+                    onNode(std::stoll(id), std::stod(lat), std::stod(lon));
+                }
+            }
+            else if (startsWith(tag, "way ") || startsWith(tag, "way\t"))
+            {
+                std::string id;
+                attribute(tag, "id", id);
+                wayId = id.empty() ? 0 : std::stoll(id);
+                refs.clear();
+                tags.clear();
+                inWay = !selfClosing;
+                if (selfClosing && onWay)
+                    onWay(wayId, refs, tags);
+            }
+            else if (inWay && startsWith(tag, "nd "))
+            {
+                std::string ref;
+                if (attribute(tag, "ref", ref))
+                    refs.push_back(std::stoll(ref));
+            }
+            else if (inWay && startsWith(tag, "tag "))
+            {
+                std::string key, value;
+                if (attribute(tag, "k", key) && attribute(tag, "v", value))
+                    tags.emplace_back(key, value);
+            }
+            else if (inWay && startsWith(tag, "/way"))
+            {
+                inWay = false;
+                if (onWay)
+                    onWay(wayId, refs, tags);
+            }
+        }
+        catch (const std::exception &)
+        {
+            // Malformed numeric attribute, skip the element
+        }
+    }
+    return true;
+}
+
+bool OSMImporter::streamPBF(const std::string &filename, const NodeCallback &onNode,
+                            const WayCallback &onWay, std::string &error)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        error = "Cannot open " + filename;
+        return false;
+    }
+
+    long long nodeCount = 0;
+    std::string headerBytes, blobBytes, data;
+
+    while (true)
+    {
+        unsigned char lengthBytes[4];
+        if (!file.read(reinterpret_cast<char *>(lengthBytes), 4))
+            break; // Clean end of file
+
+        uint32_t headerLength = (uint32_t(lengthBytes[0]) << 24) | (uint32_t(lengthBytes[1]) << 16) |
+                                (uint32_t(lengthBytes[2]) << 8) | uint32_t(lengthBytes[3]);
+        if (headerLength > MAX_HEADER_SIZE)
+        {
+            error = "Invalid BlobHeader size in PBF file";
+            return false;
+        }
+
+        headerBytes.resize(headerLength);
+        if (!file.read(&headerBytes[0], headerLength))
+        {
+            error = "Truncated BlobHeader in PBF file";
+            return false;
+        }
+
+        std::string type;
+        uint64_t dataSize = 0;
+        ProtoReader header(reinterpret_cast<const uint8_t *>(headerBytes.data()), headerBytes.size());
+        uint32_t field, wireType;
+        while (header.next(field, wireType))
+        {
+            if (field == 1 && wireType == 2)
+            {
+                ProtoReader s = header.bytes();
+                type.assign(reinterpret_cast<const char *>(s.cursor), s.end - s.cursor);
+            }
+            else if (field == 3 && wireType == 0)
+                dataSize = header.varint();
+            else
+                header.skip(wireType);
+        }
+        if (dataSize > MAX_BLOB_SIZE)
+        {
+            error = "Invalid Blob size in PBF file";
+            return false;
+        }
+
+        blobBytes.resize(static_cast<size_t>(dataSize));
+        if (dataSize > 0 && !file.read(&blobBytes[0], static_cast<std::streamsize>(dataSize)))
+        {
+            error = "Truncated Blob in PBF file";
+            return false;
+        }
+
+        if (type != "OSMData")
+            continue; // OSMHeader carries nothing the importer needs
+
+        if (!readBlob(blobBytes, data, error))
+            return false;
+        decodePrimitiveBlock(data, onNode, onWay, nodeCount);
+    }
+    return true;
+}
+
+bool OSMImporter::streamFile(const std::string &filename, const NodeCallback &onNode, const WayCallback &onWay)
+{
+    bool isPBF = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".pbf") == 0;
+    return isPBF ? streamPBF(filename, onNode, onWay, lastError)
+                 : streamXML(filename, onNode, onWay, lastError);
+}
+
+bool OSMImporter::importFile(const std::string &filename, Graph &graph)
+{
+    statistics = ImportStatistics();
+    lastError.clear();
+    referenceCounts.clear();
+    coordinates.clear();
+    segments.clear();
+
+    // Pass 1: find kept ways and count how many times each node is used
+    bool ok = streamFile(filename, nullptr,
+                         [this](int64_t, const std::vector<int64_t> &refs, const TagList &tags)
+                         {
+                             statistics.waysScanned++;
+                             bool oneway = false;
+                             if (refs.size() < 2 || wayProfile(tags, oneway).empty())
+                                 return;
+                             statistics.waysKept++;
+                             for (int64_t ref : refs)
+                                 referenceCounts[ref]++;
+                             // Way endpoints always terminate a segment
+                             referenceCounts[refs.front()]++;
+                             referenceCounts[refs.back()]++;
+                         });
+    if (!ok)
+        return false;
+    statistics.referencedNodes = static_cast<long long>(referenceCounts.size());
+
+    // Pass 2: coordinates for referenced nodes only
+    coordinates.reserve(referenceCounts.size());
+    ok = streamFile(filename,
+                    [this](int64_t id, double latitude, double longitude)
+                    {
+                        statistics.nodesScanned++;
+                        if (referenceCounts.count(id))
+                            coordinates[id] = Coordinate{latitude, longitude};
+                    },
+                    nullptr);
+    if (!ok)
+        return false;
+
+    // Pass 3: split kept ways at junctions
+    ok = streamFile(filename, nullptr,
+                    [this](int64_t, const std::vector<int64_t> &refs, const TagList &tags)
+                    {
+                        bool oneway = false;
+                        std::string profile = refs.size() < 2 ? "" : wayProfile(tags, oneway);
+                        if (profile.empty())
+                            return;
+
+                        int64_t start = 0;
+                        bool open = false;
+                        double length = 0.0;
+                        Coordinate previous{0.0, 0.0};
+                        for (int64_t ref : refs)
+                        {
+                            auto it = coordinates.find(ref);
+                            if (it == coordinates.end())
+                            {
+                                open = false; // Way clipped by the extract boundary
+                                continue;
+                            }
+                            if (!open)
+                            {
+                                start = ref;
+                                open = true;
+                                length = 0.0;
+                                previous = it->second;
+                                continue;
+                            }
+                            length += haversine(previous, it->second);
+                            previous = it->second;
+                            if (referenceCounts[ref] >= 2 && ref != start)
+                            {
+                                segments.push_back(Segment{start, ref, length, profile == "feeder", oneway});
+                                start = ref;
+                                length = 0.0;
+                            }
+                        }
+                    });
+    if (!ok)
+        return false;
+
+    // Reference counts are only needed while splitting
+    std::unordered_map<int64_t, uint32_t>().swap(referenceCounts);
+
+    contractDegreeTwoChains();
+    addToGraph(graph);
+    snapStations(graph);
+
+    std::unordered_map<int64_t, Coordinate>().swap(coordinates);
+    std::vector<Segment>().swap(segments);
+
+    std::cout << "OSM extract imported from " << filename << ": "
+              << statistics.junctionsAdded << " junctions, "
+              << statistics.segmentsAdded << " street legs, "
+              << statistics.stationsSnapped << " stations connected." << std::endl;
+    return true;
+}
+
+void OSMImporter::contractDegreeTwoChains()
+{
+    std::vector<bool> alive(segments.size(), true);
+    std::unordered_map<int64_t, std::vector<size_t>> incident;
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        incident[segments[i].from].push_back(i);
+        incident[segments[i].to].push_back(i);
+    }
+
+    std::vector<int64_t> candidates;
+    for (const auto &entry : incident)
+    {
+        if (entry.second.size() == 2)
+            candidates.push_back(entry.first);
+    }
+
+    for (int64_t node : candidates)
+    {
+        auto &edges = incident[node];
+        if (edges.size() != 2)
+            continue;
+        size_t a = edges[0], b = edges[1];
+        if (a == b || !alive[a] || !alive[b])
+            continue;
+
+        Segment first = segments[a];
+        Segment second = segments[b];
+        if (first.feeder != second.feeder || first.oneway != second.oneway)
+            continue;
+
+        // Orient both halves so the chain runs first -> node -> second
+        if (first.to != node)
+        {
+            if (first.oneway)
+                std::swap(first, second);
+            else
+                std::swap(first.from, first.to);
+        }
+        if (second.from != node)
+        {
+            if (second.oneway)
+                continue;
+            std::swap(second.from, second.to);
+        }
+        if (first.to != node || second.from != node || first.from == second.to)
+            continue;
+
+        Segment merged{first.from, second.to, first.length + second.length, first.feeder, first.oneway};
+        size_t index = segments.size();
+        segments.push_back(merged);
+        alive.push_back(true);
+        alive[a] = false;
+        alive[b] = false;
+        edges.clear();
+
+        for (int64_t end : {merged.from, merged.to})
+        {
+            auto &list = incident[end];
+            list.erase(std::remove_if(list.begin(), list.end(),
+                                      [&](size_t i)
+                                      { return i == a || i == b; }),
+                       list.end());
+            list.push_back(index);
+        }
+    }
+
+    std::vector<Segment> contracted;
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        if (alive[i])
+            contracted.push_back(segments[i]);
+    }
+    segments.swap(contracted);
+}
+
+void OSMImporter::addToGraph(Graph &graph)
+{
+    // Parallel streets between the same junctions keep only the shortest leg
+    std::map<std::pair<int64_t, int64_t>, const Segment *> best;
+    for (const auto &segment : segments)
+    {
+        for (int direction = 0; direction < (segment.oneway ? 1 : 2); ++direction)
+        {
+            std::pair<int64_t, int64_t> key = direction == 0 ? std::make_pair(segment.from, segment.to)
+                                                             : std::make_pair(segment.to, segment.from);
+            auto it = best.find(key);
+            if (it == best.end() || segment.length < it->second->length)
+                best[key] = &segment;
+        }
+    }
+
+    // Inserted in bulk: addNode/addEdge print a line per element, millions for a city
+    std::set<int64_t> junctions;
+    for (const auto &entry : best)
+    {
+        junctions.insert(entry.first.first);
+        junctions.insert(entry.first.second);
+    }
+    std::vector<Node> newNodes;
+    newNodes.reserve(junctions.size());
+    for (int64_t id : junctions)
+    {
+        const Coordinate &c = coordinates[id];
+        try
+        {
+            newNodes.emplace_back(junctionName(id), c.latitude, c.longitude);
+        }
+        catch (const std::invalid_argument &)
+        {
+            // Out-of-range coordinates in the extract; its edges are skipped too
+        }
+    }
+    statistics.junctionsAdded += static_cast<int>(graph.addNodes(newNodes));
+
+    std::vector<Edge> newEdges;
+    newEdges.reserve(best.size());
+    for (const auto &entry : best)
+    {
+        const Segment &segment = *entry.second;
+        double speed = segment.feeder ? options.feederSpeed : options.walkingSpeed;
+        int distance = static_cast<int>(std::lround(segment.length));
+        int time = std::max(1, static_cast<int>(std::ceil(segment.length / speed)));
+        int cost = segment.feeder ? static_cast<int>(std::ceil(segment.length / 1000.0)) * options.feederCostPerKm : 0;
+        newEdges.emplace_back(junctionName(entry.first.first), junctionName(entry.first.second),
+                              distance, time, cost, 0, segment.feeder ? "feeder" : "walk");
+    }
+    statistics.segmentsAdded += static_cast<int>(graph.addEdges(newEdges));
+}
+
+void OSMImporter::snapStations(Graph &graph)
+{
+    if (segments.empty() || options.snapRadiusMeters <= 0.0)
+        return;
+
+    // Uniform grid of junctions, one cell at least the snap radius wide. A degree of
+    // longitude shrinks by cos(latitude), so longitude cells are sized at the junction
+    // farthest from the equator and are wider than needed everywhere else
+    double maxLatitude = 0.0;
+    for (const auto &segment : segments)
+    {
+        for (int64_t id : {segment.from, segment.to})
+            maxLatitude = std::max(maxLatitude, std::fabs(coordinates[id].latitude));
+    }
+    const double latitudeCell = options.snapRadiusMeters / 111000.0;
+    const double longitudeCell =
+        latitudeCell / std::max(0.01, std::cos(std::min(89.0, maxLatitude + latitudeCell) * DEG_TO_RAD));
+    std::map<std::pair<long, long>, std::vector<int64_t>> grid;
+    auto cellOf = [latitudeCell, longitudeCell](double latitude, double longitude)
+    {
+        return std::make_pair(static_cast<long>(std::floor(latitude / latitudeCell)),
+                              static_cast<long>(std::floor(longitude / longitudeCell)));
+    };
+
+    for (const auto &segment : segments)
+    {
+        for (int64_t id : {segment.from, segment.to})
+        {
+            const Coordinate &c = coordinates[id];
+            grid[cellOf(c.latitude, c.longitude)].push_back(id);
+        }
+    }
+
+    std::vector<Edge> connectors; // Added in one batch, see addToGraph
+    graph.forEachNode([&](const Node &station)
+    {
+        const std::string name = station.getName();
+        if (name.compare(0, 4, "osm:") == 0 ||
+            (station.getLatitude() == 0.0 && station.getLongitude() == 0.0))
+            return;
+
+        Coordinate origin{station.getLatitude(), station.getLongitude()};
+        auto cell = cellOf(origin.latitude, origin.longitude);
+        int64_t nearest = 0;
+        double nearestDistance = options.snapRadiusMeters;
+        bool found = false;
+
+        for (long dLat = -1; dLat <= 1; ++dLat)
+        {
+            for (long dLon = -1; dLon <= 1; ++dLon)
+            {
+                auto it = grid.find({cell.first + dLat, cell.second + dLon});
+                if (it == grid.end())
+                    continue;
+                for (int64_t id : it->second)
+                {
+                    double d = haversine(origin, coordinates[id]);
+                    if (d <= nearestDistance)
+                    {
+                        nearestDistance = d;
+                        nearest = id;
+                        found = true;
+                    }
+                }
+            }
+        }
+
+        if (!found || !graph.hasNode(junctionName(nearest)))
+            return;
+
+        std::string junction = junctionName(nearest);
+        if (graph.hasEdge(name, junction) && graph.hasEdge(junction, name))
+            return;
+        int distance = static_cast<int>(std::lround(nearestDistance));
+        int time = std::max(1, static_cast<int>(std::ceil(nearestDistance / options.walkingSpeed)));
+        connectors.emplace_back(name, junction, distance, time, 0, 0, "walk");
+        connectors.emplace_back(junction, name, distance, time, 0, 0, "walk");
+        statistics.stationsSnapped++;
+    });
+    graph.addEdges(connectors);
+}
+
+double OSMImporter::haversine(const Coordinate &a, const Coordinate &b)
+{
+    double dLat = (b.latitude - a.latitude) * DEG_TO_RAD;
+    double dLon = (b.longitude - a.longitude) * DEG_TO_RAD;
+    double h = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(a.latitude * DEG_TO_RAD) * std::cos(b.latitude * DEG_TO_RAD) *
+                   std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2.0 * 6371000.0 * std::atan2(std::sqrt(h), std::sqrt(1.0 - h));
+}
+
+std::string OSMImporter::junctionName(int64_t id)
+{
+    return "osm:" + std::to_string(id);
+}
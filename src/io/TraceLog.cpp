@@ -0,0 +1,246 @@
+#include "../../include/io/TraceLog.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+    const char TRACE_MAGIC[8] = {'T', 'R', 'T', 'R', 'A', 'C', 'E', '1'};
+
+    std::atomic<uint64_t> nextInstanceId{1};
+    std::atomic<uint32_t> nextThreadId{1};
+
+    // Fixed little-endian encoding so traces move between machines
+    void putU32(std::string &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    void putU64(std::string &out, uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    uint32_t readU32(const unsigned char *bytes)
+    {
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    uint64_t readU64(const unsigned char *bytes)
+    {
+        return static_cast<uint64_t>(readU32(bytes)) | (static_cast<uint64_t>(readU32(bytes + 4)) << 32);
+    }
+}
+
+TraceLog::TraceLog(const std::string &tracePath)
+    : path(tracePath), instanceId(nextInstanceId.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+TraceLog::~TraceLog()
+{
+    flush();
+}
+
+bool TraceLog::open()
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, error);
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        lastError = "Cannot open " + path + " for writing";
+        return false;
+    }
+
+    std::string header(TRACE_MAGIC, sizeof TRACE_MAGIC);
+    putU32(header, static_cast<uint32_t>(RECORD_SIZE));
+    putU32(header, 0);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.flush();
+    if (!file)
+    {
+        lastError = "Failed to write the header of " + path;
+        file.close();
+        return false;
+    }
+    opened.store(true, std::memory_order_release);
+    return true;
+}
+
+bool TraceLog::isOpen() const
+{
+    return opened.load(std::memory_order_acquire);
+}
+
+void TraceLog::record(const Record &entry)
+{
+    if (!isOpen())
+        return;
+
+    ThreadBuffer &buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    encode(entry, buffer.bytes);
+    recordCount.fetch_add(1, std::memory_order_relaxed);
+    if (buffer.bytes.size() >= BUFFER_RECORDS * RECORD_SIZE)
+    {
+        writeBytes(buffer.bytes);
+        buffer.bytes.clear();
+    }
+}
+
+void TraceLog::flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (auto &entry : buffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(entry.second->mutex);
+            writeBytes(entry.second->bytes);
+            entry.second->bytes.clear();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (file.is_open())
+        file.flush();
+}
+
+uint64_t TraceLog::getRecordCount() const
+{
+    return recordCount.load(std::memory_order_relaxed);
+}
+
+uint64_t TraceLog::nextQueryId()
+{
+    return queryIds.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string TraceLog::getPath() const
+{
+    return path;
+}
+
+std::string TraceLog::getLastError() const
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+    return lastError;
+}
+
+bool TraceLog::readFile(const std::string &tracePath, std::vector<Record> &records, std::string &error)
+{
+    records.clear();
+    std::ifstream in(tracePath, std::ios::binary);
+    if (!in.is_open())
+    {
+        error = "Cannot open " + tracePath;
+        return false;
+    }
+
+    unsigned char header[HEADER_SIZE];
+    in.read(reinterpret_cast<char *>(header), sizeof header);
+    if (in.gcount() != static_cast<std::streamsize>(sizeof header) ||
+        std::memcmp(header, TRACE_MAGIC, sizeof TRACE_MAGIC) != 0)
+    {
+        error = "Not a route trace: " + tracePath;
+        return false;
+    }
+    if (readU32(header + 8) != RECORD_SIZE)
+    {
+        error = "Unsupported trace record size " + std::to_string(readU32(header + 8)) + " in " + tracePath;
+        return false;
+    }
+
+    std::vector<unsigned char> chunk(BUFFER_RECORDS * RECORD_SIZE);
+    while (in)
+    {
+        in.read(reinterpret_cast<char *>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        size_t complete = static_cast<size_t>(in.gcount()) / RECORD_SIZE;
+        for (size_t i = 0; i < complete; ++i)
+            records.push_back(decode(chunk.data() + i * RECORD_SIZE));
+    }
+    return true;
+}
+
+void TraceLog::encode(const Record &entry, std::string &out)
+{
+    putU64(out, entry.timestampNanos);
+    putU64(out, entry.queryId);
+    putU32(out, entry.threadId);
+    putU32(out, entry.startNode);
+    putU32(out, entry.endNode);
+    putU32(out, entry.nodesSettled);
+    putU32(out, entry.latencyMicros);
+    out.push_back(static_cast<char>(entry.criterion));
+    out.push_back(static_cast<char>(entry.status));
+    out.push_back(static_cast<char>(entry.flags));
+    out.push_back(0);
+}
+
+TraceLog::Record TraceLog::decode(const unsigned char *bytes)
+{
+    Record entry;
+    entry.timestampNanos = readU64(bytes);
+    entry.queryId = readU64(bytes + 8);
+    entry.threadId = readU32(bytes + 16);
+    entry.startNode = readU32(bytes + 20);
+    entry.endNode = readU32(bytes + 24);
+    entry.nodesSettled = readU32(bytes + 28);
+    entry.latencyMicros = readU32(bytes + 32);
+    entry.criterion = bytes[36];
+    entry.status = bytes[37];
+    entry.flags = bytes[38];
+    return entry;
+}
+
+uint32_t TraceLog::currentThreadId()
+{
+    thread_local const uint32_t id = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+uint64_t TraceLog::nowNanos()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+TraceLog::ThreadBuffer &TraceLog::localBuffer()
+{
+    // One-entry cache: a thread normally feeds a single trace
+    thread_local uint64_t cachedInstance = 0;
+    thread_local ThreadBuffer *cachedBuffer = nullptr;
+    if (cachedInstance == instanceId)
+        return *cachedBuffer;
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    std::unique_ptr<ThreadBuffer> &buffer = buffers[std::this_thread::get_id()];
+    if (!buffer)
+    {
+        buffer = std::make_unique<ThreadBuffer>();
+        buffer->bytes.reserve(BUFFER_RECORDS * RECORD_SIZE);
+    }
+    cachedInstance = instanceId;
+    cachedBuffer = buffer.get();
+    return *buffer;
+}
+
+void TraceLog::writeBytes(const std::string &bytes)
+{
+    if (bytes.empty())
+        return;
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (!file.is_open())
+        return;
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+        lastError = "Failed to write to " + path;
+}
@@ -1,4 +1,5 @@
 #include "../../include/preferences/UserPreferences.h"
+#include "../../include/io/JSONHandler.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -170,6 +171,18 @@ std::string UserPreferences::getMainPreference() const
     return currentCriteria.primaryCriterion;
 }
 
+// User profile management
+void UserPreferences::setUserProfile(const std::string &key, const std::string &value)
+{
+    userProfile[key] = value;
+}
+
+std::string UserPreferences::getUserProfile(const std::string &key) const
+{
+    auto it = userProfile.find(key);
+    return it != userProfile.end() ? it->second : "";
+}
+
 // PreferenceManager implementation
 
 std::shared_ptr<DecisionTreeNode> PreferenceManager::createDefaultDecisionTree()
@@ -279,81 +292,128 @@ bool UserPreferences::saveToFile(const std::string &filename) const
         return false;
     }
 
-    // Simple JSON-like format
-    file << "{\n";
-    file << "  \"timeWeight\": " << currentCriteria.timeWeight << ",\n";
-    file << "  \"distanceWeight\": " << currentCriteria.distanceWeight << ",\n";
-    file << "  \"costWeight\": " << currentCriteria.costWeight << ",\n";
-    file << "  \"transferWeight\": " << currentCriteria.transferWeight << ",\n";
-    file << "  \"primaryCriterion\": \"" << currentCriteria.primaryCriterion << "\",\n";
-    file << "  \"preferenceMode\": \"" << preferenceMode << "\"\n";
-    file << "}\n";
+    JSONWriter writer(file);
+    writer.beginObject()
+        .key("timeWeight")
+        .value(currentCriteria.timeWeight)
+        .key("distanceWeight")
+        .value(currentCriteria.distanceWeight)
+        .key("costWeight")
+        .value(currentCriteria.costWeight)
+        .key("transferWeight")
+        .value(currentCriteria.transferWeight)
+        .key("primaryCriterion")
+        .value(currentCriteria.primaryCriterion)
+        .key("preferenceMode")
+        .value(preferenceMode);
+
+    if (!userProfile.empty())
+    {
+        writer.key("user_profile").beginObject();
+        for (const auto &entry : userProfile)
+        {
+            writer.key(entry.first).value(entry.second);
+        }
+        writer.endObject();
+    }
+    writer.endObject();
 
-    return true;
+    return file.good();
 }
 
 bool UserPreferences::loadFromFile(const std::string &filename)
 {
-    std::ifstream file(filename);
-    if (!file.is_open())
+    JSONValue root;
+    JSONReader reader;
+    if (!reader.parseFile(filename, root))
+    {
+        return false;
+    }
+    return applyJSON(root);
+}
+
+bool UserPreferences::applyJSON(const JSONValue &root)
+{
+    if (!root.isObject())
     {
         return false;
     }
 
-    std::string line;
     PreferenceCriteria newCriteria;
-    std::string newMode = "simple";
+    std::string newMode = root.get("preferenceMode").asString("simple");
+
+    // Flat layout written by saveToFile
+    newCriteria.timeWeight = root.get("timeWeight").asNumber(newCriteria.timeWeight);
+    newCriteria.distanceWeight = root.get("distanceWeight").asNumber(newCriteria.distanceWeight);
+    newCriteria.costWeight = root.get("costWeight").asNumber(newCriteria.costWeight);
+    newCriteria.transferWeight = root.get("transferWeight").asNumber(newCriteria.transferWeight);
+    newCriteria.primaryCriterion = root.get("primaryCriterion").asString(newCriteria.primaryCriterion);
+
+    // Nested layout used by data/templates/preferences_template.json
+    const JSONValue &weights = root.get("optimization_weights");
+    if (weights.isObject())
+    {
+        newCriteria.timeWeight = weights.get("time_weight").asNumber(newCriteria.timeWeight);
+        newCriteria.distanceWeight = weights.get("distance_weight").asNumber(newCriteria.distanceWeight);
+        newCriteria.costWeight = weights.get("cost_weight").asNumber(newCriteria.costWeight);
+        newCriteria.transferWeight = weights.get("transfer_weight").asNumber(newCriteria.transferWeight);
+    }
+    const JSONValue &scoring = root.get("scoring_method");
+    if (scoring.isObject() && !root.contains("preferenceMode"))
+    {
+        newMode = scoring.get("method").asString(newMode);
+    }
 
-    // Simple parsing for JSON-like format
-    while (std::getline(file, line))
+    if (!PreferenceManager::validateWeights(newCriteria))
     {
-        // Remove whitespace and find key-value pairs
-        size_t colonPos = line.find(':');
-        if (colonPos != std::string::npos)
-        {
-            std::string key = line.substr(0, colonPos);
-            std::string value = line.substr(colonPos + 1);
+        return false;
+    }
 
-            // Remove quotes, spaces, commas
-            key.erase(0, key.find_first_not_of(" \t\""));
-            key.erase(key.find_last_not_of(" \t\"") + 1);
-            value.erase(0, value.find_first_not_of(" \t\""));
-            value.erase(value.find_last_not_of(" \t\",") + 1);
+    currentCriteria = newCriteria;
+    preferenceMode = newMode;
 
-            if (key == "timeWeight")
-            {
-                newCriteria.timeWeight = std::stod(value);
-            }
-            else if (key == "distanceWeight")
-            {
-                newCriteria.distanceWeight = std::stod(value);
-            }
-            else if (key == "costWeight")
-            {
-                newCriteria.costWeight = std::stod(value);
-            }
-            else if (key == "transferWeight")
-            {
-                newCriteria.transferWeight = std::stod(value);
-            }
-            else if (key == "primaryCriterion")
-            {
-                newCriteria.primaryCriterion = value;
-            }
-            else if (key == "preferenceMode")
+    const JSONValue &profile = root.get("user_profile");
+    for (const auto &member : profile.members())
+    {
+        setUserProfile(member.first, member.second.isString() ? member.second.asString() : member.second.dump());
+    }
+    return true;
+}
+
+std::map<std::string, UserPreferences> UserPreferences::loadProfiles(const std::string &filename)
+{
+    std::map<std::string, UserPreferences> profiles;
+    JSONValue root;
+    JSONReader reader;
+    if (!reader.parseFile(filename, root))
+    {
+        std::cerr << "Cannot load preference profiles: " << reader.getLastError() << std::endl;
+        return profiles;
+    }
+
+    // Either {"user_001": {...}, ...} or [{"user_profile": {"user_id": ...}, ...}, ...]
+    if (root.isObject())
+    {
+        for (const auto &member : root.members())
+        {
+            UserPreferences preferences;
+            if (preferences.applyJSON(member.second))
             {
-                newMode = value;
+                profiles.emplace(member.first, std::move(preferences));
             }
         }
     }
-
-    // Validate and apply
-    if (PreferenceManager::validateWeights(newCriteria))
+    else if (root.isArray())
     {
-        currentCriteria = newCriteria;
-        preferenceMode = newMode;
-        return true;
+        for (const auto &item : root.items())
+        {
+            std::string userId = item.get("user_profile").get("user_id").asString(item.get("user_id").asString());
+            UserPreferences preferences;
+            if (!userId.empty() && preferences.applyJSON(item))
+            {
+                profiles.emplace(userId, std::move(preferences));
+            }
+        }
     }
-
-    return false;
+    return profiles;
 }
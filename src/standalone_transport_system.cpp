@@ -9,6 +9,11 @@
 #include <algorithm>
 #include <cmath>
 #include <iomanip>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <filesystem>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -345,6 +350,203 @@ public:
     }
 };
 
+// ============================================================================
+// WRITE-BEHIND MAP DATA EXPORTER
+// ============================================================================
+
+/**
+ * Coalesces graph mutations and rewrites network_data.csv / nodes_data.csv in the
+ * background, either when enough changes have piled up or when the flush interval
+ * elapses. Files are serialized under the graph lock into memory, then written to a
+ * temporary path and renamed over the old file so the browser never sees a
+ * half-written CSV.
+ */
+class MapDataExporter
+{
+private:
+    const Graph &graph;
+    std::mutex &graphMutex;
+
+    std::mutex writeMutex;
+    std::mutex stateMutex;
+    std::condition_variable wakeUp;
+    std::thread flusher;
+    bool networkDirty = false;
+    bool nodesDirty = false;
+    bool stopping = false;
+    size_t pendingChanges = 0;
+
+    size_t flushThreshold;
+    std::chrono::milliseconds flushInterval;
+    size_t flushCount = 0;
+
+    static bool replaceFile(const std::string &filename, const std::string &contents)
+    {
+        const std::string tempName = filename + ".tmp";
+        {
+            std::ofstream out(tempName, std::ios::binary | std::ios::trunc);
+            if (!out.is_open())
+                return false;
+            out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            if (!out)
+                return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempName, filename, error);
+        if (error)
+        {
+            std::cerr << "Failed to replace " << filename << ": " << error.message() << "\n";
+            std::filesystem::remove(tempName, error);
+            return false;
+        }
+        return true;
+    }
+
+    std::string serializeNetwork() const
+    {
+        std::ostringstream csv;
+        csv << "from,to,distance,time,cost,transfers,mode,from_lat,from_lon,to_lat,to_lon,from_name,to_name\n";
+        for (const auto &nodeId : graph.getAllNodes())
+        {
+            const Node &fromNode = graph.getNode(nodeId);
+            for (const auto &edge : graph.getEdges(nodeId))
+            {
+                const Node &toNode = graph.getNode(edge.to);
+                csv << edge.from << ',' << edge.to << ',' << edge.distance << ','
+                    << edge.time << ',' << edge.cost << ',' << edge.transfers << ','
+                    << edge.mode << ',' << fromNode.latitude << ',' << fromNode.longitude << ','
+                    << toNode.latitude << ',' << toNode.longitude << ','
+                    << fromNode.name << ',' << toNode.name << '\n';
+            }
+        }
+        return csv.str();
+    }
+
+    std::string serializeNodes() const
+    {
+        std::ostringstream csv;
+        csv << "id,name,latitude,longitude,connections\n";
+        for (const auto &nodeId : graph.getAllNodes())
+        {
+            const Node &node = graph.getNode(nodeId);
+            csv << nodeId << ',' << node.name << ',' << node.latitude << ','
+                << node.longitude << ',' << graph.getEdges(nodeId).size() << '\n';
+        }
+        return csv.str();
+    }
+
+    // Serializes whatever is dirty (or everything when forced) and replaces the files.
+    // writeMutex keeps concurrent flushes from interleaving or landing out of order.
+    void flushPending(bool force)
+    {
+        std::lock_guard<std::mutex> writing(writeMutex);
+        bool writeNetwork, writeNodes;
+        {
+            std::lock_guard<std::mutex> state(stateMutex);
+            writeNetwork = networkDirty || force;
+            writeNodes = nodesDirty || force;
+            networkDirty = nodesDirty = false;
+            pendingChanges = 0;
+        }
+        if (!writeNetwork && !writeNodes)
+            return;
+
+        std::string networkCsv, nodesCsv;
+        {
+            std::lock_guard<std::mutex> lock(graphMutex);
+            if (writeNetwork)
+                networkCsv = serializeNetwork();
+            if (writeNodes)
+                nodesCsv = serializeNodes();
+        }
+        if (writeNetwork)
+            replaceFile("network_data.csv", networkCsv);
+        if (writeNodes)
+            replaceFile("nodes_data.csv", nodesCsv);
+
+        std::lock_guard<std::mutex> state(stateMutex);
+        ++flushCount;
+    }
+
+    void flushLoop()
+    {
+        std::unique_lock<std::mutex> state(stateMutex);
+        while (!stopping)
+        {
+            // Sleep until the first change arrives, then give later changes a chance to batch up
+            wakeUp.wait(state, [this]
+                        { return stopping || pendingChanges > 0; });
+            if (stopping)
+                break;
+            wakeUp.wait_for(state, flushInterval, [this]
+                            { return stopping || pendingChanges >= flushThreshold; });
+            state.unlock();
+            flushPending(false);
+            state.lock();
+        }
+        state.unlock();
+        flushPending(false);
+    }
+
+public:
+    MapDataExporter(const Graph &sourceGraph, std::mutex &sourceMutex,
+                    size_t threshold = 64, std::chrono::milliseconds interval = std::chrono::milliseconds(1500))
+        : graph(sourceGraph), graphMutex(sourceMutex), flushThreshold(threshold), flushInterval(interval)
+    {
+        flusher = std::thread(&MapDataExporter::flushLoop, this);
+    }
+
+    ~MapDataExporter()
+    {
+        {
+            std::lock_guard<std::mutex> state(stateMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        if (flusher.joinable())
+            flusher.join();
+    }
+
+    MapDataExporter(const MapDataExporter &) = delete;
+    MapDataExporter &operator=(const MapDataExporter &) = delete;
+
+    // Edges carry both endpoints' coordinates and nodes carry connection counts,
+    // so any change dirties both files
+    void markChanged(size_t changes = 1)
+    {
+        {
+            std::lock_guard<std::mutex> state(stateMutex);
+            networkDirty = nodesDirty = true;
+            pendingChanges += changes;
+        }
+        wakeUp.notify_one();
+    }
+
+    // Write any pending changes now, on the calling thread
+    void flush()
+    {
+        flushPending(false);
+    }
+
+    // Force both files to be rewritten regardless of pending changes
+    void exportAll()
+    {
+        flushPending(true);
+    }
+
+    size_t getFlushCount()
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        return flushCount;
+    }
+
+    static bool writeFileAtomically(const std::string &filename, const std::string &contents)
+    {
+        return replaceFile(filename, contents);
+    }
+};
+
 // ============================================================================
 // USER INTERFACE AND MAIN APPLICATION
 // ============================================================================
@@ -353,6 +555,8 @@ class TransportApp
 {
 private:
     Graph graph;
+    std::mutex graphMutex; // Held for mutations; the exporter reads the graph from its own thread
+    MapDataExporter exporter{graph, graphMutex};
 
 public:
     TransportApp()
@@ -361,6 +565,7 @@ public:
     }
     void initializeDefaultNetwork()
     {
+        std::lock_guard<std::mutex> lock(graphMutex);
         std::cout << "Graph initialized with adjacency list representation." << std::endl;
         std::cout << "Initializing comprehensive Jakarta transportation network..." << std::endl;
 
@@ -561,10 +766,7 @@ public:
             std::cout << std::string(60, '=') << std::endl;
 
             // Export route information for map visualization
-            exportRouteForMap(result, criteria); // Auto-update map data
-            std::cout << "\nAuto-updating map data with latest route..." << std::endl;
-            exportNetworkCSV();
-            exportNodesCSV();
+            exportRouteForMap(result, criteria); // The network itself is unchanged, so only the route is written
             std::cout << "Map data updated! Refresh 'jakarta_current_map.html' to see the route." << std::endl;
         }
         else
@@ -589,13 +791,14 @@ public:
         std::cout << "Enter longitude: ";
         std::cin >> lon;
         std::cin.ignore();
-        graph.addNode(id, lat, lon, name);
+        {
+            std::lock_guard<std::mutex> lock(graphMutex);
+            graph.addNode(id, lat, lon, name);
+        }
 
-        // Auto-update map and CSV data
-        std::cout << "\nAuto-updating map and data files..." << std::endl;
-        exportNetworkCSV();
-        exportNodesCSV();
-        std::cout << "Map data updated! Refresh 'jakarta_current_map.html' to see changes." << std::endl;
+        // Map data is rewritten in the background once changes settle
+        exporter.markChanged();
+        std::cout << "Map data update scheduled. Refresh 'jakarta_current_map.html' in a moment to see changes." << std::endl;
     }
     void addEdge()
     {
@@ -621,13 +824,14 @@ public:
         std::cin.ignore();
         std::cout << "Enter transport mode: ";
         std::getline(std::cin, mode);
-        graph.addEdge(from, to, distance, time, cost, transfers, mode);
+        {
+            std::lock_guard<std::mutex> lock(graphMutex);
+            graph.addEdge(from, to, distance, time, cost, transfers, mode);
+        }
 
-        // Auto-update map and CSV data
-        std::cout << "\nAuto-updating map and data files..." << std::endl;
-        exportNetworkCSV();
-        exportNodesCSV();
-        std::cout << "Map data updated! Refresh 'jakarta_current_map.html' to see changes." << std::endl;
+        // Map data is rewritten in the background once changes settle
+        exporter.markChanged();
+        std::cout << "Map data update scheduled. Refresh 'jakarta_current_map.html' in a moment to see changes." << std::endl;
     }
     void runTests()
     {
@@ -701,61 +905,22 @@ public:
         }
     }
 
-    void exportNetworkCSV()
+    void exportMapData()
     {
-        std::ofstream csvFile("network_data.csv");
-        if (csvFile.is_open())
-        {
-            csvFile << "from,to,distance,time,cost,transfers,mode,from_lat,from_lon,to_lat,to_lon,from_name,to_name" << std::endl;
-            auto nodes = graph.getAllNodes();
-            for (const auto &nodeId : nodes)
-            {
-                const Node &fromNode = graph.getNode(nodeId);
-                for (const auto &edge : graph.getEdges(nodeId))
-                {
-                    const Node &toNode = graph.getNode(edge.to);
-                    csvFile << edge.from << "," << edge.to << "," << edge.distance << ",";
-                    csvFile << edge.time << "," << edge.cost << "," << edge.transfers << ",";
-                    csvFile << edge.mode << "," << fromNode.latitude << "," << fromNode.longitude << ",";
-                    csvFile << toNode.latitude << "," << toNode.longitude << ",";
-                    csvFile << fromNode.name << "," << toNode.name << std::endl;
-                }
-            }
-            csvFile.close();
-        }
-    }
-
-    void exportNodesCSV()
-    {
-        std::ofstream nodesFile("nodes_data.csv");
-        if (nodesFile.is_open())
-        {
-            nodesFile << "id,name,latitude,longitude,connections" << std::endl;
-            auto nodes = graph.getAllNodes();
-            for (const auto &nodeId : nodes)
-            {
-                const Node &node = graph.getNode(nodeId);
-                nodesFile << nodeId << "," << node.name << "," << node.latitude << ",";
-                nodesFile << node.longitude << "," << graph.getEdges(nodeId).size() << std::endl;
-            }
-            nodesFile.close();
-        }
+        exporter.exportAll();
     }
 
     void exportRouteForMap(const RouteResult &route, const std::string &criteria)
     {
-        std::ofstream routeFile("current_route.csv");
-        if (routeFile.is_open())
+        std::ostringstream routeFile;
+        routeFile << "step,station_id,station_name,latitude,longitude,criteria\n";
+        for (size_t i = 0; i < route.path.size(); ++i)
         {
-            routeFile << "step,station_id,station_name,latitude,longitude,criteria" << std::endl;
-            for (size_t i = 0; i < route.path.size(); ++i)
-            {
-                const Node &node = graph.getNode(route.path[i]);
-                routeFile << (i + 1) << "," << route.path[i] << "," << node.name << ",";
-                routeFile << node.latitude << "," << node.longitude << "," << criteria << std::endl;
-            }
-            routeFile.close();
+            const Node &node = graph.getNode(route.path[i]);
+            routeFile << (i + 1) << ',' << route.path[i] << ',' << node.name << ','
+                      << node.latitude << ',' << node.longitude << ',' << criteria << '\n';
         }
+        MapDataExporter::writeFileAtomically("current_route.csv", routeFile.str());
     }
     void generateInteractiveMap()
     {
@@ -763,8 +928,7 @@ public:
         std::cout << std::string(40, '-') << std::endl;
 
         // Export updated CSV data
-        exportNetworkCSV();
-        exportNodesCSV(); // Generate updated interactive map with integrated JavaScript
+        exportMapData(); // Generate updated interactive map with integrated JavaScript
         std::ofstream htmlFile("jakarta_current_map.html");
         if (htmlFile.is_open())
         {
@@ -878,8 +1042,7 @@ public:
 
         // Auto-generate initial map and data on startup
         std::cout << "\nInitializing interactive map and data files..." << std::endl;
-        exportNetworkCSV();
-        exportNodesCSV();
+        exportMapData();
         std::cout << "Initial map data generated! Open 'jakarta_current_map.html' to view the network." << std::endl;
 
         while (true)
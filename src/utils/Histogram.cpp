@@ -0,0 +1,164 @@
+#include "../../include/utils/Histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace transport
+{
+    namespace utils
+    {
+
+        namespace
+        {
+            unsigned highestBit(uint64_t value)
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+                unsigned bit = 0;
+                while (value >>= 1)
+                    ++bit;
+                return bit;
+#endif
+            }
+
+            void raiseTo(std::atomic<uint64_t> &target, uint64_t value)
+            {
+                uint64_t seen = target.load(std::memory_order_relaxed);
+                while (value > seen && !target.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+                {
+                }
+            }
+
+            void lowerTo(std::atomic<uint64_t> &target, uint64_t value)
+            {
+                uint64_t seen = target.load(std::memory_order_relaxed);
+                while (value < seen && !target.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+                {
+                }
+            }
+        }
+
+        Histogram::Histogram(const Histogram &other)
+        {
+            merge(other);
+        }
+
+        Histogram &Histogram::operator=(const Histogram &other)
+        {
+            if (this != &other)
+            {
+                reset();
+                merge(other);
+            }
+            return *this;
+        }
+
+        size_t Histogram::bucketIndex(uint64_t value)
+        {
+            if (value < SUB_BUCKETS)
+                return static_cast<size_t>(value);
+            unsigned shift = highestBit(value) - SUB_BUCKET_BITS;
+            return static_cast<size_t>(SUB_BUCKETS + shift * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS));
+        }
+
+        uint64_t Histogram::bucketLowerBound(size_t bucket)
+        {
+            if (bucket < SUB_BUCKETS)
+                return bucket;
+            size_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+            size_t sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+            return (SUB_BUCKETS + sub) << shift;
+        }
+
+        uint64_t Histogram::bucketUpperBound(size_t bucket)
+        {
+            if (bucket < SUB_BUCKETS)
+                return bucket;
+            size_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+            return bucketLowerBound(bucket) + ((uint64_t(1) << shift) - 1);
+        }
+
+        void Histogram::record(uint64_t value)
+        {
+            buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+            sum.fetch_add(value, std::memory_order_relaxed);
+            lowerTo(min, value);
+            raiseTo(max, value);
+        }
+
+        void Histogram::merge(const Histogram &other)
+        {
+            for (size_t b = 0; b < BUCKETS; ++b)
+            {
+                uint64_t added = other.getBucketCount(b);
+                if (added)
+                    buckets[b].fetch_add(added, std::memory_order_relaxed);
+            }
+            count.fetch_add(other.getCount(), std::memory_order_relaxed);
+            sum.fetch_add(other.getSum(), std::memory_order_relaxed);
+            lowerTo(min, other.min.load(std::memory_order_relaxed));
+            raiseTo(max, other.getMax());
+        }
+
+        void Histogram::reset()
+        {
+            for (std::atomic<uint64_t> &bucket : buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            count.store(0, std::memory_order_relaxed);
+            sum.store(0, std::memory_order_relaxed);
+            min.store(UINT64_MAX, std::memory_order_relaxed);
+            max.store(0, std::memory_order_relaxed);
+        }
+
+        double Histogram::getMean() const
+        {
+            uint64_t samples = getCount();
+            return samples ? static_cast<double>(getSum()) / samples : 0.0;
+        }
+
+        uint64_t Histogram::getCountAtOrBelow(uint64_t limit) const
+        {
+            uint64_t total = 0;
+            for (size_t b = 0; b < BUCKETS && bucketUpperBound(b) <= limit; ++b)
+                total += getBucketCount(b);
+            return total;
+        }
+
+        uint64_t Histogram::getPercentile(double fraction) const
+        {
+            // Copy the buckets once so the rank and the walk agree under concurrent records
+            std::vector<uint64_t> counts(BUCKETS);
+            uint64_t total = 0;
+            for (size_t b = 0; b < BUCKETS; ++b)
+                total += counts[b] = getBucketCount(b);
+            if (total == 0)
+                return 0;
+
+            double clamped = std::min(1.0, std::max(0.0, fraction));
+            uint64_t rank = static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(total)));
+            rank = std::min(total, std::max<uint64_t>(rank, 1));
+
+            uint64_t seen = 0;
+            for (size_t b = 0; b < BUCKETS; ++b)
+            {
+                seen += counts[b];
+                if (seen >= rank)
+                    return std::min(getMax(), std::max(getMin(), bucketUpperBound(b)));
+            }
+            return getMax();
+        }
+
+        std::string Histogram::summary() const
+        {
+            std::ostringstream line;
+            line << "n=" << getCount() << " mean=" << static_cast<uint64_t>(getMean() + 0.5)
+                 << " p50=" << getPercentile(0.5) << " p90=" << getPercentile(0.9)
+                 << " p99=" << getPercentile(0.99) << " max=" << getMax();
+            return line.str();
+        }
+
+    } // namespace utils
+} // namespace transport
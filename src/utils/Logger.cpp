@@ -1,368 +1,652 @@
 #include "../../include/utils/Logger.h"
-#include "utils\/StringUtils.h"
-#include <chrono>
-#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
 #include <filesystem>
-#include <iostream>
-#include <sstream>
+#include <thread>
 
 namespace transport
 {
+    namespace utils
+    {
 
-    namespace fs = std::filesystem;
+        namespace
+        {
+            const size_t DEFAULT_QUEUE_CAPACITY = 8192;
+            const size_t MAX_BATCH_SIZE = 512;
+            const std::chrono::milliseconds WRITER_IDLE_TIMEOUT(100);
 
-    std::mutex Logger::mtx;
-    std::unique_ptr<Logger> Logger::instance = nullptr;
-    std::string Logger::logFilePath = "logs/system.log";
-    Logger::LogLevel Logger::currentLogLevel = Logger::LogLevel::INFO;
-    std::ofstream Logger::logFile;
-    Logger::LogDestination Logger::logDest = Logger::LogDestination::BOTH;
-    size_t Logger::maxFileSize = 1048576; // 1MB
-    unsigned int Logger::maxBackupFiles = 5;
+            size_t levelIndex(LogLevel level)
+            {
+                return static_cast<size_t>(level);
+            }
 
-    Logger::Logger()
-    {
-    }
+            std::string baseName(const std::string &path)
+            {
+                size_t slash = path.find_last_of("/\\");
+                return slash == std::string::npos ? path : path.substr(slash + 1);
+            }
 
-    Logger::Logger(const Logger &) = delete;
-    Logger &Logger::operator=(const Logger &) = delete;
+            // Counts the caller as a producer on the queue until released or destroyed
+            class ProducerScope
+            {
+            public:
+                explicit ProducerScope(std::atomic<int> &producers) : producers(producers)
+                {
+                    producers.fetch_add(1, std::memory_order_seq_cst);
+                }
+                ~ProducerScope() { release(); }
 
-    Logger::~Logger()
-    {
-        std::lock_guard<std::mutex> lock(mtx);
-        if (logFile.is_open())
+                void release()
+                {
+                    if (held)
+                        producers.fetch_sub(1, std::memory_order_release);
+                    held = false;
+                }
+
+            private:
+                std::atomic<int> &producers;
+                bool held = true;
+            };
+        }
+
+        void LogEntry::generateTimestamp()
         {
-            logFile.close();
+            auto now = std::chrono::system_clock::now();
+            std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+            int millis = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                              now.time_since_epoch())
+                                              .count() %
+                                          1000);
+
+            std::tm local{};
+#ifdef _WIN32
+            localtime_s(&local, &seconds);
+#else
+            localtime_r(&seconds, &local);
+#endif
+            char buffer[32];
+            size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+            std::snprintf(buffer + length, sizeof(buffer) - length, ".%03d", millis);
+            timestamp = buffer;
         }
-    }
 
-    Logger::LogStreamHelper::LogStreamHelper(LogLevel level,
-                                             const char *file, int line, const char *function)
-        : level(level), file(file), line(line), function(function) {}
+        void LogEntry::generateThreadId()
+        {
+            // Formatting a thread id goes through a stream; do it once per thread
+            thread_local const std::string cachedId = []()
+            {
+                std::ostringstream stream;
+                stream << std::this_thread::get_id();
+                return stream.str();
+            }();
+            threadId = cachedId;
+        }
 
-    Logger::LogStreamHelper::~LogStreamHelper()
-    {
-        Logger::getInstance().log(level, file, line, function, buffer.str());
-    }
+        Logger &Logger::getInstance()
+        {
+            static Logger instance;
+            return instance;
+        }
 
-    Logger &Logger::getInstance()
-    {
-        // Double-checked locking pattern with call_once for better thread safety
-        std::call_once(initFlag, []()
-                       {
-            instance.reset(new Logger());
-            initializeLogFile(); });
-        return *instance;
-    }
-
-    void Logger::initializeLogFile()
-    {
-        if (logDest == LogDestination::FILE || logDest == LogDestination::BOTH)
+        Logger::Logger()
+            : currentLogLevel_(LogLevel::INFO),
+              destination_(LogDestination::CONSOLE_ONLY),
+              currentFileSize_(0),
+              maxFileSize_(10 * 1024 * 1024),
+              maxBackupFiles_(5),
+              consoleOutputEnabled_(true),
+              fileOutputEnabled_(false),
+              timestampEnabled_(true),
+              threadIdEnabled_(false),
+              maxHistorySize_(1000),
+              totalLogCount_(0),
+              droppedCount_(0),
+              queue_(new MpscRingBuffer<QueuedEntry>(DEFAULT_QUEUE_CAPACITY)),
+              overflowPolicy_(OverflowPolicy::BLOCK),
+              asyncEnabled_(false),
+              activeProducers_(0),
+              writerSleeping_(false),
+              stopWriter_(false),
+              enqueuedCount_(0),
+              writtenCount_(0)
+        {
+            for (auto &count : logCountByLevel_)
+                count.store(0, std::memory_order_relaxed);
+
+            const char *term = std::getenv("TERM");
+            colorSupported_ = term != nullptr && std::string(term) != "dumb";
+
+            std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+            asyncEnabled_.store(true);
+            startWriter();
+        }
+
+        Logger::~Logger()
+        {
+            std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+            stopWriter();
+            std::lock_guard<std::mutex> lock(logMutex_);
+            drainPending();
+            if (logFile_ && logFile_->is_open())
+                logFile_->flush();
+        }
+
+        bool Logger::configure(const std::string &logFileName, LogDestination destination,
+                               size_t maxFileSize, int maxBackupFiles)
         {
-            try
+            std::lock_guard<std::mutex> lock(logMutex_);
+            destination_ = destination;
+            maxFileSize_ = maxFileSize;
+            maxBackupFiles_ = std::max(0, maxBackupFiles);
+            consoleOutputEnabled_ = destination != LogDestination::FILE_ONLY;
+            fileOutputEnabled_ = destination != LogDestination::CONSOLE_ONLY;
+            logFileName_ = logFileName;
+            logFile_.reset();
+            currentFileSize_ = 0;
+
+            if (!fileOutputEnabled_)
+                return true;
+
+            std::error_code error;
+            std::filesystem::path parent = std::filesystem::path(logFileName).parent_path();
+            if (!parent.empty())
+                std::filesystem::create_directories(parent, error);
+
+            logFile_.reset(new std::ofstream(logFileName, std::ios::app | std::ios::binary));
+            if (!logFile_->is_open())
             {
-                fs::create_directories(fs::path(logFilePath).parent_path());
-                logFile.open(logFilePath, std::ios::app);
-                if (!logFile.is_open())
+                std::cerr << "Logger: cannot open log file " << logFileName << std::endl;
+                logFile_.reset();
+                fileOutputEnabled_ = false;
+                return false;
+            }
+            logFile_->seekp(0, std::ios::end);
+            currentFileSize_ = static_cast<size_t>(logFile_->tellp());
+            return true;
+        }
+
+        void Logger::setLogLevel(LogLevel level)
+        {
+            currentLogLevel_.store(level, std::memory_order_relaxed);
+        }
+
+        LogLevel Logger::getLogLevel() const
+        {
+            return currentLogLevel_.load(std::memory_order_relaxed);
+        }
+
+        bool Logger::shouldLog(LogLevel level) const
+        {
+            return level >= currentLogLevel_.load(std::memory_order_relaxed);
+        }
+
+        void Logger::log(LogLevel level, const std::string &message,
+                         const std::string &filename, int lineNumber,
+                         const std::string &functionName)
+        {
+            if (!shouldLog(level))
+                return;
+
+            // Everything up to the push runs on the caller without taking a lock
+            QueuedEntry item;
+            item.entry = LogEntry(level, message, filename, lineNumber, functionName);
+            item.formatted = formatMessage(item.entry);
+            totalLogCount_.fetch_add(1, std::memory_order_relaxed);
+            logCountByLevel_[levelIndex(level)].fetch_add(1, std::memory_order_relaxed);
+
+            // Registered before the check, so setQueueCapacity either sees this producer or
+            // this producer sees asynchronous logging turned off
+            ProducerScope producing(activeProducers_);
+            if (!asyncEnabled_.load(std::memory_order_seq_cst))
+            {
+                producing.release();
+                writeSynchronously(item);
+                return;
+            }
+
+            bool queued = queue_->tryPush(std::move(item));
+            if (!queued && overflowPolicy_.load(std::memory_order_relaxed) == OverflowPolicy::DROP)
+            {
+                droppedCount_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            while (!queued)
+            {
+                // BLOCK: make sure the writer is awake, then wait for it to free slots
+                if (!asyncEnabled_.load(std::memory_order_acquire))
                 {
-                    throw std::runtime_error("Cannot open log file: " + logFilePath);
+                    producing.release();
+                    writeSynchronously(item);
+                    return;
                 }
+                std::unique_lock<std::mutex> lock(writerMutex_);
+                writerWake_.notify_one();
+                drained_.wait_for(lock, std::chrono::milliseconds(1));
+                lock.unlock();
+                queued = queue_->tryPush(std::move(item));
             }
-            catch (const fs::filesystem_error &e)
+            producing.release();
+            enqueuedCount_.fetch_add(1, std::memory_order_release);
+
+            // Pairs with the fence in writerLoop: either the writer sees the entry
+            // before sleeping or we see it asleep and wake it
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (writerSleeping_.load(std::memory_order_relaxed))
             {
-                std::cerr << "Filesystem error: " << e.what() << std::endl;
-                throw;
+                std::lock_guard<std::mutex> lock(writerMutex_);
+                writerWake_.notify_one();
             }
         }
-    }
 
-    void Logger::log(LogLevel level, const std::string &file, int line,
-                     const std::string &function, const std::string &message)
-    {
-        if (level < currentLogLevel)
-            return;
+        void Logger::log(LogLevel level, const std::string &message)
+        {
+            log(level, message, "", 0, "");
+        }
 
-        std::lock_guard<std::mutex> lock(mtx);
+        void Logger::log(LogLevel level, const std::stringstream &stream)
+        {
+            log(level, stream.str(), "", 0, "");
+        }
 
-        try
+        void Logger::setConsoleOutput(bool enable)
         {
-            const auto now = std::chrono::system_clock::now();
-            const auto time = std::chrono::system_clock::to_time_t(now);
-            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                now.time_since_epoch()) %
-                            1000;
+            std::lock_guard<std::mutex> lock(logMutex_);
+            consoleOutputEnabled_ = enable;
+        }
 
-            std::ostringstream stream;
-            stream << std::put_time(std::localtime(&time), "%Y-%m-%dT%H:%M:%S")
-                   << '.' << std::setfill('0') << std::setw(3) << ms.count()
-                   << " " << logLevelToString(level)
-                   << " [" << fs::path(file).filename().string() << ":"
-                   << line << "][" << function << "] "
-                   << message << std::endl;
+        void Logger::setFileOutput(bool enable)
+        {
+            std::lock_guard<std::mutex> lock(logMutex_);
+            fileOutputEnabled_ = enable;
+        }
 
-            const std::string logEntry = stream.str();
-            writeToDestinations(logEntry);
-            checkFileRotation();
+        void Logger::setTimestampEnabled(bool enable)
+        {
+            timestampEnabled_.store(enable, std::memory_order_relaxed);
         }
-        catch (const std::exception &e)
+
+        void Logger::setThreadIdEnabled(bool enable)
         {
-            std::cerr << "Logger error: " << e.what() << std::endl;
+            threadIdEnabled_.store(enable, std::memory_order_relaxed);
         }
-    }
 
-    void Logger::writeToDestinations(const std::string &message)
-    {
-        if ((logDest == LogDestination::CONSOLE || logDest == LogDestination::BOTH))
+        void Logger::setAsyncEnabled(bool enable)
         {
-            std::cout << addColor(message);
-            std::cout.flush(); // Ensure immediate output
+            std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+            if (enable == asyncEnabled_.load())
+                return;
+
+            if (enable)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(logMutex_);
+                    asyncEnabled_.store(true, std::memory_order_release);
+                }
+                startWriter();
+            }
+            else
+            {
+                // New callers write synchronously; wait out those still pushing, so the
+                // writer drains every queued entry before it stops
+                asyncEnabled_.store(false, std::memory_order_seq_cst);
+                while (activeProducers_.load(std::memory_order_acquire) > 0)
+                    std::this_thread::yield();
+                stopWriter();
+
+                std::lock_guard<std::mutex> lock(logMutex_);
+                drainPending();
+            }
         }
 
-        if ((logDest == LogDestination::FILE || logDest == LogDestination::BOTH) &&
-            logFile.is_open())
+        bool Logger::isAsyncEnabled() const
         {
-            logFile << removeColor(message);
-            logFile.flush();
+            return asyncEnabled_.load(std::memory_order_relaxed);
         }
-    }
 
-    std::string Logger::logLevelToString(LogLevel level)
-    {
-        switch (level)
-        {
-        case LogLevel::DEBUG:
-            return "DEBUG";
-        case LogLevel::INFO:
-            return "INFO "; // Added space for consistent alignment
-        case LogLevel::WARNING:
-            return "WARN "; // Standardized to 5 chars
-        case LogLevel::ERROR:
-            return "ERROR";
-        case LogLevel::CRITICAL:
-            return "CRIT "; // Standardized to 5 chars
-        default:
-            return "UNKN "; // Standardized to 5 chars
-        }
-    }
-
-    std::string Logger::addColor(const std::string &message)
-    {
-        if (logDest == LogDestination::FILE)
-            return message;
+        void Logger::setQueueCapacity(size_t capacity)
+        {
+            std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+            bool wasAsync = asyncEnabled_.load();
+            stopWriter();
 
-        std::string colored = message;
+            // New callers write synchronously; wait out those still pushing to the old queue
+            asyncEnabled_.store(false, std::memory_order_seq_cst);
+            while (activeProducers_.load(std::memory_order_acquire) > 0)
+                std::this_thread::yield();
 
-        // Find the log level in the message more reliably
-        size_t levelStart = colored.find(' ') + 1;
-        if (levelStart != std::string::npos && levelStart < colored.length())
-        {
-            size_t levelEnd = colored.find(' ', levelStart);
-            if (levelEnd != std::string::npos)
             {
-                std::string level = colored.substr(levelStart, levelEnd - levelStart);
+                std::lock_guard<std::mutex> lock(logMutex_);
+                drainPending();
+                queue_.reset(new MpscRingBuffer<QueuedEntry>(capacity));
+                asyncEnabled_.store(wasAsync, std::memory_order_release);
+            }
+            startWriter();
+        }
 
-                // Remove trailing spaces for comparison
-                level.erase(level.find_last_not_of(' ') + 1);
+        size_t Logger::getQueueCapacity() const
+        {
+            std::lock_guard<std::mutex> lock(logMutex_);
+            return queue_->capacity();
+        }
 
-                if (level == "ERROR")
-                {
-                    colored.insert(0, "\033[1;31m"); // Red
-                    colored.append("\033[0m");
-                }
-                else if (level == "WARN")
-                {
-                    colored.insert(0, "\033[1;33m"); // Yellow
-                    colored.append("\033[0m");
-                }
-                else if (level == "DEBUG")
-                {
-                    colored.insert(0, "\033[1;36m"); // Cyan
-                    colored.append("\033[0m");
-                }
-                else if (level == "CRIT")
-                {
-                    colored.insert(0, "\033[1;35m"); // Magenta
-                    colored.append("\033[0m");
-                }
-                else if (level == "INFO")
+        void Logger::setOverflowPolicy(OverflowPolicy policy)
+        {
+            overflowPolicy_.store(policy, std::memory_order_relaxed);
+        }
+
+        OverflowPolicy Logger::getOverflowPolicy() const
+        {
+            return overflowPolicy_.load(std::memory_order_relaxed);
+        }
+
+        size_t Logger::getDroppedCount() const
+        {
+            return droppedCount_.load(std::memory_order_relaxed);
+        }
+
+        void Logger::flush()
+        {
+            std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+            if (writerThread_.joinable())
+            {
+                size_t target = enqueuedCount_.load(std::memory_order_acquire);
+                std::unique_lock<std::mutex> lock(writerMutex_);
+                while (writtenCount_.load(std::memory_order_acquire) < target)
                 {
-                    colored.insert(0, "\033[1;32m"); // Green
-                    colored.append("\033[0m");
+                    writerWake_.notify_one();
+                    drained_.wait_for(lock, WRITER_IDLE_TIMEOUT);
                 }
             }
+
+            std::lock_guard<std::mutex> lock(logMutex_);
+            if (!writerThread_.joinable())
+                drainPending();
+            if (logFile_ && logFile_->is_open())
+                logFile_->flush();
+            std::cout.flush();
         }
-        return colored;
-    }
 
-    std::string Logger::removeColor(const std::string &message)
-    {
-        std::string cleanMessage;
-        cleanMessage.reserve(message.length()); // Reserve space for efficiency
-        bool inColorCode = false;
+        std::vector<LogEntry> Logger::getRecentLogs(size_t maxEntries) const
+        {
+            std::lock_guard<std::mutex> lock(logMutex_);
+            size_t count = std::min(maxEntries, logHistory_.size());
+            return std::vector<LogEntry>(logHistory_.end() - count, logHistory_.end());
+        }
 
-        for (char c : message)
+        void Logger::clearHistory()
         {
-            if (c == '\033')
-            {
-                inColorCode = true;
-                continue;
-            }
-            if (inColorCode && c == 'm')
+            std::lock_guard<std::mutex> lock(logMutex_);
+            logHistory_.clear();
+        }
+
+        std::string Logger::getStatistics() const
+        {
+            std::string stats = "Total log messages: " + std::to_string(totalLogCount_.load()) + "\n";
+            for (size_t i = 0; i < 5; ++i)
             {
-                inColorCode = false;
-                continue;
+                stats += "  " + levelToString(static_cast<LogLevel>(i)) + ": " +
+                         std::to_string(logCountByLevel_[i].load()) + "\n";
             }
-            if (!inColorCode)
+            stats += "Dropped (queue full): " + std::to_string(droppedCount_.load()) + "\n";
+            stats += "Queue capacity: " + std::to_string(getQueueCapacity()) + " (" +
+                     (asyncEnabled_.load() ? "async" : "sync") + ", " +
+                     (overflowPolicy_.load() == OverflowPolicy::DROP ? "drop" : "block") + " on overflow)\n";
+            return stats;
+        }
+
+        std::string Logger::levelToString(LogLevel level)
+        {
+            switch (level)
             {
-                cleanMessage += c;
+            case LogLevel::DEBUG:
+                return "DEBUG";
+            case LogLevel::INFO:
+                return "INFO";
+            case LogLevel::WARNING:
+                return "WARNING";
+            case LogLevel::ERROR:
+                return "ERROR";
+            case LogLevel::CRITICAL:
+                return "CRITICAL";
             }
+            return "UNKNOWN";
         }
-        return cleanMessage;
-    }
 
-    void Logger::checkFileRotation()
-    {
-        if (logDest == LogDestination::CONSOLE || !logFile.is_open())
-            return;
+        LogLevel Logger::stringToLevel(const std::string &levelStr)
+        {
+            std::string upper = levelStr;
+            std::transform(upper.begin(), upper.end(), upper.begin(),
+                           [](unsigned char c)
+                           { return static_cast<char>(std::toupper(c)); });
+
+            if (upper == "DEBUG")
+                return LogLevel::DEBUG;
+            if (upper == "WARNING" || upper == "WARN")
+                return LogLevel::WARNING;
+            if (upper == "ERROR")
+                return LogLevel::ERROR;
+            if (upper == "CRITICAL")
+                return LogLevel::CRITICAL;
+            return LogLevel::INFO;
+        }
 
-        try
+        std::string Logger::formatMessage(const LogEntry &entry) const
         {
-            const std::streampos currentPos = logFile.tellp();
-            if (currentPos >= 0 && static_cast<size_t>(currentPos) >= maxFileSize)
+            std::string line;
+            line.reserve(entry.message.size() + 64);
+            if (timestampEnabled_.load(std::memory_order_relaxed))
             {
-                rotateLogFile();
+                line += '[';
+                line += entry.timestamp;
+                line += "] ";
             }
+            line += '[';
+            line += levelToString(entry.level);
+            line += "] ";
+            if (threadIdEnabled_.load(std::memory_order_relaxed))
+            {
+                line += "[T:";
+                line += entry.threadId;
+                line += "] ";
+            }
+            line += entry.message;
+            if (!entry.filename.empty())
+            {
+                line += " (";
+                line += baseName(entry.filename);
+                line += ':';
+                line += std::to_string(entry.lineNumber);
+                if (!entry.functionName.empty())
+                {
+                    line += " in ";
+                    line += entry.functionName;
+                }
+                line += ')';
+            }
+            return line;
         }
-        catch (const std::exception &e)
-        {
-            std::cerr << "Error checking file rotation: " << e.what() << std::endl;
-        }
-    }
 
-    void Logger::rotateLogFile()
-    {
-        try
+        void Logger::writeBatch(std::vector<QueuedEntry> &batch)
         {
-            logFile.close();
+            if (batch.empty())
+                return;
 
-            // Rotate existing files
-            for (int i = static_cast<int>(maxBackupFiles) - 1; i >= 0; --i)
-            {
-                const std::string oldFile = i == 0 ? logFilePath : logFilePath + "." + std::to_string(i);
-                const std::string newFile = logFilePath + "." + std::to_string(i + 1);
+            bool toConsole = consoleOutputEnabled_ && destination_ != LogDestination::FILE_ONLY;
+            bool toFile = fileOutputEnabled_ && destination_ != LogDestination::CONSOLE_ONLY &&
+                          logFile_ && logFile_->is_open();
 
-                if (fs::exists(oldFile))
+            // Build each output once so the whole batch costs one write per destination
+            std::string consoleText;
+            std::string fileText;
+            for (QueuedEntry &item : batch)
+            {
+                if (toConsole)
                 {
-                    // Remove target file if it exists to avoid conflicts
-                    if (fs::exists(newFile))
-                    {
-                        fs::remove(newFile);
-                    }
-                    fs::rename(oldFile, newFile);
+                    if (colorSupported_)
+                        consoleText += getColorCode(item.entry.level);
+                    consoleText += item.formatted;
+                    if (colorSupported_)
+                        consoleText += getResetCode();
+                    consoleText += '\n';
+                }
+                if (toFile)
+                {
+                    fileText += item.formatted;
+                    fileText += '\n';
                 }
+                logHistory_.push_back(std::move(item.entry));
             }
 
-            // Delete oldest file if exceeds max backup
-            const std::string oldestFile = logFilePath + "." +
-                                           std::to_string(maxBackupFiles + 1);
-            if (fs::exists(oldestFile))
+            if (logHistory_.size() > maxHistorySize_)
+                logHistory_.erase(logHistory_.begin(), logHistory_.end() - maxHistorySize_);
+
+            if (!consoleText.empty())
             {
-                fs::remove(oldestFile);
+                std::cout.write(consoleText.data(), static_cast<std::streamsize>(consoleText.size()));
+                std::cout.flush();
             }
-
-            // Reopen the main log file
-            logFile.open(logFilePath, std::ios::trunc);
-            if (!logFile.is_open())
+            if (!fileText.empty())
             {
-                throw std::runtime_error("Cannot reopen log file after rotation: " + logFilePath);
+                logFile_->write(fileText.data(), static_cast<std::streamsize>(fileText.size()));
+                logFile_->flush();
+                currentFileSize_ += fileText.size();
+                if (currentFileSize_ >= maxFileSize_)
+                    rotateLogFile();
             }
         }
-        catch (const fs::filesystem_error &e)
-        {
-            std::cerr << "Filesystem error during log rotation: " << e.what() << std::endl;
-        }
-        catch (const std::exception &e)
+
+        void Logger::writeSynchronously(QueuedEntry &item)
         {
-            std::cerr << "Error during log rotation: " << e.what() << std::endl;
+            std::lock_guard<std::mutex> lock(logMutex_);
+            // Once a writer is back it is the only consumer, so leave the queue alone
+            if (!asyncEnabled_.load(std::memory_order_acquire))
+                drainPending();
+            std::vector<QueuedEntry> batch;
+            batch.push_back(std::move(item));
+            writeBatch(batch);
         }
-    }
-
-    void Logger::setLogDestination(LogDestination dest)
-    {
-        std::lock_guard<std::mutex> lock(mtx);
-        logDest = dest;
 
-        if (logFile.is_open())
+        void Logger::drainPending()
         {
-            logFile.close();
+            std::vector<QueuedEntry> pending;
+            QueuedEntry item;
+            while (queue_->tryPop(item))
+                pending.push_back(std::move(item));
+            writeBatch(pending);
+            writtenCount_.fetch_add(pending.size(), std::memory_order_release);
         }
 
-        if (dest == LogDestination::FILE || dest == LogDestination::BOTH)
+        void Logger::writerLoop()
         {
-            try
+            std::vector<QueuedEntry> batch;
+            batch.reserve(MAX_BATCH_SIZE);
+            QueuedEntry item;
+
+            for (;;)
             {
-                fs::create_directories(fs::path(logFilePath).parent_path());
-                logFile.open(logFilePath, std::ios::app);
-                if (!logFile.is_open())
+                while (batch.size() < MAX_BATCH_SIZE && queue_->tryPop(item))
+                    batch.push_back(std::move(item));
+
+                if (!batch.empty())
                 {
-                    throw std::runtime_error("Cannot open log file: " + logFilePath);
+                    size_t written = batch.size();
+                    {
+                        std::lock_guard<std::mutex> lock(logMutex_);
+                        writeBatch(batch);
+                    }
+                    batch.clear();
+                    writtenCount_.fetch_add(written, std::memory_order_release);
+                    {
+                        std::lock_guard<std::mutex> lock(writerMutex_);
+                    }
+                    drained_.notify_all();
+                    continue;
                 }
+
+                std::unique_lock<std::mutex> lock(writerMutex_);
+                if (stopWriter_ && !queue_->hasPending())
+                    break;
+                writerSleeping_.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!queue_->hasPending())
+                    writerWake_.wait_for(lock, WRITER_IDLE_TIMEOUT);
+                writerSleeping_.store(false, std::memory_order_relaxed);
             }
-            catch (const std::exception &e)
+        }
+
+        void Logger::startWriter()
+        {
+            if (writerThread_.joinable() || !asyncEnabled_.load())
+                return;
             {
-                std::cerr << "Error setting log destination: " << e.what() << std::endl;
+                std::lock_guard<std::mutex> lock(writerMutex_);
+                stopWriter_ = false;
             }
+            writerThread_ = std::thread(&Logger::writerLoop, this);
         }
-    }
-
-    void Logger::setLogLevel(LogLevel level)
-    {
-        std::lock_guard<std::mutex> lock(mtx);
-        currentLogLevel = level;
-    }
 
-    void Logger::setLogFilePath(const std::string &path)
-    {
-        std::lock_guard<std::mutex> lock(mtx);
-
-        if (logFile.is_open())
+        void Logger::stopWriter()
         {
-            logFile.close();
+            if (!writerThread_.joinable())
+                return;
+            {
+                std::lock_guard<std::mutex> lock(writerMutex_);
+                stopWriter_ = true;
+            }
+            writerWake_.notify_one();
+            writerThread_.join();
+            drained_.notify_all();
         }
 
-        logFilePath = path;
-
-        if (logDest == LogDestination::FILE || logDest == LogDestination::BOTH)
+        void Logger::rotateLogFile()
         {
-            try
+            logFile_.reset();
+            if (maxBackupFiles_ > 0)
             {
-                fs::create_directories(fs::path(logFilePath).parent_path());
-                logFile.open(logFilePath, std::ios::app);
-                if (!logFile.is_open())
+                std::remove((logFileName_ + "." + std::to_string(maxBackupFiles_)).c_str());
+                for (int i = maxBackupFiles_ - 1; i >= 1; --i)
                 {
-                    throw std::runtime_error("Cannot open log file: " + logFilePath);
+                    std::rename((logFileName_ + "." + std::to_string(i)).c_str(),
+                                (logFileName_ + "." + std::to_string(i + 1)).c_str());
                 }
+                std::rename(logFileName_.c_str(), (logFileName_ + ".1").c_str());
             }
-            catch (const std::exception &e)
+
+            logFile_.reset(new std::ofstream(logFileName_, std::ios::trunc | std::ios::binary));
+            currentFileSize_ = 0;
+            if (!logFile_->is_open())
             {
-                std::cerr << "Error setting log file path: " << e.what() << std::endl;
+                std::cerr << "Logger: cannot reopen log file " << logFileName_ << " after rotation" << std::endl;
+                logFile_.reset();
             }
         }
-    }
-
-    void Logger::setMaxFileSize(size_t size)
-    {
-        std::lock_guard<std::mutex> lock(mtx);
-        maxFileSize = size;
-    }
 
-    void Logger::setMaxBackupFiles(unsigned int count)
-    {
-        std::lock_guard<std::mutex> lock(mtx);
-        maxBackupFiles = count;
-    }
+        std::string Logger::getColorCode(LogLevel level) const
+        {
+            switch (level)
+            {
+            case LogLevel::DEBUG:
+                return "\033[36m"; // Cyan
+            case LogLevel::INFO:
+                return "\033[32m"; // Green
+            case LogLevel::WARNING:
+                return "\033[33m"; // Yellow
+            case LogLevel::ERROR:
+                return "\033[31m"; // Red
+            case LogLevel::CRITICAL:
+                return "\033[1;31m"; // Bold red
+            }
+            return "";
+        }
 
-    // Add missing static member for std::call_once
-    std::once_flag Logger::initFlag;
+        std::string Logger::getResetCode() const
+        {
+            return "\033[0m";
+        }
 
+    } // namespace utils
 } // namespace transport
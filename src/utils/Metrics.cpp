@@ -0,0 +1,289 @@
+#include "../../include/utils/Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace transport
+{
+    namespace utils
+    {
+
+        namespace
+        {
+            uint64_t toBits(double value)
+            {
+                uint64_t bits;
+                std::memcpy(&bits, &value, sizeof bits);
+                return bits;
+            }
+
+            double fromBits(uint64_t bits)
+            {
+                double value;
+                std::memcpy(&value, &bits, sizeof value);
+                return value;
+            }
+
+            // Prometheus sample value: integers exactly, everything else with 15 significant digits
+            std::string formatValue(double value)
+            {
+                if (std::isnan(value))
+                    return "NaN";
+                if (std::isinf(value))
+                    return value > 0 ? "+Inf" : "-Inf";
+                char text[32];
+                std::snprintf(text, sizeof text, "%.15g", value);
+                return text;
+            }
+
+            std::string escape(const std::string &text, bool quotes)
+            {
+                std::string escaped;
+                escaped.reserve(text.size());
+                for (char c : text)
+                {
+                    if (c == '\\')
+                        escaped += "\\\\";
+                    else if (c == '\n')
+                        escaped += "\\n";
+                    else if (c == '"' && quotes)
+                        escaped += "\\\"";
+                    else
+                        escaped += c;
+                }
+                return escaped;
+            }
+
+            std::string withLabel(const std::string &labels, const std::string &extra)
+            {
+                if (labels.empty() && extra.empty())
+                    return "";
+                if (labels.empty() || extra.empty())
+                    return "{" + labels + extra + "}";
+                return "{" + labels + "," + extra + "}";
+            }
+        }
+
+        void Gauge::set(double newValue)
+        {
+            bits.store(toBits(newValue), std::memory_order_relaxed);
+        }
+
+        void Gauge::add(double delta)
+        {
+            uint64_t current = bits.load(std::memory_order_relaxed);
+            while (!bits.compare_exchange_weak(current, toBits(fromBits(current) + delta), std::memory_order_relaxed))
+            {
+            }
+        }
+
+        double Gauge::get() const
+        {
+            return fromBits(bits.load(std::memory_order_relaxed));
+        }
+
+        const std::vector<double> &MetricsRegistry::defaultLatencyBounds()
+        {
+            static const std::vector<double> bounds = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+                                                       0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+            return bounds;
+        }
+
+        Counter &MetricsRegistry::counter(const std::string &name, const std::string &help, const Labels &labels)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool created = false;
+            Series &entry = series(name, help, Type::Counter, labels, created);
+            if (created || !entry.counter)
+            {
+                if (entry.read)
+                    throw std::invalid_argument("Metric " + name + " is already a function metric");
+                entry.counter = std::make_unique<Counter>();
+            }
+            return *entry.counter;
+        }
+
+        Gauge &MetricsRegistry::gauge(const std::string &name, const std::string &help, const Labels &labels)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool created = false;
+            Series &entry = series(name, help, Type::Gauge, labels, created);
+            if (created || !entry.gauge)
+            {
+                if (entry.read)
+                    throw std::invalid_argument("Metric " + name + " is already a function metric");
+                entry.gauge = std::make_unique<Gauge>();
+            }
+            return *entry.gauge;
+        }
+
+        Histogram &MetricsRegistry::histogram(const std::string &name, const std::string &help,
+                                              const Labels &labels, double unitScale,
+                                              const std::vector<double> &bounds)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool created = false;
+            Series &entry = series(name, help, Type::Histogram, labels, created);
+            if (created)
+            {
+                entry.histogram = std::make_unique<Histogram>();
+                entry.unitScale = unitScale;
+                entry.bounds = bounds;
+            }
+            return *entry.histogram;
+        }
+
+        void MetricsRegistry::counterFunction(const std::string &name, const std::string &help,
+                                              std::function<double()> read, const Labels &labels)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool created = false;
+            Series &entry = series(name, help, Type::Counter, labels, created);
+            if (entry.counter)
+                throw std::invalid_argument("Metric " + name + " is already a counter");
+            entry.read = std::move(read); // Registering again replaces the source
+        }
+
+        void MetricsRegistry::gaugeFunction(const std::string &name, const std::string &help,
+                                            std::function<double()> read, const Labels &labels)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool created = false;
+            Series &entry = series(name, help, Type::Gauge, labels, created);
+            if (entry.gauge)
+                throw std::invalid_argument("Metric " + name + " is already a gauge");
+            entry.read = std::move(read);
+        }
+
+        std::string MetricsRegistry::exportPrometheus() const
+        {
+            static const char *const TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::string out;
+            for (const auto &familyEntry : families)
+            {
+                const std::string &name = familyEntry.first;
+                const Family &family = familyEntry.second;
+                out += "# HELP " + name + " " + escape(family.help, false) + "\n";
+                out += "# TYPE " + name + " " + TYPE_NAMES[static_cast<int>(family.type)] + "\n";
+
+                for (const auto &entry : family.series)
+                {
+                    if (family.type != Type::Histogram)
+                    {
+                        double value = entry->read      ? entry->read()
+                                       : entry->counter ? static_cast<double>(entry->counter->get())
+                                                        : entry->gauge->get();
+                        out += name + withLabel(entry->labels, "") + " " + formatValue(value) + "\n";
+                        continue;
+                    }
+
+                    // Copy the buckets once so the cumulative counts and _count agree
+                    const Histogram &histogram = *entry->histogram;
+                    std::vector<uint64_t> counts(Histogram::BUCKETS);
+                    for (size_t b = 0; b < Histogram::BUCKETS; ++b)
+                        counts[b] = histogram.getBucketCount(b);
+
+                    uint64_t cumulative = 0;
+                    size_t bucket = 0;
+                    for (double bound : entry->bounds)
+                    {
+                        double limit = std::floor(bound / entry->unitScale);
+                        while (bucket < Histogram::BUCKETS &&
+                               static_cast<double>(Histogram::bucketUpperBound(bucket)) <= limit)
+                            cumulative += counts[bucket++];
+                        out += name + "_bucket" + withLabel(entry->labels, "le=\"" + formatValue(bound) + "\"") +
+                               " " + std::to_string(cumulative) + "\n";
+                    }
+                    while (bucket < Histogram::BUCKETS)
+                        cumulative += counts[bucket++];
+                    out += name + "_bucket" + withLabel(entry->labels, "le=\"+Inf\"") + " " +
+                           std::to_string(cumulative) + "\n";
+                    out += name + "_sum" + withLabel(entry->labels, "") + " " +
+                           formatValue(static_cast<double>(histogram.getSum()) * entry->unitScale) + "\n";
+                    out += name + "_count" + withLabel(entry->labels, "") + " " + std::to_string(cumulative) + "\n";
+                }
+            }
+            return out;
+        }
+
+        bool MetricsRegistry::writePrometheusFile(const std::string &path) const
+        {
+            std::string text = exportPrometheus();
+            std::string temporary = path + ".tmp";
+            {
+                std::ofstream file(temporary, std::ios::trunc);
+                if (!file.is_open())
+                {
+                    std::cerr << "Error: Cannot open " << temporary << " for writing" << std::endl;
+                    return false;
+                }
+                file << text;
+                if (!file.flush())
+                {
+                    std::cerr << "Error: Failed to write " << temporary << std::endl;
+                    return false;
+                }
+            }
+
+            std::error_code error;
+            std::filesystem::rename(temporary, path, error);
+            if (error)
+            {
+                std::cerr << "Error: Cannot replace " << path << ": " << error.message() << std::endl;
+                std::filesystem::remove(temporary, error);
+                return false;
+            }
+            return true;
+        }
+
+        MetricsRegistry::Series &MetricsRegistry::series(const std::string &name, const std::string &help,
+                                                         Type type, const Labels &labels, bool &created)
+        {
+            auto inserted = families.try_emplace(name);
+            Family &family = inserted.first->second;
+            if (inserted.second)
+            {
+                family.type = type;
+                family.help = help;
+            }
+            else if (family.type != type)
+            {
+                throw std::invalid_argument("Metric " + name + " is already registered with another type");
+            }
+
+            std::string rendered = renderLabels(labels);
+            for (auto &entry : family.series)
+            {
+                if (entry->labels == rendered)
+                {
+                    created = false;
+                    return *entry;
+                }
+            }
+            family.series.push_back(std::make_unique<Series>());
+            family.series.back()->labels = rendered;
+            created = true;
+            return *family.series.back();
+        }
+
+        std::string MetricsRegistry::renderLabels(const Labels &labels)
+        {
+            std::string rendered;
+            for (const auto &label : labels)
+            {
+                if (!rendered.empty())
+                    rendered += ",";
+                rendered += label.first + "=\"" + escape(label.second, true) + "\"";
+            }
+            return rendered;
+        }
+
+    } // namespace utils
+} // namespace transport
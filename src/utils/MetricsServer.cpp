@@ -0,0 +1,204 @@
+#include "../../include/utils/MetricsServer.h"
+#include "../../include/utils/Metrics.h"
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace transport
+{
+    namespace utils
+    {
+
+        namespace
+        {
+            const int POLL_INTERVAL_MS = 200;      // How quickly stop() is noticed
+            const size_t MAX_REQUEST_BYTES = 8192; // Only the request line is needed
+
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+            const int SEND_FLAGS = MSG_NOSIGNAL; // A scraper hanging up must not raise SIGPIPE
+#else
+            const int SEND_FLAGS = 0;
+#endif
+
+            void sendAll(int socket, const std::string &data)
+            {
+                size_t sent = 0;
+                while (sent < data.size())
+                {
+                    ssize_t written = ::send(socket, data.data() + sent, data.size() - sent, SEND_FLAGS);
+                    if (written < 0 && errno == EINTR)
+                        continue;
+                    if (written <= 0)
+                        return;
+                    sent += static_cast<size_t>(written);
+                }
+            }
+
+            std::string response(const std::string &status, const std::string &contentType, const std::string &body)
+            {
+                return "HTTP/1.1 " + status + "\r\nContent-Type: " + contentType +
+                       "\r\nContent-Length: " + std::to_string(body.size()) +
+                       "\r\nConnection: close\r\n\r\n" + body;
+            }
+#endif
+        }
+
+        MetricsServer::MetricsServer(const MetricsRegistry &metricsRegistry)
+            : registry(metricsRegistry)
+        {
+        }
+
+        MetricsServer::~MetricsServer()
+        {
+            stop();
+        }
+
+        bool MetricsServer::start(uint16_t port)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (running.load())
+            {
+                lastError = "Metrics server is already running on port " + std::to_string(boundPort.load());
+                return false;
+            }
+
+#ifdef _WIN32
+            (void)port;
+            lastError = "The metrics HTTP endpoint is not supported on this platform";
+            return false;
+#else
+            listenSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+            if (listenSocket < 0)
+            {
+                lastError = std::string("Cannot create socket: ") + std::strerror(errno);
+                return false;
+            }
+            int reuse = 1;
+            ::setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof reuse);
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(port);
+            socklen_t length = sizeof address;
+            if (::bind(listenSocket, reinterpret_cast<sockaddr *>(&address), sizeof address) < 0 ||
+                ::listen(listenSocket, 16) < 0 ||
+                ::getsockname(listenSocket, reinterpret_cast<sockaddr *>(&address), &length) < 0)
+            {
+                lastError = "Cannot listen on 127.0.0.1:" + std::to_string(port) + ": " + std::strerror(errno);
+                ::close(listenSocket);
+                listenSocket = -1;
+                return false;
+            }
+
+            boundPort.store(ntohs(address.sin_port));
+            running.store(true);
+            thread = std::thread(&MetricsServer::serve, this);
+            return true;
+#endif
+        }
+
+        void MetricsServer::stop()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running.exchange(false))
+                return;
+            if (thread.joinable())
+                thread.join();
+#ifndef _WIN32
+            ::close(listenSocket);
+#endif
+            listenSocket = -1;
+            boundPort.store(0);
+        }
+
+        bool MetricsServer::isRunning() const
+        {
+            return running.load();
+        }
+
+        uint16_t MetricsServer::getPort() const
+        {
+            return boundPort.load();
+        }
+
+        std::string MetricsServer::getLastError() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return lastError;
+        }
+
+        void MetricsServer::serve()
+        {
+#ifndef _WIN32
+            while (running.load())
+            {
+                pollfd waiting{};
+                waiting.fd = listenSocket;
+                waiting.events = POLLIN;
+                if (::poll(&waiting, 1, POLL_INTERVAL_MS) <= 0 || !(waiting.revents & POLLIN))
+                    continue;
+
+                int client = ::accept(listenSocket, nullptr, nullptr);
+                if (client < 0)
+                    continue;
+                handleClient(client);
+                ::close(client);
+            }
+#endif
+        }
+
+        void MetricsServer::handleClient(int client)
+        {
+#ifdef _WIN32
+            (void)client;
+#else
+            // A stalled client must not keep the endpoint busy
+            timeval timeout{};
+            timeout.tv_sec = 1;
+            ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout);
+            ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof timeout);
+
+            std::string request;
+            char chunk[1024];
+            while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES)
+            {
+                ssize_t received = ::recv(client, chunk, sizeof chunk, 0);
+                if (received < 0 && errno == EINTR)
+                    continue;
+                if (received <= 0)
+                    break;
+                request.append(chunk, static_cast<size_t>(received));
+            }
+
+            std::string line = request.substr(0, request.find("\r\n"));
+            size_t methodEnd = line.find(' ');
+            size_t targetEnd = line.find(' ', methodEnd == std::string::npos ? 0 : methodEnd + 1);
+            if (methodEnd == std::string::npos || targetEnd == std::string::npos)
+            {
+                sendAll(client, response("400 Bad Request", "text/plain", "Bad request\n"));
+                return;
+            }
+            std::string method = line.substr(0, methodEnd);
+            std::string target = line.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+            target = target.substr(0, target.find('?'));
+
+            if (method == "GET" && target == "/metrics")
+                sendAll(client, response("200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                                         registry.exportPrometheus()));
+            else
+                sendAll(client, response("404 Not Found", "text/plain", "Only GET /metrics is served\n"));
+#endif
+        }
+
+    } // namespace utils
+} // namespace transport
@@ -0,0 +1,289 @@
+#include "../../include/utils/WorkStealingScheduler.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace transport
+{
+    namespace utils
+    {
+
+        namespace
+        {
+            thread_local const WorkStealingScheduler *currentScheduler = nullptr;
+            thread_local int currentIndex = -1;
+
+            // Time the running task spent in nested tasks and in parallelFor waits; the
+            // nested tasks count their own busy time, the waits are not busy at all
+            thread_local int64_t excludedNanoseconds = 0;
+
+            // Bounds of the sleep between steal attempts of a waiting parallelFor caller
+            const std::chrono::microseconds MIN_HELP_BACKOFF{20};
+            const std::chrono::microseconds MAX_HELP_BACKOFF{1000};
+
+            int64_t nowNanoseconds()
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+            }
+        }
+
+        WorkStealingScheduler::WorkStealingScheduler(size_t threadCount)
+        {
+            if (threadCount == 0)
+                threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+            statsStartNanoseconds = nowNanoseconds();
+            for (size_t i = 0; i < threadCount; ++i)
+                workers.push_back(std::make_unique<Worker>());
+            for (size_t i = 0; i < threadCount; ++i)
+                threads.emplace_back(&WorkStealingScheduler::workerLoop, this, i);
+        }
+
+        WorkStealingScheduler::~WorkStealingScheduler()
+        {
+            waitIdle();
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                stopping = true;
+            }
+            wakeUp.notify_all();
+            for (auto &thread : threads)
+                thread.join();
+        }
+
+        int WorkStealingScheduler::currentWorkerIndex() const
+        {
+            return currentScheduler == this ? currentIndex : -1;
+        }
+
+        void WorkStealingScheduler::submit(Task task)
+        {
+            outstanding.fetch_add(1);
+
+            // Nested work stays on the submitting worker; external work is spread out
+            int self = currentWorkerIndex();
+            size_t target = self >= 0 ? static_cast<size_t>(self)
+                                      : nextQueue.fetch_add(1, std::memory_order_relaxed) % workers.size();
+            {
+                std::lock_guard<std::mutex> lock(workers[target]->mutex);
+                workers[target]->tasks.push_back(std::move(task));
+            }
+            queued.fetch_add(1);
+
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+            }
+            wakeUp.notify_one();
+        }
+
+        bool WorkStealingScheduler::popLocal(size_t self, Task &task)
+        {
+            Worker &worker = *workers[self];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.tasks.empty())
+                return false;
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+
+        bool WorkStealingScheduler::steal(size_t self, Task &task)
+        {
+            for (size_t offset = 1; offset < workers.size(); ++offset)
+            {
+                Worker &victim = *workers[(self + offset) % workers.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty())
+                {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    workers[self]->stolen.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void WorkStealingScheduler::run(size_t self, Task &task)
+        {
+            queued.fetch_sub(1);
+            int64_t outerExcluded = excludedNanoseconds;
+            excludedNanoseconds = 0;
+            int64_t started = nowNanoseconds();
+            try
+            {
+                task();
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Scheduler task failed: " << e.what() << std::endl;
+            }
+            catch (...)
+            {
+                std::cerr << "Scheduler task failed with an unknown exception" << std::endl;
+            }
+
+            int64_t elapsed = nowNanoseconds() - started;
+            int64_t own = std::max<int64_t>(0, elapsed - excludedNanoseconds);
+            excludedNanoseconds = outerExcluded + elapsed; // The enclosing task, if any, excludes all of it
+
+            Worker &worker = *workers[self];
+            worker.busyNanoseconds.fetch_add(static_cast<uint64_t>(own), std::memory_order_relaxed);
+            worker.executed.fetch_add(1, std::memory_order_relaxed);
+
+            if (outstanding.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                idle.notify_all();
+            }
+        }
+
+        bool WorkStealingScheduler::tryRunOne(size_t self)
+        {
+            Task task;
+            if (!popLocal(self, task) && !steal(self, task))
+                return false;
+            run(self, task);
+            return true;
+        }
+
+        void WorkStealingScheduler::workerLoop(size_t index)
+        {
+            currentScheduler = this;
+            currentIndex = static_cast<int>(index);
+
+            while (true)
+            {
+                if (tryRunOne(index))
+                    continue;
+
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                wakeUp.wait(lock, [this]
+                            { return stopping || queued.load() > 0; });
+                if (stopping && queued.load() == 0)
+                    return;
+            }
+        }
+
+        void WorkStealingScheduler::parallelFor(size_t begin, size_t end,
+                                                const std::function<void(size_t)> &body, size_t grainSize)
+        {
+            if (begin >= end)
+                return;
+            grainSize = std::max<size_t>(1, grainSize);
+
+            struct LoopState
+            {
+                std::atomic<size_t> remaining{0};
+                std::mutex mutex;
+                std::condition_variable done;
+                std::exception_ptr error;
+            };
+            auto state = std::make_shared<LoopState>();
+            size_t chunks = (end - begin + grainSize - 1) / grainSize;
+            state->remaining = chunks;
+
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                size_t first = begin + chunk * grainSize;
+                size_t last = std::min(end, first + grainSize);
+                submit([state, first, last, &body]()
+                       {
+                    try
+                    {
+                        for (size_t i = first; i < last; ++i)
+                            body(i);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (!state->error)
+                            state->error = std::current_exception();
+                    }
+                    if (state->remaining.fetch_sub(1) == 1)
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        state->done.notify_all();
+                    } });
+            }
+
+            int self = currentWorkerIndex();
+            if (self >= 0)
+            {
+                // Help instead of blocking, otherwise nested loops could starve the pool.
+                // With nothing to run, sleep until the loop finishes or the backoff expires,
+                // then look for work again
+                std::chrono::microseconds backoff = MIN_HELP_BACKOFF;
+                while (state->remaining.load() > 0)
+                {
+                    if (tryRunOne(static_cast<size_t>(self)))
+                    {
+                        backoff = MIN_HELP_BACKOFF;
+                        continue;
+                    }
+
+                    int64_t waitStarted = nowNanoseconds();
+                    {
+                        std::unique_lock<std::mutex> lock(state->mutex);
+                        state->done.wait_for(lock, backoff, [&state]
+                                             { return state->remaining.load() == 0; });
+                    }
+                    excludedNanoseconds += nowNanoseconds() - waitStarted;
+                    backoff = std::min(backoff * 2, MAX_HELP_BACKOFF);
+                }
+            }
+            else
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->done.wait(lock, [&state]
+                                 { return state->remaining.load() == 0; });
+            }
+
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->error)
+                std::rethrow_exception(state->error);
+        }
+
+        void WorkStealingScheduler::waitIdle()
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            idle.wait(lock, [this]
+                      { return outstanding.load() == 0; });
+        }
+
+        size_t WorkStealingScheduler::getThreadCount() const
+        {
+            return workers.size();
+        }
+
+        std::vector<WorkStealingScheduler::WorkerStats> WorkStealingScheduler::getWorkerStats() const
+        {
+            double wallSeconds = std::max(1e-9, (nowNanoseconds() - statsStartNanoseconds.load()) / 1e9);
+            std::vector<WorkerStats> stats;
+            for (const auto &worker : workers)
+            {
+                WorkerStats entry;
+                entry.tasksExecuted = worker->executed.load(std::memory_order_relaxed);
+                entry.tasksStolen = worker->stolen.load(std::memory_order_relaxed);
+                entry.busySeconds = worker->busyNanoseconds.load(std::memory_order_relaxed) / 1e9;
+                entry.utilization = entry.busySeconds / wallSeconds;
+                stats.push_back(entry);
+            }
+            return stats;
+        }
+
+        void WorkStealingScheduler::resetStats()
+        {
+            for (auto &worker : workers)
+            {
+                worker->executed = 0;
+                worker->stolen = 0;
+                worker->busyNanoseconds = 0;
+            }
+            statsStartNanoseconds = nowNanoseconds();
+        }
+
+    } // namespace utils
+} // namespace transport
@@ -0,0 +1,95 @@
+#include "allocation_counter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @file allocation_counter.cpp
+ * @brief Counting replacements for the global allocation functions
+ *
+ * Every replaceable form is defined here, so allocations and deallocations always
+ * pair up: plain and array forms use malloc and free, aligned forms aligned_alloc.
+ * Counting is off unless an AllocationCounting scope is alive, so suites that do not
+ * ask for counts pay a relaxed load per allocation, not two atomic increments.
+ */
+
+namespace
+{
+    std::atomic<uint64_t> allocationCount{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+    std::atomic<int> countingScopes{0};
+
+    void *allocate(std::size_t size, std::size_t alignment)
+    {
+        if (countingScopes.load(std::memory_order_relaxed) > 0)
+        {
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+            allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+        if (size == 0)
+            size = 1;
+        if (alignment <= alignof(std::max_align_t))
+            return std::malloc(size);
+        // aligned_alloc wants a size that is a multiple of the alignment
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void *allocateOrThrow(std::size_t size, std::size_t alignment)
+    {
+        void *memory = allocate(size, alignment);
+        if (!memory)
+            throw std::bad_alloc();
+        return memory;
+    }
+}
+
+AllocationCount allocationsSoFar()
+{
+    return {allocationCount.load(std::memory_order_relaxed), allocatedBytes.load(std::memory_order_relaxed)};
+}
+
+AllocationCounting::AllocationCounting()
+{
+    countingScopes.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocationCounting::~AllocationCounting()
+{
+    countingScopes.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t size) { return allocateOrThrow(size, 0); }
+void *operator new[](std::size_t size) { return allocateOrThrow(size, 0); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, 0); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate(size, 0); }
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept { std::free(memory); }
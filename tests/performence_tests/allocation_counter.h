@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @file allocation_counter.h
+ * @brief Heap allocation counts of the whole benchmark process
+ *
+ * allocation_counter.cpp replaces the global operator new and delete of run_benchmarks
+ * with malloc-based versions that count allocations while an AllocationCounting is
+ * alive. Take a snapshot before and after the code under test; the difference is what
+ * it allocated, from any thread.
+ */
+
+struct AllocationCount
+{
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+
+    AllocationCount operator-(const AllocationCount &earlier) const
+    {
+        return {allocations - earlier.allocations, bytes - earlier.bytes};
+    }
+};
+
+// Allocations counted so far, over every AllocationCounting scope
+AllocationCount allocationsSoFar();
+
+/**
+ * @brief Enables counting while alive; outside such scopes, e.g. in the routing suite,
+ *        an allocation costs one relaxed load more than usual
+ */
+class AllocationCounting
+{
+public:
+    AllocationCounting();
+    ~AllocationCounting();
+
+    AllocationCounting(const AllocationCounting &) = delete;
+    AllocationCounting &operator=(const AllocationCounting &) = delete;
+};
@@ -0,0 +1,253 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "allocation_counter.h"
+#include "benchmark_report.h"
+#include "../test_utils.h"
+#include "../../include/core/Graph.h"
+#include "../../include/io/CSVHandler.h"
+#include "../../include/io/JSONHandler.h"
+#include "../../include/io/NetworkGenerator.h"
+#include "../../include/preferences/UserPreferences.h"
+
+/**
+ * @file benchmark_io.cpp
+ * @brief Throughput and heap allocations of the network and preference loaders and writers
+ *
+ * Each case times whole-file loads or saves, repeated --repetitions times, and reports
+ * MB/s and rows/s at the median plus heap allocations and bytes per row. A row is a
+ * data line of a CSV file, or a scalar value of a preferences file. Console chatter is
+ * discarded but still formatted, so its cost shows up as part of the loader's.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct CsvDataset
+    {
+        std::string name;
+        std::string path;
+    };
+
+    uint64_t fileSize(const std::string &path)
+    {
+        std::error_code error;
+        uint64_t size = std::filesystem::file_size(path, error);
+        return error ? 0 : size;
+    }
+
+    // Data lines: everything but the header, blank lines and # comments
+    uint64_t countCsvRows(const std::string &path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        uint64_t rows = 0;
+        bool header = true;
+        while (std::getline(file, line))
+        {
+            if (header)
+                header = false;
+            else if (!line.empty() && line[0] != '#')
+                rows++;
+        }
+        return rows;
+    }
+
+    uint64_t countJsonValues(const JSONValue &value)
+    {
+        uint64_t count = 0;
+        for (const auto &member : value.members())
+            count += countJsonValues(member.second);
+        for (const JSONValue &element : value.items())
+            count += countJsonValues(element);
+        return value.isObject() || value.isArray() ? count : 1;
+    }
+
+    /**
+     * @brief Time run() over the configured repetitions, one sample each
+     * @param prepare Untimed setup before every run, e.g. a fresh graph to load into
+     */
+    BenchmarkResult measure(const BenchmarkOptions &options, uint64_t bytes, uint64_t rows,
+                            const std::function<void()> &prepare, const std::function<bool()> &run)
+    {
+        ScopedSilence quiet;
+        AllocationCounting counting;
+        prepare();
+        run(); // Warm the page cache and the allocator
+
+        BenchmarkResult result;
+        AllocationCount allocated;
+        size_t failures = 0;
+        for (size_t repetition = 0; repetition < options.repetitions; ++repetition)
+        {
+            prepare();
+            AllocationCount before = allocationsSoFar();
+            Clock::time_point started = Clock::now();
+            failures += run() ? 0 : 1;
+            result.samplesMicros.push_back(
+                std::chrono::duration<double, std::micro>(Clock::now() - started).count());
+            AllocationCount used = allocationsSoFar() - before;
+            allocated.allocations += used.allocations;
+            allocated.bytes += used.bytes;
+        }
+
+        double seconds = BenchmarkReport::percentile(result.samplesMicros, 0.50) / 1e6;
+        double runs = static_cast<double>(options.repetitions);
+        double totalRows = static_cast<double>(rows) * runs;
+        result.throughput = seconds > 0 ? 1.0 / seconds : 0.0;
+        result.counters["bytes"] = static_cast<double>(bytes);
+        result.counters["rows"] = static_cast<double>(rows);
+        result.counters["mb_per_s"] = seconds > 0 ? static_cast<double>(bytes) / 1e6 / seconds : 0.0;
+        result.counters["rows_per_s"] = seconds > 0 ? static_cast<double>(rows) / seconds : 0.0;
+        if (totalRows > 0)
+        {
+            result.counters["allocations_per_row"] = static_cast<double>(allocated.allocations) / totalRows;
+            result.counters["allocated_bytes_per_row"] = static_cast<double>(allocated.bytes) / totalRows;
+        }
+        result.counters["failures"] = static_cast<double>(failures);
+        return result;
+    }
+
+    void addResult(BenchmarkReport &report, BenchmarkResult result, const std::string &name,
+                   const std::string &operation, const std::string &dataset)
+    {
+        result.name = name;
+        result.parameters = {{"suite", "io"}, {"operation", operation}, {"dataset", dataset}};
+        std::map<std::string, double> counters = result.counters;
+        report.add(std::move(result));
+        std::cout << "    " << counters["mb_per_s"] << " MB/s, " << counters["rows_per_s"] << " rows/s, "
+                  << counters["allocations_per_row"] << " allocations/row, " << counters["allocated_bytes_per_row"]
+                  << " bytes/row" << std::endl;
+    }
+
+    void benchmarkCsv(BenchmarkReport &report, const CsvDataset &dataset, const std::string &outputDir)
+    {
+        const BenchmarkOptions &options = report.getOptions();
+        uint64_t bytes = fileSize(dataset.path);
+        uint64_t rows = countCsvRows(dataset.path);
+        std::unique_ptr<Graph> graph;
+        auto freshGraph = [&graph]()
+        { graph = std::make_unique<Graph>(); };
+
+        std::string name = "io/" + dataset.name + "/graph_load_csv";
+        if (report.selected(name))
+            addResult(report, measure(options, bytes, rows, freshGraph, [&]()
+                                      { return graph->loadFromCSV(dataset.path); }),
+                      name, "graph_load_csv", dataset.name);
+
+        CSVHandler handler;
+        name = "io/" + dataset.name + "/csv_handler_load";
+        if (report.selected(name))
+            addResult(report, measure(options, bytes, rows, freshGraph, [&]()
+                                      { return handler.loadGraph(dataset.path, *graph); }),
+                      name, "csv_handler_load", dataset.name);
+
+        // Writers serialize the loaded graph, one row per edge
+        bool savesSelected = report.selected("io/" + dataset.name + "/graph_save_csv") ||
+                             report.selected("io/" + dataset.name + "/csv_handler_save");
+        if (!savesSelected)
+            return;
+        std::unique_ptr<Graph> loaded;
+        {
+            ScopedSilence quiet;
+            loaded = std::make_unique<Graph>();
+            loaded->loadFromCSV(dataset.path);
+        }
+        uint64_t edges = static_cast<uint64_t>(loaded->getEdgeCount());
+        std::string output = outputDir + "/" + dataset.name + ".csv";
+
+        auto timeSave = [&](const std::string &operation, const std::function<bool()> &save)
+        {
+            std::string caseName = "io/" + dataset.name + "/" + operation;
+            if (!report.selected(caseName))
+                return;
+            BenchmarkResult result = measure(options, 0, edges, []() {}, save);
+            // The written size is only known afterwards
+            double seconds = BenchmarkReport::percentile(result.samplesMicros, 0.50) / 1e6;
+            result.counters["bytes"] = static_cast<double>(fileSize(output));
+            result.counters["mb_per_s"] = seconds > 0 ? result.counters["bytes"] / 1e6 / seconds : 0.0;
+            addResult(report, std::move(result), caseName, operation, dataset.name);
+        };
+        timeSave("graph_save_csv", [&]()
+                 { return loaded->saveToCSV(output); });
+        timeSave("csv_handler_save", [&]()
+                 { return handler.saveGraph(output, *loaded); });
+    }
+
+    void benchmarkPreferences(BenchmarkReport &report, const std::string &dataset, const std::string &path)
+    {
+        JSONValue root;
+        JSONReader reader;
+        if (!reader.parseFile(path, root))
+        {
+            std::cout << "Skipping preferences " << dataset << ": " << reader.getLastError() << std::endl;
+            return;
+        }
+
+        std::string name = "io/" + dataset + "/preferences_load";
+        if (!report.selected(name))
+            return;
+        std::unique_ptr<UserPreferences> preferences;
+        addResult(report,
+                  measure(report.getOptions(), fileSize(path), countJsonValues(root),
+                          [&preferences]()
+                          { preferences = std::make_unique<UserPreferences>(); },
+                          [&]()
+                          { return preferences->loadFromFile(path); }),
+                  name, "preferences_load", dataset);
+    }
+}
+
+void runIOBenchmarks(BenchmarkReport &report)
+{
+    const BenchmarkOptions &options = report.getOptions();
+    std::string outputDir = (std::filesystem::temp_directory_path() / "transport_io_benchmarks").string();
+    std::error_code error;
+    std::filesystem::create_directories(outputDir, error);
+
+    std::vector<CsvDataset> datasets;
+    for (const auto &bundled : {CsvDataset{"jakarta", "data/sample_data/jakarta.csv"},
+                                CsvDataset{"network_data", "network_data.csv"}})
+    {
+        std::string path = findDataFile(bundled.path);
+        if (path.empty())
+            std::cout << "Skipping " << bundled.name << ": " << bundled.path << " not found" << std::endl;
+        else
+            datasets.push_back({bundled.name, path});
+    }
+
+    // A generated network in the network_data.csv schema, large enough to dwarf per-file costs
+    NetworkGenerator::Options generatorOptions;
+    generatorOptions.stopCount = options.quick ? 1000 : 10000;
+    generatorOptions.seed = options.seed;
+    std::string synthetic = "synthetic_" + std::to_string(generatorOptions.stopCount);
+    NetworkGenerator generator(generatorOptions);
+    if (generator.writeCSV(outputDir + "/" + synthetic + "_network.csv", outputDir + "/" + synthetic + "_nodes.csv"))
+        datasets.push_back({synthetic, outputDir + "/" + synthetic + "_network.csv"});
+    else
+        std::cout << "Skipping " << synthetic << ": " << generator.getLastError() << std::endl;
+
+    for (const CsvDataset &dataset : datasets)
+        benchmarkCsv(report, dataset, outputDir);
+
+    std::string bundledPreferences = findDataFile("config/user_preferences.json");
+    if (!bundledPreferences.empty())
+        benchmarkPreferences(report, "user_preferences", bundledPreferences);
+
+    // A profile-heavy file as written by saveToFile
+    UserPreferences profile;
+    for (int entry = 0; entry < 256; ++entry)
+        profile.setUserProfile("setting_" + std::to_string(entry), "value " + std::to_string(entry));
+    std::string profilePath = outputDir + "/profile_256.json";
+    if (profile.saveToFile(profilePath))
+        benchmarkPreferences(report, "profile_256", profilePath);
+
+    std::filesystem::remove_all(outputDir, error);
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "benchmark_report.h"
+
+/**
+ * @file benchmark_main.cpp
+ * @brief Entry point of run_benchmarks
+ *
+ * Usage: run_benchmarks [--json FILE] [--filter TEXT] [--queries N] [--repetitions N] [--seed N] [--quick]
+ *                       [SUITE...]
+ *
+ * Runs the named suites (all by default), prints one line per case and, with --json,
+ * writes the full report including raw samples.
+ */
+
+// Implemented in the benchmark_*.cpp files of this directory
+extern void runRoutingBenchmarks(BenchmarkReport &report);
+extern void runIOBenchmarks(BenchmarkReport &report);
+
+namespace
+{
+    void printUsage(const char *program)
+    {
+        std::cerr << "Usage: " << program
+                  << " [--json FILE] [--filter TEXT] [--queries N] [--repetitions N] [--seed N] [--quick] [SUITE...]"
+                  << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    struct BenchmarkSuite
+    {
+        std::string name;
+        std::function<void(BenchmarkReport &)> run;
+    };
+
+    std::vector<BenchmarkSuite> suites = {
+        {"routing", runRoutingBenchmarks},
+        {"io", runIOBenchmarks}};
+
+    BenchmarkOptions options;
+    std::vector<std::string> requested;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        try
+        {
+            if (argument == "--json" && hasValue)
+                options.jsonPath = argv[++i];
+            else if (argument == "--filter" && hasValue)
+                options.filter = argv[++i];
+            else if (argument == "--queries" && hasValue)
+                options.queries = static_cast<size_t>(std::max(1, std::stoi(argv[++i])));
+            else if (argument == "--repetitions" && hasValue)
+                options.repetitions = static_cast<size_t>(std::max(1, std::stoi(argv[++i])));
+            else if (argument == "--seed" && hasValue)
+                options.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+            else if (argument == "--quick")
+                options.quick = true;
+            else if (!argument.empty() && argument[0] != '-')
+                requested.push_back(argument);
+            else
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        catch (const std::exception &)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::cout << "=== Transportation Route Recommendation System Benchmarks ===" << std::endl;
+    std::cout << std::left << std::setw(48) << "case" << std::right << std::setw(8) << "count"
+              << std::setw(14) << "ops/s" << std::setw(12) << "p50 us" << std::setw(12) << "p99 us"
+              << std::setw(12) << "mean us" << std::endl;
+
+    BenchmarkReport report(options);
+    for (const std::string &name : requested)
+    {
+        bool known = false;
+        for (const auto &suite : suites)
+            known = known || suite.name == name;
+        if (!known)
+        {
+            std::cerr << "Unknown benchmark suite: " << name << std::endl;
+            return 1;
+        }
+    }
+    for (const auto &suite : suites)
+    {
+        bool wanted = requested.empty();
+        for (const std::string &name : requested)
+            wanted = wanted || name == suite.name;
+        if (wanted)
+            suite.run(report);
+    }
+
+    if (!options.jsonPath.empty())
+    {
+        if (!report.writeJSON(options.jsonPath))
+            return 1;
+        std::cout << "Report written to " << options.jsonPath << std::endl;
+    }
+    return 0;
+}
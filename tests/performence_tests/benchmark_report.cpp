@@ -0,0 +1,145 @@
+#include "benchmark_report.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include "../../include/io/JSONHandler.h"
+
+BenchmarkReport::BenchmarkReport(const BenchmarkOptions &benchmarkOptions)
+    : options(benchmarkOptions)
+{
+}
+
+const BenchmarkOptions &BenchmarkReport::getOptions() const
+{
+    return options;
+}
+
+bool BenchmarkReport::selected(const std::string &name) const
+{
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+void BenchmarkReport::add(BenchmarkResult result)
+{
+    double mean = result.samplesMicros.empty()
+                      ? 0.0
+                      : std::accumulate(result.samplesMicros.begin(), result.samplesMicros.end(), 0.0) /
+                            static_cast<double>(result.samplesMicros.size());
+    std::cout << std::left << std::setw(48) << result.name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << result.samplesMicros.size()
+              << std::setw(14) << result.throughput
+              << std::setw(12) << percentile(result.samplesMicros, 0.50)
+              << std::setw(12) << percentile(result.samplesMicros, 0.99)
+              << std::setw(12) << mean << std::endl;
+    results.push_back(std::move(result));
+}
+
+const std::vector<BenchmarkResult> &BenchmarkReport::getResults() const
+{
+    return results;
+}
+
+bool BenchmarkReport::writeJSON(const std::string &path) const
+{
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, error);
+
+    std::ofstream out(path);
+    if (!out.is_open())
+    {
+        std::cerr << "Error: Cannot open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char timestamp[32];
+    std::strftime(timestamp, sizeof timestamp, "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    JSONWriter json(out);
+    json.beginObject();
+    json.key("schema").value(1);
+    json.key("timestamp").value(timestamp);
+    json.key("hardware_threads").value(static_cast<int>(std::thread::hardware_concurrency()));
+    json.key("seed").value(static_cast<long long>(options.seed));
+    json.key("queries").value(static_cast<long long>(options.queries));
+    json.key("repetitions").value(static_cast<long long>(options.repetitions));
+    json.key("quick").value(options.quick);
+
+    json.key("results").beginArray();
+    for (const BenchmarkResult &result : results)
+    {
+        double mean = result.samplesMicros.empty()
+                          ? 0.0
+                          : std::accumulate(result.samplesMicros.begin(), result.samplesMicros.end(), 0.0) /
+                                static_cast<double>(result.samplesMicros.size());
+        json.beginObject();
+        json.key("name").value(result.name);
+        json.key("parameters").beginObject();
+        for (const auto &parameter : result.parameters)
+            json.key(parameter.first).value(parameter.second);
+        json.endObject();
+        json.key("count").value(static_cast<long long>(result.samplesMicros.size()));
+        json.key("throughput_per_sec").value(result.throughput);
+        json.key("p50_us").value(percentile(result.samplesMicros, 0.50));
+        json.key("p90_us").value(percentile(result.samplesMicros, 0.90));
+        json.key("p99_us").value(percentile(result.samplesMicros, 0.99));
+        json.key("mean_us").value(mean);
+        json.key("max_us").value(percentile(result.samplesMicros, 1.0));
+        json.key("counters").beginObject();
+        for (const auto &counter : result.counters)
+            json.key(counter.first).value(counter.second);
+        json.endObject();
+        // Raw samples on a single line; they are what a baseline comparison tests
+        std::ostringstream samples;
+        samples << "[";
+        for (size_t i = 0; i < result.samplesMicros.size(); ++i)
+        {
+            if (i)
+                samples << ",";
+            JSONWriter::writeNumber(samples, std::round(result.samplesMicros[i] * 1000.0) / 1000.0);
+        }
+        samples << "]";
+        json.key("samples_us").raw(samples.str());
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    out << std::endl;
+
+    if (!out)
+    {
+        std::cerr << "Error: Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+double BenchmarkReport::percentile(std::vector<double> samples, double fraction)
+{
+    if (samples.empty())
+        return 0.0;
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(samples.size())));
+    return samples[std::min(samples.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+std::string findDataFile(const std::string &relativePath)
+{
+    for (const char *prefix : {"", "../", "../../"})
+    {
+        std::string candidate = prefix + relativePath;
+        if (std::filesystem::exists(candidate))
+            return candidate;
+    }
+    return "";
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @file benchmark_report.h
+ * @brief Options, timing results and the JSON report shared by the benchmark suites
+ *
+ * Every suite adds one BenchmarkResult per case. Results keep their raw samples so
+ * a later run can be compared against a stored report sample by sample, not only by
+ * the summary percentiles.
+ */
+
+struct BenchmarkOptions
+{
+    std::string jsonPath;    // Report file, empty for the console table only
+    std::string filter;      // Only run cases whose name contains this
+    unsigned seed = 46;      // Seed of every query set and synthetic graph
+    size_t queries = 200;    // Timed queries per dataset, strategy and criterion
+    size_t repetitions = 20; // Timed runs of each I/O case
+    bool quick = false;      // Skip the large synthetic inputs
+};
+
+struct BenchmarkResult
+{
+    std::string name;                              // Unique in the report, e.g. routing/jakarta/dijkstra/time
+    std::map<std::string, std::string> parameters; // dataset, strategy, criterion, ...
+    std::vector<double> samplesMicros;             // One per timed operation
+    double throughput = 0;                         // Operations per second
+    std::map<std::string, double> counters;        // Case-specific figures, e.g. nodes or MB/s
+};
+
+class BenchmarkReport
+{
+public:
+    explicit BenchmarkReport(const BenchmarkOptions &options);
+
+    const BenchmarkOptions &getOptions() const;
+
+    // Whether the case passes the --filter option
+    bool selected(const std::string &name) const;
+
+    // Record a finished case and print its summary line
+    void add(BenchmarkResult result);
+
+    const std::vector<BenchmarkResult> &getResults() const;
+
+    /**
+     * @brief Write every result with its percentiles and raw samples as JSON
+     * @return True if successful, false otherwise
+     */
+    bool writeJSON(const std::string &path) const;
+
+    // Nearest-rank percentile, 0 for no samples
+    static double percentile(std::vector<double> samples, double fraction);
+
+private:
+    BenchmarkOptions options;
+    std::vector<BenchmarkResult> results;
+};
+
+// Path of a bundled data file, also when running from a build directory
+std::string findDataFile(const std::string &relativePath);
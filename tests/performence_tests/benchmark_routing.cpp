@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "benchmark_report.h"
+#include "../test_utils.h"
+#include "../../include/core/Graph.h"
+#include "../../include/core/GraphSnapshot.h"
+#include "../../include/algorithms/DeltaSteppingStrategy.h"
+#include "../../include/algorithms/DijkstraStrategy.h"
+#include "../../include/algorithms/RouteService.h"
+#include "../../include/io/NetworkGenerator.h"
+#include "../../include/utils/WorkStealingScheduler.h"
+
+/**
+ * @file benchmark_routing.cpp
+ * @brief Query latency and throughput of every routing strategy and criterion
+ *
+ * Each dataset gets one fixed-seed set of origin/destination pairs, shared by all
+ * strategies and criteria so their numbers are directly comparable. Latency samples
+ * are single queries run back to back; the route service additionally reports the
+ * throughput of the whole set submitted at once to its worker pool.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const char *const CRITERIA[] = {"distance", "time", "cost", "transfers"};
+    const size_t WARMUP_QUERIES = 5;
+
+    struct Dataset
+    {
+        std::string name;
+        Graph graph;
+    };
+
+    double microsSince(Clock::time_point started)
+    {
+        return std::chrono::duration<double, std::micro>(Clock::now() - started).count();
+    }
+
+    Graph createSyntheticNetwork(uint64_t stops, unsigned seed)
+    {
+        ScopedSilence quiet;
+        NetworkGenerator::Options generatorOptions;
+        generatorOptions.stopCount = stops;
+        generatorOptions.seed = seed;
+        Graph graph;
+        NetworkGenerator(generatorOptions).buildGraph(graph);
+        return graph;
+    }
+
+    bool loadDataset(const std::string &name, const std::string &relativePath, std::vector<Dataset> &datasets)
+    {
+        std::string path = findDataFile(relativePath);
+        if (path.empty())
+        {
+            std::cout << "Skipping " << name << ": " << relativePath << " not found" << std::endl;
+            return false;
+        }
+        ScopedSilence quiet;
+        Dataset dataset{name, Graph()};
+        if (!dataset.graph.loadFromCSV(path))
+            return false;
+        datasets.push_back(std::move(dataset));
+        return true;
+    }
+
+    std::vector<std::pair<std::string, std::string>> makeQueries(const Graph &graph, size_t count, unsigned seed)
+    {
+        std::vector<std::string> names = graph.getAllNodes();
+        std::vector<std::pair<std::string, std::string>> queries;
+        if (names.size() < 2)
+            return queries;
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<size_t> pick(0, names.size() - 1);
+        while (queries.size() < count)
+        {
+            size_t from = pick(random), to = pick(random);
+            if (from != to)
+                queries.emplace_back(names[from], names[to]);
+        }
+        return queries;
+    }
+
+    // Times strategy.findRoute over the query set, one query at a time
+    BenchmarkResult timeStrategy(RouteStrategy &strategy, const Graph &graph,
+                                 const std::vector<std::pair<std::string, std::string>> &queries,
+                                 const std::string &criterion)
+    {
+        for (size_t i = 0; i < std::min(WARMUP_QUERIES, queries.size()); ++i)
+            strategy.findRoute(graph, queries[i].first, queries[i].second, criterion);
+
+        BenchmarkResult result;
+        size_t found = 0;
+        Clock::time_point started = Clock::now();
+        for (const auto &query : queries)
+        {
+            Clock::time_point queryStarted = Clock::now();
+            found += strategy.findRoute(graph, query.first, query.second, criterion).isValid ? 1 : 0;
+            result.samplesMicros.push_back(microsSince(queryStarted));
+        }
+        double seconds = microsSince(started) / 1e6;
+        result.throughput = seconds > 0 ? static_cast<double>(queries.size()) / seconds : 0.0;
+        result.counters["found"] = static_cast<double>(found);
+        return result;
+    }
+
+    BenchmarkResult timeRouteService(RouteService &service,
+                                     const std::vector<std::pair<std::string, std::string>> &queries,
+                                     const std::string &criterion)
+    {
+        for (size_t i = 0; i < std::min(WARMUP_QUERIES, queries.size()); ++i)
+            service.findRoute(queries[i].first, queries[i].second, criterion);
+
+        BenchmarkResult result;
+        size_t found = 0;
+        for (const auto &query : queries)
+        {
+            Clock::time_point queryStarted = Clock::now();
+            found += service.findRoute(query.first, query.second, criterion).isValid ? 1 : 0;
+            result.samplesMicros.push_back(microsSince(queryStarted));
+        }
+        result.counters["found"] = static_cast<double>(found);
+
+        // Throughput with every worker busy
+        std::vector<RouteService::Query> batch;
+        for (const auto &query : queries)
+            batch.push_back({query.first, query.second, criterion});
+        Clock::time_point started = Clock::now();
+        std::vector<std::future<RouteResult>> answers = service.submitBatch(batch);
+        for (auto &answer : answers)
+            answer.get();
+        double seconds = microsSince(started) / 1e6;
+        result.throughput = seconds > 0 ? static_cast<double>(queries.size()) / seconds : 0.0;
+        result.counters["threads"] = static_cast<double>(service.getThreadCount());
+        return result;
+    }
+}
+
+void runRoutingBenchmarks(BenchmarkReport &report)
+{
+    const BenchmarkOptions &options = report.getOptions();
+
+    std::vector<Dataset> datasets;
+    loadDataset("jakarta", "data/sample_data/jakarta.csv", datasets);
+    loadDataset("network_data", "network_data.csv", datasets);
+    for (uint64_t stops : {1000, 10000, 100000})
+    {
+        if (options.quick && stops > 1000)
+            break;
+        datasets.push_back({"synthetic_" + std::to_string(stops), createSyntheticNetwork(stops, options.seed)});
+    }
+
+    transport::utils::WorkStealingScheduler scheduler;
+    for (Dataset &dataset : datasets)
+    {
+        // Large graphs get fewer queries so the suite finishes in minutes
+        size_t count = dataset.graph.getNodeCount() > 50000 ? std::max<size_t>(options.queries / 10, 10)
+                                                           : options.queries;
+        auto queries = makeQueries(dataset.graph, count, options.seed);
+        auto snapshot = std::make_shared<const GraphSnapshot>(dataset.graph);
+        RouteService service(snapshot);
+        service.getTreeCache().setMemoryBudget(0); // Measure searches, not cached trees
+
+        DijkstraStrategy dijkstra;
+        DeltaSteppingStrategy deltaStepping(0, &scheduler);
+        std::vector<std::pair<std::string, std::function<BenchmarkResult(const std::string &)>>> strategies = {
+            {"dijkstra", [&](const std::string &criterion)
+             { return timeStrategy(dijkstra, dataset.graph, queries, criterion); }},
+            {"delta_stepping", [&](const std::string &criterion)
+             { return timeStrategy(deltaStepping, dataset.graph, queries, criterion); }},
+            {"route_service", [&](const std::string &criterion)
+             { return timeRouteService(service, queries, criterion); }}};
+
+        for (const auto &strategy : strategies)
+        {
+            for (const char *criterion : CRITERIA)
+            {
+                std::string name = "routing/" + dataset.name + "/" + strategy.first + "/" + criterion;
+                if (!report.selected(name))
+                    continue;
+                BenchmarkResult result = strategy.second(criterion);
+                result.name = name;
+                result.parameters = {{"suite", "routing"}, {"dataset", dataset.name},
+                                     {"strategy", strategy.first}, {"criterion", criterion}};
+                result.counters["nodes"] = static_cast<double>(dataset.graph.getNodeCount());
+                result.counters["edges"] = static_cast<double>(dataset.graph.getEdgeCount());
+                report.add(std::move(result));
+            }
+        }
+    }
+}
@@ -13,6 +13,23 @@ extern void runPreferenceTests();
 extern void runFullSystemTests();
 extern void runAlgorithmBenchmarks();
 extern void runMemoryTests();
+extern void runGTFSImportTests();
+extern void runOSMImportTests();
+extern void runJSONTests();
+extern void runNetworkJournalTests();
+extern void runRouteServiceTests();
+extern void runVersionedGraphTests();
+extern void runWorkStealingTests();
+extern void runRouteCacheTests();
+extern void runMultiSourceSearchTests();
+extern void runDeltaSteppingTests();
+extern void runAsyncRouteTests();
+extern void runSearchStatsTests();
+extern void runLoggerTests();
+extern void runTraceLogTests();
+extern void runMetricsTests();
+extern void runNetworkGeneratorTests();
+extern void runStrategyDifferentialTests();
 
 int main(int argc, char *argv[])
 {
@@ -33,7 +50,24 @@ int main(int argc, char *argv[])
         {"Preference Tests", runPreferenceTests},
         {"Full System Tests", runFullSystemTests},
         {"Algorithm Benchmark Tests", runAlgorithmBenchmarks},
-        {"Memory Usage Tests", runMemoryTests}};
+        {"Memory Usage Tests", runMemoryTests},
+        {"GTFS Import Tests", runGTFSImportTests},
+        {"OSM Import Tests", runOSMImportTests},
+        {"JSON Tests", runJSONTests},
+        {"Network Journal Tests", runNetworkJournalTests},
+        {"Route Service Tests", runRouteServiceTests},
+        {"Versioned Graph Tests", runVersionedGraphTests},
+        {"Work Stealing Tests", runWorkStealingTests},
+        {"Route Cache Tests", runRouteCacheTests},
+        {"Multi-Source Search Tests", runMultiSourceSearchTests},
+        {"Delta Stepping Tests", runDeltaSteppingTests},
+        {"Async Route Tests", runAsyncRouteTests},
+        {"Search Stats Tests", runSearchStatsTests},
+        {"Logger Tests", runLoggerTests},
+        {"Trace Log Tests", runTraceLogTests},
+        {"Metrics Tests", runMetricsTests},
+        {"Network Generator Tests", runNetworkGeneratorTests},
+        {"Strategy Differential Tests", runStrategyDifferentialTests}};
 
     // If no arguments, run all tests
     if (argc == 1)
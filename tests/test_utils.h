@@ -0,0 +1,30 @@
+#pragma once
+#include <iostream>
+#include <streambuf>
+
+/**
+ * @file test_utils.h
+ * @brief Helpers shared by the unit tests and the benchmarks
+ */
+
+/**
+ * @brief Discards std::cout while alive, for the per-node chatter of Graph loading
+ */
+class ScopedSilence
+{
+public:
+    ScopedSilence() : previous(std::cout.rdbuf(&sink)) {}
+    ~ScopedSilence() { std::cout.rdbuf(previous); }
+
+    ScopedSilence(const ScopedSilence &) = delete;
+    ScopedSilence &operator=(const ScopedSilence &) = delete;
+
+private:
+    struct NullBuffer : std::streambuf
+    {
+        int overflow(int c) override { return traits_type::not_eof(c); }
+    };
+
+    NullBuffer sink;
+    std::streambuf *previous;
+};
@@ -0,0 +1,185 @@
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../../include/core/Graph.h"
+#include "../../include/core/GraphSnapshot.h"
+#include "../../include/algorithms/AsyncRoute.h"
+#include "../../include/algorithms/RouteService.h"
+#include "test_graphs.h"
+
+/**
+ * @file test_async_route.cpp
+ * @brief Unit tests for completion callbacks and the coroutine route API
+ *
+ * The coroutine tests only run when the suite is built as C++20.
+ */
+
+class AsyncRouteTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    static std::vector<RouteService::Query> makeQueries(int count)
+    {
+        std::vector<RouteService::Query> queries;
+        for (int i = 0; i < count; ++i)
+            queries.push_back({"S" + std::to_string(i * 3), "S" + std::to_string(i * 5 + 1), "time"});
+        return queries;
+    }
+
+#if TRANSPORT_HAS_COROUTINES
+    static RouteTask<bool> awaitOnWorker(RouteService &service, std::string start, std::string end)
+    {
+        RouteResult expected = service.findRoute(start, end, "distance");
+        RouteResult route = co_await findRouteAsync(service, start, end, "distance");
+        // The answering worker resumes the coroutine
+        co_return route.isValid == expected.isValid && route.totalDistance == expected.totalDistance &&
+            service.getScheduler().currentWorkerIndex() >= 0;
+    }
+
+    static RouteTask<RouteResult> failingTask(RouteService &service)
+    {
+        RouteResult route = co_await findRouteAsync(service, "S0", "S1");
+        throw std::runtime_error("leg failed");
+        co_return route;
+    }
+#endif
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testCompletionCallback()
+    {
+        Graph graph = createRandomGraph(300, 3, 77);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 4);
+        std::vector<RouteService::Query> queries = makeQueries(40);
+
+        std::vector<std::shared_ptr<std::promise<RouteResult>>> answers;
+        for (const RouteService::Query &query : queries)
+        {
+            auto answer = std::make_shared<std::promise<RouteResult>>();
+            service.submit(query.start, query.end, query.criteria, CancellationToken(),
+                           [answer](const RouteResult &result, std::exception_ptr error)
+                           {
+                               if (error)
+                                   answer->set_exception(error);
+                               else
+                                   answer->set_value(result);
+                           });
+            answers.push_back(answer);
+        }
+
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            RouteResult expected = service.findRoute(queries[i].start, queries[i].end, queries[i].criteria);
+            RouteResult actual = answers[i]->get_future().get();
+            if (actual.isValid != expected.isValid || actual.totalTime != expected.totalTime)
+                return false;
+        }
+        return true;
+    }
+
+#if TRANSPORT_HAS_COROUTINES
+    bool testAwaitRoute()
+    {
+        Graph graph = createRandomGraph(300, 3, 77);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 4);
+        return syncWait(awaitOnWorker(service, "S2", "S250")) && syncWait(awaitOnWorker(service, "S7", "Missing"));
+    }
+
+    bool testFanOutMatchesBlockingCalls()
+    {
+        Graph graph = createRandomGraph(400, 3, 77);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 4);
+        std::vector<RouteService::Query> queries = makeQueries(60);
+
+        std::vector<RouteResult> results = syncWait(findRoutesAsync(service, queries));
+        if (results.size() != queries.size() || !syncWait(findRoutesAsync(service, {})).empty())
+            return false;
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            RouteResult expected = service.findRoute(queries[i].start, queries[i].end, queries[i].criteria);
+            if (results[i].isValid != expected.isValid || results[i].totalTime != expected.totalTime)
+                return false;
+        }
+        return true;
+    }
+
+    bool testCancellationPropagates()
+    {
+        Graph graph = createRandomGraph(300, 3, 77);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 2);
+        CancellationToken token = CancellationToken::cancellable();
+        token.cancel();
+
+        for (const RouteResult &result : syncWait(findRoutesAsync(service, makeQueries(20), token)))
+        {
+            if (result.status != RouteStatus::Cancelled)
+                return false;
+        }
+        return true;
+    }
+
+    bool testWhenAllRethrows()
+    {
+        Graph graph = createRandomGraph(100, 2, 77);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 2);
+        std::vector<RouteTask<RouteResult>> tasks;
+        tasks.push_back(failingTask(service));
+        tasks.push_back(failingTask(service));
+        try
+        {
+            syncWait(whenAll(std::move(tasks)));
+        }
+        catch (const std::runtime_error &error)
+        {
+            return std::string(error.what()) == "leg failed";
+        }
+        return false;
+    }
+#endif
+
+    void printSummary()
+    {
+        std::cout << "\nAsync Route Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Completion Callback", testCompletionCallback());
+#if TRANSPORT_HAS_COROUTINES
+        runTest("Await Route", testAwaitRoute());
+        runTest("Fan-Out Matches Blocking Calls", testFanOutMatchesBlockingCalls());
+        runTest("Cancellation Propagates", testCancellationPropagates());
+        runTest("When All Rethrows", testWhenAllRethrows());
+#else
+        std::cout << "Coroutine tests skipped (build with C++20 to run them)" << std::endl;
+#endif
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runAsyncRouteTests()
+{
+    AsyncRouteTestRunner testRunner;
+    testRunner.runAllTests();
+}
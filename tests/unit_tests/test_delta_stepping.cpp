@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../include/core/Graph.h"
+#include "../../include/core/GraphSnapshot.h"
+#include "../../include/algorithms/DeltaSteppingStrategy.h"
+#include "../../include/algorithms/DijkstraStrategy.h"
+#include "../../include/algorithms/RouteService.h"
+#include "../../include/utils/WorkStealingScheduler.h"
+#include "test_graphs.h"
+
+/**
+ * @file test_delta_stepping.cpp
+ * @brief Unit tests for the parallel delta-stepping strategy
+ */
+
+class DeltaSteppingTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testDistancesMatchDijkstra()
+    {
+        Graph graph = createRandomGraph(3000, 3, 21, 0, 60);
+        GraphSnapshot snapshot(graph);
+        transport::utils::WorkStealingScheduler scheduler(4);
+        RouteService::SearchWorkspace workspace;
+
+        for (long long delta : {0LL, 1LL, 7LL, 1000000LL})
+        {
+            DeltaSteppingStrategy strategy(delta, &scheduler);
+            for (auto criterion : {GraphSnapshot::Criterion::Time, GraphSnapshot::Criterion::Distance})
+            {
+                for (int origin : {0, 1234})
+                {
+                    uint32_t source = snapshot.findNode("S" + std::to_string(origin));
+                    DeltaSteppingStrategy::ShortestPaths paths =
+                        strategy.computeShortestPaths(snapshot, source, criterion, true);
+                    RouteService::searchAll(snapshot, workspace, source, criterion);
+                    if (!paths.complete)
+                        return false;
+
+                    for (uint32_t v = 0; v < snapshot.getNodeCount(); ++v)
+                    {
+                        long long expected = workspace.isReached(v) ? workspace.distance[v]
+                                                                    : DeltaSteppingStrategy::UNREACHED;
+                        if (paths.distance[v] != expected)
+                            return false;
+                        // Every parent link must be a tight edge
+                        uint32_t parent = paths.parentNode[v];
+                        if (parent != GraphSnapshot::INVALID_NODE &&
+                            paths.distance[parent] + snapshot.getEdges(parent).getWeights(criterion)[paths.parentEdge[v]] !=
+                                paths.distance[v])
+                            return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool testRoutesMatchDijkstra()
+    {
+        Graph graph = createRandomGraph(500, 3, 4, 0, 60);
+        DeltaSteppingStrategy deltaStepping;
+        DijkstraStrategy dijkstra;
+
+        for (int i = 0; i < 40; ++i)
+        {
+            std::string start = "S" + std::to_string(i * 11), end = "S" + std::to_string(i * 7 + 3);
+            RouteResult expected = dijkstra.findRoute(graph, start, end, "cost");
+            RouteResult actual = deltaStepping.findRoute(graph, start, end, "cost");
+            if (actual.isValid != expected.isValid || actual.status != expected.status)
+                return false;
+            if (actual.isValid && (actual.totalCost != expected.totalCost || actual.path.front() != start ||
+                                   actual.path.back() != end))
+                return false;
+        }
+
+        RouteResult missing = deltaStepping.findRoute(graph, "S0", "Nowhere", "time");
+        return !missing.isValid && missing.status == RouteStatus::NotFound;
+    }
+
+    bool testSnapshotFollowsGraphEdits()
+    {
+        Graph graph;
+        graph.addNode("A", 0.0, 0.0);
+        graph.addNode("B", 0.0, 0.1);
+        graph.addNode("C", 0.0, 0.2);
+        graph.addEdge("A", "B", 100, 10, 1000, 0, "walk");
+        graph.addEdge("B", "C", 100, 10, 1000, 0, "walk");
+
+        DeltaSteppingStrategy strategy(5);
+        RouteResult before = strategy.findRoute(graph, "A", "C", "time");
+        graph.addEdge("A", "C", 100, 3, 1000, 0, "walk");
+        RouteResult after = strategy.findRoute(graph, "A", "C", "time");
+        return before.isValid && before.totalTime == 20 && after.isValid && after.totalTime == 3 &&
+               after.path.size() == 2;
+    }
+
+    bool testIsochrone()
+    {
+        Graph graph;
+        for (const char *name : {"A", "B", "C", "D", "E"})
+            graph.addNode(name, 0.0, 0.0);
+        graph.addEdge("A", "B", 100, 5, 1000, 0, "walk");
+        graph.addEdge("B", "C", 100, 5, 1000, 0, "walk");
+        graph.addEdge("A", "D", 100, 15, 1000, 0, "walk");
+        graph.addEdge("E", "A", 100, 1, 1000, 0, "walk");
+
+        DeltaSteppingStrategy strategy(4);
+        std::vector<std::string> reachable = strategy.computeIsochrone(graph, "A", 10, "time");
+        std::sort(reachable.begin(), reachable.end());
+        return reachable == std::vector<std::string>{"A", "B", "C"} &&
+               strategy.computeIsochrone(graph, "Nowhere", 10).empty();
+    }
+
+    bool testRouteTotalsMatchDistances()
+    {
+        Graph graph;
+        for (const char *name : {"A", "B", "C"})
+            graph.addNode(name, 0.0, 0.0);
+        graph.addEdge("A", "B", 100, 5, 1000, 0, "walk");
+        graph.addEdge("B", "C", 100, 0, 1000, 0, "walk");
+
+        // Negative weights never reach a snapshot, so the search has nothing to clamp
+        GraphSnapshot base(graph);
+        GraphSnapshot::Editor editor(base);
+        if (editor.addEdge("A", "C", 100, -3, 1000, 0, "walk") || editor.updateEdge("A", "B", 100, -1, 1000, 0, "walk"))
+            return false;
+        std::shared_ptr<const GraphSnapshot> snapshot = editor.publish();
+
+        DeltaSteppingStrategy strategy(2);
+        uint32_t source = snapshot->findNode("A"), target = snapshot->findNode("C");
+        DeltaSteppingStrategy::ShortestPaths paths =
+            strategy.computeShortestPaths(*snapshot, source, GraphSnapshot::Criterion::Time, true);
+        RouteResult result;
+        RouteService::extractPath(*snapshot, paths.parentNode.data(), paths.parentEdge.data(), source, target, result);
+        return paths.complete && paths.distance[target] == 5 && result.isValid && result.totalTime == 5;
+    }
+
+    bool testCancellation()
+    {
+        Graph graph = createRandomGraph(200, 2, 8, 0, 60);
+        CancellationToken token = CancellationToken::cancellable();
+        token.cancel();
+        DeltaSteppingStrategy strategy;
+        RouteResult result = strategy.findRoute(graph, "S0", "S1", "time", token);
+        return !result.isValid && result.status == RouteStatus::Cancelled;
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nDelta Stepping Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Distances Match Dijkstra", testDistancesMatchDijkstra());
+        runTest("Routes Match Dijkstra", testRoutesMatchDijkstra());
+        runTest("Snapshot Follows Graph Edits", testSnapshotFollowsGraphEdits());
+        runTest("Isochrone", testIsochrone());
+        runTest("Route Totals Match Distances", testRouteTotalsMatchDistances());
+        runTest("Cancellation", testCancellation());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runDeltaSteppingTests()
+{
+    DeltaSteppingTestRunner testRunner;
+    testRunner.runAllTests();
+}
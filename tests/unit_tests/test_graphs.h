@@ -0,0 +1,56 @@
+#pragma once
+#include <random>
+#include <string>
+#include <vector>
+#include "../../include/core/Graph.h"
+
+/**
+ * @file test_graphs.h
+ * @brief Graph factories shared by the unit tests
+ */
+
+/**
+ * @brief Random sparse network of stops "S0" .. "S<nodeCount - 1>"
+ *
+ * Every stop gets up to edgesPerNode bus edges to uniformly picked stops, minus self
+ * loops and repeats. Distance, time, cost and transfers are each drawn from
+ * [minWeight, maxWeight] and scaled to their unit. The same seed always gives the
+ * same graph, so failures are reproducible. Built through the bulk insert path, which
+ * keeps the per-element Graph output out of the test log.
+ */
+inline Graph createRandomGraph(int nodeCount, int edgesPerNode, unsigned seed, int minWeight = 1,
+                               int maxWeight = 60)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> pick(0, nodeCount - 1);
+    std::uniform_int_distribution<int> weight(minWeight, maxWeight);
+
+    std::vector<Node> nodes;
+    nodes.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; ++i)
+        nodes.emplace_back("S" + std::to_string(i), -6.3 + i * 0.0005, 106.7);
+
+    std::vector<Edge> edges;
+    edges.reserve(static_cast<size_t>(nodeCount) * edgesPerNode);
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        for (int k = 0; k < edgesPerNode; ++k)
+        {
+            int j = pick(random);
+            if (j == i)
+                continue;
+            // Separate statements: argument evaluation order is unspecified
+            int distance = weight(random) * 100;
+            int time = weight(random);
+            int cost = weight(random) * 500;
+            int transfers = weight(random) % 3;
+            edges.emplace_back("S" + std::to_string(i), "S" + std::to_string(j), distance, time, cost, transfers,
+                               "bus");
+        }
+    }
+
+    Graph graph;
+    graph.addNodes(nodes);
+    graph.addEdges(edges);
+    return graph;
+}
@@ -0,0 +1,234 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <filesystem>
+#include <map>
+#include <set>
+#include "../../include/core/Graph.h"
+#include "../../include/io/JSONHandler.h"
+#include "../../include/preferences/UserPreferences.h"
+
+/**
+ * @file test_json.cpp
+ * @brief Unit tests for the JSON reader/writer and the code that loads through it
+ */
+
+class JSONTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    const std::string TMP_DIR = "tests/tmp/json";
+
+    // Counts events so the SAX path can be checked without a DOM
+    class CountingHandler : public JSONSaxHandler
+    {
+    public:
+        int objects = 0, arrays = 0, keys = 0, strings = 0, numbers = 0;
+        bool onStartObject() override { return ++objects > 0; }
+        bool onStartArray() override { return ++arrays > 0; }
+        bool onKey(std::string_view) override { return ++keys > 0; }
+        bool onString(std::string_view) override { return ++strings > 0; }
+        bool onNumber(double) override { return ++numbers > 0; }
+    };
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testNestedDocument()
+    {
+        JSONValue root;
+        JSONReader reader;
+        bool ok = reader.parse(R"({"a": {"b": [1, 2.5, -3e2, true, null]},
+                                    "s": "line\nbreak \"q\" é 🚀"})",
+                               root);
+        const JSONValue &list = root.get("a").get("b");
+        return ok && list.size() == 5 && list[0].asNumber() == 1 && list[1].asNumber() == 2.5 &&
+               list[2].asNumber() == -300 && list[3].asBool() && list[4].isNull() &&
+               root.get("s").asString() == "line\nbreak \"q\" \xC3\xA9 \xF0\x9F\x9A\x80" &&
+               root.get("missing").isNull();
+    }
+
+    bool testMalformedInput()
+    {
+        JSONValue root;
+        JSONReader reader;
+        return !reader.parse("{\"a\": 1,}", root) && !reader.parse("[1 2]", root) &&
+               !reader.parse("{\"a\": tru}", root) && !reader.parse("\"open", root) &&
+               !reader.parse("{} extra", root) && !reader.getLastError().empty();
+    }
+
+    bool testSaxEvents()
+    {
+        CountingHandler handler;
+        JSONReader reader;
+        bool ok = reader.parse(R"({"x": [{"y": "z"}, 3, 4]})", handler);
+        return ok && handler.objects == 2 && handler.arrays == 1 && handler.keys == 2 &&
+               handler.strings == 1 && handler.numbers == 2;
+    }
+
+    bool testWriterRoundTrip()
+    {
+        JSONValue root = JSONValue::object();
+        root.set("name", "Blok M \"Terminal\"");
+        root.set("ratio", 0.1);
+        JSONValue &list = root.set("ids", JSONValue::array());
+        list.append(1);
+        list.append(false);
+
+        JSONValue parsed;
+        JSONReader reader;
+        return reader.parse(root.dump(2), parsed) && parsed.dump() == root.dump() &&
+               root.dump() == R"({"name":"Blok M \"Terminal\"","ratio":0.1,"ids":[1,false]})";
+    }
+
+    bool testPreferencesTemplate()
+    {
+        std::filesystem::create_directories(TMP_DIR);
+        std::ofstream file(TMP_DIR + "/template.json");
+        file << R"({"user_profile": {"user_id": "u1", "name": "Rina"},
+                    "optimization_weights": {"time_weight": 0.4, "distance_weight": 0.2,
+                                             "cost_weight": 0.3, "transfer_weight": 0.1},
+                    "scoring_method": {"method": "topsis", "alternatives": ["weighted_sum", "topsis"]}})";
+        file.close();
+
+        UserPreferences preferences;
+        if (!preferences.loadFromFile(TMP_DIR + "/template.json"))
+            return false;
+        PreferenceCriteria criteria = preferences.getCriteria();
+        return criteria.timeWeight == 0.4 && criteria.costWeight == 0.3 &&
+               preferences.getPreferenceMode() == "topsis" &&
+               preferences.getUserProfile("name") == "Rina";
+    }
+
+    bool testProfilesAndNetwork()
+    {
+        std::filesystem::create_directories(TMP_DIR);
+        std::ofstream profiles(TMP_DIR + "/profiles.json");
+        profiles << "{";
+        for (int i = 0; i < 200; ++i)
+        {
+            profiles << (i ? "," : "") << "\"user_" << i << "\": {\"timeWeight\": 0.7, \"distanceWeight\": 0.1,"
+                     << " \"costWeight\": 0.1, \"transferWeight\": 0.1, \"primaryCriterion\": \"time\"}";
+        }
+        profiles << ", \"broken\": {\"timeWeight\": 5}}";
+        profiles.close();
+
+        auto loaded = UserPreferences::loadProfiles(TMP_DIR + "/profiles.json");
+        if (loaded.size() != 200 || loaded.count("broken"))
+            return false;
+
+        Graph graph;
+        graph.addNode("Blok M", -6.2441, 106.7990);
+        graph.addNode("Senayan", -6.2270, 106.8020);
+        graph.addEdge("Blok M", "Senayan", 3000, 9, 3500, 0, "bus");
+
+        JSONHandler handler;
+        Graph copy;
+        return handler.saveGraph(TMP_DIR + "/network.json", graph) &&
+               handler.loadGraph(TMP_DIR + "/network.json", copy) &&
+               copy.getNodeCount() == 2 && copy.getNode("Senayan").getLatitude() == -6.2270 &&
+               copy.getEdge("Blok M", "Senayan").getCost() == 3500;
+    }
+
+    // Network records go in through the bulk Graph calls, with the per-element semantics kept
+    bool testLoadGraphInBulk()
+    {
+        std::filesystem::create_directories(TMP_DIR);
+        std::ofstream file(TMP_DIR + "/bulk_network.json");
+        file << R"({"nodes": [{"name": "Blok M", "lat": -6.2441, "lon": 106.7990},
+                              {"name": "Senayan", "lat": -6.2000, "lon": 106.8000},
+                              {"name": "Senayan", "lat": -6.2270, "lon": 106.8020},
+                              {"name": "Kota", "lat": 95.0, "lon": 106.8130}],
+                    "edges": [{"from": "Blok M", "to": "Senayan", "distance": 3000, "time": 9, "cost": 3500},
+                              {"from": "Blok M", "to": "Senayan", "distance": 1, "time": 1, "cost": 1},
+                              {"from": "Senayan", "to": "Monas", "distance": 4000, "time": 12},
+                              {"from": "Senayan", "to": "Blok M", "distance": -5}]})";
+        file.close();
+
+        Graph graph;
+        graph.addNode("Blok M", -6.0, 106.0);
+        JSONHandler handler;
+        std::ostringstream output;
+        std::streambuf *previous = std::cout.rdbuf(output.rdbuf());
+        bool loaded = handler.loadGraph(TMP_DIR + "/bulk_network.json", graph);
+        std::cout.rdbuf(previous);
+
+        // Later node records win, the first of two duplicate edges wins, an undeclared
+        // endpoint is added at 0,0, and invalid records are skipped
+        return loaded && output.str().empty() && graph.getNodeCount() == 3 && !graph.hasNode("Kota") &&
+               graph.getNode("Blok M").getLatitude() == -6.2441 &&
+               graph.getNode("Senayan").getLatitude() == -6.2270 && graph.getNode("Monas").getLatitude() == 0.0 &&
+               graph.getEdgeCount() == 2 && graph.getEdge("Blok M", "Senayan").getCost() == 3500;
+    }
+
+    // Strings that look like numbers or literals must come back as strings
+    bool testFlatMapRoundTrip()
+    {
+        std::filesystem::create_directories(TMP_DIR);
+        std::ofstream file(TMP_DIR + "/flat.json");
+        file << R"({"count": "123", "enabled": "true", "missing": "null", "list": "[1]",
+                    "number": 123, "flag": true, "nothing": null, "ids": [1, 2]})";
+        file.close();
+
+        std::set<std::string> rawKeys;
+        std::map<std::string, std::string> data = JSONHandler::parseJSON(TMP_DIR + "/flat.json", &rawKeys);
+        if (!JSONHandler::writeJSON(TMP_DIR + "/flat_copy.json", data, rawKeys) ||
+            !JSONHandler::writeJSON(TMP_DIR + "/flat_strings.json", data))
+            return false;
+
+        JSONValue copy, strings;
+        JSONReader reader;
+        if (!reader.parseFile(TMP_DIR + "/flat_copy.json", copy) ||
+            !reader.parseFile(TMP_DIR + "/flat_strings.json", strings))
+            return false;
+        for (const char *key : {"count", "enabled", "missing", "list"})
+        {
+            if (!copy.get(key).isString() || !strings.get(key).isString())
+                return false;
+        }
+        return copy.get("count").asString() == "123" && copy.get("number").isNumber() && copy.get("flag").isBool() &&
+               copy.get("nothing").isNull() && copy.get("ids").isArray() && strings.get("number").asString() == "123";
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nJSON Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("JSON Nested Document", testNestedDocument());
+        runTest("JSON Malformed Input", testMalformedInput());
+        runTest("JSON SAX Events", testSaxEvents());
+        runTest("JSON Writer Round Trip", testWriterRoundTrip());
+        runTest("JSON Preferences Template", testPreferencesTemplate());
+        runTest("JSON Profiles And Network", testProfilesAndNetwork());
+        runTest("JSON Flat Map Round Trip", testFlatMapRoundTrip());
+        runTest("JSON Bulk Network Load", testLoadGraphInBulk());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runJSONTests()
+{
+    JSONTestRunner testRunner;
+    testRunner.runAllTests();
+}
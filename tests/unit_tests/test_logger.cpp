@@ -0,0 +1,293 @@
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <filesystem>
+#include "../../include/utils/Logger.h"
+
+/**
+ * @file test_logger.cpp
+ * @brief Unit tests for the asynchronous Logger backend
+ */
+
+using transport::utils::LogDestination;
+using transport::utils::Logger;
+using transport::utils::LogLevel;
+using transport::utils::OverflowPolicy;
+
+class LoggerTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    const std::string TMP_DIR = "tests/tmp/logger";
+
+    std::string freshLog(const std::string &name, size_t maxFileSize = 10 * 1024 * 1024)
+    {
+        std::filesystem::remove_all(TMP_DIR + "/" + name);
+        std::string path = TMP_DIR + "/" + name + "/test.log";
+        Logger::getInstance().configure(path, LogDestination::FILE_ONLY, maxFileSize, 2);
+        return path;
+    }
+
+    static size_t countLines(const std::string &path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        size_t count = 0;
+        while (std::getline(file, line))
+            count++;
+        return count;
+    }
+
+    // Counts how often a log argument is actually evaluated
+    static int expensiveCalls;
+    static int expensiveArgument()
+    {
+        return ++expensiveCalls;
+    }
+
+    // Log from several threads at once and return the number of attempts
+    static size_t hammer(int threadCount, int perThread)
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([t, perThread]()
+                                 {
+                for (int i = 0; i < perThread; ++i)
+                    Logger::getInstance().log(LogLevel::INFO, "thread " + std::to_string(t) + " entry " + std::to_string(i)); });
+        }
+        for (auto &thread : threads)
+            thread.join();
+        return static_cast<size_t>(threadCount) * perThread;
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testConcurrentLogging()
+    {
+        Logger &logger = Logger::getInstance();
+        std::string path = freshLog("concurrent");
+        size_t dropped = logger.getDroppedCount();
+
+        size_t attempts = hammer(4, 2000);
+        logger.flush();
+        return logger.isAsyncEnabled() && countLines(path) == attempts && logger.getDroppedCount() == dropped;
+    }
+
+    bool testBlockPolicyLosesNothing()
+    {
+        Logger &logger = Logger::getInstance();
+        logger.setQueueCapacity(4);
+        logger.setOverflowPolicy(OverflowPolicy::BLOCK);
+        std::string path = freshLog("block");
+        size_t dropped = logger.getDroppedCount();
+
+        size_t attempts = hammer(6, 1000);
+        logger.flush();
+        return logger.getQueueCapacity() == 4 && countLines(path) == attempts && logger.getDroppedCount() == dropped;
+    }
+
+    bool testDropPolicyCountsDrops()
+    {
+        Logger &logger = Logger::getInstance();
+        logger.setQueueCapacity(2);
+        logger.setOverflowPolicy(OverflowPolicy::DROP);
+        std::string path = freshLog("drop");
+        size_t dropped = logger.getDroppedCount();
+
+        size_t attempts = hammer(8, 5000);
+        logger.flush();
+        size_t newlyDropped = logger.getDroppedCount() - dropped;
+        logger.setOverflowPolicy(OverflowPolicy::BLOCK);
+        logger.setQueueCapacity(8192);
+        return newlyDropped > 0 && countLines(path) + newlyDropped == attempts &&
+               logger.getStatistics().find("Dropped (queue full): ") != std::string::npos;
+    }
+
+    // Resizing must fence producers off the old queue and lose no entry
+    bool testResizeWhileLogging()
+    {
+        Logger &logger = Logger::getInstance();
+        logger.setOverflowPolicy(OverflowPolicy::BLOCK);
+        std::string path = freshLog("resize");
+        size_t dropped = logger.getDroppedCount();
+
+        size_t attempts = 0;
+        std::thread producers([&attempts]()
+                              { attempts = hammer(4, 3000); });
+        for (size_t capacity : {4, 64, 2, 1024, 16, 8192})
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            logger.setQueueCapacity(capacity);
+        }
+        producers.join();
+        logger.flush();
+        return logger.isAsyncEnabled() && logger.getQueueCapacity() == 8192 && countLines(path) == attempts &&
+               logger.getDroppedCount() == dropped;
+    }
+
+    bool testSynchronousMode()
+    {
+        Logger &logger = Logger::getInstance();
+        std::string path = freshLog("sync");
+        logger.setAsyncEnabled(false);
+        logger.clearHistory();
+        logger.log(LogLevel::WARNING, "written on the caller");
+
+        // No flush needed: the entry is in history before log() returns
+        std::vector<transport::utils::LogEntry> recent = logger.getRecentLogs(1);
+        bool synchronous = !logger.isAsyncEnabled() && recent.size() == 1 &&
+                           recent[0].message == "written on the caller" && recent[0].level == LogLevel::WARNING;
+
+        logger.setAsyncEnabled(true);
+        logger.log(LogLevel::INFO, "back to async");
+        logger.flush();
+        return synchronous && logger.isAsyncEnabled() && countLines(path) == 2;
+    }
+
+    // Turning async off must fence producers off the queue; everything logged before the
+    // producers finish is in the file without a flush while logging is synchronous
+    bool testDisableWhileLogging()
+    {
+        Logger &logger = Logger::getInstance();
+        logger.setOverflowPolicy(OverflowPolicy::BLOCK);
+        std::string path = freshLog("disable");
+
+        size_t attempts = 0;
+        std::thread producers([&attempts]()
+                              { attempts = hammer(4, 3000); });
+        for (int toggle = 0; toggle < 5; ++toggle)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            logger.setAsyncEnabled(false);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            logger.setAsyncEnabled(true);
+        }
+        logger.setAsyncEnabled(false);
+        producers.join();
+
+        size_t lines = countLines(path);
+        logger.setAsyncEnabled(true);
+        return lines == attempts;
+    }
+
+    bool testLevelsAndRotation()
+    {
+        Logger &logger = Logger::getInstance();
+        std::string path = freshLog("rotation", 2000);
+        logger.setLogLevel(LogLevel::WARNING);
+        logger.clearHistory();
+        logger.log(LogLevel::DEBUG, "filtered");
+        logger.log(LogLevel::INFO, "filtered");
+        for (int i = 0; i < 100; ++i)
+            logger.log(LogLevel::ERROR, "rotated entry " + std::to_string(i));
+        logger.flush();
+        logger.setLogLevel(LogLevel::INFO);
+
+        std::vector<transport::utils::LogEntry> recent = logger.getRecentLogs(1000);
+        bool filtered = recent.size() == 100 && recent.back().message == "rotated entry 99";
+        return filtered && std::filesystem::exists(path + ".1") && !std::filesystem::exists(path + ".3") &&
+               Logger::stringToLevel("warn") == LogLevel::WARNING && Logger::levelToString(LogLevel::CRITICAL) == "CRITICAL";
+    }
+
+    bool testFormatter()
+    {
+        using transport::utils::formatLog;
+        std::string name = "Central";
+        return formatLog("Route {} -> {} in {} min", name, "Harbour", 42) == "Route Central -> Harbour in 42 min" &&
+               formatLog("{} {} {} {}", true, 'x', -7L, 2.5) == "true x -7 2.5" &&
+               formatLog("{{literal}} {}", 1) == "{literal} 1" &&
+               formatLog("missing {} and {}", 1) == "missing 1 and {}" &&
+               formatLog("extra {}", 1, 2) == "extra 1" &&
+               formatLog("none }}") == "none }";
+    }
+
+    bool testLazyArguments()
+    {
+        Logger &logger = Logger::getInstance();
+        freshLog("lazy");
+        logger.setLogLevel(LogLevel::WARNING);
+        expensiveCalls = 0;
+
+        LOG_DEBUG_FMT("never built {}", expensiveArgument());
+        LOG_INFO("never built " + std::to_string(expensiveArgument()));
+        bool skipped = expensiveCalls == 0;
+
+        // A compiled-out level is skipped even when the runtime level would let it through
+        logger.setLogLevel(LogLevel::DEBUG);
+        expensiveCalls = 0;
+        if constexpr (!transport::utils::isLogLevelCompiledIn(LogLevel::DEBUG))
+        {
+            LOG_DEBUG_FMT("compiled out {}", expensiveArgument());
+            LOG_DEBUG("compiled out " + std::to_string(expensiveArgument()));
+        }
+        if constexpr (!transport::utils::isLogLevelCompiledIn(LogLevel::ERROR))
+            LOG_ERROR_FMT("compiled out {}", expensiveArgument());
+        bool compiledOut = expensiveCalls == 0;
+        logger.setLogLevel(LogLevel::WARNING);
+
+        bool logged = true;
+        if constexpr (transport::utils::isLogLevelCompiledIn(LogLevel::WARNING))
+        {
+            LOG_WARNING_FMT("built {}", expensiveArgument());
+            logger.flush();
+            std::vector<transport::utils::LogEntry> recent = logger.getRecentLogs(1);
+            logged = expensiveCalls == 1 && !recent.empty() && recent.back().message == "built 1";
+        }
+        logger.setLogLevel(LogLevel::INFO);
+
+        static_assert(transport::utils::isLogLevelCompiledIn(LogLevel::CRITICAL), "CRITICAL is always compiled in");
+        return skipped && compiledOut && logged;
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nLogger Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Concurrent Logging", testConcurrentLogging());
+        runTest("Block Policy Loses Nothing", testBlockPolicyLosesNothing());
+        runTest("Drop Policy Counts Drops", testDropPolicyCountsDrops());
+        runTest("Resize While Logging", testResizeWhileLogging());
+        runTest("Synchronous Mode", testSynchronousMode());
+        runTest("Disable While Logging", testDisableWhileLogging());
+        runTest("Levels And Rotation", testLevelsAndRotation());
+        runTest("Formatter", testFormatter());
+        runTest("Lazy Arguments", testLazyArguments());
+
+        // Leave the singleton as other tests expect it
+        Logger::getInstance().configure("", LogDestination::CONSOLE_ONLY);
+        printSummary();
+    }
+};
+
+int LoggerTestRunner::expensiveCalls = 0;
+
+// Function that will be called from test_main.cpp
+void runLoggerTests()
+{
+    LoggerTestRunner testRunner;
+    testRunner.runAllTests();
+}
@@ -0,0 +1,274 @@
+#include <arpa/inet.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <netinet/in.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../../include/core/TransportationSystem.h"
+#include "../../include/utils/Metrics.h"
+#include "../../include/utils/MetricsServer.h"
+
+/**
+ * @file test_metrics.cpp
+ * @brief Unit tests for the metrics registry, its exports and the system instrumentation
+ */
+
+using transport::utils::Counter;
+using transport::utils::Gauge;
+using transport::utils::Histogram;
+using transport::utils::MetricsRegistry;
+using transport::utils::MetricsServer;
+
+class MetricsTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    const std::string TMP_DIR = "tests/tmp/metrics";
+
+    static bool contains(const std::string &text, const std::string &line)
+    {
+        return text.find(line + "\n") != std::string::npos;
+    }
+
+    // Plain HTTP/1.1 request to the loopback interface, returns the raw response
+    static std::string httpGet(uint16_t port, const std::string &target)
+    {
+        int client = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        if (client < 0 || ::connect(client, reinterpret_cast<sockaddr *>(&address), sizeof address) < 0)
+        {
+            if (client >= 0)
+                ::close(client);
+            return "";
+        }
+
+        std::string request = "GET " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        ::send(client, request.data(), request.size(), 0);
+        std::string response;
+        char chunk[4096];
+        ssize_t received;
+        while ((received = ::recv(client, chunk, sizeof chunk, 0)) > 0)
+            response.append(chunk, static_cast<size_t>(received));
+        ::close(client);
+        return response;
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testConcurrentUpdates()
+    {
+        MetricsRegistry registry;
+        Counter &counter = registry.counter("test_events_total", "Events");
+        Gauge &gauge = registry.gauge("test_level", "Level");
+        Histogram &histogram = registry.histogram("test_duration_seconds", "Duration");
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&]()
+                                 {
+                for (int i = 0; i < 50000; ++i)
+                {
+                    counter.increment();
+                    gauge.add(0.5);
+                    histogram.record(static_cast<uint64_t>(i));
+                } });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        return counter.get() == 200000 && gauge.get() == 100000.0 && histogram.getCount() == 200000 &&
+               histogram.getSum() == 4 * (49999ull * 50000 / 2) && histogram.getMax() == 49999 &&
+               &registry.counter("test_events_total", "Events") == &counter;
+    }
+
+    bool testHistogramAccuracy()
+    {
+        // Every value lies inside its own bucket, and neighbouring buckets touch
+        for (uint64_t value : {0ull, 1ull, 31ull, 32ull, 33ull, 63ull, 64ull, 1000ull, 123456789ull, ~0ull})
+        {
+            size_t bucket = Histogram::bucketIndex(value);
+            if (bucket >= Histogram::BUCKETS || value < Histogram::bucketLowerBound(bucket) ||
+                value > Histogram::bucketUpperBound(bucket))
+                return false;
+        }
+        for (size_t b = 1; b < Histogram::BUCKETS; ++b)
+        {
+            if (Histogram::bucketLowerBound(b) != Histogram::bucketUpperBound(b - 1) + 1)
+                return false;
+        }
+
+        Histogram histogram;
+        for (uint64_t value = 1; value <= 100000; ++value)
+            histogram.record(value);
+        for (double fraction : {0.5, 0.9, 0.99, 0.999})
+        {
+            double exact = fraction * 100000;
+            double error = std::fabs(static_cast<double>(histogram.getPercentile(fraction)) - exact) / exact;
+            if (error > 1.0 / Histogram::SUB_BUCKETS)
+                return false;
+        }
+        return histogram.getPercentile(1.0) == 100000 && histogram.getCountAtOrBelow(31) == 31 &&
+               Histogram().getPercentile(0.5) == 0;
+    }
+
+    bool testPrometheusFormat()
+    {
+        MetricsRegistry registry;
+        registry.counter("test_requests_total", "Requests\nserved", {{"path", "/a\"b\\"}}).increment(3);
+        registry.gauge("test_temperature", "Temperature").set(-1.5);
+        registry.gaugeFunction("test_answer", "Answer", []()
+                               { return 42.0; });
+        Histogram &histogram = registry.histogram("test_latency_seconds", "Latency", {{"mode", "sync"}}, 1e-6,
+                                                  {0.001, 0.01});
+        histogram.record(500);   // 0.5 ms
+        histogram.record(5000);  // 5 ms
+        histogram.record(50000); // 50 ms
+
+        bool clash = false;
+        try
+        {
+            registry.gauge("test_requests_total", "Requests");
+        }
+        catch (const std::invalid_argument &)
+        {
+            clash = true;
+        }
+
+        std::string text = registry.exportPrometheus();
+        return clash &&
+               contains(text, "# HELP test_requests_total Requests\\nserved") &&
+               contains(text, "# TYPE test_requests_total counter") &&
+               contains(text, "test_requests_total{path=\"/a\\\"b\\\\\"} 3") &&
+               contains(text, "# TYPE test_temperature gauge") &&
+               contains(text, "test_temperature -1.5") &&
+               contains(text, "test_answer 42") &&
+               contains(text, "# TYPE test_latency_seconds histogram") &&
+               contains(text, "test_latency_seconds_bucket{mode=\"sync\",le=\"0.001\"} 1") &&
+               contains(text, "test_latency_seconds_bucket{mode=\"sync\",le=\"0.01\"} 2") &&
+               contains(text, "test_latency_seconds_bucket{mode=\"sync\",le=\"+Inf\"} 3") &&
+               contains(text, "test_latency_seconds_sum{mode=\"sync\"} 0.0555") &&
+               contains(text, "test_latency_seconds_count{mode=\"sync\"} 3") &&
+               text.find("# TYPE test_answer") < text.find("# TYPE test_latency_seconds"); // Sorted by name
+    }
+
+    bool testFileExport()
+    {
+        std::filesystem::create_directories(TMP_DIR);
+        std::string path = TMP_DIR + "/transport.prom";
+        MetricsRegistry registry;
+        registry.counter("test_writes_total", "Writes").increment();
+        if (!registry.writePrometheusFile(path) || registry.writePrometheusFile(TMP_DIR + "/missing/dir/x.prom"))
+            return false;
+
+        std::ifstream in(path);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        return contents.str() == registry.exportPrometheus() && !std::filesystem::exists(path + ".tmp");
+    }
+
+    bool testHttpEndpoint()
+    {
+        MetricsRegistry registry;
+        registry.counter("test_scrapes_total", "Scrapes").increment(7);
+        MetricsServer server(registry);
+        if (!server.start(0) || server.getPort() == 0)
+            return false;
+
+        MetricsServer second(registry);
+        bool portTaken = !second.start(server.getPort()) && !second.getLastError().empty();
+
+        std::string metrics = httpGet(server.getPort(), "/metrics");
+        std::string missing = httpGet(server.getPort(), "/");
+        uint16_t port = server.getPort();
+        server.stop();
+
+        return portTaken && metrics.rfind("HTTP/1.1 200 OK\r\n", 0) == 0 &&
+               metrics.find("Content-Type: text/plain; version=0.0.4") != std::string::npos &&
+               contains(metrics, "test_scrapes_total 7") && missing.rfind("HTTP/1.1 404", 0) == 0 &&
+               !server.isRunning() && server.getPort() == 0 && httpGet(port, "/metrics").empty();
+    }
+
+    bool testSystemInstrumentation()
+    {
+        TransportationSystem system;
+        system.addLocation("A", 0.0, 0.0);
+        system.addLocation("B", 0.0, 0.1);
+        system.addLocation("C", 0.0, 0.2);
+        system.addRoute("A", "B", 100, 5, 1000, 0, "walk");
+
+        system.findRoute("A", "B");
+        system.findRoute("A", "B"); // Answered from the route cache
+        system.findRoute("A", "C");
+        system.findRoute("A", "Nowhere");
+        bool asyncFound = system.findRouteAsync("A", "B").get().isValid;
+
+        if (!system.startMetricsServer(0))
+            return false;
+        std::string scraped = httpGet(system.getMetricsPort(), "/metrics");
+        system.stopMetricsServer();
+
+        std::string text = system.getMetrics().exportPrometheus();
+        return asyncFound && system.getMetricsPort() == 0 &&
+               contains(scraped, "transport_route_queries_total{mode=\"sync\",status=\"found\"} 2") &&
+               contains(text, "transport_route_queries_total{mode=\"sync\",status=\"found\"} 2") &&
+               contains(text, "transport_route_queries_total{mode=\"sync\",status=\"not_found\"} 2") &&
+               contains(text, "transport_route_queries_total{mode=\"async\",status=\"found\"} 1") &&
+               contains(text, "transport_route_query_duration_seconds_count{mode=\"sync\"} 4") &&
+               contains(text, "transport_route_query_duration_seconds_count{mode=\"async\"} 1") &&
+               contains(text, "transport_route_cache_hits_total 1") &&
+               contains(text, "transport_network_nodes 3") &&
+               contains(text, "transport_network_edges 1") &&
+               contains(text, "transport_network_load_duration_seconds_count{source=\"csv\"} 0");
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nMetrics Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Concurrent Updates", testConcurrentUpdates());
+        runTest("Histogram Accuracy", testHistogramAccuracy());
+        runTest("Prometheus Format", testPrometheusFormat());
+        runTest("File Export", testFileExport());
+        runTest("HTTP Endpoint", testHttpEndpoint());
+        runTest("System Instrumentation", testSystemInstrumentation());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runMetricsTests()
+{
+    MetricsTestRunner testRunner;
+    testRunner.runAllTests();
+}
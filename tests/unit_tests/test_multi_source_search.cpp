@@ -0,0 +1,148 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../include/core/Graph.h"
+#include "../../include/core/GraphSnapshot.h"
+#include "../../include/algorithms/MultiSourceSearch.h"
+#include "../../include/algorithms/RouteService.h"
+#include "test_graphs.h"
+
+/**
+ * @file test_multi_source_search.cpp
+ * @brief Unit tests for the lockstep multi-source search kernels
+ */
+
+class MultiSourceSearchTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    static std::vector<MultiSourceSearch::Kernel> supportedKernels()
+    {
+        std::vector<MultiSourceSearch::Kernel> kernels;
+        for (auto kernel : {MultiSourceSearch::Kernel::Scalar, MultiSourceSearch::Kernel::AVX2,
+                            MultiSourceSearch::Kernel::AVX512})
+        {
+            if (MultiSourceSearch::isSupported(kernel))
+                kernels.push_back(kernel);
+        }
+        return kernels;
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testKernelsMatchDijkstra()
+    {
+        Graph graph = createRandomGraph(400, 2, 99, 0, 90);
+        GraphSnapshot snapshot(graph);
+        std::vector<uint32_t> sources;
+        for (uint32_t i = 0; i < MultiSourceSearch::LANES; ++i)
+            sources.push_back(snapshot.findNode("S" + std::to_string(i * 23)));
+
+        RouteService::SearchWorkspace workspace;
+        for (auto criterion : {GraphSnapshot::Criterion::Time, GraphSnapshot::Criterion::Cost})
+        {
+            for (MultiSourceSearch::Kernel kernel : supportedKernels())
+            {
+                MultiSourceSearch search(kernel);
+                search.run(snapshot, sources, criterion);
+                for (uint32_t lane = 0; lane < sources.size(); ++lane)
+                {
+                    RouteService::searchAll(snapshot, workspace, sources[lane], criterion);
+                    for (uint32_t node = 0; node < snapshot.getNodeCount(); ++node)
+                    {
+                        long long expected = workspace.isReached(node) ? workspace.distance[node]
+                                                                       : MultiSourceSearch::UNREACHED;
+                        if (search.getDistance(lane, node) != expected)
+                            return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool testPartialAndEmptyLanes()
+    {
+        Graph graph;
+        graph.addNode("A", 0.0, 0.0);
+        graph.addNode("B", 0.0, 0.1);
+        graph.addNode("C", 0.0, 0.2);
+        graph.addEdge("A", "B", 100, 4, 1000, 0, "walk");
+        graph.addEdge("B", "C", 100, 6, 1000, 0, "walk");
+        GraphSnapshot snapshot(graph);
+
+        MultiSourceSearch search(MultiSourceSearch::Kernel::Scalar);
+        search.run(snapshot, {snapshot.findNode("A"), GraphSnapshot::INVALID_NODE, snapshot.findNode("C")},
+                   GraphSnapshot::Criterion::Time);
+
+        uint32_t a = snapshot.findNode("A"), c = snapshot.findNode("C");
+        return search.getDistance(0, c) == 10 && !search.reaches(1, a) && !search.reaches(1, c) &&
+               search.getDistance(2, c) == 0 && search.getDistance(2, a) == MultiSourceSearch::UNREACHED &&
+               !search.reaches(MultiSourceSearch::LANES - 1, a);
+    }
+
+    bool testServiceMatrixWithEachKernel()
+    {
+        Graph graph = createRandomGraph(250, 3, 7, 0, 90);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 3);
+        std::vector<std::string> origins, destinations;
+        for (int i = 0; i < 37; ++i)
+            origins.push_back("S" + std::to_string(i * 5));
+        origins.push_back("Missing");
+        for (int i = 0; i < 30; ++i)
+            destinations.push_back("S" + std::to_string(i * 8 + 1));
+
+        service.setBatchKernel(MultiSourceSearch::Kernel::Scalar);
+        std::vector<std::vector<long long>> reference = service.computeMatrix(origins, destinations, "distance");
+        for (MultiSourceSearch::Kernel kernel : supportedKernels())
+        {
+            service.setBatchKernel(kernel);
+            if (service.getBatchKernel() != kernel ||
+                service.computeMatrix(origins, destinations, "distance") != reference)
+                return false;
+        }
+
+        RouteResult route = service.findRoute("S0", "S1", "distance");
+        long long expected = route.isValid ? static_cast<long long>(route.totalDistance) : RouteService::UNREACHABLE;
+        return reference[0][0] == expected && reference.back()[0] == RouteService::UNREACHABLE;
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nMulti-Source Search Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        std::cout << "Detected kernel: " << MultiSourceSearch::kernelName(MultiSourceSearch::detectKernel()) << std::endl;
+        runTest("Kernels Match Dijkstra", testKernelsMatchDijkstra());
+        runTest("Partial And Empty Lanes", testPartialAndEmptyLanes());
+        runTest("Service Matrix With Each Kernel", testServiceMatrixWithEachKernel());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runMultiSourceSearchTests()
+{
+    MultiSourceSearchTestRunner testRunner;
+    testRunner.runAllTests();
+}
@@ -0,0 +1,213 @@
+#include <cmath>
+#include <iostream>
+#include <filesystem>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include "../../include/core/Graph.h"
+#include "../../include/io/CSVHandler.h"
+#include "../../include/io/NetworkGenerator.h"
+#include "../../include/io/NetworkJournal.h"
+
+/**
+ * @file test_network_generator.cpp
+ * @brief Unit tests for the synthetic network generator
+ */
+
+class NetworkGeneratorTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    const std::string TMP_DIR = "tests/tmp/generator";
+
+    std::string freshDir(const std::string &name)
+    {
+        std::filesystem::remove_all(TMP_DIR + "/" + name);
+        std::filesystem::create_directories(TMP_DIR + "/" + name);
+        return TMP_DIR + "/" + name;
+    }
+
+    static NetworkGenerator::Options options(uint64_t stops, unsigned seed = 47)
+    {
+        NetworkGenerator::Options generatorOptions;
+        generatorOptions.stopCount = stops;
+        generatorOptions.seed = seed;
+        return generatorOptions;
+    }
+
+    // Every stop and link rendered as text, for comparing two generators
+    static std::string fingerprint(const NetworkGenerator &generator)
+    {
+        std::ostringstream out;
+        generator.forEachStop([&](const NetworkGenerator::Stop &stop)
+                              { out << stop.id << ' ' << stop.latitude << ' ' << stop.longitude << '\n'; });
+        generator.forEachLink([&](const NetworkGenerator::Link &link)
+                              { out << link.from << '>' << link.to << ' ' << link.distance << ' ' << link.time
+                                    << ' ' << link.cost << ' ' << link.transfers << ' ' << link.mode << '\n'; });
+        return out.str();
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testDeterministic()
+    {
+        NetworkGenerator first(options(2000)), second(options(2000)), other(options(2000, 48));
+        return fingerprint(first) == fingerprint(second) && fingerprint(first) != fingerprint(other);
+    }
+
+    bool testLinkCountMatchesLinks()
+    {
+        NetworkGenerator generator(options(5000));
+        uint64_t links = 0;
+        bool modesKnown = true;
+        generator.forEachLink([&](const NetworkGenerator::Link &link)
+                              {
+                                  links++;
+                                  std::string mode = link.mode;
+                                  modesKnown = modesKnown && (mode == "TransJakarta" ||
+                                                              mode == "TransJakarta+Transfer" ||
+                                                              mode == "MRT/LRT");
+                              });
+        return links == generator.getLinkCount() && modesKnown;
+    }
+
+    bool testStopsInJakarta()
+    {
+        NetworkGenerator generator(options(250000));
+        bool inside = true;
+        generator.forEachStop([&](const NetworkGenerator::Stop &stop)
+                              {
+                                  inside = inside && stop.latitude > -6.5 && stop.latitude < -5.9 &&
+                                           stop.longitude > 106.5 && stop.longitude < 107.1;
+                              });
+        return inside;
+    }
+
+    bool testStationsHaveCorridorLinks()
+    {
+        // Spacing 1 puts corridor steps next to each other, where no corridor link is added
+        NetworkGenerator::Options dense = options(2000);
+        dense.corridorStopSpacing = 1;
+        NetworkGenerator generator(dense);
+        std::unordered_set<uint64_t> linked;
+        generator.forEachLink([&](const NetworkGenerator::Link &link)
+                              {
+                                  if (std::string(link.mode) == "MRT/LRT")
+                                      linked.insert(link.from);
+                              });
+        bool named = true;
+        generator.forEachStop([&](const NetworkGenerator::Stop &stop)
+                              {
+                                  bool station = stop.name.rfind("Stasiun ", 0) == 0;
+                                  named = named && station == (linked.count(stop.index) != 0);
+                              });
+        return named && !linked.empty();
+    }
+
+    bool testConnected()
+    {
+        Graph graph;
+        NetworkGenerator generator(options(3000));
+        // Stops and links go in through the bulk calls, without a console line per element
+        std::ostringstream output;
+        std::streambuf *previous = std::cout.rdbuf(output.rdbuf());
+        generator.buildGraph(graph);
+        std::cout.rdbuf(previous);
+        if (output.str().find("added") != std::string::npos || graph.getNodeCount() != 3000 ||
+            static_cast<uint64_t>(graph.getEdgeCount()) != generator.getLinkCount())
+            return false;
+
+        std::unordered_set<std::string> reached = {"S0"};
+        std::queue<std::string> frontier;
+        frontier.push("S0");
+        while (!frontier.empty())
+        {
+            std::string node = frontier.front();
+            frontier.pop();
+            for (const std::string &neighbour : graph.getNeighbors(node))
+                if (reached.insert(neighbour).second)
+                    frontier.push(neighbour);
+        }
+        return reached.size() == static_cast<size_t>(graph.getNodeCount());
+    }
+
+    bool testCSVRoundTrip()
+    {
+        std::string dir = freshDir("csv");
+        NetworkGenerator generator(options(1500));
+        if (!generator.writeCSV(dir + "/network_data.csv", dir + "/nodes_data.csv"))
+            return false;
+
+        Graph built, loaded;
+        generator.buildGraph(built);
+        if (!loaded.loadFromCSV(dir + "/network_data.csv"))
+            return false;
+
+        // Graph::loadFromCSV skips coordinates, so check those against nodes_data.csv
+        auto rows = CSVHandler::readCSV(dir + "/nodes_data.csv");
+        NetworkGenerator::Stop stop = generator.stop(700);
+        return loaded.getNodeCount() == built.getNodeCount() && loaded.getEdgeCount() == built.getEdgeCount() &&
+               loaded.getEdge("S700", "S701").getTime() == built.getEdge("S700", "S701").getTime() &&
+               rows.size() == 1501 && rows[701][0] == stop.id && rows[701][1] == stop.name &&
+               std::abs(std::stod(rows[701][2]) - stop.latitude) < 1e-5;
+    }
+
+    bool testSnapshotLoadsInJournal()
+    {
+        std::string base = freshDir("snapshot") + "/network";
+        NetworkGenerator generator(options(1500));
+        if (!generator.writeSnapshot(base))
+            return false;
+
+        Graph built, restored;
+        generator.buildGraph(built);
+        NetworkJournal journal(base);
+        if (!journal.open(restored))
+            return false;
+        NetworkGenerator::Stop stop = generator.stop(42);
+        return restored.getNodeCount() == built.getNodeCount() && restored.getEdgeCount() == built.getEdgeCount() &&
+               restored.getNode(stop.id).getLongitude() == built.getNode(stop.id).getLongitude();
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nNetwork Generator Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Generator Deterministic Per Seed", testDeterministic());
+        runTest("Generator Link Count Matches Links", testLinkCountMatchesLinks());
+        runTest("Generator Stops Within Jakarta", testStopsInJakarta());
+        runTest("Generator Stations Have Corridor Links", testStationsHaveCorridorLinks());
+        runTest("Generator Network Connected", testConnected());
+        runTest("Generator CSV Round Trip", testCSVRoundTrip());
+        runTest("Generator Snapshot Loads In Journal", testSnapshotLoadsInJournal());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runNetworkGeneratorTests()
+{
+    NetworkGeneratorTestRunner testRunner;
+    testRunner.runAllTests();
+}
@@ -0,0 +1,244 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <filesystem>
+#include "../../include/core/Graph.h"
+#include "../../include/core/TransportationSystem.h"
+#include "../../include/io/NetworkJournal.h"
+
+/**
+ * @file test_network_journal.cpp
+ * @brief Unit tests for the append-only network edit journal
+ */
+
+class NetworkJournalTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    const std::string TMP_DIR = "tests/tmp/journal";
+
+    std::string freshBase(const std::string &name)
+    {
+        std::filesystem::remove_all(TMP_DIR + "/" + name);
+        std::filesystem::create_directories(TMP_DIR + "/" + name);
+        return TMP_DIR + "/" + name + "/network";
+    }
+
+    static NetworkJournal::Mutation addNode(const std::string &name, double lat, double lon)
+    {
+        NetworkJournal::Mutation mutation;
+        mutation.operation = NetworkJournal::Operation::AddNode;
+        mutation.source = name;
+        mutation.latitude = lat;
+        mutation.longitude = lon;
+        return mutation;
+    }
+
+    static NetworkJournal::Mutation addEdge(const std::string &from, const std::string &to, int time)
+    {
+        NetworkJournal::Mutation mutation;
+        mutation.operation = NetworkJournal::Operation::AddEdge;
+        mutation.source = from;
+        mutation.destination = to;
+        mutation.distance = 3000;
+        mutation.time = time;
+        mutation.cost = 3500;
+        mutation.mode = "bus";
+        return mutation;
+    }
+
+    // Apply to the live graph and log it, the way TransportationSystem does
+    static bool edit(NetworkJournal &journal, Graph &graph, const NetworkJournal::Mutation &mutation)
+    {
+        return NetworkJournal::apply(mutation, graph) && journal.append(mutation);
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testChecksum()
+    {
+        return NetworkJournal::crc32("123456789", 9) == 0xCBF43926u;
+    }
+
+    bool testReplayAfterRestart()
+    {
+        std::string base = freshBase("replay");
+        {
+            Graph graph;
+            NetworkJournal journal(base);
+            if (!journal.open(graph))
+                return false;
+            edit(journal, graph, addNode("Blok M", -6.2441, 106.7990));
+            edit(journal, graph, addNode("Senayan", -6.2270, 106.8020));
+            edit(journal, graph, addNode("Dukuh Atas", -6.2005, 106.8227));
+            edit(journal, graph, addEdge("Blok M", "Senayan", 9));
+            edit(journal, graph, addEdge("Senayan", "Dukuh Atas", 7));
+
+            NetworkJournal::Mutation update = addEdge("Blok M", "Senayan", 6);
+            update.operation = NetworkJournal::Operation::UpdateEdge;
+            edit(journal, graph, update);
+
+            NetworkJournal::Mutation removal;
+            removal.operation = NetworkJournal::Operation::RemoveNode;
+            removal.source = "Dukuh Atas";
+            edit(journal, graph, removal);
+
+            // Re-adding after a removal must replay in log order
+            edit(journal, graph, addNode("Dukuh Atas", -6.2010, 106.8230));
+            edit(journal, graph, addEdge("Dukuh Atas", "Blok M", 15));
+            NetworkJournal::Mutation edgeRemoval = addEdge("Blok M", "Senayan", 0);
+            edgeRemoval.operation = NetworkJournal::Operation::RemoveEdge;
+            edit(journal, graph, edgeRemoval);
+            edit(journal, graph, addEdge("Blok M", "Senayan", 4));
+        }
+
+        // Replay goes through the bulk Graph calls, without a console line per record
+        Graph restored;
+        NetworkJournal journal(base);
+        std::ostringstream output;
+        std::streambuf *previous = std::cout.rdbuf(output.rdbuf());
+        bool opened = journal.open(restored);
+        std::cout.rdbuf(previous);
+        return opened && journal.getStatistics().recordsReplayed == 11 &&
+               output.str().find("added") == std::string::npos && output.str().find("removed") == std::string::npos &&
+               output.str().find("updated") == std::string::npos && restored.getNodeCount() == 3 &&
+               restored.getNode("Dukuh Atas").getLatitude() == -6.2010 && restored.getEdgeCount() == 2 &&
+               restored.getEdge("Blok M", "Senayan").getTime() == 4 &&
+               restored.getEdge("Dukuh Atas", "Blok M").getTime() == 15 &&
+               restored.getNode("Senayan").getLatitude() == -6.2270;
+    }
+
+    bool testTornTailIsDiscarded()
+    {
+        std::string base = freshBase("torn");
+        {
+            Graph graph;
+            NetworkJournal journal(base);
+            journal.open(graph);
+            edit(journal, graph, addNode("Blok M", -6.2441, 106.7990));
+            edit(journal, graph, addNode("Senayan", -6.2270, 106.8020));
+        }
+
+        // Simulate a crash halfway through the third record
+        std::string logPath = base + ".log.0";
+        auto goodSize = std::filesystem::file_size(logPath);
+        {
+            std::ofstream log(logPath, std::ios::binary | std::ios::app);
+            log.write("\x30\x00\x00\x00\xde\xad\xbe\xef\x04", 9);
+        }
+
+        Graph restored;
+        NetworkJournal journal(base);
+        if (!journal.open(restored) || restored.getNodeCount() != 2 ||
+            journal.getStatistics().tailsDiscarded != 1 ||
+            std::filesystem::file_size(logPath) != goodSize)
+            return false;
+
+        // Appends after recovery must replay cleanly
+        edit(journal, restored, addEdge("Blok M", "Senayan", 9));
+        Graph again;
+        NetworkJournal reopened(base);
+        return reopened.open(again) && again.hasEdge("Blok M", "Senayan");
+    }
+
+    bool testCompaction()
+    {
+        std::string base = freshBase("compact");
+        Graph graph;
+        {
+            NetworkJournal journal(base);
+            journal.open(graph);
+            for (int i = 0; i < 50; ++i)
+                edit(journal, graph, addNode("Stop " + std::to_string(i), -6.2 - i * 0.001, 106.8));
+            for (int i = 1; i < 50; ++i)
+                edit(journal, graph, addEdge("Stop " + std::to_string(i - 1), "Stop " + std::to_string(i), i));
+
+            if (!journal.compact(graph, true))
+                return false;
+            // Edits made while the snapshot is written land in the next generation
+            edit(journal, graph, addEdge("Stop 49", "Stop 0", 99));
+            journal.waitForCompaction();
+
+            if (journal.getStatistics().compactions != 1 || journal.getStatistics().generation != 1 ||
+                std::filesystem::exists(base + ".log.0") || !std::filesystem::exists(base + ".snapshot"))
+                return false;
+        }
+
+        Graph restored;
+        NetworkJournal journal(base);
+        return journal.open(restored) && journal.getStatistics().recordsReplayed == 1 &&
+               restored.getNodeCount() == 50 && restored.getEdgeCount() == 50 &&
+               restored.getEdge("Stop 49", "Stop 0").getTime() == 99 &&
+               restored.getNode("Stop 10").getLatitude() == graph.getNode("Stop 10").getLatitude();
+    }
+
+    // Reloading the network under an open journal must not leave the old edits to be
+    // replayed on top of the new network
+    bool testReloadCompactsJournal()
+    {
+        std::string base = freshBase("reload");
+        std::string dir = TMP_DIR + "/reload";
+        std::ofstream(dir + "/first.csv") << "source,destination,distance,time,cost,transfers,mode\n"
+                                          << "Blok_M,Senayan,2500,6,3500,0,mrt\n";
+        std::ofstream(dir + "/second.csv") << "source,destination,distance,time,cost,transfers,mode\n"
+                                           << "Kota,Mangga_Dua,1800,8,3500,0,bus\n";
+        {
+            TransportationSystem system;
+            if (!system.loadNetworkData(dir + "/first.csv") || !system.enableJournal(base) ||
+                system.getMutableNetwork() != nullptr)
+                return false;
+            system.addLocation("Bundaran_HI", -6.195, 106.823);
+            if (!system.loadNetworkData(dir + "/second.csv") || !system.isJournalEnabled())
+                return false;
+            system.addLocation("Ancol", -6.126, 106.833);
+            system.disableJournal();
+            if (system.getMutableNetwork() == nullptr)
+                return false;
+        }
+
+        TransportationSystem restored;
+        return restored.loadNetworkData(dir + "/first.csv") && restored.enableJournal(base) &&
+               restored.getNetwork().hasNode("Kota") && restored.getNetwork().hasNode("Ancol") &&
+               !restored.getNetwork().hasNode("Blok_M") && !restored.getNetwork().hasNode("Bundaran_HI");
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nNetwork Journal Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Journal CRC-32 Check Value", testChecksum());
+        runTest("Journal Replay After Restart", testReplayAfterRestart());
+        runTest("Journal Torn Tail Discarded", testTornTailIsDiscarded());
+        runTest("Journal Background Compaction", testCompaction());
+        runTest("Journal Compacted On Network Reload", testReloadCompactsJournal());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runNetworkJournalTests()
+{
+    NetworkJournalTestRunner testRunner;
+    testRunner.runAllTests();
+}
@@ -0,0 +1,264 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <filesystem>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <vector>
+#include "../../include/core/Graph.h"
+#include "../../include/io/OSMImporter.h"
+
+/**
+ * @file test_osm_import.cpp
+ * @brief Unit tests for the OSM walking/feeder network importer
+ */
+
+class OSMImportTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    const std::string EXTRACT_FILE = "tests/tmp/osm/small.osm";
+
+    // The XML sample below as uncompressed PBF: nodes 1-5 dense, 6-7 as plain nodes
+    const std::string PBF_FIXTURE = "tests/unit_tests/fixtures/small.osm.pbf";
+
+    // Footway 1-2-3-4-5 split over two ways, a primary road 3-6 and a motorway 6-7
+    void writeSampleExtract()
+    {
+        std::filesystem::create_directories("tests/tmp/osm");
+        std::ofstream file(EXTRACT_FILE);
+        file << "<?xml version='1.0' encoding='UTF-8'?>\n"
+             << "<osm version=\"0.6\">\n"
+             << " <node id=\"1\" lat=\"-6.2440\" lon=\"106.7991\"/>\n"
+             << " <node id=\"2\" lat=\"-6.2400\" lon=\"106.8000\"/>\n"
+             << " <node id=\"3\" lat=\"-6.2350\" lon=\"106.8010\"/>\n"
+             << " <node id=\"4\" lat=\"-6.2300\" lon=\"106.8015\"/>\n"
+             << " <node id=\"5\" lat=\"-6.2271\" lon=\"106.8019\"/>\n"
+             << " <node id=\"6\" lat=\"-6.2350\" lon=\"106.8100\"/>\n"
+             << " <node id=\"7\" lat=\"-6.2350\" lon=\"106.8200\"><tag k=\"name\" v=\"A &amp; B\"/></node>\n"
+             << " <way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/><nd ref=\"3\"/>"
+             << "<tag k=\"highway\" v=\"footway\"/></way>\n"
+             << " <way id=\"11\"><nd ref=\"3\"/><nd ref=\"4\"/><nd ref=\"5\"/>"
+             << "<tag k=\"highway\" v=\"pedestrian\"/></way>\n"
+             << " <way id=\"12\"><nd ref=\"3\"/><nd ref=\"6\"/>"
+             << "<tag k=\"highway\" v=\"primary\"/><tag k=\"oneway\" v=\"yes\"/></way>\n"
+             << " <way id=\"13\"><nd ref=\"6\"/><nd ref=\"7\"/>"
+             << "<tag k=\"highway\" v=\"motorway\"/></way>\n"
+             << "</osm>\n";
+    }
+
+    Graph createStations()
+    {
+        Graph graph;
+        graph.addNode("Blok M", -6.2441, 106.7990);
+        graph.addNode("Senayan", -6.2270, 106.8020);
+        graph.addNode("Far Away", -6.1000, 106.9000);
+        return graph;
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testFeederAndWalkLegs()
+    {
+        writeSampleExtract();
+        Graph graph = createStations();
+        OSMImporter importer;
+        if (!importer.importFile(EXTRACT_FILE, graph))
+            return false;
+
+        // Junction 3 joins three legs, so nothing is contracted; 7 is only on a motorway
+        return graph.hasNode("osm:1") && graph.hasNode("osm:3") && graph.hasNode("osm:5") &&
+               graph.hasNode("osm:6") && !graph.hasNode("osm:2") && !graph.hasNode("osm:7") &&
+               graph.hasEdge("osm:1", "osm:3") && graph.hasEdge("osm:3", "osm:1") &&
+               graph.hasEdge("osm:3", "osm:6") && !graph.hasEdge("osm:6", "osm:3") &&
+               graph.getEdge("osm:3", "osm:6").getTransportMode() == "feeder" &&
+               graph.hasEdge("Blok M", "osm:1") && graph.hasEdge("osm:5", "Senayan") &&
+               graph.getEdgesFrom("Far Away").empty() &&
+               importer.getStatistics().stationsSnapped == 2;
+    }
+
+    bool testDegreeTwoContraction()
+    {
+        writeSampleExtract();
+        Graph graph = createStations();
+        OSMImporter::ImportOptions options;
+        options.includeFeederRoads = false;
+        OSMImporter importer(options);
+        if (!importer.importFile(EXTRACT_FILE, graph))
+            return false;
+
+        // Without the feeder road, junction 3 has degree two and the footway collapses
+        if (graph.hasNode("osm:3") || !graph.hasEdge("osm:1", "osm:5"))
+            return false;
+        Edge leg = graph.getEdge("osm:1", "osm:5");
+        return leg.getTransportMode() == "walk" && leg.getDistance() > 1800 &&
+               leg.getDistance() < 2200 && leg.getCost() == 0;
+    }
+
+    // A '>' inside a quoted value or a comment must not end the tag early
+    bool testXMLQuotedAngleBracket()
+    {
+        std::filesystem::create_directories("tests/tmp/osm");
+        const std::string path = "tests/tmp/osm/quoted.osm";
+        std::ofstream(path) << "<osm version=\"0.6\">\n"
+                            << " <!-- it's a > b -->\n"
+                            << " <node id=\"1\" lat=\"-6.2440\" lon=\"106.7991\"><tag k=\"note\" v=\"x>y\"/></node>\n"
+                            << " <node id=\"2\" lat=\"-6.2400\" lon=\"106.8000\"/>\n"
+                            << " <way id=\"10\"><tag k=\"name\" v='Jl. A > B'/><nd ref=\"1\"/><nd ref=\"2\"/>"
+                            << "<tag k=\"highway\" v=\"footway\"/></way>\n"
+                            << "</osm>\n";
+
+        size_t nodes = 0;
+        OSMImporter::TagList wayTags;
+        std::vector<int64_t> wayRefs;
+        std::string error;
+        bool ok = OSMImporter::streamXML(
+            path, [&nodes](int64_t, double, double)
+            { nodes++; },
+            [&](int64_t, const std::vector<int64_t> &refs, const OSMImporter::TagList &tags)
+            {
+                wayRefs = refs;
+                wayTags = tags;
+            },
+            error);
+        return ok && nodes == 2 && wayRefs == std::vector<int64_t>{1, 2} && wayTags.size() == 2 &&
+               wayTags[0].second == "Jl. A > B" && wayTags[1].second == "footway";
+    }
+
+    // At 60 degrees north a degree of longitude is half as wide, so a junction 270 m
+    // west of the station lies two raw-degree cells away but within the snap radius
+    bool testSnapAtHighLatitude()
+    {
+        std::filesystem::create_directories("tests/tmp/osm");
+        const std::string path = "tests/tmp/osm/north.osm";
+        std::ofstream(path) << "<osm version=\"0.6\">\n"
+                            << " <node id=\"1\" lat=\"60.0000\" lon=\"9.9999\"/>\n"
+                            << " <node id=\"2\" lat=\"60.0000\" lon=\"10.0200\"/>\n"
+                            << " <way id=\"10\"><nd ref=\"1\"/><nd ref=\"2\"/>"
+                            << "<tag k=\"highway\" v=\"footway\"/></way>\n"
+                            << "</osm>\n";
+
+        Graph graph;
+        graph.addNode("Nordstasjon", 60.0, 10.0048);
+        OSMImporter importer;
+        if (!importer.importFile(path, graph) || !graph.hasEdge("Nordstasjon", "osm:1"))
+            return false;
+        int distance = graph.getEdge("Nordstasjon", "osm:1").getDistance();
+        return distance > 260 && distance < 290 && importer.getStatistics().stationsSnapped == 1;
+    }
+
+    bool testPBFDecoder()
+    {
+        std::map<int64_t, std::pair<double, double>> nodes;
+        std::map<int64_t, std::vector<int64_t>> ways;
+        std::string primaryOneway;
+        std::string error;
+        bool ok = OSMImporter::streamPBF(
+            PBF_FIXTURE,
+            [&nodes](int64_t id, double latitude, double longitude)
+            { nodes[id] = {latitude, longitude}; },
+            [&ways, &primaryOneway](int64_t id, const std::vector<int64_t> &refs, const OSMImporter::TagList &tags)
+            {
+                ways[id] = refs;
+                if (id == 12 && tags.size() == 2 && tags[0].second == "primary")
+                    primaryOneway = tags[1].first + "=" + tags[1].second;
+            },
+            error);
+
+        return ok && nodes.size() == 7 && std::abs(nodes[1].first + 6.2440) < 1e-7 &&
+               std::abs(nodes[5].second - 106.8019) < 1e-7 && std::abs(nodes[7].second - 106.8200) < 1e-7 &&
+               ways.size() == 4 && ways[11] == std::vector<int64_t>{3, 4, 5} && primaryOneway == "oneway=yes";
+    }
+
+    bool testPBFImport()
+    {
+        Graph graph = createStations();
+        OSMImporter importer;
+        // Junctions and legs are inserted in bulk, without a console line per element
+        std::ostringstream output;
+        std::streambuf *previous = std::cout.rdbuf(output.rdbuf());
+        bool imported = importer.importFile(PBF_FIXTURE, graph);
+        std::cout.rdbuf(previous);
+        if (!imported || output.str().find("added") != std::string::npos)
+            return false;
+        bool legs = graph.hasEdge("osm:1", "osm:3") && graph.hasEdge("osm:3", "osm:6") &&
+                    !graph.hasEdge("osm:6", "osm:3") && !graph.hasNode("osm:7") &&
+                    graph.hasEdge("Blok M", "osm:1") && importer.getStatistics().waysKept == 3;
+
+        Graph walkOnly = createStations();
+        OSMImporter::ImportOptions options;
+        options.includeFeederRoads = false;
+        OSMImporter walkImporter(options);
+        return legs && walkImporter.importFile(PBF_FIXTURE, walkOnly) && !walkOnly.hasNode("osm:3") &&
+               walkOnly.hasEdge("osm:1", "osm:5");
+    }
+
+    // A compressed blob whose raw_size claims 1 TiB must be rejected, not allocated
+    bool testPBFRejectsHugeRawSize()
+    {
+        std::filesystem::create_directories("tests/tmp/osm");
+        const std::string path = "tests/tmp/osm/huge.osm.pbf";
+        // Blob: raw_size (field 2) = 2^40, zlib_data (field 3) = 2 junk bytes
+        const std::string blob("\x10\x80\x80\x80\x80\x80\x20\x1a\x02\x78\x9c", 11);
+        const std::string header = std::string("\x0a\x07OSMData\x18", 10) + static_cast<char>(blob.size());
+        std::ofstream file(path, std::ios::binary);
+        file << std::string("\0\0\0", 3) << static_cast<char>(header.size()) << header << blob;
+        file.close();
+
+        Graph graph;
+        OSMImporter importer;
+        return !importer.importFile(path, graph) &&
+               importer.getLastError().find("raw_size") != std::string::npos;
+    }
+
+    bool testMissingFile()
+    {
+        Graph graph;
+        OSMImporter importer;
+        return !importer.importFile("tests/tmp/osm/missing.osm.pbf", graph) &&
+               !importer.getLastError().empty();
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nOSM Import Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("OSM Feeder And Walk Legs", testFeederAndWalkLegs());
+        runTest("OSM Degree-2 Contraction", testDegreeTwoContraction());
+        runTest("OSM XML Quoted Angle Bracket", testXMLQuotedAngleBracket());
+        runTest("OSM Snap At High Latitude", testSnapAtHighLatitude());
+        runTest("OSM PBF Decoder", testPBFDecoder());
+        runTest("OSM PBF Import", testPBFImport());
+        runTest("OSM PBF Rejects Huge raw_size", testPBFRejectsHugeRawSize());
+        runTest("OSM Missing File", testMissingFile());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runOSMImportTests()
+{
+    OSMImportTestRunner testRunner;
+    testRunner.runAllTests();
+}
@@ -0,0 +1,227 @@
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/core/Graph.h"
+#include "../../include/core/TransportationSystem.h"
+#include "../../include/algorithms/RouteCache.h"
+
+/**
+ * @file test_route_cache.cpp
+ * @brief Unit tests for the sharded LRU route cache and graph versioning
+ */
+
+class RouteCacheTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    static RouteResult makeRoute(const std::string &start, const std::string &end, int time)
+    {
+        RouteResult route;
+        route.path = {start, "Transit_" + std::to_string(time), end};
+        route.totalTime = time;
+        route.criteria = "time";
+        route.isValid = true;
+        route.status = RouteStatus::Found;
+        return route;
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testGraphVersion()
+    {
+        Graph graph;
+        uint64_t empty = graph.getVersion();
+        graph.addNode("A", -6.2, 106.8);
+        graph.addNode("B", -6.3, 106.9);
+        uint64_t withNodes = graph.getVersion();
+        bool rejected = !graph.addNode("A", 0.0, 0.0) && graph.getVersion() == withNodes;
+
+        Graph copy(graph);
+        bool copyShares = copy.getVersion() == graph.getVersion();
+        copy.addEdge("A", "B", 100, 1, 1000, 0, "walk");
+        graph.addEdge("A", "B", 100, 1, 1000, 0, "walk");
+
+        return withNodes > empty && rejected && copyShares && copy.getVersion() != graph.getVersion();
+    }
+
+    bool testHitMissAndVersionKey()
+    {
+        RouteCache cache;
+        RouteResult result;
+        bool coldMiss = !cache.lookup("Blok_M", "Kota", "time", 7, result);
+        cache.insert("Blok_M", "Kota", "time", 7, makeRoute("Blok_M", "Kota", 31));
+
+        bool hit = cache.lookup("Blok_M", "Kota", "time", 7, result) && result.totalTime == 31 &&
+                   result.path.size() == 3;
+        bool otherVersion = !cache.lookup("Blok_M", "Kota", "time", 8, result);
+        bool otherCriteria = !cache.lookup("Blok_M", "Kota", "cost", 7, result);
+
+        RouteResult timedOut;
+        timedOut.status = RouteStatus::TimedOut;
+        bool rejectsTimeout = !cache.insert("Kota", "Blok_M", "time", 7, timedOut);
+
+        size_t purged = cache.purgeStale(8);
+        RouteCache::Statistics stats = cache.getStatistics();
+        return coldMiss && hit && otherVersion && otherCriteria && rejectsTimeout && purged == 1 &&
+               stats.hits == 1 && stats.misses == 3 && stats.entries == 0 && stats.bytes == 0;
+    }
+
+    bool testLruEvictionWithinBudget()
+    {
+        // Single shard so the eviction order is fully determined
+        RouteCache cache(4096, 1);
+        for (int i = 0; i < 200; ++i)
+        {
+            RouteResult probe;
+            cache.lookup("S0", "T0", "time", 1, probe); // Keep the first pair hot
+            cache.insert("S" + std::to_string(i), "T" + std::to_string(i), "time", 1,
+                         makeRoute("S" + std::to_string(i), "T" + std::to_string(i), i));
+        }
+
+        RouteResult result;
+        RouteCache::Statistics stats = cache.getStatistics();
+        bool hotSurvives = cache.lookup("S0", "T0", "time", 1, result);
+        bool coldEvicted = !cache.lookup("S1", "T1", "time", 1, result);
+        bool newestKept = cache.lookup("S199", "T199", "time", 1, result);
+
+        cache.setMemoryBudget(0);
+        return stats.bytes <= 4096 && stats.evictions > 0 && hotSurvives && coldEvicted && newestKept &&
+               cache.getStatistics().entries == 0;
+    }
+
+    bool testConcurrentAccess()
+    {
+        RouteCache cache(1 << 20, 8);
+        std::atomic<bool> consistent{true};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&cache, &consistent, t]
+                                 {
+                for (int i = 0; i < 2000; ++i)
+                {
+                    int pair = (i * 7 + t) % 50;
+                    std::string start = "S" + std::to_string(pair), end = "T" + std::to_string(pair);
+                    RouteResult result;
+                    if (cache.lookup(start, end, "time", 1, result))
+                    {
+                        if (result.totalTime != pair || result.path.front() != start)
+                            consistent = false;
+                    }
+                    else
+                    {
+                        cache.insert(start, end, "time", 1, makeRoute(start, end, pair));
+                    }
+                } });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        RouteCache::Statistics stats = cache.getStatistics();
+        return consistent.load() && stats.entries == 50 && stats.hits + stats.misses == 8000 &&
+               stats.hitRate() > 0.9;
+    }
+
+    bool testSystemInvalidatesOnEdit()
+    {
+        TransportationSystem system;
+        system.addLocation("Blok_M", -6.244, 106.800);
+        system.addLocation("Senayan", -6.227, 106.802);
+        system.addLocation("Kota", -6.137, 106.814);
+        system.addRoute("Blok_M", "Senayan", 2500, 6, 3500, 0, "mrt");
+        system.addRoute("Senayan", "Kota", 9000, 25, 5000, 0, "mrt");
+        system.clearRouteCache();
+
+        RouteResult first = system.findRoute("Blok_M", "Kota", "time");
+        RouteResult second = system.findRoute("Blok_M", "Kota", "time");
+        RouteCache::Statistics warm = system.getRouteCacheStatistics();
+
+        system.addRoute("Blok_M", "Kota", 12000, 20, 9000, 1, "bus");
+        RouteResult afterEdit = system.findRoute("Blok_M", "Kota", "time");
+        RouteCache::Statistics edited = system.getRouteCacheStatistics();
+
+        return first.totalTime == 31 && second.totalTime == 31 && warm.hits == 1 && warm.misses == 1 &&
+               afterEdit.totalTime == 20 && edited.misses == 2 && edited.entries == 1;
+    }
+
+    bool testSystemMissesAfterAlgorithmSwitch()
+    {
+        TransportationSystem system;
+        system.addLocation("Blok_M", -6.244, 106.800);
+        system.addLocation("Senayan", -6.227, 106.802);
+        system.addRoute("Blok_M", "Senayan", 2500, 6, 3500, 0, "mrt");
+        system.clearRouteCache();
+
+        system.setAlgorithm("dijkstra");
+        system.findRoute("Blok_M", "Senayan", "time");
+        system.setAlgorithm("dijkstra");
+        system.findRoute("Blok_M", "Senayan", "time");
+        RouteCache::Statistics same = system.getRouteCacheStatistics();
+
+        system.setAlgorithm("delta_stepping");
+        RouteResult switched = system.findRoute("Blok_M", "Senayan", "time");
+        RouteCache::Statistics after = system.getRouteCacheStatistics();
+        return same.hits == 1 && same.misses == 1 && switched.totalTime == 6 && after.hits == 1 &&
+               after.misses == 2 && after.entries == 1;
+    }
+
+    // Edits through a kept getMutableNetwork() pointer must reach the concurrent query pool too
+    bool testRouteServiceFollowsKeptReference()
+    {
+        TransportationSystem system;
+        system.addLocation("Blok_M", -6.244, 106.800);
+        system.addLocation("Senayan", -6.227, 106.802);
+        system.addRoute("Blok_M", "Senayan", 2500, 6, 3500, 0, "mrt");
+        Graph &network = *system.getMutableNetwork();
+
+        bool before = system.findRouteAsync("Blok_M", "Kota", "time").get().isValid;
+        network.addNode("Kota", -6.137, 106.814);
+        network.addEdge("Senayan", "Kota", 9000, 25, 5000, 0, "mrt");
+        RouteResult after = system.findRouteAsync("Blok_M", "Kota", "time").get();
+        return !before && after.isValid && after.totalTime == 31 &&
+               system.getRouteService().getSnapshot()->getVersion() == network.getVersion();
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nRoute Cache Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Graph Version Stamps", testGraphVersion());
+        runTest("Cache Hit, Miss And Version Key", testHitMissAndVersionKey());
+        runTest("LRU Eviction Within Budget", testLruEvictionWithinBudget());
+        runTest("Concurrent Cache Access", testConcurrentAccess());
+        runTest("System Invalidates On Edit", testSystemInvalidatesOnEdit());
+        runTest("System Misses After Algorithm Switch", testSystemMissesAfterAlgorithmSwitch());
+        runTest("Route Service Follows Kept Reference", testRouteServiceFollowsKeptReference());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runRouteCacheTests()
+{
+    RouteCacheTestRunner testRunner;
+    testRunner.runAllTests();
+}
@@ -0,0 +1,377 @@
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/core/Graph.h"
+#include "../../include/core/GraphSnapshot.h"
+#include "../../include/algorithms/DijkstraStrategy.h"
+#include "../../include/algorithms/RouteService.h"
+#include "../../include/algorithms/ShortestPathTreeCache.h"
+#include "../../include/core/VersionedGraph.h"
+#include "test_graphs.h"
+
+/**
+ * @file test_route_service.cpp
+ * @brief Unit tests for the graph snapshot and the concurrent route service
+ */
+
+class RouteServiceTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    static bool sameCost(const RouteResult &a, const RouteResult &b, const std::string &criteria)
+    {
+        if (a.isValid != b.isValid)
+            return false;
+        if (!a.isValid)
+            return true;
+        // Ties may pick different paths, so compare the optimised total only
+        if (criteria == "distance")
+            return a.totalDistance == b.totalDistance;
+        if (criteria == "cost")
+            return a.totalCost == b.totalCost;
+        if (criteria == "transfers")
+            return a.totalTransfers == b.totalTransfers;
+        return a.totalTime == b.totalTime;
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testSnapshotLayout()
+    {
+        Graph graph;
+        graph.addNode("A", 0.0, 0.0);
+        graph.addNode("B", 1.0, 1.0);
+        graph.addNode("C", 2.0, 2.0);
+        graph.addEdge("A", "B", 1000, 5, 2000, 0, "walk");
+        graph.addEdge("A", "C", 3000, 9, 4000, 1, "train");
+
+        GraphSnapshot snapshot(graph);
+        GraphSnapshot::EdgeRange edges = snapshot.getEdges(snapshot.findNode("A"));
+        return snapshot.getNodeCount() == 3 && snapshot.getEdgeCount() == 2 && edges.size() == 2 &&
+               edges.getWeight(1, GraphSnapshot::Criterion::Cost) == 4000 &&
+               snapshot.getModeName(edges.modes[1]) == "train" &&
+               snapshot.findNode("missing") == GraphSnapshot::INVALID_NODE &&
+               GraphSnapshot::parseCriterion("composite") == GraphSnapshot::Criterion::Time;
+    }
+
+    bool testMatchesDijkstraConcurrently()
+    {
+        Graph graph = createRandomGraph(300, 3, 20240601);
+        auto snapshot = std::make_shared<const GraphSnapshot>(graph);
+        RouteService service(snapshot, 4);
+
+        const std::vector<std::string> criteria = {"time", "distance", "cost", "transfers"};
+        std::vector<RouteService::Query> queries;
+        for (int i = 0; i < 400; ++i)
+            queries.push_back({"S" + std::to_string((i * 7) % 300), "S" + std::to_string((i * 13 + 5) % 300),
+                               criteria[i % criteria.size()]});
+
+        auto futures = service.submitBatch(queries);
+        DijkstraStrategy reference;
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            RouteResult expected = reference.findRoute(graph, queries[i].start, queries[i].end, queries[i].criteria);
+            if (!sameCost(futures[i].get(), expected, queries[i].criteria))
+                return false;
+        }
+        return service.getCompletedQueries() == queries.size() && service.getThreadCount() == 4;
+    }
+
+    bool testSnapshotSwap()
+    {
+        Graph graph;
+        graph.addNode("A", 0.0, 0.0);
+        graph.addNode("B", 1.0, 1.0);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 2);
+        RouteResult before = service.findRoute("A", "B");
+
+        graph.addEdge("A", "B", 1000, 5, 2000, 0, "walk");
+        service.setSnapshot(std::make_shared<const GraphSnapshot>(graph));
+        RouteResult after = service.findRoute("A", "B");
+        RouteResult unknown = service.findRoute("A", "Z");
+
+        return !before.isValid && after.isValid && after.path.size() == 2 &&
+               after.totalTime == 5 && !unknown.isValid;
+    }
+
+    bool testThreadCountFromConfig()
+    {
+        return RouteService::threadCountFromConfig("config/system_settings.conf") == 4 &&
+               RouteService::threadCountFromConfig("config/missing.conf") == 0;
+    }
+
+    bool testDeadlineAndCancellation()
+    {
+        // A->B is unreachable, so an unbounded search settles the whole network
+        Graph graph = createRandomGraph(2000, 3, 20240601);
+        graph.addNode("Island", -6.9, 107.5);
+        DijkstraStrategy dijkstra;
+        auto snapshot = std::make_shared<const GraphSnapshot>(graph);
+        RouteService::SearchWorkspace workspace;
+
+        CancellationToken expired = CancellationToken::withTimeout(std::chrono::milliseconds(0));
+        CancellationToken cancelled = CancellationToken::cancellable();
+        CancellationToken copy = cancelled;
+        copy.cancel();
+
+        RouteResult unbounded = dijkstra.findRoute(graph, "S0", "Island", "time");
+        RouteResult timedOut = dijkstra.findRoute(graph, "S0", "Island", "time", expired);
+        RouteResult stopped = RouteService::search(*snapshot, workspace, "S0", "Island", "time", cancelled);
+        RouteResult snapshotTimedOut = RouteService::search(*snapshot, workspace, "S0", "Island", "time", expired);
+        RouteResult reachable = dijkstra.findRoute(graph, "S0", "S1", "time");
+
+        return unbounded.status == RouteStatus::NotFound && timedOut.status == RouteStatus::TimedOut &&
+               !timedOut.isValid && stopped.status == RouteStatus::Cancelled &&
+               snapshotTimedOut.status == RouteStatus::TimedOut &&
+               reachable.isValid == (reachable.status == RouteStatus::Found);
+    }
+
+    bool testExpiredQueriesAreShed()
+    {
+        Graph graph = createRandomGraph(200, 3, 20240601);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 2);
+
+        std::vector<RouteService::Query> queries(50, RouteService::Query{"S1", "S150", "time"});
+        auto futures = service.submitBatch(queries, CancellationToken::withTimeout(std::chrono::milliseconds(0)));
+        for (auto &future : futures)
+        {
+            RouteResult result = future.get();
+            if (result.status != RouteStatus::TimedOut || !result.path.empty())
+                return false;
+        }
+        return service.findRoute("S1", "S150").status != RouteStatus::TimedOut;
+    }
+
+    bool testHotOriginServedFromTree()
+    {
+        Graph graph = createRandomGraph(300, 3, 20240601);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 2);
+        service.getTreeCache().setHotThreshold(3);
+        DijkstraStrategy reference;
+
+        // Sequential so the tree is built exactly once, by the third query
+        for (int i = 0; i < 60; ++i)
+        {
+            std::string end = "S" + std::to_string((i * 37 + 1) % 300);
+            RouteResult expected = reference.findRoute(graph, "S5", end, "time");
+            RouteResult actual = service.findRoute("S5", end, "time");
+            if (!sameCost(actual, expected, "time") || actual.status != expected.status)
+                return false;
+        }
+
+        ShortestPathTreeCache::Statistics stats = service.getTreeCache().getStatistics();
+        return stats.treesBuilt == 1 && stats.trees == 1 && stats.hits == 57 && stats.misses == 3;
+    }
+
+    bool testTreesFollowGraphVersion()
+    {
+        Graph graph;
+        graph.addNode("Stadium", -6.218, 106.802);
+        graph.addNode("Senayan", -6.227, 106.802);
+        graph.addNode("Kota", -6.137, 106.814);
+        graph.addEdge("Stadium", "Senayan", 900, 10, 0, 0, "walk");
+        graph.addEdge("Senayan", "Kota", 9000, 25, 5000, 0, "mrt");
+
+        auto versions = std::make_shared<VersionedGraph>(graph);
+        RouteService service(versions, 1);
+        service.getTreeCache().setHotThreshold(1);
+
+        RouteResult before = service.findRoute("Stadium", "Kota");
+        bool cachedBefore = service.getTreeCache().getStatistics().trees == 1;
+        versions->addEdge("Stadium", "Kota", 12000, 20, 9000, 1, "bus");
+        RouteResult after = service.findRoute("Stadium", "Kota");
+        ShortestPathTreeCache::Statistics stats = service.getTreeCache().getStatistics();
+
+        return cachedBefore && before.totalTime == 35 && after.totalTime == 20 && after.path.size() == 2 &&
+               stats.treesBuilt == 2 && stats.trees == 1;
+    }
+
+    bool testTreeCacheMemoryCap()
+    {
+        ShortestPathTreeCache cache(3000, 1);
+        auto makeTree = [](uint32_t source)
+        {
+            auto tree = std::make_shared<ShortestPathTreeCache::Tree>();
+            tree->graphVersion = 1;
+            tree->source = source;
+            tree->distance.assign(100, 0);
+            tree->parentNode.assign(100, 0);
+            tree->parentEdge.assign(100, 0);
+            return tree;
+        };
+
+        for (uint32_t source = 0; source < 5; ++source)
+        {
+            bool shouldBuild = false;
+            cache.acquire(1, source, GraphSnapshot::Criterion::Time, shouldBuild);
+            if (!shouldBuild)
+                return false;
+            cache.publish(makeTree(source));
+        }
+
+        bool shouldBuild = false;
+        bool newestKept = cache.acquire(1, 4, GraphSnapshot::Criterion::Time, shouldBuild) != nullptr;
+        bool oldestEvicted = cache.acquire(1, 0, GraphSnapshot::Criterion::Time, shouldBuild) == nullptr;
+        ShortestPathTreeCache::Statistics stats = cache.getStatistics();
+        return newestKept && oldestEvicted && stats.bytes <= 3000 && stats.evictions >= 3 && stats.treesBuilt == 5;
+    }
+
+    bool testIdenticalQueriesCoalesce()
+    {
+        Graph graph = createRandomGraph(200, 3, 20240601);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 1);
+        service.getTreeCache().setMemoryBudget(0);
+
+        // Hold the only worker so the burst piles up behind the first query
+        std::promise<void> release;
+        std::shared_future<void> gate = release.get_future().share();
+        service.getScheduler().submit([gate]
+                                      { gate.wait(); });
+
+        std::vector<std::future<RouteResult>> burst;
+        for (int i = 0; i < 20; ++i)
+            burst.push_back(service.submit("S3", "S120", "time"));
+        // The leader gives up at once, its follower still has time and must be retried
+        std::future<RouteResult> expiredLeader =
+            service.submit("S4", "S120", "time", CancellationToken::withTimeout(std::chrono::milliseconds(0)));
+        std::future<RouteResult> patientFollower = service.submit("S4", "S120", "time");
+        std::future<RouteResult> other = service.submit("S120", "S3", "time");
+        release.set_value();
+
+        DijkstraStrategy reference;
+        RouteResult expected = reference.findRoute(graph, "S3", "S120", "time");
+        bool shared = true;
+        for (auto &future : burst)
+            shared = shared && sameCost(future.get(), expected, "time");
+
+        RouteResult retried = patientFollower.get();
+        return shared && expiredLeader.get().status == RouteStatus::TimedOut &&
+               sameCost(retried, reference.findRoute(graph, "S4", "S120", "time"), "time") &&
+               retried.status != RouteStatus::TimedOut &&
+               sameCost(other.get(), reference.findRoute(graph, "S120", "S3", "time"), "time") &&
+               service.getCoalescedQueries() == 20 && service.getCompletedQueries() == 23;
+    }
+
+    // A follower with a short deadline must not wait out a leader that has none
+    bool testFollowerKeepsItsDeadline()
+    {
+        Graph graph = createRandomGraph(200, 3, 20240601);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 1);
+        service.getTreeCache().setMemoryBudget(0);
+
+        // Hold the only worker, and wait until it is held, so the leader cannot run first
+        std::promise<void> release;
+        std::shared_future<void> gate = release.get_future().share();
+        auto held = std::make_shared<std::promise<void>>();
+        std::future<void> holding = held->get_future();
+        service.getScheduler().submit([gate, held]
+                                      { held->set_value(); gate.wait(); });
+        holding.wait();
+
+        std::future<RouteResult> leader = service.submit("S3", "S120", "time");
+        std::future<RouteResult> hurried =
+            service.submit("S3", "S120", "time", CancellationToken::withTimeout(std::chrono::milliseconds(20)));
+        CancellationToken cancellation = CancellationToken::cancellable();
+        std::future<RouteResult> cancelled = service.submit("S3", "S120", "time", cancellation);
+        std::future<RouteResult> patient = service.submit("S3", "S120", "time");
+        cancellation.cancel();
+
+        // Both stopped followers complete while the leader is still stuck behind the gate
+        bool hurriedDone = hurried.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+        bool cancelledDone = cancelled.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+        bool leaderWaiting = leader.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready;
+        release.set_value();
+
+        RouteResult timedOut = hurried.get();
+        RouteResult expected = DijkstraStrategy().findRoute(graph, "S3", "S120", "time");
+        return hurriedDone && cancelledDone && leaderWaiting && timedOut.status == RouteStatus::TimedOut &&
+               !timedOut.isValid && timedOut.criteria == "time" &&
+               cancelled.get().status == RouteStatus::Cancelled && sameCost(leader.get(), expected, "time") &&
+               sameCost(patient.get(), expected, "time") && service.getCompletedQueries() == 4;
+    }
+
+    // Destroying the service must answer queued leaders and retry their followers
+    bool testDestroyWithCoalescedQueries()
+    {
+        Graph graph = createRandomGraph(200, 3, 20240601);
+        std::vector<std::future<RouteResult>> followers;
+        std::future<RouteResult> expiredLeader;
+        std::thread releaser;
+        {
+            RouteService service(std::make_shared<const GraphSnapshot>(graph), 1);
+            service.getTreeCache().setMemoryBudget(0);
+
+            std::promise<void> release;
+            std::shared_future<void> gate = release.get_future().share();
+            service.getScheduler().submit([gate]
+                                          { gate.wait(); });
+
+            expiredLeader =
+                service.submit("S4", "S120", "time", CancellationToken::withTimeout(std::chrono::milliseconds(0)));
+            for (int i = 0; i < 5; ++i)
+                followers.push_back(service.submit("S4", "S120", "time"));
+            // Let the destructor start before the leader runs
+            releaser = std::thread([release = std::move(release)]() mutable
+                                   {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                release.set_value(); });
+        }
+        releaser.join();
+
+        RouteResult expected = DijkstraStrategy().findRoute(graph, "S4", "S120", "time");
+        bool answered = expiredLeader.get().status == RouteStatus::TimedOut;
+        for (auto &follower : followers)
+            answered = answered && sameCost(follower.get(), expected, "time");
+        return answered;
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nRoute Service Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Snapshot CSR Layout", testSnapshotLayout());
+        runTest("Service Matches Dijkstra Concurrently", testMatchesDijkstraConcurrently());
+        runTest("Service Snapshot Swap", testSnapshotSwap());
+        runTest("Service Thread Count From Config", testThreadCountFromConfig());
+        runTest("Deadline And Cancellation", testDeadlineAndCancellation());
+        runTest("Expired Queries Are Shed", testExpiredQueriesAreShed());
+        runTest("Hot Origin Served From Tree", testHotOriginServedFromTree());
+        runTest("Trees Follow Graph Version", testTreesFollowGraphVersion());
+        runTest("Tree Cache Memory Cap", testTreeCacheMemoryCap());
+        runTest("Identical Queries Coalesce", testIdenticalQueriesCoalesce());
+        runTest("Follower Keeps Its Deadline", testFollowerKeepsItsDeadline());
+        runTest("Destroy With Coalesced Queries", testDestroyWithCoalescedQueries());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runRouteServiceTests()
+{
+    RouteServiceTestRunner testRunner;
+    testRunner.runAllTests();
+}
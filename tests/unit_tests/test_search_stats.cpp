@@ -0,0 +1,142 @@
+#include <iostream>
+#include <string>
+#include "../../include/core/Graph.h"
+#include "../../include/core/TransportationSystem.h"
+#include "../../include/algorithms/DeltaSteppingStrategy.h"
+#include "../../include/algorithms/DijkstraStrategy.h"
+#include "../../include/algorithms/SearchStats.h"
+#include "../../include/utils/Histogram.h"
+#include "test_graphs.h"
+
+/**
+ * @file test_search_stats.cpp
+ * @brief Unit tests for per-query search statistics and their histograms
+ */
+
+class SearchStatsTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    // Invariants every search must satisfy, whatever its queue
+    static bool consistent(const SearchStats &stats, size_t nodeCount)
+    {
+        return stats.nodesSettled > 0 && stats.nodesSettled <= nodeCount && stats.heapPops <= stats.heapPushes &&
+               stats.stalePops <= stats.heapPops && stats.nodesSettled + stats.stalePops <= stats.heapPops &&
+               stats.peakQueueSize >= 1 && stats.peakQueueSize <= stats.heapPushes &&
+               stats.edgesRelaxed >= stats.heapPushes - 1 && stats.phaseSeconds[SearchStats::Search] > 0.0 &&
+               stats.totalSeconds() >= stats.phaseSeconds[SearchStats::Search];
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testDijkstraCounters()
+    {
+        Graph graph = createRandomGraph(400, 3, 5);
+        DijkstraStrategy dijkstra;
+        for (int i = 0; i < 10; ++i)
+        {
+            std::string start = "S" + std::to_string(i * 13), end = "S" + std::to_string(i * 29 + 7);
+            SearchStats stats;
+            stats.nodesSettled = 12345; // Must be reset by the search
+            RouteResult instrumented = dijkstra.findRoute(graph, start, end, "time", CancellationToken(), &stats);
+            RouteResult plain = dijkstra.findRoute(graph, start, end, "time");
+            if (instrumented.isValid != plain.isValid || instrumented.totalTime != plain.totalTime ||
+                !consistent(stats, graph.getNodeCount()))
+                return false;
+        }
+        return true;
+    }
+
+    bool testDeltaSteppingCounters()
+    {
+        Graph graph = createRandomGraph(2000, 3, 5);
+        DeltaSteppingStrategy strategy(10);
+        SearchStats stats;
+        RouteResult route = strategy.findRoute(graph, "S0", "S1500", "time", CancellationToken(), &stats);
+        return route.isValid == DijkstraStrategy().findRoute(graph, "S0", "S1500", "time").isValid &&
+               consistent(stats, graph.getNodeCount());
+    }
+
+    bool testHistogram()
+    {
+        transport::utils::Histogram histogram;
+        if (histogram.getPercentile(0.5) != 0 || histogram.getMin() != 0)
+            return false;
+        for (uint64_t value = 1; value <= 1000; ++value)
+            histogram.record(value);
+        histogram.record(0);
+
+        transport::utils::Histogram other;
+        other.record(5000);
+        histogram.merge(other);
+
+        // Within one sub-bucket (1/32) of the exact median
+        uint64_t p50 = histogram.getPercentile(0.5);
+        transport::utils::Histogram copy = histogram;
+        return histogram.getCount() == 1002 && histogram.getMin() == 0 && histogram.getMax() == 5000 &&
+               histogram.getSum() == 500500 + 5000 && p50 >= 500 && p50 <= 516 &&
+               histogram.getPercentile(1.0) == 5000 && histogram.getBucketCount(0) == 1 &&
+               copy.getCount() == 1002 && copy.getPercentile(0.5) == p50 && copy.getMin() == 0;
+    }
+
+    bool testSystemAggregates()
+    {
+        TransportationSystem system;
+        system.setRouteCacheBudget(0);
+        system.addLocation("A", 0.0, 0.0);
+        system.addLocation("B", 0.0, 0.1);
+        system.addLocation("C", 0.0, 0.2);
+        system.addRoute("A", "B", 100, 5, 1000, 0, "walk");
+        system.addRoute("B", "C", 100, 5, 1000, 0, "walk");
+
+        system.findRoute("A", "C", "time"); // Not recorded: statistics are off
+        system.setSearchStatsEnabled(true);
+        for (int i = 0; i < 5; ++i)
+            system.findRoute("A", "C", "time");
+
+        const SearchStatsCollector &collected = system.getSearchStatistics();
+        transport::utils::Histogram settled = collected.getHistogram(SearchStatsCollector::NodesSettled);
+        bool recorded = collected.getQueries() == 5 && settled.getCount() == 5 && settled.getMin() >= 2 &&
+                        collected.report().find("edges_relaxed") != std::string::npos;
+        system.resetSearchStatistics();
+        return recorded && collected.getQueries() == 0 && system.isSearchStatsEnabled();
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nSearch Stats Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Dijkstra Counters", testDijkstraCounters());
+        runTest("Delta Stepping Counters", testDeltaSteppingCounters());
+        runTest("Histogram", testHistogram());
+        runTest("System Aggregates", testSystemAggregates());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runSearchStatsTests()
+{
+    SearchStatsTestRunner testRunner;
+    testRunner.runAllTests();
+}
@@ -0,0 +1,489 @@
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../../include/core/Graph.h"
+#include "../../include/core/Node.h"
+#include "../../include/algorithms/DijkstraStrategy.h"
+#include "../../include/algorithms/StrategyRegistry.h"
+
+/**
+ * @file test_strategy_differential.cpp
+ * @brief Differential fuzz tests of every registered RouteStrategy against Dijkstra
+ *
+ * Each case is a random directed graph and one query. A strategy passes a case when it
+ * agrees with the reference on whether a route exists, returns a path of existing edges
+ * from start to end, reports the totals of that path, and matches the reference's total
+ * for the criterion. A failing case is shrunk until no single edge, unused node or
+ * weight reduction can go, and printed together with the seed that produced it.
+ */
+
+namespace
+{
+    const unsigned FUZZ_SEED = 20240611;
+    const int FUZZ_CASES = 250;
+    const char *const CRITERIA[] = {"distance", "time", "cost", "transfers"};
+
+    struct FuzzEdge
+    {
+        int from;
+        int to;
+        int distance;
+        int time;
+        int cost;
+        int transfers;
+    };
+
+    struct FuzzCase
+    {
+        std::vector<std::pair<double, double>> coordinates;
+        std::vector<FuzzEdge> edges;
+        int start = 0;
+        int end = 0;
+        std::string criterion = "time";
+    };
+
+    std::string nodeName(int index)
+    {
+        return "N" + std::to_string(index);
+    }
+
+    // Shortest distance an edge may have: the straight line, so heuristics stay admissible
+    int minimumDistance(const FuzzCase &fuzzCase, int from, int to)
+    {
+        Node source(nodeName(from), fuzzCase.coordinates[from].first, fuzzCase.coordinates[from].second);
+        Node destination(nodeName(to), fuzzCase.coordinates[to].first, fuzzCase.coordinates[to].second);
+        return static_cast<int>(std::ceil(source.distanceTo(destination)));
+    }
+
+    // Shortest time for a distance: no vehicle is faster than 60 km/h
+    int minimumTime(int distance)
+    {
+        return (distance + 999) / 1000;
+    }
+
+    /**
+     * @brief Random graph of 2 to 24 stops with a random query
+     *
+     * Some stops share coordinates, as interchanges do, so zero distances and times occur;
+     * costs and transfers are often zero as well. Queries may be unreachable or start == end.
+     */
+    FuzzCase generateCase(std::mt19937 &random)
+    {
+        FuzzCase fuzzCase;
+        int nodeCount = std::uniform_int_distribution<int>(2, 24)(random);
+        std::uniform_real_distribution<double> offset(0.0, 0.1);
+        std::uniform_int_distribution<int> pickNode(0, nodeCount - 1);
+        for (int i = 0; i < nodeCount; ++i)
+        {
+            if (i > 0 && random() % 6 == 0)
+                fuzzCase.coordinates.push_back(fuzzCase.coordinates[pickNode(random) % i]);
+            else
+                fuzzCase.coordinates.push_back({-6.3 + offset(random), 106.7 + offset(random)});
+        }
+
+        int edgeCount = std::uniform_int_distribution<int>(0, nodeCount * 3)(random);
+        std::set<std::pair<int, int>> used;
+        for (int k = 0; k < edgeCount; ++k)
+        {
+            int from = pickNode(random);
+            int to = pickNode(random);
+            if (from == to || !used.insert({from, to}).second)
+                continue;
+            FuzzEdge edge;
+            edge.from = from;
+            edge.to = to;
+            edge.distance = minimumDistance(fuzzCase, from, to) +
+                            (random() % 3 == 0 ? 0 : std::uniform_int_distribution<int>(0, 3000)(random));
+            edge.time = minimumTime(edge.distance) +
+                        (random() % 3 == 0 ? 0 : std::uniform_int_distribution<int>(0, 15)(random));
+            edge.cost = random() % 3 == 0 ? 0 : std::uniform_int_distribution<int>(1, 20)(random) * 500;
+            edge.transfers = std::uniform_int_distribution<int>(0, 2)(random);
+            fuzzCase.edges.push_back(edge);
+        }
+
+        fuzzCase.start = pickNode(random);
+        fuzzCase.end = random() % 10 == 0 ? fuzzCase.start : pickNode(random);
+        fuzzCase.criterion = CRITERIA[random() % 4];
+        return fuzzCase;
+    }
+
+    Graph buildGraph(const FuzzCase &fuzzCase)
+    {
+        // Bulk insert: one graph version per case and no per-element console output
+        std::vector<Node> nodes;
+        nodes.reserve(fuzzCase.coordinates.size());
+        for (size_t i = 0; i < fuzzCase.coordinates.size(); ++i)
+            nodes.emplace_back(nodeName(static_cast<int>(i)), fuzzCase.coordinates[i].first,
+                               fuzzCase.coordinates[i].second);
+        std::vector<Edge> edges;
+        edges.reserve(fuzzCase.edges.size());
+        for (const FuzzEdge &edge : fuzzCase.edges)
+            edges.emplace_back(nodeName(edge.from), nodeName(edge.to), edge.distance, edge.time, edge.cost,
+                               edge.transfers, "bus");
+
+        Graph graph;
+        graph.addNodes(nodes);
+        graph.addEdges(edges);
+        return graph;
+    }
+
+    double criterionTotal(const RouteResult &result, const std::string &criterion)
+    {
+        if (criterion == "distance")
+            return result.totalDistance;
+        if (criterion == "cost")
+            return result.totalCost;
+        if (criterion == "transfers")
+            return result.totalTransfers;
+        return result.totalTime;
+    }
+
+    /**
+     * @brief Run one case through the candidate and the reference
+     * @return Empty if the candidate passes, otherwise what it got wrong
+     */
+    std::string findMismatch(const FuzzCase &fuzzCase, RouteStrategy &candidate)
+    {
+        Graph graph = buildGraph(fuzzCase);
+        std::string start = nodeName(fuzzCase.start);
+        std::string end = nodeName(fuzzCase.end);
+        DijkstraStrategy reference;
+        RouteResult expected = reference.findRoute(graph, start, end, fuzzCase.criterion);
+        RouteResult actual;
+        try
+        {
+            actual = candidate.findRoute(graph, start, end, fuzzCase.criterion);
+        }
+        catch (const std::exception &e)
+        {
+            return std::string("threw: ") + e.what();
+        }
+
+        if (actual.isValid != (actual.status == RouteStatus::Found))
+            return "isValid disagrees with status";
+        if (actual.isValid != expected.isValid)
+            return expected.isValid ? "found no route, reference did" : "found a route, reference did not";
+        if (!actual.isValid)
+            return "";
+
+        if (actual.path.empty() || actual.path.front() != start || actual.path.back() != end)
+            return "path does not run from start to end";
+        RouteResult walked;
+        for (size_t i = 0; i + 1 < actual.path.size(); ++i)
+        {
+            if (!graph.hasEdge(actual.path[i], actual.path[i + 1]))
+                return "path uses missing edge " + actual.path[i] + " -> " + actual.path[i + 1];
+            Edge edge = graph.getEdge(actual.path[i], actual.path[i + 1]);
+            walked.totalDistance += edge.getDistance();
+            walked.totalTime += edge.getTime();
+            walked.totalCost += edge.getCost();
+            walked.totalTransfers += edge.getTransfers();
+        }
+        if (walked.totalDistance != actual.totalDistance || walked.totalTime != actual.totalTime ||
+            walked.totalCost != actual.totalCost || walked.totalTransfers != actual.totalTransfers)
+            return "reported totals differ from the path's";
+
+        double optimal = criterionTotal(expected, fuzzCase.criterion);
+        double total = criterionTotal(actual, fuzzCase.criterion);
+        if (total != optimal)
+        {
+            std::ostringstream message;
+            message << fuzzCase.criterion << " total " << total << ", reference " << optimal;
+            return message.str();
+        }
+        return "";
+    }
+
+    // Renumber the nodes that edges or the query use, dropping the rest
+    FuzzCase dropUnusedNodes(const FuzzCase &fuzzCase)
+    {
+        std::unordered_map<int, int> renumbered;
+        FuzzCase compact;
+        auto keep = [&](int index)
+        {
+            auto found = renumbered.find(index);
+            if (found != renumbered.end())
+                return found->second;
+            int next = static_cast<int>(compact.coordinates.size());
+            renumbered[index] = next;
+            compact.coordinates.push_back(fuzzCase.coordinates[index]);
+            return next;
+        };
+        compact.start = keep(fuzzCase.start);
+        compact.end = keep(fuzzCase.end);
+        compact.criterion = fuzzCase.criterion;
+        for (FuzzEdge edge : fuzzCase.edges)
+        {
+            edge.from = keep(edge.from);
+            edge.to = keep(edge.to);
+            compact.edges.push_back(edge);
+        }
+        return compact;
+    }
+
+    /**
+     * @brief Greedily shrink a failing case while it keeps failing
+     *
+     * Removes edges one at a time, then unused nodes, then lowers each weight to its
+     * floor or halfway there, repeating until nothing changes. Distances and times never
+     * go below the bounds the generator keeps, so the result is still a valid case.
+     */
+    FuzzCase minimize(FuzzCase fuzzCase, RouteStrategy &candidate)
+    {
+        auto fails = [&candidate](const FuzzCase &attempt)
+        { return !findMismatch(attempt, candidate).empty(); };
+
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (size_t i = fuzzCase.edges.size(); i-- > 0;)
+            {
+                FuzzCase attempt = fuzzCase;
+                attempt.edges.erase(attempt.edges.begin() + static_cast<long>(i));
+                if (fails(attempt))
+                {
+                    fuzzCase = attempt;
+                    changed = true;
+                }
+            }
+
+            FuzzCase compact = dropUnusedNodes(fuzzCase);
+            if (compact.coordinates.size() < fuzzCase.coordinates.size() && fails(compact))
+            {
+                fuzzCase = compact;
+                changed = true;
+            }
+
+            for (size_t i = 0; i < fuzzCase.edges.size(); ++i)
+            {
+                const FuzzEdge edge = fuzzCase.edges[i];
+                // The time floor follows the distance before shrinking, so it stays valid
+                std::vector<std::pair<int FuzzEdge::*, int>> weights = {
+                    {&FuzzEdge::distance, minimumDistance(fuzzCase, edge.from, edge.to)},
+                    {&FuzzEdge::time, minimumTime(edge.distance)},
+                    {&FuzzEdge::cost, 0},
+                    {&FuzzEdge::transfers, 0}};
+                for (const auto &weight : weights)
+                {
+                    int current = fuzzCase.edges[i].*weight.first;
+                    for (int smaller : {weight.second, weight.second + (current - weight.second) / 2})
+                    {
+                        if (smaller >= current)
+                            continue;
+                        FuzzCase attempt = fuzzCase;
+                        attempt.edges[i].*weight.first = smaller;
+                        if (fails(attempt))
+                        {
+                            fuzzCase = attempt;
+                            changed = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        return fuzzCase;
+    }
+
+    std::string describeCase(const FuzzCase &fuzzCase)
+    {
+        std::ostringstream text;
+        text.precision(9);
+        for (size_t i = 0; i < fuzzCase.coordinates.size(); ++i)
+            text << "    node " << nodeName(static_cast<int>(i)) << " " << fuzzCase.coordinates[i].first << ","
+                 << fuzzCase.coordinates[i].second << "\n";
+        for (const FuzzEdge &edge : fuzzCase.edges)
+            text << "    edge " << nodeName(edge.from) << " -> " << nodeName(edge.to) << " distance=" << edge.distance
+                 << " time=" << edge.time << " cost=" << edge.cost << " transfers=" << edge.transfers << "\n";
+        text << "    query " << nodeName(fuzzCase.start) << " -> " << nodeName(fuzzCase.end) << " by "
+             << fuzzCase.criterion << "\n";
+        return text.str();
+    }
+
+    // Fewest hops instead of least weight: valid paths, wrong totals on purpose
+    class FewestHopsStrategy : public RouteStrategy
+    {
+    public:
+        RouteResult findRoute(const Graph &graph, const std::string &start, const std::string &end,
+                              const std::string &criteria, const CancellationToken &, SearchStats *) override
+        {
+            RouteResult result;
+            result.criteria = criteria;
+            std::unordered_map<std::string, std::string> predecessors;
+            std::queue<std::string> frontier;
+            frontier.push(start);
+            predecessors[start] = "";
+            while (!frontier.empty() && !predecessors.count(end))
+            {
+                std::string node = frontier.front();
+                frontier.pop();
+                for (const Edge &edge : graph.getEdgesFrom(node))
+                {
+                    if (predecessors.emplace(edge.getDestination(), node).second)
+                        frontier.push(edge.getDestination());
+                }
+            }
+            if (!predecessors.count(end))
+                return result;
+
+            result.path = reconstructPath(predecessors, start, end);
+            for (size_t i = 0; i + 1 < result.path.size(); ++i)
+            {
+                Edge edge = graph.getEdge(result.path[i], result.path[i + 1]);
+                result.totalDistance += edge.getDistance();
+                result.totalTime += edge.getTime();
+                result.totalCost += edge.getCost();
+                result.totalTransfers += edge.getTransfers();
+            }
+            result.isValid = true;
+            result.status = RouteStatus::Found;
+            return result;
+        }
+    };
+}
+
+class StrategyDifferentialTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    struct Failure
+    {
+        unsigned seed = 0;
+        std::string reason;
+        FuzzCase minimized;
+    };
+
+    /**
+     * @brief Fuzz one strategy, each case generated from its own seed
+     * @return True if every case passed; otherwise failure holds the first failing case, minimized
+     */
+    bool fuzz(RouteStrategy &candidate, int cases, Failure &failure)
+    {
+        for (int index = 0; index < cases; ++index)
+        {
+            unsigned seed = FUZZ_SEED + static_cast<unsigned>(index);
+            std::mt19937 random(seed);
+            FuzzCase fuzzCase = generateCase(random);
+            if (findMismatch(fuzzCase, candidate).empty())
+                continue;
+            failure.seed = seed;
+            failure.minimized = minimize(fuzzCase, candidate);
+            failure.reason = findMismatch(failure.minimized, candidate);
+            return false;
+        }
+        return true;
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testRegistry()
+    {
+        StrategyRegistry &registry = StrategyRegistry::instance();
+        std::vector<std::string> names = registry.getNames();
+        return !names.empty() && names.front() == StrategyRegistry::REFERENCE &&
+               registry.contains("delta_stepping") &&
+               !registry.add(StrategyRegistry::REFERENCE, []()
+                             { return std::make_unique<DijkstraStrategy>(); }) &&
+               registry.create("no_such_strategy") == nullptr &&
+               registry.create("delta_stepping") != nullptr;
+    }
+
+    bool testRegisteredStrategiesMatchReference()
+    {
+        bool allPassed = true;
+        for (const std::string &name : StrategyRegistry::instance().getNames())
+        {
+            if (name == StrategyRegistry::REFERENCE)
+                continue;
+            std::unique_ptr<RouteStrategy> candidate = StrategyRegistry::instance().create(name);
+            Failure failure;
+            if (!candidate || fuzz(*candidate, FUZZ_CASES, failure))
+                continue;
+            allPassed = false;
+            std::cout << "  " << name << " disagrees with " << StrategyRegistry::REFERENCE << " (seed " << failure.seed
+                      << "): " << failure.reason << "\n"
+                      << describeCase(failure.minimized);
+        }
+        return allPassed;
+    }
+
+    // The harness must catch a plausible bug and shrink it until no single edge can go
+    bool testBrokenStrategyIsMinimized()
+    {
+        FewestHopsStrategy broken;
+        Failure failure;
+        if (fuzz(broken, FUZZ_CASES, failure) || failure.reason.empty())
+            return false;
+
+        std::mt19937 random(failure.seed);
+        bool minimized = failure.minimized.edges.size() < generateCase(random).edges.size() &&
+                         dropUnusedNodes(failure.minimized).coordinates.size() == failure.minimized.coordinates.size();
+        for (size_t i = 0; minimized && i < failure.minimized.edges.size(); ++i)
+        {
+            FuzzCase smaller = failure.minimized;
+            smaller.edges.erase(smaller.edges.begin() + static_cast<long>(i));
+            minimized = findMismatch(smaller, broken).empty();
+        }
+        if (!minimized)
+            std::cout << "  Not minimal (seed " << failure.seed << "): " << failure.reason << "\n"
+                      << describeCase(failure.minimized);
+        return minimized;
+    }
+
+    bool testReferenceAgreesWithItself()
+    {
+        std::mt19937 random(FUZZ_SEED);
+        FuzzCase fuzzCase = generateCase(random);
+        DijkstraStrategy reference;
+        return findMismatch(fuzzCase, reference).empty() &&
+               findMismatch(dropUnusedNodes(fuzzCase), reference).empty();
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nStrategy Differential Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Registry", testRegistry());
+        runTest("Reference Agrees With Itself", testReferenceAgreesWithItself());
+        runTest("Registered Strategies Match Reference", testRegisteredStrategiesMatchReference());
+        runTest("Broken Strategy Is Minimized", testBrokenStrategyIsMinimized());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runStrategyDifferentialTests()
+{
+    StrategyDifferentialTestRunner testRunner;
+    testRunner.runAllTests();
+}
@@ -0,0 +1,258 @@
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/core/Graph.h"
+#include "../../include/core/GraphSnapshot.h"
+#include "../../include/core/TransportationSystem.h"
+#include "../../include/algorithms/RouteService.h"
+#include "../../include/io/TraceLog.h"
+#include "test_graphs.h"
+
+/**
+ * @file test_trace_log.cpp
+ * @brief Unit tests for the binary route query trace
+ */
+
+class TraceLogTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    const std::string TMP_DIR = "tests/tmp/trace";
+
+    std::string freshPath(const std::string &name)
+    {
+        std::filesystem::create_directories(TMP_DIR);
+        std::string path = TMP_DIR + "/" + name + ".trace";
+        std::filesystem::remove(path);
+        return path;
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testConcurrentRecordsRoundTrip()
+    {
+        std::string path = freshPath("roundtrip");
+        const uint64_t perThread = 1000; // Several per-thread buffer flushes each
+        {
+            TraceLog trace(path);
+            if (!trace.open())
+                return false;
+
+            std::vector<std::thread> threads;
+            for (uint64_t t = 0; t < 4; ++t)
+            {
+                threads.emplace_back([&trace, t, perThread]()
+                                     {
+                    for (uint64_t i = 0; i < perThread; ++i)
+                    {
+                        TraceLog::Record record;
+                        record.timestampNanos = TraceLog::nowNanos();
+                        record.queryId = t * perThread + i;
+                        record.threadId = TraceLog::currentThreadId();
+                        record.startNode = static_cast<uint32_t>(i);
+                        record.endNode = static_cast<uint32_t>(t);
+                        record.nodesSettled = static_cast<uint32_t>(i * 3);
+                        record.latencyMicros = 0xFFFFFFF0u;
+                        record.criterion = static_cast<uint8_t>(i % 4);
+                        record.status = static_cast<uint8_t>(t % 4);
+                        record.flags = TraceLog::FLAG_COALESCED;
+                        trace.record(record);
+                    } });
+            }
+            for (auto &thread : threads)
+                thread.join();
+            if (trace.getRecordCount() != 4 * perThread)
+                return false;
+        } // Destructor writes what is still buffered
+
+        // A torn record at the end (crash mid-write) is ignored
+        std::ofstream(path, std::ios::binary | std::ios::app) << "torn";
+
+        std::vector<TraceLog::Record> records;
+        std::string error;
+        if (!TraceLog::readFile(path, records, error) || records.size() != 4 * perThread ||
+            std::filesystem::file_size(path) != TraceLog::HEADER_SIZE + 4 * perThread * TraceLog::RECORD_SIZE + 4)
+            return false;
+
+        std::set<uint64_t> ids;
+        for (const TraceLog::Record &record : records)
+        {
+            uint64_t t = record.queryId / perThread, i = record.queryId % perThread;
+            if (record.startNode != i || record.endNode != t || record.nodesSettled != i * 3 ||
+                record.latencyMicros != 0xFFFFFFF0u || record.criterion != i % 4 || record.status != t % 4 ||
+                record.flags != TraceLog::FLAG_COALESCED || record.threadId == 0)
+                return false;
+            ids.insert(record.queryId);
+        }
+        return ids.size() == 4 * perThread;
+    }
+
+    bool testRejectsForeignFiles()
+    {
+        std::string path = freshPath("foreign");
+        std::ofstream(path) << "timestamp,query,latency\n1,2,3\n";
+        std::vector<TraceLog::Record> records;
+        std::string error;
+        return !TraceLog::readFile(path, records, error) && !error.empty() &&
+               !TraceLog::readFile(TMP_DIR + "/missing.trace", records, error);
+    }
+
+    bool testRouteServiceTracesQueries()
+    {
+        Graph graph = createRandomGraph(300, 3, 44);
+        auto snapshot = std::make_shared<const GraphSnapshot>(graph);
+        std::string path = freshPath("service");
+        auto trace = std::make_shared<TraceLog>(path);
+        if (!trace->open())
+            return false;
+
+        RouteService service(snapshot, 4);
+        service.getTreeCache().setMemoryBudget(0); // Every query searches
+        service.findRoute("S0", "S1"); // Before tracing: not recorded
+        service.setTraceLog(trace);
+
+        std::vector<std::future<RouteResult>> futures;
+        for (int i = 0; i < 40; ++i)
+            futures.push_back(service.submit("S" + std::to_string(i), "S" + std::to_string(299 - i), "cost"));
+        futures.push_back(service.submit("S1", "Nowhere", "time"));
+        std::vector<RouteResult> results;
+        for (auto &future : futures)
+            results.push_back(future.get());
+        service.setTraceLog(nullptr);
+        service.findRoute("S2", "S3"); // After tracing: not recorded
+        trace->flush();
+
+        std::vector<TraceLog::Record> records;
+        std::string error;
+        if (!TraceLog::readFile(path, records, error) || records.size() != futures.size())
+            return false;
+
+        std::set<uint64_t> ids;
+        size_t unknown = 0;
+        for (const TraceLog::Record &record : records)
+        {
+            ids.insert(record.queryId);
+            if (record.endNode == TraceLog::INVALID_NODE)
+            {
+                unknown++;
+                if (record.status != static_cast<uint8_t>(RouteStatus::NotFound) ||
+                    record.criterion != static_cast<uint8_t>(GraphSnapshot::Criterion::Time))
+                    return false;
+                continue;
+            }
+            int i = 0;
+            while (i < 40 && snapshot->findNode("S" + std::to_string(i)) != record.startNode)
+                ++i;
+            if (i == 40 || record.endNode != snapshot->findNode("S" + std::to_string(299 - i)) ||
+                record.nodesSettled == 0 ||
+                record.criterion != static_cast<uint8_t>(GraphSnapshot::Criterion::Cost) ||
+                record.status != static_cast<uint8_t>(results[i].status) || record.timestampNanos == 0)
+                return false;
+        }
+        return unknown == 1 && ids.size() == records.size();
+    }
+
+    bool testSystemTraceFile()
+    {
+        TransportationSystem system;
+        system.addLocation("A", 0.0, 0.0);
+        system.addLocation("B", 0.0, 0.1);
+        system.addRoute("A", "B", 100, 5, 1000, 0, "walk");
+        std::string path = freshPath("system");
+        if (system.setTraceFile(TMP_DIR) || system.getTraceLog()) // A directory cannot be opened
+            return false;
+        if (!system.setTraceFile(path))
+            return false;
+        bool found = system.findRouteAsync("A", "B").get().isValid;
+        std::shared_ptr<TraceLog> trace = system.getTraceLog();
+        trace->flush();
+        bool stopped = system.setTraceFile("") && !system.getTraceLog();
+
+        std::vector<TraceLog::Record> records;
+        std::string error;
+        return found && stopped && TraceLog::readFile(path, records, error) && records.size() == 1 &&
+               records[0].status == static_cast<uint8_t>(RouteStatus::Found);
+    }
+
+    // The synchronous path used by the CLI must trace its queries too
+    bool testSystemTracesFindRoute()
+    {
+        TransportationSystem system;
+        system.addLocation("A", 0.0, 0.0);
+        system.addLocation("B", 0.0, 0.1);
+        system.addLocation("C", 0.0, 0.2);
+        system.addRoute("A", "B", 100, 5, 1000, 0, "walk");
+        system.addRoute("B", "C", 100, 5, 1000, 0, "walk");
+        system.clearRouteCache();
+        std::string path = freshPath("system_sync");
+        if (!system.setTraceFile(path))
+            return false;
+
+        bool found = system.findRoute("A", "C", "time").isValid;
+        bool missing = !system.findRoute("A", "Nowhere", "time").isValid;
+        // "AB" sorts before "B" and "C" and so renumbers them
+        system.addLocation("AB", 0.0, 0.05);
+        bool renumbered = system.findRoute("A", "C", "time").isValid;
+        system.getTraceLog()->flush();
+        system.setTraceFile("");
+        // Ids must match the route service's numbering without tracing having built it
+        GraphSnapshot snapshot(system.getNetwork());
+
+        std::vector<TraceLog::Record> records;
+        std::string error;
+        if (!found || !missing || !renumbered || !TraceLog::readFile(path, records, error) || records.size() != 3)
+            return false;
+        const TraceLog::Record &route = records[0];
+        return route.status == static_cast<uint8_t>(RouteStatus::Found) && route.nodesSettled > 0 &&
+               route.startNode == snapshot.findNode("A") && route.endNode == 2 &&
+               records[2].endNode == snapshot.findNode("C") && snapshot.findNode("C") == 3 &&
+               route.criterion == static_cast<uint8_t>(GraphSnapshot::Criterion::Time) &&
+               records[1].status == static_cast<uint8_t>(RouteStatus::NotFound) &&
+               records[1].endNode == TraceLog::INVALID_NODE && records[0].queryId != records[1].queryId;
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nTrace Log Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Concurrent Records Round Trip", testConcurrentRecordsRoundTrip());
+        runTest("Rejects Foreign Files", testRejectsForeignFiles());
+        runTest("Route Service Traces Queries", testRouteServiceTracesQueries());
+        runTest("System Trace File", testSystemTraceFile());
+        runTest("System Traces findRoute", testSystemTracesFindRoute());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runTraceLogTests()
+{
+    TraceLogTestRunner testRunner;
+    testRunner.runAllTests();
+}
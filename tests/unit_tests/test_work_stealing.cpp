@@ -0,0 +1,255 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/core/Graph.h"
+#include "../../include/core/GraphSnapshot.h"
+#include "../../include/algorithms/DijkstraStrategy.h"
+#include "../../include/algorithms/RouteService.h"
+#include "../../include/algorithms/StrategyRegistry.h"
+#include "../../include/core/TransportationSystem.h"
+#include "../../include/utils/WorkStealingScheduler.h"
+
+/**
+ * @file test_work_stealing.cpp
+ * @brief Unit tests for the work-stealing scheduler and the batch routing built on it
+ */
+
+using transport::utils::WorkStealingScheduler;
+
+// Dijkstra that counts its searches, to see which strategy a system query went through
+class CountingStrategy : public RouteStrategy
+{
+public:
+    static std::atomic<int> searches;
+
+    RouteResult findRoute(const Graph &graph, const std::string &start, const std::string &end, const std::string &criteria,
+                          const CancellationToken &cancellation = CancellationToken(),
+                          SearchStats *stats = nullptr) override
+    {
+        searches++;
+        return DijkstraStrategy().findRoute(graph, start, end, criteria, cancellation, stats);
+    }
+};
+
+std::atomic<int> CountingStrategy::searches{0};
+
+class WorkStealingTestRunner
+{
+private:
+    int totalTests = 0;
+    int passedTests = 0;
+
+    // Star around a hub plus a tail of leaf stops, so per-origin cost is very uneven
+    Graph createHubNetwork(int spokes)
+    {
+        Graph graph;
+        graph.addNode("Hub", -6.2, 106.8);
+        for (int i = 0; i < spokes; ++i)
+        {
+            std::string name = "P" + std::to_string(i);
+            graph.addNode(name, -6.2 + i * 0.001, 106.8);
+            graph.addEdge("Hub", name, 1000 + i, 5 + i % 7, 3500, 0, "bus");
+            if (i % 3 == 0)
+                graph.addEdge(name, "Hub", 1000 + i, 6, 3500, 0, "bus");
+            if (i > 0)
+                graph.addEdge("P" + std::to_string(i - 1), name, 400, 2, 2000, 1, "walk");
+        }
+        graph.addNode("Island", -6.5, 107.0);
+        return graph;
+    }
+
+public:
+    void runTest(const std::string &testName, bool result)
+    {
+        totalTests++;
+        std::cout << "Test: " << testName << " - ";
+        if (result)
+        {
+            std::cout << "PASSED" << std::endl;
+            passedTests++;
+        }
+        else
+        {
+            std::cout << "FAILED" << std::endl;
+        }
+    }
+
+    bool testSubmitAndWaitIdle()
+    {
+        WorkStealingScheduler scheduler(4);
+        std::atomic<int> sum{0};
+        for (int i = 1; i <= 1000; ++i)
+            scheduler.submit([&sum, i]
+                             { sum += i; });
+        scheduler.waitIdle();
+
+        std::future<int> answer = scheduler.async([]
+                                                  { return 42; });
+        return sum.load() == 500500 && answer.get() == 42 && scheduler.getThreadCount() == 4;
+    }
+
+    bool testUnevenTasksAreStolen()
+    {
+        // Every task lands on worker 0's deque; the others only get work by stealing
+        WorkStealingScheduler scheduler(4);
+        std::atomic<int> done{0};
+        scheduler.submit([&]
+                         {
+            for (int i = 0; i < 64; ++i)
+                scheduler.submit([&done]
+                                 {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    done++; }); });
+        scheduler.waitIdle();
+
+        size_t executed = 0, stolen = 0, activeWorkers = 0;
+        for (const auto &stats : scheduler.getWorkerStats())
+        {
+            executed += stats.tasksExecuted;
+            stolen += stats.tasksStolen;
+            if (stats.tasksExecuted > 0)
+                ++activeWorkers;
+        }
+        return done.load() == 64 && executed == 65 && stolen > 0 && activeWorkers > 1;
+    }
+
+    bool testNestedParallelFor()
+    {
+        WorkStealingScheduler scheduler(2);
+        std::vector<std::atomic<int>> cells(40 * 40);
+        scheduler.parallelFor(0, 40, [&](size_t row)
+                              { scheduler.parallelFor(0, 40, [&](size_t column)
+                                                      { cells[row * 40 + column]++; }); });
+
+        for (const auto &cell : cells)
+        {
+            if (cell.load() != 1)
+                return false;
+        }
+
+        bool rethrown = false;
+        try
+        {
+            scheduler.parallelFor(0, 10, [](size_t i)
+                                  { if (i == 7) throw std::runtime_error("bad origin"); });
+        }
+        catch (const std::runtime_error &)
+        {
+            rethrown = true;
+        }
+        return rethrown;
+    }
+
+    bool testUtilizationReported()
+    {
+        WorkStealingScheduler scheduler(2);
+        scheduler.parallelFor(0, 8, [](size_t)
+                              { std::this_thread::sleep_for(std::chrono::milliseconds(5)); });
+        std::vector<WorkStealingScheduler::WorkerStats> stats = scheduler.getWorkerStats();
+        double busy = stats[0].busySeconds + stats[1].busySeconds;
+        bool reported = busy >= 0.035 && stats[0].utilization > 0.0 && stats[0].utilization <= 1.0;
+
+        scheduler.resetStats();
+        stats = scheduler.getWorkerStats();
+        return reported && stats[0].tasksExecuted == 0 && stats[1].busySeconds == 0.0;
+    }
+
+    // A task waiting on a nested loop is not busy; only the inner bodies count
+    bool testNestedBusyTimeCountedOnce()
+    {
+        WorkStealingScheduler scheduler(2);
+        std::atomic<int64_t> innerNanoseconds{0};
+        scheduler.parallelFor(0, 2, [&](size_t)
+                              { scheduler.parallelFor(0, 4, [&](size_t)
+                                                      {
+                auto started = std::chrono::steady_clock::now();
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                innerNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now() - started).count(); }); });
+
+        double busy = 0.0;
+        for (const auto &stats : scheduler.getWorkerStats())
+            busy += stats.busySeconds;
+        double inner = innerNanoseconds.load() / 1e9;
+        return busy >= inner && busy < inner * 1.25 + 0.005;
+    }
+
+    bool testMatrixMatchesDijkstra()
+    {
+        Graph graph = createHubNetwork(60);
+        RouteService service(std::make_shared<const GraphSnapshot>(graph), 3);
+        DijkstraStrategy dijkstra;
+
+        std::vector<std::string> names = graph.getNodeNames();
+        names.push_back("Nowhere");
+        std::vector<std::vector<long long>> matrix = service.computeMatrix(names, names, "time");
+
+        for (size_t o = 0; o < names.size(); ++o)
+        {
+            for (size_t d = 0; d < names.size(); ++d)
+            {
+                long long expected = RouteService::UNREACHABLE;
+                if (o == d && graph.hasNode(names[o]))
+                    expected = 0;
+                else if (graph.hasNode(names[o]) && graph.hasNode(names[d]))
+                {
+                    RouteResult route = dijkstra.findRoute(graph, names[o], names[d], "time");
+                    if (route.isValid)
+                        expected = route.totalTime;
+                }
+                if (matrix[o][d] != expected)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    bool testAlternativesUseSelectedStrategy()
+    {
+        StrategyRegistry::instance().add("counting_dijkstra", []()
+                                         { return std::make_unique<CountingStrategy>(); });
+        TransportationSystem system;
+        system.addLocation("Blok_M", -6.244, 106.800);
+        system.addLocation("Senayan", -6.227, 106.802);
+        system.addLocation("Kota", -6.137, 106.814);
+        system.addRoute("Blok_M", "Senayan", 2500, 6, 3500, 0, "mrt");
+        system.addRoute("Senayan", "Kota", 9000, 25, 5000, 0, "mrt");
+        system.addRoute("Blok_M", "Kota", 12000, 40, 3500, 1, "bus");
+
+        int before = CountingStrategy::searches;
+        if (!system.setAlgorithm("counting_dijkstra"))
+            return false;
+        std::vector<RouteResult> routes = system.findAlternativeRoutes("Blok_M", "Kota", 4);
+        return CountingStrategy::searches - before == 4 && routes.size() == 4 && routes[0].totalTime == 31 &&
+               routes[1].totalDistance == 11500 && routes[2].totalCost == 3500;
+    }
+
+    void printSummary()
+    {
+        std::cout << "\nWork Stealing Tests Summary: " << passedTests << "/"
+                  << totalTests << " tests passed." << std::endl;
+    }
+
+    void runAllTests()
+    {
+        runTest("Submit And Wait Idle", testSubmitAndWaitIdle());
+        runTest("Uneven Tasks Are Stolen", testUnevenTasksAreStolen());
+        runTest("Nested Parallel For", testNestedParallelFor());
+        runTest("Utilization Reported", testUtilizationReported());
+        runTest("Nested Busy Time Counted Once", testNestedBusyTimeCountedOnce());
+        runTest("OD Matrix Matches Dijkstra", testMatrixMatchesDijkstra());
+        runTest("Alternatives Use Selected Strategy", testAlternativesUseSelectedStrategy());
+        printSummary();
+    }
+};
+
+// Function that will be called from test_main.cpp
+void runWorkStealingTests()
+{
+    WorkStealingTestRunner testRunner;
+    testRunner.runAllTests();
+}
@@ -0,0 +1,361 @@
+#include "../include/io/JSONHandler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @file bench_compare.cpp
+ * @brief Benchmark regression gate: compares a run_benchmarks report against a stored baseline
+ *
+ * Usage: bench_compare <baseline.json> (<current.json> | --run <run_benchmarks>)
+ *                      [--confirm N] [--p50 PCT] [--p99 PCT] [--alpha P] [--allow-missing]
+ *
+ * A case regresses when its p50 grew by more than the given percentage (10 by default)
+ * and a one-sided Mann-Whitney U test on the raw samples says the current timings are
+ * larger with p below alpha (0.01), or when its p99 grew by more than its percentage
+ * (25 by default). Requiring both keeps noise from failing the p50 check, and keeps
+ * statistically real but negligible shifts from failing it. The U test compares whole
+ * distributions and barely notices a slowdown confined to the tail, and a few hundred
+ * samples hold too few points above the p99 for any test at alpha, so the p99 is gated
+ * on its threshold and the confirmation reruns alone, as is the p50 of a case with too
+ * few samples for the U test.
+ *
+ * With --run the tool runs the benchmark itself, with the seed, query and repetition
+ * counts and quick flag of the baseline, then reruns every flagged case on its own N more times (2 by
+ * default); only a case that regresses in every run counts. Comparing two report files
+ * has no reruns, so a p99 regression there rests on the threshold alone.
+ *
+ * A baseline case missing from the current run fails the check as well, since a case
+ * that crashed or was renamed would otherwise pass unnoticed; --allow-missing reports
+ * it without failing, e.g. after deliberately dropping a case. Exits with 1 on any
+ * regression, missing case or unusable input.
+ */
+
+namespace
+{
+    struct Thresholds
+    {
+        double p50 = 0.10;
+        double p99 = 0.25;
+        double alpha = 0.01;
+    };
+
+    // Below this many samples per side the test has no power; thresholds decide alone
+    const size_t MIN_SAMPLES = 8;
+
+    void printUsage(const char *program)
+    {
+        std::cerr << "Usage: " << program
+                  << " <baseline.json> (<current.json> | --run <run_benchmarks>) [--confirm N] [--p50 PCT]"
+                  << " [--p99 PCT] [--alpha P] [--allow-missing]" << std::endl;
+    }
+
+    // Nearest-rank percentile, the same definition BenchmarkReport uses
+    double percentile(std::vector<double> samples, double fraction)
+    {
+        if (samples.empty())
+            return 0.0;
+        std::sort(samples.begin(), samples.end());
+        size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(samples.size())));
+        return samples[std::min(std::max<size_t>(rank, 1), samples.size()) - 1];
+    }
+
+    /**
+     * @brief One-sided Mann-Whitney U test that current is stochastically larger than baseline
+     *
+     * Normal approximation with tie correction and continuity correction, accurate for
+     * the hundreds of samples a benchmark case records.
+     * @return p-value, 1 when either side is empty or every sample is equal
+     */
+    double mannWhitneyGreater(const std::vector<double> &baseline, const std::vector<double> &current)
+    {
+        double n1 = static_cast<double>(current.size());
+        double n2 = static_cast<double>(baseline.size());
+        if (current.empty() || baseline.empty())
+            return 1.0;
+
+        std::vector<std::pair<double, bool>> pooled; // Sample, whether it is from current
+        for (double sample : current)
+            pooled.emplace_back(sample, true);
+        for (double sample : baseline)
+            pooled.emplace_back(sample, false);
+        std::sort(pooled.begin(), pooled.end(),
+                  [](const auto &a, const auto &b)
+                  { return a.first < b.first; });
+
+        // Tied samples share the mean of their ranks
+        double currentRankSum = 0.0;
+        double tieTerm = 0.0;
+        for (size_t i = 0; i < pooled.size();)
+        {
+            size_t j = i;
+            while (j < pooled.size() && pooled[j].first == pooled[i].first)
+                ++j;
+            double rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+            for (size_t k = i; k < j; ++k)
+                if (pooled[k].second)
+                    currentRankSum += rank;
+            double ties = static_cast<double>(j - i);
+            tieTerm += ties * ties * ties - ties;
+            i = j;
+        }
+
+        double n = n1 + n2;
+        double u = currentRankSum - n1 * (n1 + 1.0) / 2.0;
+        double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+        if (variance <= 0.0)
+            return 1.0;
+        double z = (u - n1 * n2 / 2.0 - 0.5) / std::sqrt(variance);
+        return 0.5 * std::erfc(z / std::sqrt(2.0));
+    }
+
+    std::vector<double> samplesOf(const JSONValue &result)
+    {
+        std::vector<double> samples;
+        for (const JSONValue &sample : result.get("samples_us").items())
+            samples.push_back(sample.asNumber());
+        return samples;
+    }
+
+    std::string change(double fraction)
+    {
+        std::ostringstream out;
+        out << std::showpos << std::fixed << std::setprecision(1) << fraction * 100.0 << "%";
+        return out.str();
+    }
+
+    bool load(const std::string &path, JSONValue &report)
+    {
+        JSONReader reader;
+        if (!reader.parseFile(path, report))
+        {
+            std::cerr << "Error: Cannot read " << path << ": " << reader.getLastError() << std::endl;
+            return false;
+        }
+        if (report.get("schema").asNumber() != 1 || !report.get("results").isArray())
+        {
+            std::cerr << "Error: " << path << " is not a run_benchmarks report" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    struct Verdict
+    {
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double p50Change = 0.0; // Fraction, +0.12 for 12% slower
+        double p99Change = 0.0;
+        double pValue = 1.0; // U test, gates the p50 only
+        bool tested = false; // Enough samples for the U test
+        bool regressed = false;
+        bool faster = false;
+    };
+
+    Verdict judge(const JSONValue &before, const JSONValue &after, const Thresholds &thresholds)
+    {
+        std::vector<double> oldSamples = samplesOf(before), newSamples = samplesOf(after);
+        double oldP50 = percentile(oldSamples, 0.50), oldP99 = percentile(oldSamples, 0.99);
+
+        Verdict verdict;
+        verdict.p50 = percentile(newSamples, 0.50);
+        verdict.p99 = percentile(newSamples, 0.99);
+        verdict.p50Change = oldP50 > 0 ? verdict.p50 / oldP50 - 1.0 : 0.0;
+        verdict.p99Change = oldP99 > 0 ? verdict.p99 / oldP99 - 1.0 : 0.0;
+        verdict.tested = oldSamples.size() >= MIN_SAMPLES && newSamples.size() >= MIN_SAMPLES;
+        verdict.pValue = verdict.tested ? mannWhitneyGreater(oldSamples, newSamples) : 1.0;
+
+        bool p50Slower = verdict.p50Change > thresholds.p50 && (!verdict.tested || verdict.pValue < thresholds.alpha);
+        bool p99Slower = verdict.p99Change > thresholds.p99;
+        verdict.regressed = p50Slower || p99Slower;
+        verdict.faster = verdict.p50Change < -thresholds.p50 && verdict.tested &&
+                         mannWhitneyGreater(newSamples, oldSamples) < thresholds.alpha;
+        return verdict;
+    }
+
+    const JSONValue *findResult(const JSONValue &report, const std::string &name)
+    {
+        for (const JSONValue &result : report.get("results").items())
+            if (result.get("name").asString() == name)
+                return &result;
+        return nullptr;
+    }
+
+    /**
+     * @brief Run the benchmark binary with the baseline's options and load its report
+     * @param filter Single case to run, empty for every case
+     */
+    bool runBenchmark(const std::string &program, const JSONValue &baseline, const std::string &filter,
+                      JSONValue &report)
+    {
+        std::string output = (std::filesystem::temp_directory_path() / "bench_compare_current.json").string();
+        std::ostringstream command;
+        command << "\"" << program << "\" --json \"" << output << "\" --seed "
+                << static_cast<long long>(baseline.get("seed").asNumber()) << " --queries "
+                << static_cast<long long>(baseline.get("queries").asNumber()) << " --repetitions "
+                << static_cast<long long>(baseline.get("repetitions").asNumber());
+        if (baseline.get("quick").asBool())
+            command << " --quick";
+        if (!filter.empty())
+            command << " --filter \"" << filter << "\"";
+        // The per-case table of a full run is worth seeing; confirmation runs stay quiet
+        command << (filter.empty() ? "" : " > \"" + output + ".log\"");
+
+        if (std::system(command.str().c_str()) != 0)
+        {
+            std::cerr << "Error: Benchmark run failed: " << command.str() << std::endl;
+            return false;
+        }
+        bool loaded = load(output, report);
+        std::error_code error;
+        std::filesystem::remove(output, error);
+        std::filesystem::remove(output + ".log", error);
+        return loaded;
+    }
+
+    void printRow(const std::string &name, const Verdict &verdict, const std::string &note)
+    {
+        std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << verdict.p50 << std::setw(9) << change(verdict.p50Change) << std::setw(10)
+                  << verdict.p99 << std::setw(9) << change(verdict.p99Change) << std::setw(10);
+        if (verdict.tested)
+            std::cout << std::setprecision(4) << verdict.pValue;
+        else
+            std::cout << "-";
+        std::cout << "  " << note << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> paths;
+    std::string program;
+    int confirmations = 2;
+    bool allowMissing = false;
+    Thresholds thresholds;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        try
+        {
+            if (argument == "--run" && hasValue)
+                program = argv[++i];
+            else if (argument == "--confirm" && hasValue)
+                confirmations = std::max(0, std::stoi(argv[++i]));
+            else if (argument == "--p50" && hasValue)
+                thresholds.p50 = std::stod(argv[++i]) / 100.0;
+            else if (argument == "--p99" && hasValue)
+                thresholds.p99 = std::stod(argv[++i]) / 100.0;
+            else if (argument == "--alpha" && hasValue)
+                thresholds.alpha = std::stod(argv[++i]);
+            else if (argument == "--allow-missing")
+                allowMissing = true;
+            else if (!argument.empty() && argument[0] != '-')
+                paths.push_back(argument);
+            else
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        catch (const std::exception &)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (paths.size() != (program.empty() ? 2u : 1u))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    JSONValue baseline, current;
+    if (!load(paths[0], baseline))
+        return 1;
+    if (program.empty() ? !load(paths[1], current) : !runBenchmark(program, baseline, "", current))
+        return 1;
+
+    // Different seeds or query counts time different queries; the samples are not comparable
+    for (const char *key : {"seed", "queries", "repetitions", "quick"})
+    {
+        if (baseline.get(key).dump() != current.get(key).dump())
+        {
+            std::cerr << "Error: Baseline and current run differ in " << key << " (" << baseline.get(key).dump()
+                      << " vs " << current.get(key).dump() << "); record a new baseline" << std::endl;
+            return 1;
+        }
+    }
+    if (baseline.get("hardware_threads").dump() != current.get("hardware_threads").dump())
+        std::cout << "Warning: Baseline was recorded with " << baseline.get("hardware_threads").dump()
+                  << " hardware threads, this machine has " << current.get("hardware_threads").dump() << std::endl;
+
+    std::cout << "\n"
+              << std::left << std::setw(48) << "case" << std::right << std::setw(10) << "p50 us"
+              << std::setw(9) << "change" << std::setw(10) << "p99 us" << std::setw(9) << "change"
+              << std::setw(10) << "p-value" << "  verdict" << std::endl;
+
+    int regressions = 0, compared = 0;
+    for (const JSONValue &result : current.get("results").items())
+    {
+        std::string name = result.get("name").asString();
+        const JSONValue *before = findResult(baseline, name);
+        if (!before)
+        {
+            std::cout << std::left << std::setw(48) << name << "  new, not in baseline" << std::endl;
+            continue;
+        }
+        compared++;
+
+        Verdict verdict = judge(*before, result, thresholds);
+        int confirmed = 0;
+        bool cleared = false;
+        for (int run = 0; verdict.regressed && !program.empty() && run < confirmations; ++run)
+        {
+            JSONValue rerun;
+            const JSONValue *again = runBenchmark(program, baseline, name, rerun) ? findResult(rerun, name) : nullptr;
+            if (!again)
+                break;
+            Verdict next = judge(*before, *again, thresholds);
+            if (!next.regressed)
+            {
+                verdict = next;
+                cleared = true;
+                break;
+            }
+            confirmed++;
+        }
+
+        std::string note = verdict.regressed ? "REGRESSION" : verdict.faster ? "faster" : "ok";
+        if (cleared)
+            note += " (not reproduced on rerun)";
+        else if (confirmed > 0)
+            note += " (confirmed by " + std::to_string(confirmed) + " rerun" + (confirmed > 1 ? "s)" : ")");
+        regressions += verdict.regressed ? 1 : 0;
+        printRow(name, verdict, note);
+    }
+
+    int missing = 0;
+    for (const JSONValue &result : baseline.get("results").items())
+    {
+        std::string name = result.get("name").asString();
+        if (findResult(current, name))
+            continue;
+        missing++;
+        std::cout << std::left << std::setw(48) << name << "  MISSING from current run"
+                  << (allowMissing ? " (allowed)" : "") << std::endl;
+    }
+
+    std::cout << "\n"
+              << compared << " cases compared, " << regressions << " regressed, " << missing << " missing (p50 +"
+              << std::fixed << std::setprecision(0) << thresholds.p50 * 100 << "%, p99 +" << thresholds.p99 * 100
+              << "%, alpha " << std::setprecision(3) << thresholds.alpha << ")" << std::endl;
+    return regressions > 0 || (missing > 0 && !allowMissing) ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+#include "../include/io/TraceLog.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * @file trace_analyzer.cpp
+ * @brief Summarizes a binary route query trace written by TraceLog
+ *
+ * Usage: trace_analyzer <trace file> [--top N]
+ *
+ * Prints the status mix, latency percentiles overall and per criterion, the work
+ * (nodes settled) behind them, and the N origin/destination pairs with the slowest
+ * single query.
+ */
+
+namespace
+{
+    // Same order as GraphSnapshot::Criterion and RouteStatus
+    const char *const CRITERION_NAMES[] = {"distance", "time", "cost", "transfers"};
+    const char *const STATUS_NAMES[] = {"found", "not found", "timed out", "cancelled"};
+
+    std::string criterionName(uint8_t criterion)
+    {
+        return criterion < 4 ? CRITERION_NAMES[criterion] : "criterion " + std::to_string(criterion);
+    }
+
+    std::string nodeName(uint32_t node)
+    {
+        return node == TraceLog::INVALID_NODE ? std::string("?") : std::to_string(node);
+    }
+
+    // Nearest-rank percentile of an ascending vector
+    uint32_t percentile(const std::vector<uint32_t> &sorted, double fraction)
+    {
+        if (sorted.empty())
+            return 0;
+        size_t rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size()) + 0.999999);
+        return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    }
+
+    struct Group
+    {
+        std::vector<uint32_t> latencies;
+        std::vector<uint32_t> settled;
+
+        void add(const TraceLog::Record &record)
+        {
+            latencies.push_back(record.latencyMicros);
+            settled.push_back(record.nodesSettled);
+        }
+    };
+
+    void printHeader()
+    {
+        std::cout << std::left << std::setw(12) << "" << std::right
+                  << std::setw(9) << "count" << std::setw(12) << "p50 us" << std::setw(12) << "p90 us"
+                  << std::setw(12) << "p99 us" << std::setw(12) << "p99.9 us" << std::setw(12) << "max us"
+                  << std::setw(14) << "mean us" << std::setw(13) << "settled p50" << std::setw(13) << "settled p99"
+                  << std::endl;
+    }
+
+    void printGroup(const std::string &label, Group &group)
+    {
+        std::sort(group.latencies.begin(), group.latencies.end());
+        std::sort(group.settled.begin(), group.settled.end());
+        double mean = std::accumulate(group.latencies.begin(), group.latencies.end(), 0.0) /
+                      static_cast<double>(group.latencies.size());
+
+        std::cout << std::left << std::setw(12) << label << std::right
+                  << std::setw(9) << group.latencies.size()
+                  << std::setw(12) << percentile(group.latencies, 0.50)
+                  << std::setw(12) << percentile(group.latencies, 0.90)
+                  << std::setw(12) << percentile(group.latencies, 0.99)
+                  << std::setw(12) << percentile(group.latencies, 0.999)
+                  << std::setw(12) << group.latencies.back()
+                  << std::setw(14) << std::fixed << std::setprecision(1) << mean
+                  << std::setw(13) << percentile(group.settled, 0.50)
+                  << std::setw(13) << percentile(group.settled, 0.99) << std::endl;
+    }
+
+    void printUsage(const char *program)
+    {
+        std::cerr << "Usage: " << program << " <trace file> [--top N]" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string path;
+    size_t top = 10;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--top" && i + 1 < argc)
+        {
+            try
+            {
+                top = static_cast<size_t>(std::max(0, std::stoi(argv[++i])));
+            }
+            catch (const std::exception &)
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (path.empty() && argument[0] != '-')
+        {
+            path = argument;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (path.empty())
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<TraceLog::Record> records;
+    std::string error;
+    if (!TraceLog::readFile(path, records, error))
+    {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "Trace: " << path << std::endl;
+    if (records.empty())
+    {
+        std::cout << "No records." << std::endl;
+        return 0;
+    }
+
+    // Overview
+    uint64_t first = records.front().timestampNanos, last = first;
+    std::set<uint32_t> threads;
+    size_t statusCounts[4] = {0, 0, 0, 0};
+    size_t coalesced = 0, failed = 0;
+    for (const TraceLog::Record &record : records)
+    {
+        first = std::min(first, record.timestampNanos);
+        last = std::max(last, record.timestampNanos);
+        threads.insert(record.threadId);
+        if (record.status < 4)
+            statusCounts[record.status]++;
+        if (record.flags & TraceLog::FLAG_COALESCED)
+            coalesced++;
+        if (record.flags & TraceLog::FLAG_FAILED)
+            failed++;
+    }
+    double seconds = static_cast<double>(last - first) / 1e9;
+    std::cout << "Records: " << records.size() << " from " << threads.size() << " threads over "
+              << std::fixed << std::setprecision(3) << seconds << " s";
+    if (seconds > 0)
+        std::cout << " (" << std::setprecision(1) << static_cast<double>(records.size()) / seconds << " queries/s)";
+    std::cout << std::endl;
+
+    std::cout << "Status:";
+    for (int s = 0; s < 4; ++s)
+        std::cout << (s ? ", " : " ") << STATUS_NAMES[s] << " " << statusCounts[s];
+    std::cout << "; coalesced " << coalesced << ", failed " << failed << std::endl
+              << std::endl;
+
+    // Latency overall and per criterion
+    Group overall;
+    std::map<uint8_t, Group> byCriterion;
+    for (const TraceLog::Record &record : records)
+    {
+        overall.add(record);
+        byCriterion[record.criterion].add(record);
+    }
+    printHeader();
+    printGroup("all", overall);
+    for (auto &entry : byCriterion)
+        printGroup(criterionName(entry.first), entry.second);
+
+    // Slowest origin/destination pairs, ranked by their slowest query
+    if (top == 0)
+        return 0;
+    using PairKey = std::tuple<uint32_t, uint32_t, uint8_t>;
+    std::map<PairKey, Group> byPair;
+    for (const TraceLog::Record &record : records)
+        byPair[PairKey(record.startNode, record.endNode, record.criterion)].add(record);
+
+    std::vector<std::pair<uint32_t, PairKey>> ranked;
+    for (auto &entry : byPair)
+        ranked.emplace_back(*std::max_element(entry.second.latencies.begin(), entry.second.latencies.end()),
+                            entry.first);
+    std::sort(ranked.begin(), ranked.end(), [](const auto &a, const auto &b)
+              { return a.first > b.first; });
+    ranked.resize(std::min(ranked.size(), top));
+
+    std::cout << std::endl
+              << "Slowest pairs (node ids):" << std::endl;
+    std::cout << std::left << std::setw(24) << "start -> end" << std::setw(11) << "criterion" << std::right
+              << std::setw(8) << "count" << std::setw(12) << "max us" << std::setw(14) << "mean us"
+              << std::setw(13) << "max settled" << std::endl;
+    for (const auto &entry : ranked)
+    {
+        const Group &group = byPair[entry.second];
+        double mean = std::accumulate(group.latencies.begin(), group.latencies.end(), 0.0) /
+                      static_cast<double>(group.latencies.size());
+        std::string pair = nodeName(std::get<0>(entry.second)) + " -> " + nodeName(std::get<1>(entry.second));
+        std::cout << std::left << std::setw(24) << pair << std::setw(11) << criterionName(std::get<2>(entry.second))
+                  << std::right << std::setw(8) << group.latencies.size() << std::setw(12) << entry.first
+                  << std::setw(14) << std::fixed << std::setprecision(1) << mean
+                  << std::setw(13) << *std::max_element(group.settled.begin(), group.settled.end()) << std::endl;
+    }
+    return 0;
+}